@@ -1,9 +1,14 @@
 ﻿#pragma once
 #include <Windows.h>
-#include "graphics/GraphicsDevice.h"
+#include "FrameScheduler.h"
+#include "graphics/D3D11GraphicsDevice.h"
 #include "graphics/Shader.h"
 #include "ImguiManager.h"
 #include "capturer/WGCCapturer.h"
+#include "graphics/ReadbackRing.h"
+#include "graphics/UploadRing.h"
+#include "capturer/SnapshotWriter.h"
+#include <filesystem>
 #include <memory>
 #include <d3dcompiler.h>
 #include <wrl/client.h>
@@ -13,11 +18,27 @@ namespace lens
     class Application
     {
     public:
+        // 帧来源，默认使用 WGC 捕获桌面窗口
+        enum class CaptureBackend
+        {
+            WGC,
+            Synthetic,
+            FileReplay
+        };
+
         Application(HINSTANCE hInstance, int mCmdShow,
             const wchar_t* className = L"LensWindowClass", const wchar_t* title = L"Lens Application");
 
         ~Application();
 
+        // 需在 Initialize 之前调用
+        void SetCaptureBackend(CaptureBackend backend, const std::filesystem::path& replayPath = {});
+        void SetFrameDedup(bool enabled) { m_frameDedup = enabled; }
+        // 无窗口运行：使用空图形后端跑 frameCount 帧捕获 → 上传 → 回读/截图，结束时输出每帧 CPU 耗时
+        void SetHeadless(uint32_t frameCount) { m_headless = true; m_headlessFrames = frameCount; }
+        // 没有输入和新帧时的最低重绘频率，0 表示完全空闲时不重绘
+        void SetMinRefreshRate(double hz) { m_schedulerDesc.minRefreshHz = hz; }
+
         void Initialize();
 
         int Run();
@@ -25,29 +46,54 @@ namespace lens
         static LRESULT CALLBACK WindowProcProxy(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
         // Public getter for capturer access from UI panels
-        capturer::WGCCapturer* GetCapturer() const { return m_capturer.get(); }
+        capturer::ICaptureSource* GetCapturer() const { return m_capturer.get(); }
 
     private:
         bool CreateLenWindow(int width = 800, int height = 600);
+        bool InitializeHeadless();
+        int RunHeadless();
+        capturer::ICaptureSource::CaptureDesc GetCaptureDesc() const;
+        void LogPipelineStats() const;
+        std::unique_ptr<capturer::ICaptureSource> CreateCaptureSource();
+        bool StartWindowCapture(capturer::WGCCapturer* wgcCapturer);
         bool CreateCaptureShaders();
         bool CreateCaptureSampler();
-        bool CompileShader(const std::string& code, const char* entryPoint, const char* target, Microsoft::WRL::ComPtr<ID3DBlob>& blob);
+        void CreateUploadRing();
+        // 窗口模式下的 D3D11 设备，空后端返回 nullptr
+        graphics::D3D11GraphicsDevice* GetD3D11Device() const;
 
         LRESULT CALLBACK WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
         HINSTANCE m_hInstance;
         int m_nCmdShow;
-        HWND m_hwnd;
+        HWND m_hwnd = nullptr;
 
-        graphics::GraphicsDevice* m_graphicsDevice;
-        ImguiManager* m_imgui;
+        std::unique_ptr<graphics::GraphicsDevice> m_graphicsDevice;
+        ImguiManager* m_imgui = nullptr;
+        bool m_headless = false;
+        uint32_t m_headlessFrames = 0;
 
         // WGC Capture related
-        std::unique_ptr<capturer::WGCCapturer> m_capturer;
-        graphics::Shader m_captureShader;
+        CaptureBackend m_captureBackend = CaptureBackend::WGC;
+        std::filesystem::path m_replayPath;
+        bool m_frameDedup = false;
+        // 捕获线程发布新帧时置位，须比 m_capturer 活得久
+        winrt::handle m_frameEvent;
+        std::unique_ptr<capturer::ICaptureSource> m_capturer;
+        std::unique_ptr<graphics::Shader> m_captureShader;
         Microsoft::WRL::ComPtr<ID3D11SamplerState> m_captureSampler;
-        Microsoft::WRL::ComPtr<ID3D11Buffer> m_captureConstantBuffer;
-        std::shared_ptr<graphics::Texture> m_lastCapturedFrame;
+
+        // GPU 到 CPU 的异步回读，每帧开始时 Poll
+        std::unique_ptr<graphics::ReadbackRing> m_readback;
+        // 每帧的常量从这里分配，一帧只映射一次，EndFrame 时解除映射；设备不支持按偏移绑定时为空。
+        // 目前还没有读取常量的绘制，捕获着色器接入绘制时再把 CaptureParams 放到这里
+        std::unique_ptr<graphics::UploadRing> m_uploads;
+        // 截图编码和写文件在后台线程，自带独立的回读槽位
+        std::unique_ptr<capturer::SnapshotWriter> m_snapshots;
+
+        // 只在有变化时重绘，其余时间阻塞在 MsgWaitForMultipleObjectsEx
+        FrameScheduler::Desc m_schedulerDesc;
+        FrameScheduler m_scheduler;
 
         int width;
         int height;
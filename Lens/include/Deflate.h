@@ -0,0 +1,20 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lens
+{
+    // 校验和：CRC-32（PNG/ZIP 使用的多项式）与 Adler-32（zlib），可分段累加
+    uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+    uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler = 1);
+
+    // 合并两段数据的 Adler-32，second 为后一段（长度 secondLength）单独计算的结果
+    uint32_t Adler32Combine(uint32_t first, uint32_t second, uint64_t secondLength);
+
+    // 原始 deflate 流（RFC 1951）压缩，结果追加到 output。
+    // level 0 只输出存储块，1~9 依次增加匹配搜索深度，每块在动态/固定 Huffman 和存储之间取最小。
+    // finalBlock 为 false 时以空存储块结尾并字节对齐，分段独立压缩的结果可以直接拼接成一个流
+    void Deflate(const uint8_t* data, size_t size, uint32_t level, bool finalBlock, std::vector<uint8_t>& output);
+}
@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace lens
+{
+    // 空闲感知的重绘调度：只有输入、新帧、到期的定时器或超过最低刷新间隔时才重绘，
+    // 其余时间让平台层阻塞等待。本身不等待也不读时钟，时间都由调用方传入，可以脱离窗口单独测试。
+    //
+    //   timeout = GetWaitTimeout(now)      平台层据此等待消息和新帧信号
+    //   Invalidate(...) / ScheduleAt(...)  醒来后登记发生的事件
+    //   if (ShouldRedraw(now)) { 绘制; OnRedrawn(now); }
+    class FrameScheduler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum class Reason
+        {
+            Input,          // 窗口消息（键鼠、尺寸变化等）
+            NewFrame,       // 捕获源发布了新帧或回读完成
+            Timer,          // ScheduleAt 的期限到了
+            MinRefresh,     // 超过最低刷新间隔
+            Settle          // 输入之后的补充帧，让 ImGui 的悬停、展开等状态稳定下来
+        };
+
+        struct Desc
+        {
+            double minRefreshHz = 1.0;      // 没有任何事件时的最低重绘频率，0 表示不重绘
+            uint32_t settleFrames = 2;      // 每次输入后额外重绘的帧数
+        };
+
+        struct Stats
+        {
+            uint64_t wakeups = 0;           // ShouldRedraw 调用次数
+            uint64_t redraws = 0;
+            uint64_t idleWakeups = 0;       // 醒来但不需要重绘
+            uint64_t byInput = 0;           // 以下按原因计数，一帧可能同时有几个原因
+            uint64_t byNewFrame = 0;
+            uint64_t byTimer = 0;
+            uint64_t byMinRefresh = 0;
+            uint64_t bySettle = 0;
+        };
+
+        FrameScheduler();
+        explicit FrameScheduler(const Desc& desc);
+
+        void Configure(const Desc& desc);
+
+        // 登记需要重绘的事件，下一次 ShouldRedraw 返回 true
+        void Invalidate(Reason reason);
+
+        // 一次性定时器：到期时醒来重绘。多次调用只保留最早的期限，调用方需要时每轮重新设置
+        void ScheduleAt(Clock::time_point deadline);
+
+        // 平台层最多可以等待多久；需要立即重绘时返回 0，没有任何期限时返回 Clock::duration::max()
+        Clock::duration GetWaitTimeout(Clock::time_point now) const;
+
+        // 醒来后调用，检查到期的定时器和刷新间隔，返回本轮是否需要重绘
+        bool ShouldRedraw(Clock::time_point now);
+
+        // 绘制完一帧后调用，清除已处理的事件
+        void OnRedrawn(Clock::time_point now);
+
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        static constexpr uint32_t Bit(Reason reason) { return 1u << static_cast<uint32_t>(reason); }
+
+        Desc m_desc;
+        Clock::duration m_minInterval{};    // 0 表示没有最低刷新率
+        uint32_t m_pending = 0;             // Reason 位掩码
+        uint32_t m_settleRemaining = 0;
+        Clock::time_point m_lastRedraw{};
+        Clock::time_point m_timerDeadline = Clock::time_point::max();
+
+        Stats m_stats;
+    };
+}
@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lens
+{
+    // LZ4 块格式（不含帧头）的压缩与解压，与参考实现的 LZ4_compress_default / LZ4_decompress_safe 互通。
+    // 只用一级哈希查找，速度优先，适合录制时逐帧压缩
+
+    // 最坏情况下的压缩结果大小
+    inline size_t Lz4CompressBound(size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    // 压缩结果追加到 output，返回本次追加的字节数
+    size_t Lz4Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& output);
+
+    // 解压后必须恰好是 outputSize 字节；输入损坏时返回 false，不会越界读写
+    bool Lz4Decompress(const uint8_t* data, size_t size, uint8_t* output, size_t outputSize);
+}
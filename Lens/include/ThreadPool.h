@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lens
+{
+    // 固定线程数的工作线程池，供 CPU 侧图像处理并行使用
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+        // 处理 [begin, end) 范围
+        using RangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+        // threadCount 为 0 时不创建工作线程，所有任务在调用线程上执行
+        explicit ThreadPool(uint32_t threadCount = GetDefaultThreadCount());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // 进程共享的线程池，首次使用时创建
+        static ThreadPool& GetShared();
+
+        // 硬件线程数减一，调用线程也参与 ParallelFor
+        static uint32_t GetDefaultThreadCount();
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_threads.size()); }
+
+        std::future<void> Submit(Task task);
+
+        // 把 [0, count) 切成大小为 grain 的块并行执行，返回时全部完成。
+        // 调用线程也领取任务块，因此在工作线程内嵌套调用不会死锁
+        void ParallelFor(uint32_t count, uint32_t grain, const RangeFunction& fn);
+
+    private:
+        void WorkerLoop();
+
+        std::vector<std::thread> m_threads;
+        std::deque<Task> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        bool m_stopping = false;
+    };
+}
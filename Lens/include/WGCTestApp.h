@@ -1,6 +1,6 @@
 ﻿#pragma once
 #include <Windows.h>
-#include "graphics/GraphicsDevice.h"
+#include "graphics/D3D11GraphicsDevice.h"
 #include "graphics/Shader.h"
 #include "capturer/WGCCapturer.h"
 #include <memory>
@@ -34,8 +34,8 @@ namespace lens
         int m_nCmdShow;
         HWND m_hwnd;
 
-        graphics::GraphicsDevice* m_graphicsDevice;
-        graphics::Shader m_shader;
+        graphics::D3D11GraphicsDevice* m_graphicsDevice;
+        std::unique_ptr<graphics::Shader> m_shader;
         std::unique_ptr<capturer::WGCCapturer> m_capturer;
 
         Microsoft::WRL::ComPtr<ID3D11SamplerState> m_sampler;
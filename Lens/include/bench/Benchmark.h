@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace lens::graphics
+{
+    struct CpuImage;
+}
+
+namespace lens::bench
+{
+    // 命令行 --bench <名称> [参数...] 进入基准测试模式，不创建窗口，结果写入日志。
+    // 返回进程退出码
+    int RunBenchmark(const std::string& name, const std::vector<std::string>& args);
+
+    // 参数辅助：取第 index 个参数，缺省时返回 fallback
+    uint32_t GetArgU32(const std::vector<std::string>& args, size_t index, uint32_t fallback);
+
+    // 计时辅助
+    template<typename Fn>
+    double MeasureSeconds(Fn&& fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 近似桌面截图的测试内容：纯色窗口和"文字"块占大部分，右下角一块带噪声的照片区域
+    void FillScreenshot(graphics::CpuImage& image);
+
+    // 各项基准测试
+    void BenchCaptureScaling(const std::vector<std::string>& args);
+    void BenchPixelConvert(const std::vector<std::string>& args);
+    void BenchResample(const std::vector<std::string>& args);
+    void BenchFrameDiff(const std::vector<std::string>& args);
+    void BenchDedup(const std::vector<std::string>& args);
+    void BenchImageEncode(const std::vector<std::string>& args);
+    void BenchDeltaCodec(const std::vector<std::string>& args);
+    void BenchMjpeg(const std::vector<std::string>& args);
+    void BenchShaderCache(const std::vector<std::string>& args);
+    void BenchMailbox(const std::vector<std::string>& args);
+}
@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include "capturer/FramePacer.h"
+#include "capturer/ICaptureSource.h"
+#include "graphics/GraphicsDevice.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lens::capturer
+{
+    // 同时管理多个捕获会话：所有源共享同一个 GraphicsDevice，
+    // 每个源有独立的分发线程和帧率预算，回调在该源的分发线程上执行
+    class CaptureManager
+    {
+    public:
+        using FrameCallback = std::function<void(const Frame& frame)>;
+
+        struct SourceStats
+        {
+            uint32_t id = 0;
+            std::string name;
+            uint64_t received = 0;      // 从源取到的帧
+            uint64_t dispatched = 0;    // 通过预算、交给回调的帧
+            uint64_t budgetDropped = 0; // 超出预算被丢弃的帧
+            uint64_t sourceDropped = 0; // 源内部被覆盖的帧
+            double fps = 0.0;           // 分发帧率
+        };
+
+        struct Stats
+        {
+            std::vector<SourceStats> sources;
+            uint64_t totalReceived = 0;
+            uint64_t totalDispatched = 0;
+            uint64_t totalDropped = 0;
+            double totalFps = 0.0;
+        };
+
+        CaptureManager(lens::graphics::GraphicsDevice* device);
+        ~CaptureManager();
+
+        CaptureManager(const CaptureManager&) = delete;
+        CaptureManager& operator=(const CaptureManager&) = delete;
+
+        lens::graphics::GraphicsDevice* GetDevice() const { return m_device; }
+
+        // 添加已初始化的源，fpsBudget 为 0 表示不限制，返回源 id（失败为 0）
+        uint32_t AddSource(std::unique_ptr<ICaptureSource> source, uint32_t fpsBudget = 0);
+        bool RemoveSource(uint32_t id);
+        size_t GetSourceCount() const;
+
+        // 需在 Start 之前设置
+        void SetFrameCallback(FrameCallback callback) { m_callback = std::move(callback); }
+
+        bool Start();
+        void Stop();
+        bool IsRunning() const { return m_running; }
+
+        Stats GetStats() const;
+
+    private:
+        struct Session
+        {
+            uint32_t id = 0;
+            std::unique_ptr<ICaptureSource> source;
+            FramePacer budget;
+            std::thread worker;
+            std::atomic<bool> running{ false };
+            std::chrono::steady_clock::time_point startTime;
+        };
+
+        lens::graphics::GraphicsDevice* m_device;
+        FrameCallback m_callback;
+
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<Session>> m_sessions;
+        uint32_t m_nextId = 1;
+        std::atomic<bool> m_running{ false };
+
+        bool StartSession(Session& session);
+        void StopSession(Session& session);
+        void WorkerLoop(Session& session);
+    };
+}
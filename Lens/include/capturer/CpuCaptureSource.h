@@ -0,0 +1,79 @@
+﻿#pragma once
+
+#include "capturer/DirtyRegion.h"
+#include "capturer/FrameDiff.h"
+#include "capturer/FrameMailbox.h"
+#include "capturer/ICaptureSource.h"
+#include "graphics/CpuImage.h"
+#include "graphics/TexturePool.h"
+#include <atomic>
+#include <thread>
+
+namespace lens::capturer
+{
+    // 在系统内存中产生帧的捕获源基类：内部工作线程按帧率调用 ProduceFrame，
+    // 消费端取帧时再按需上传到 GPU。device 为空时只提供 CPU 图像
+    class CpuCaptureSource : public ICaptureSource
+    {
+    public:
+        CpuCaptureSource(lens::graphics::GraphicsDevice* device);
+        ~CpuCaptureSource() override;
+
+        // 初始化和清理
+        bool Initialize(const CaptureDesc& desc) override;
+        void Shutdown() override;
+
+        // 捕获控制
+        bool StartCapture() override;
+        void StopCapture() override;
+        bool IsCapturing() const override { return m_isCapturing; }
+
+        // 帧获取
+        Frame GetLatestFrame() override;
+        bool AcquireFrame(Frame& frame, std::chrono::milliseconds timeout) override;
+        bool HasNewFrame() const override { return m_frames.HasNew(); }
+        FrameStats GetFrameStats() const override;
+        std::shared_ptr<const lens::graphics::CpuImage> GetLatestImage();
+
+        // 统计
+        uint64_t GetProducedFrameCount() const { return m_frames.GetPublishedCount(); }
+
+    protected:
+        // 由子类实现，ProduceFrame 返回空表示本次没有新帧
+        virtual bool OnInitialize() { return true; }
+        virtual std::shared_ptr<const lens::graphics::CpuImage> ProduceFrame(uint64_t frameIndex) = 0;
+
+        lens::graphics::GraphicsDevice* m_device;
+        CaptureDesc m_desc;
+
+    private:
+        static constexpr uint32_t kDirtyTileSize = 64;
+
+        std::thread m_worker;
+        std::atomic<bool> m_isCapturing{ false };
+
+        // 帧存储，工作线程生产，消费端取走后再上传
+        FrameMailbox<Frame> m_frames;
+        // 最近上传的纹理；消费端持有的旧帧纹理保持不变，新内容写到池里的另一张纹理
+        std::shared_ptr<lens::graphics::Texture> m_texture;
+        std::unique_ptr<lens::graphics::TexturePool> m_texturePool;
+
+        // 脏区：工作线程与上一帧逐块比较；上传时序号连续才只更新变化区域
+        std::shared_ptr<const lens::graphics::CpuImage> m_previousImage;
+        FrameDiff m_frameDiff{ kDirtyTileSize };
+        FrameDiff::Result m_diffResult;
+
+        // 去重：内容没变的帧沿用上一帧的指纹；被丢弃帧的脏区累积到下一次发布的帧上，
+        // 保证消费端按连续序号只更新脏区时不会漏掉变化
+        FrameDeduplicator m_dedup;
+        FrameFingerprint m_lastFingerprint;
+        std::vector<DirtyRect> m_pendingDirty;
+        std::atomic<uint64_t> m_unchangedCount{ 0 };
+        uint64_t m_uploadedSequence = 0;
+        bool m_hasUploaded = false;
+
+        void UploadFrame(const Frame& frame);
+
+        void WorkerLoop();
+    };
+}
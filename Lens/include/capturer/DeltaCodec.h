@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include "capturer/FrameDiff.h"
+#include "graphics/CpuImage.h"
+#include <cstdint>
+#include <vector>
+
+namespace lens
+{
+    class ThreadPool;
+}
+
+namespace lens::capturer
+{
+    // 无损录制编码：每隔 keyframeInterval 帧一个关键帧，其余帧只保存变化的块。
+    // 变化块与上一帧逐字节异或后大部分为零，再用 LZ4 压缩；各块互相独立，在线程池上并行编解码。
+    //
+    //   [DeltaFrameHeader][DeltaTileEntry x tileCount][各块压缩数据依次排列]
+    //
+    // 关键帧包含全部块且不做异或；没有列出的块与上一帧相同
+    namespace deltaformat
+    {
+        constexpr uint32_t kMagic = 0x544C444C;    // "LDLT"
+        constexpr uint32_t kKeyframe = 1u << 0;
+        constexpr uint32_t kStoredTile = 1u << 31; // DeltaTileEntry::size 最高位：未压缩
+
+        struct DeltaFrameHeader
+        {
+            uint32_t magic;
+            uint32_t flags;
+            uint32_t width;
+            uint32_t height;
+            uint32_t format;        // TextureFormat
+            uint32_t tileSize;
+            uint32_t tileCount;     // 本帧保存的块数
+            uint32_t reserved;
+        };
+
+        struct DeltaTileEntry
+        {
+            uint32_t index;         // ty * tilesX + tx
+            uint32_t size;          // 压缩数据字节数，可带 kStoredTile
+        };
+
+        static_assert(sizeof(DeltaFrameHeader) == 32);
+        static_assert(sizeof(DeltaTileEntry) == 8);
+    }
+
+    class DeltaEncoder
+    {
+    public:
+        struct Desc
+        {
+            uint32_t tileSize = 64;
+            uint32_t keyframeInterval = 120;    // 60 fps 下每 2 秒一个关键帧，限制随机定位时需要解码的帧数
+            ThreadPool* pool = nullptr;         // 为空时使用共享线程池
+        };
+
+        struct Stats
+        {
+            uint64_t frames = 0;
+            uint64_t keyframes = 0;
+            uint64_t tiles = 0;                 // 实际编码的块数
+            uint64_t inputBytes = 0;            // 未压缩的整帧字节数
+            uint64_t outputBytes = 0;
+            double encodeMs = 0.0;
+        };
+
+        DeltaEncoder();
+        explicit DeltaEncoder(const Desc& desc);
+
+        // 结果覆盖写入 output。尺寸或格式变化时自动输出关键帧
+        bool Encode(const lens::graphics::CpuImage& image, std::vector<uint8_t>& output, bool* keyframe = nullptr);
+
+        // 下一帧强制为关键帧
+        void ForceKeyframe() { m_forceKeyframe = true; }
+
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        Desc m_desc;
+        Stats m_stats;
+        bool m_forceKeyframe = true;
+        uint32_t m_sinceKeyframe = 0;
+
+        // 编码端自己保存的上一帧，只更新变化块，不整帧复制
+        lens::graphics::CpuImage m_previous;
+        FrameDiff m_diff;
+        FrameDiff::Result m_diffResult;
+
+        std::vector<uint32_t> m_tiles;
+        std::vector<std::vector<uint8_t>> m_tileData;
+    };
+
+    // 解码端保存当前帧，按顺序应用增量；遇到关键帧重新开始
+    class DeltaDecoder
+    {
+    public:
+        explicit DeltaDecoder(ThreadPool* pool = nullptr);
+
+        bool Decode(const uint8_t* data, size_t size);
+
+        // 最近一次成功解码的帧
+        const lens::graphics::CpuImage& GetImage() const { return m_image; }
+        bool HasImage() const { return m_valid; }
+
+        void Reset() { m_valid = false; }
+
+        static bool IsKeyframe(const uint8_t* data, size_t size);
+
+    private:
+        ThreadPool* m_pool;
+        lens::graphics::CpuImage m_image;
+        bool m_valid = false;
+        std::vector<size_t> m_offsets;
+    };
+}
@@ -0,0 +1,24 @@
+﻿#pragma once
+
+#include "capturer/Frame.h"
+#include "graphics/CpuImage.h"
+#include <cstdint>
+#include <vector>
+
+namespace lens::capturer
+{
+    // 逐块比较两帧，输出变化的区域：同一行相邻的块合并成一段，
+    // 上下相邻且左右对齐的段再合并。previous 为空或尺寸、格式不同时输出整帧。
+    // 一次性调用的便捷接口，反复比较时直接持有 FrameDiff 以复用缓冲区和位图
+    void CompareTiles(const lens::graphics::CpuImage* previous, const lens::graphics::CpuImage& current,
+        uint32_t tileSize, std::vector<DirtyRect>& rects);
+
+    // 把 rects 合入 accumulated，数量超过 maxRects 时退化为一个包围盒
+    void AccumulateDirtyRects(std::vector<DirtyRect>& accumulated, const std::vector<DirtyRect>& rects,
+        size_t maxRects = 64);
+
+    DirtyRect GetBoundingRect(const std::vector<DirtyRect>& rects);
+
+    // 裁剪到 width x height 内，丢弃空矩形
+    void ClipDirtyRects(std::vector<DirtyRect>& rects, uint32_t width, uint32_t height);
+}
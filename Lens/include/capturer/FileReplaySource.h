@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "capturer/CpuCaptureSource.h"
+#include "capturer/RawRecording.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace lens::capturer
+{
+    // 文件回放源：按帧率依次回放目录中的 BMP/QOI 序列（文件名排序）或一个 .lensraw 录制，
+    // 可用 Texture::SaveToFile 保存的截图作为输入，让管线以确定的内容运行
+    class FileReplaySource : public CpuCaptureSource
+    {
+    public:
+        struct ReplayDesc
+        {
+            std::filesystem::path path;     // 目录或单个 .bmp/.qoi/.lensraw 文件
+            bool loop = true;
+            bool preload = false;           // 预先全部读入内存，排除磁盘 IO 的影响
+        };
+
+        FileReplaySource(lens::graphics::GraphicsDevice* device, const ReplayDesc& replayDesc);
+        ~FileReplaySource() override;
+
+        const char* GetName() const override { return "FileReplay"; }
+
+        size_t GetFrameCount() const { return m_recording ? m_recording->GetFrameCount() : m_files.size(); }
+
+        // 读取 24/32 位未压缩 BMP，输出 BGRA8
+        static bool LoadBmp(const std::filesystem::path& file, lens::graphics::CpuImage& image);
+        static bool LoadQoi(const std::filesystem::path& file, lens::graphics::CpuImage& image);
+
+        // 按扩展名选择 LoadBmp 或 LoadQoi
+        static bool LoadFrame(const std::filesystem::path& file, lens::graphics::CpuImage& image);
+
+    protected:
+        bool OnInitialize() override;
+        std::shared_ptr<const lens::graphics::CpuImage> ProduceFrame(uint64_t frameIndex) override;
+
+    private:
+        ReplayDesc m_replayDesc;
+        std::vector<std::filesystem::path> m_files;
+        std::unique_ptr<RawRecordingReader> m_recording;
+        std::vector<std::shared_ptr<const lens::graphics::CpuImage>> m_preloaded;
+
+        // 录制中的第 index 帧，非 BGRA8 时转换
+        bool LoadRecordedFrame(size_t index, lens::graphics::CpuImage& image) const;
+    };
+}
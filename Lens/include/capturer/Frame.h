@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include "capturer/FrameFingerprint.h"
+#include "graphics/CpuImage.h"
+#include "graphics/Texture.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lens::capturer
+{
+    struct DirtyRect
+    {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // 帧的元数据，纹理本身不携带任何时间和来源信息
+    struct FrameDescriptor
+    {
+        uint32_t sourceId = 0;      // 由 CaptureManager 分配，单源时为 0
+        uint64_t sequence = 0;      // 源内递增的帧序号
+        int64_t captureTime = 0;    // 捕获时间，100ns，与 GetTimestamp 同一时基
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        // 脏区信息，相对于 sequence - 1 那一帧；dirtyKnown 为 false 时按整帧变化处理。
+        // 消费端跳过了帧（序号不连续）时不能只处理这些区域
+        bool dirtyKnown = false;
+        std::vector<DirtyRect> dirtyRects;
+
+        bool IsUnchanged() const { return dirtyKnown && dirtyRects.empty(); }
+
+        // 帧指纹，只有 CPU 帧且开启去重时计算，否则 valid 为 false
+        FrameFingerprint fingerprint;
+    };
+
+    // 捕获源交付的一帧。GPU 源填充 texture，CPU 源填充 image；
+    // 两者都是引用计数句柄，Frame 本身可以廉价地移动
+    struct Frame
+    {
+        FrameDescriptor descriptor;
+
+        std::shared_ptr<lens::graphics::Texture> texture;
+        std::shared_ptr<const lens::graphics::CpuImage> image;
+
+        explicit operator bool() const { return texture || image; }
+    };
+}
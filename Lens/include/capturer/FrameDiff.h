@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "capturer/Frame.h"
+#include "graphics/CpuImage.h"
+#include <cstdint>
+#include <vector>
+
+namespace lens
+{
+    class ThreadPool;
+}
+
+namespace lens::capturer
+{
+    // 两帧 CPU 图像的逐块差异检测。
+    // 每块按行做向量化比较，发现差异立即停止该块；一个块行（tileSize 行）内所有块都变化后跳过剩余行。
+    // 块行之间互不依赖，大帧在线程池上并行处理。同一实例不能被多个线程同时调用
+    class FrameDiff
+    {
+    public:
+        struct Result
+        {
+            uint32_t tileSize = 0;
+            uint32_t tilesX = 0;
+            uint32_t tilesY = 0;
+            uint32_t wordsPerRow = 0;           // 每个块行占用的 bitmap 字数
+            std::vector<uint64_t> bitmap;       // 每块 1 位，按块行对齐
+            uint32_t dirtyTiles = 0;
+            std::vector<DirtyRect> rects;       // 相邻变化块合并后的矩形
+
+            bool IsTileDirty(uint32_t tx, uint32_t ty) const
+            {
+                return (bitmap[static_cast<size_t>(ty) * wordsPerRow + tx / 64] >> (tx % 64)) & 1;
+            }
+            bool IsUnchanged() const { return dirtyTiles == 0; }
+        };
+
+        // tileSize 常用 16 或 64（像素）
+        explicit FrameDiff(uint32_t tileSize = 64);
+
+        uint32_t GetTileSize() const { return m_tileSize; }
+
+        // previous 为空或尺寸、格式不同时整帧标记为变化。pool 为空时使用共享线程池
+        bool Compare(const lens::graphics::CpuImage* previous, const lens::graphics::CpuImage& current,
+            Result& result, ThreadPool* pool = nullptr);
+
+        // 原始数据版本，stride 以字节为单位
+        bool Compare(const uint8_t* previous, uint32_t previousStride, const uint8_t* current, uint32_t currentStride,
+            uint32_t width, uint32_t height, uint32_t bytesPerPixel, Result& result, ThreadPool* pool = nullptr);
+
+        // 小于该像素数的帧不并行，默认约 1080p 的四分之一
+        void SetParallelThreshold(uint64_t pixels) { m_parallelThreshold = pixels; }
+
+    private:
+        void MarkAllDirty(uint32_t width, uint32_t height, Result& result) const;
+        static void PrepareResult(uint32_t width, uint32_t height, uint32_t tileSize, Result& result);
+        static void BuildRects(uint32_t width, uint32_t height, Result& result);
+
+        uint32_t m_tileSize;
+        uint64_t m_parallelThreshold = 512 * 1024;
+    };
+}
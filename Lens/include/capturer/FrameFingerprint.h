@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include "graphics/CpuImage.h"
+#include <atomic>
+#include <cstdint>
+
+namespace lens
+{
+    class ThreadPool;
+}
+
+namespace lens::capturer
+{
+    // 帧指纹：由 32x32 亮度网格得到的感知哈希，加上整帧像素的 64 位内容哈希。
+    // 感知哈希的汉明距离小说明画面看起来几乎一样；内容哈希相同说明像素完全相同
+    struct FrameFingerprint
+    {
+        bool valid = false;
+        uint64_t dHash = 0;         // 相邻网格亮度的大小关系
+        uint64_t pHash = 0;         // 网格 DCT 低频系数与中位数的大小关系
+        uint64_t contentHash = 0;
+    };
+
+    inline uint32_t HammingDistance(uint64_t a, uint64_t b)
+    {
+        uint64_t x = a ^ b;
+        uint32_t count = 0;
+        while (x)
+        {
+            x &= x - 1;
+            count++;
+        }
+        return count;
+    }
+
+    // 两个指纹的感知距离：dHash 和 pHash 距离的较大者，内容哈希相同时为 0
+    uint32_t GetFingerprintDistance(const FrameFingerprint& a, const FrameFingerprint& b);
+
+    // 只支持 BGRA8/RGBA8，其它格式返回 valid = false。
+    // 一次遍历整帧同时累加亮度网格和内容哈希，按网格行在线程池上并行；pool 为空时使用共享线程池
+    FrameFingerprint ComputeFingerprint(const lens::graphics::CpuImage& image, ThreadPool* pool = nullptr);
+
+    // 去重策略：与上一次放行的帧比较，距离不超过 maxDistance 的帧被丢弃。
+    // 与上一次放行的帧而不是上一帧比较，缓慢累积的变化最终仍会超过阈值而放行
+    class FrameDeduplicator
+    {
+    public:
+        struct Desc
+        {
+            bool enabled = false;
+            uint32_t maxDistance = 2;   // 0 表示只丢弃像素完全相同或感知哈希完全相同的帧
+        };
+
+        FrameDeduplicator() = default;
+        explicit FrameDeduplicator(const Desc& desc) : m_desc(desc) {}
+
+        void Configure(const Desc& desc) { m_desc = desc; Reset(); }
+        const Desc& GetDesc() const { return m_desc; }
+        void Reset();
+
+        // 返回 true 表示该帧应被丢弃；无效指纹总是放行
+        bool ShouldDrop(const FrameFingerprint& fingerprint, uint64_t frameBytes);
+
+        uint64_t GetCheckedCount() const { return m_checked.load(std::memory_order_relaxed); }
+        uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+        uint64_t GetDroppedBytes() const { return m_droppedBytes.load(std::memory_order_relaxed); }
+
+    private:
+        Desc m_desc{};
+        FrameFingerprint m_reference;
+        std::atomic<uint64_t> m_checked{ 0 };
+        std::atomic<uint64_t> m_dropped{ 0 };
+        std::atomic<uint64_t> m_droppedBytes{ 0 };
+    };
+}
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include "capturer/LatencyHistogram.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace lens::capturer
+{
+    // 当前时间，100ns。MSVC 的 steady_clock 基于 QPC，
+    // 与 WGC 帧的 SystemRelativeTime 是同一时基，可以直接相减
+    inline int64_t GetTimestamp()
+    {
+        using Ticks = std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>;
+        return std::chrono::duration_cast<Ticks>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 帧从捕获到各阶段的延迟统计
+    class FrameLatency
+    {
+    public:
+        enum class Stage
+        {
+            Arrival,    // 源收到帧
+            CopyDone,   // 复制/上传到自有纹理（只计 CPU 提交时刻）
+            Pickup,     // 消费端取走
+            Present,    // CapturePanel 显示
+            Count
+        };
+
+        static const char* GetStageName(Stage stage);
+
+        void Record(Stage stage, int64_t captureTime, int64_t now = GetTimestamp())
+        {
+            m_histograms[static_cast<size_t>(stage)].Record(now - captureTime);
+        }
+
+        const LatencyHistogram& Get(Stage stage) const { return m_histograms[static_cast<size_t>(stage)]; }
+        void Reset();
+
+        // 把每个阶段的 p50/p99/p99.9 写到日志
+        void LogSummary(const char* sourceName) const;
+
+        static double TicksToMs(uint64_t ticks) { return static_cast<double>(ticks) / 10'000.0; }
+
+    private:
+        std::array<LatencyHistogram, static_cast<size_t>(Stage::Count)> m_histograms;
+    };
+}
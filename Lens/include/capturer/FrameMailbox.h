@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace lens::capturer
+{
+    // 单生产者/单消费者的三缓冲邮箱，"最新的帧胜出"：
+    // 生产者和消费者各持有一个槽位，中间槽位通过一次原子交换传递，
+    // Publish 和 TryTake 都是 wait-free 的；未被取走就被覆盖的帧计为丢帧。
+    // 只有 WaitTake 会在没有新帧时阻塞等待
+    template<typename T>
+    class FrameMailbox
+    {
+    public:
+        FrameMailbox() = default;
+        FrameMailbox(const FrameMailbox&) = delete;
+        FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+        // 生产者线程调用
+        void Publish(T value)
+        {
+            m_slots[m_back] = std::move(value);
+            uint32_t prev = m_middle.exchange(m_back | kNewBit);
+            m_back = prev & kIndexMask;
+
+            m_published.fetch_add(1, std::memory_order_relaxed);
+            if (prev & kNewBit)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // 只有存在等待者时才进锁通知
+            if (m_waiters.load() > 0)
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                m_waitCondition.notify_all();
+            }
+        }
+
+        // 消费者线程调用，没有新帧时返回 false 且不修改 out
+        bool TryTake(T& out)
+        {
+            if (!HasNew())
+                return false;
+
+            uint32_t prev = m_middle.exchange(m_front);
+            m_front = prev & kIndexMask;
+            out = std::move(m_slots[m_front]);
+            m_slots[m_front] = T{};
+            return true;
+        }
+
+        // 消费者线程调用，最多等待 timeout，超时返回 false
+        template<typename Rep, typename Period>
+        bool WaitTake(T& out, std::chrono::duration<Rep, Period> timeout)
+        {
+            if (TryTake(out))
+                return true;
+
+            {
+                std::unique_lock<std::mutex> lock(m_waitMutex);
+                m_waiters.fetch_add(1);
+                m_waitCondition.wait_for(lock, timeout, [this] { return HasNew(); });
+                m_waiters.fetch_sub(1);
+            }
+
+            return TryTake(out);
+        }
+
+        bool HasNew() const { return (m_middle.load() & kNewBit) != 0; }
+
+        // 只能在生产者停止后调用，同时清零统计
+        void Reset()
+        {
+            for (auto& slot : m_slots)
+            {
+                slot = T{};
+            }
+            m_back = 0;
+            m_front = 1;
+            m_middle.store(2);
+            m_published.store(0, std::memory_order_relaxed);
+            m_dropped.store(0, std::memory_order_relaxed);
+        }
+
+        // 统计
+        uint64_t GetPublishedCount() const { return m_published.load(std::memory_order_relaxed); }
+        uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr uint32_t kIndexMask = 0x3;
+        static constexpr uint32_t kNewBit = 0x4;
+
+        T m_slots[3]{};
+        uint32_t m_back = 0;                    // 生产者独占
+        uint32_t m_front = 1;                   // 消费者独占
+        std::atomic<uint32_t> m_middle{ 2 };    // 中间槽位索引 | 新帧标记
+
+        std::atomic<uint64_t> m_published{ 0 };
+        std::atomic<uint64_t> m_dropped{ 0 };
+
+        std::atomic<uint32_t> m_waiters{ 0 };
+        std::mutex m_waitMutex;
+        std::condition_variable m_waitCondition;
+    };
+}
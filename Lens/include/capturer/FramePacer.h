@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace lens::capturer
+{
+    // 帧节流：在复制和分配之前决定一帧是否需要继续处理。
+    // 时间戳单位为 100ns（与 WGC 的 SystemRelativeTime 一致），只要求单调递增
+    class FramePacer
+    {
+    public:
+        enum class Policy
+        {
+            Unlimited,      // 全部转发
+            FixedRate,      // 按固定节拍转发，节拍不随到达时间漂移
+            MaxRate,        // 相邻两次转发的间隔不小于 1/fps
+            OnChangeOnly    // 只转发内容有变化的帧，同时受 MaxRate 限制
+        };
+
+        struct Desc
+        {
+            Policy policy = Policy::FixedRate;
+            uint32_t frameRate = 30;
+            // 抖动容差（仅 FixedRate）：帧提前到达不超过此比例的间隔时仍然转发，避免 60→30 时掉成 20
+            float jitterTolerance = 0.25f;
+        };
+
+        static constexpr int64_t kTicksPerSecond = 10'000'000;
+
+        FramePacer() = default;
+        explicit FramePacer(const Desc& desc) { Configure(desc); }
+
+        void Configure(const Desc& desc);
+        void Reset();
+
+        // 每个到达的帧调用一次，返回 true 表示需要转发
+        bool ShouldForward(int64_t timestamp, bool contentChanged = true);
+
+        // 统计
+        uint64_t GetDeliveredCount() const { return m_delivered.load(std::memory_order_relaxed); }
+        uint64_t GetForwardedCount() const { return m_forwarded.load(std::memory_order_relaxed); }
+        uint64_t GetDecimatedCount() const { return GetDeliveredCount() - GetForwardedCount(); }
+
+    private:
+        Desc m_desc{};
+        int64_t m_interval = 0;
+        int64_t m_tolerance = 0;
+        int64_t m_nextDeadline = 0;
+        int64_t m_lastForwarded = 0;
+        bool m_hasForwarded = false;
+
+        std::atomic<uint64_t> m_delivered{ 0 };
+        std::atomic<uint64_t> m_forwarded{ 0 };
+    };
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include "capturer/Frame.h"
+#include "capturer/FrameLatency.h"
+#include "capturer/FramePacer.h"
+#include "graphics/GraphicsDevice.h"
+#include "graphics/Texture.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace lens::capturer
+{
+    // 帧来源的抽象接口，WGC、合成源、文件回放源都实现它
+    class ICaptureSource
+    {
+    public:
+        struct CaptureDesc
+        {
+            uint32_t frameRate = 30;
+            FramePacer::Policy pacing = FramePacer::Policy::FixedRate;
+            lens::graphics::TextureFormat format = lens::graphics::TextureFormat::BGRA8_UNorm;
+            bool captureCursor = true;
+            bool captureBorder = true;
+            // 在独立的捕获线程上取帧和复制，不经过 UI 消息循环（仅 WGC 使用）
+            bool freeThreaded = false;
+            // 按帧指纹丢弃与上一次转发的帧几乎相同的帧（仅 CPU 源使用）
+            bool dedup = false;
+            uint32_t dedupMaxDistance = 2;
+        };
+
+        struct FrameStats
+        {
+            uint64_t delivered = 0;     // 源交付的帧
+            uint64_t forwarded = 0;     // 通过节流、进入管线的帧
+            uint64_t dropped = 0;       // 进入管线后被更新的帧覆盖、没有被取走的帧
+            uint64_t unchanged = 0;     // 内容没有变化、跳过了复制的帧
+            uint64_t deduplicated = 0;  // 与上一次转发的帧几乎相同、被去重丢弃的帧
+            uint64_t dedupBytes = 0;    // 去重省下的像素字节数
+        };
+
+        virtual ~ICaptureSource() = default;
+
+        virtual const char* GetName() const = 0;
+
+        // 初始化和清理
+        virtual bool Initialize(const CaptureDesc& desc) = 0;
+        virtual void Shutdown() = 0;
+
+        // 捕获控制
+        virtual bool StartCapture() = 0;
+        virtual void StopCapture() = 0;
+        virtual bool IsCapturing() const = 0;
+
+        // 帧获取：同一个源只能有一个消费者。
+        // GetLatestFrame 只在渲染线程调用，返回的帧保证带 texture（CPU 源会在这里上传到 GPU）；
+        // AcquireFrame 不访问设备上下文，可在任意线程阻塞等待，超时返回 false
+        virtual Frame GetLatestFrame() = 0;
+        virtual bool AcquireFrame(Frame& frame, std::chrono::milliseconds timeout) = 0;
+        virtual bool HasNewFrame() const = 0;
+
+        // 统计
+        virtual FrameStats GetFrameStats() const { return {}; }
+        FrameLatency& GetLatency() { return m_latency; }
+        const FrameLatency& GetLatency() const { return m_latency; }
+
+        // 每发布一帧在生产线程上调用一次，供消费端唤醒等待中的循环。
+        // 须在 StartCapture 之前设置，回调应立即返回（例如只触发一个事件）
+        void SetFrameListener(std::function<void()> listener) { m_frameListener = std::move(listener); }
+
+    protected:
+        void NotifyFrameListener()
+        {
+            if (m_frameListener)
+                m_frameListener();
+        }
+
+        FrameLatency m_latency;
+        std::function<void()> m_frameListener;
+    };
+}
@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace lens::capturer
+{
+    // 对数分桶的延迟直方图：每个 2 的幂区间再分 8 个子桶，相对误差约 12.5%。
+    // Record 只做几次原子加，可在任意线程并发调用。单位与调用方一致（这里用 100ns）
+    class LatencyHistogram
+    {
+    public:
+        static constexpr uint32_t kSubBucketBits = 3;
+        static constexpr uint32_t kSubBucketCount = 1u << kSubBucketBits;
+        static constexpr uint32_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+        LatencyHistogram() { Reset(); }
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        void Record(int64_t value)
+        {
+            uint64_t v = value > 0 ? static_cast<uint64_t>(value) : 0;
+            m_buckets[BucketIndex(v)].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(v, std::memory_order_relaxed);
+
+            uint64_t prevMax = m_max.load(std::memory_order_relaxed);
+            while (v > prevMax && !m_max.compare_exchange_weak(prevMax, v, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void Reset()
+        {
+            for (auto& bucket : m_buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            m_count.store(0, std::memory_order_relaxed);
+            m_sum.store(0, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+        }
+
+        uint64_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+        uint64_t GetMax() const { return m_max.load(std::memory_order_relaxed); }
+
+        double GetMean() const
+        {
+            uint64_t count = GetCount();
+            return count ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / count : 0.0;
+        }
+
+        // percentile 取 [0, 1]，返回所在桶的上界
+        uint64_t GetPercentile(double percentile) const
+        {
+            uint64_t count = GetCount();
+            if (count == 0)
+                return 0;
+
+            uint64_t target = static_cast<uint64_t>(percentile * static_cast<double>(count) + 0.5);
+            target = target < 1 ? 1 : (target > count ? count : target);
+
+            uint64_t accumulated = 0;
+            for (uint32_t i = 0; i < kBucketCount; ++i)
+            {
+                accumulated += m_buckets[i].load(std::memory_order_relaxed);
+                if (accumulated >= target)
+                {
+                    uint64_t upper = BucketUpperBound(i);
+                    uint64_t max = GetMax();
+                    return upper < max ? upper : max;
+                }
+            }
+            return GetMax();
+        }
+
+        static uint32_t BucketIndex(uint64_t value)
+        {
+            if (value < kSubBucketCount)
+                return static_cast<uint32_t>(value);
+
+            uint32_t exponent = 63 - static_cast<uint32_t>(std::countl_zero(value));
+            uint32_t sub = static_cast<uint32_t>(value >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1);
+            return (exponent - kSubBucketBits + 1) * kSubBucketCount + sub;
+        }
+
+        static uint64_t BucketUpperBound(uint32_t index)
+        {
+            if (index < kSubBucketCount)
+                return index;
+
+            uint32_t exponent = index / kSubBucketCount + kSubBucketBits - 1;
+            uint64_t sub = index % kSubBucketCount;
+            uint32_t shift = exponent - kSubBucketBits;
+            uint64_t lower = (kSubBucketCount + sub) << shift;
+            return lower + ((uint64_t(1) << shift) - 1);
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, kBucketCount> m_buckets;
+        std::atomic<uint64_t> m_count{ 0 };
+        std::atomic<uint64_t> m_sum{ 0 };
+        std::atomic<uint64_t> m_max{ 0 };
+    };
+}
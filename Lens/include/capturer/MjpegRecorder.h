@@ -0,0 +1,123 @@
+﻿#pragma once
+
+#include "graphics/CpuImage.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lens
+{
+    class ThreadPool;
+}
+
+namespace lens::capturer
+{
+    // 有损录制：每帧编码成 JPEG，封装为 AVI（OpenDML），常见播放器可以直接打开。
+    // 帧按捕获时间对齐到固定帧率，来得太密的帧跳过，中间缺的帧写空数据块让播放器重复上一帧。
+    //
+    //   RIFF 'AVI ' [hdrl][movi: 00dc ... ix00][idx1]     第一段同时带旧式 idx1 索引
+    //   RIFF 'AVIX' [movi: 00dc ... ix00]                 之后每段约 1 GB，由 hdrl 里的 indx 超级索引引用
+    //
+    // 编码和写盘在后台线程，单帧 JPEG 按重启间隔在线程池上并行
+    class MjpegRecorder
+    {
+    public:
+        struct Desc
+        {
+            std::filesystem::path path;
+            uint32_t frameRate = 30;
+            uint32_t quality = 85;          // JPEG 质量 1~100
+            uint32_t queueCapacity = 4;     // 等待编码的帧数，满了丢弃新帧
+            ThreadPool* pool = nullptr;     // 为空时使用共享线程池
+        };
+
+        struct Stats
+        {
+            uint64_t submitted = 0;
+            uint64_t encoded = 0;
+            uint64_t repeated = 0;          // 补齐时间轴写入的空帧
+            uint64_t skipped = 0;           // 超过帧率被跳过的帧
+            uint64_t dropped = 0;           // 队列已满或尺寸变化被丢弃的帧
+            uint64_t bytesWritten = 0;
+            double encodeMs = 0.0;          // 累计编码耗时
+        };
+
+        MjpegRecorder();
+        ~MjpegRecorder();
+
+        MjpegRecorder(const MjpegRecorder&) = delete;
+        MjpegRecorder& operator=(const MjpegRecorder&) = delete;
+
+        // 视频尺寸取第一帧，之后尺寸不同的帧被丢弃
+        bool Open(const Desc& desc);
+
+        // captureTime 为 100ns 单位的捕获时间。持有图像直到编码完成，不复制像素
+        bool Submit(std::shared_ptr<const lens::graphics::CpuImage> image, int64_t captureTime);
+
+        // 编码完队列中的帧，写出索引并关闭文件，析构时自动调用
+        bool Close();
+
+        bool IsOpen() const { return m_file.is_open(); }
+        Stats GetStats() const;
+
+    private:
+        struct Job
+        {
+            std::shared_ptr<const lens::graphics::CpuImage> image;
+            int64_t captureTime = 0;
+        };
+
+        struct ChunkEntry
+        {
+            uint64_t offset;    // 数据块头在文件中的位置
+            uint32_t size;      // 数据字节数，不含块头和填充
+        };
+
+        struct SuperIndexEntry
+        {
+            uint64_t offset;    // ix00 块的位置
+            uint32_t size;      // ix00 块总长
+            uint32_t duration;  // 该段的帧数
+        };
+
+        void EncoderLoop();
+        bool WriteFrame(const uint8_t* data, uint32_t size);
+        void BeginSegment();
+        void FinishSegment();
+        std::vector<uint8_t> BuildHeader(uint32_t riffSize) const;
+
+        Desc m_desc;
+        std::ofstream m_file;
+
+        // 只在后台线程访问，Close 时线程已退出
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        int64_t m_firstTime = 0;
+        int64_t m_nextSlot = 0;     // 下一帧在固定帧率时间轴上的位置
+        uint64_t m_riffStart = 0;
+        uint64_t m_moviStart = 0;
+        uint64_t m_position = 0;
+        uint32_t m_frameCount = 0;
+        uint32_t m_firstSegmentFrames = 0;
+        uint32_t m_firstRiffSize = 0;
+        uint32_t m_maxChunkSize = 0;
+        std::vector<ChunkEntry> m_segment;
+        std::vector<SuperIndexEntry> m_superIndex;
+        std::vector<uint8_t> m_encoded;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<Job> m_queue;
+        bool m_stopping = false;
+        bool m_failed = false;
+        std::thread m_thread;
+
+        Stats m_stats;
+    };
+}
@@ -0,0 +1,266 @@
+﻿#pragma once
+
+#include "capturer/DeltaCodec.h"
+#include "capturer/Frame.h"
+#include "graphics/CpuImage.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lens::capturer
+{
+    // .lensraw 录制文件：未压缩帧按追加顺序存放，文件尾部是帧索引。
+    //
+    //   [文件头，4 KB]
+    //   [帧记录 0][帧记录 1]...     每条记录：RawFrameHeader + 脏区，补齐到 4 KB 后接像素，像素再补齐到 4 KB
+    //                               开启增量压缩时像素换成 DeltaCodec 编码的数据
+    //   [索引：RawIndexEntry x N][填充][RawTrailer]   尾部结构位于文件最后 64 字节
+    //
+    // 所有记录和像素都从 4 KB 边界开始，写入可以绕过系统缓存，读取时映射后直接按页访问。
+    // 录制中断没有写出索引时，读取端顺序扫描记录头重建索引
+    namespace rawformat
+    {
+        constexpr uint32_t kAlignment = 4096;
+        constexpr uint32_t kVersion = 1;
+        constexpr char kFileMagic[8] = { 'L', 'E', 'N', 'S', 'R', 'A', 'W', '\0' };
+        constexpr char kTrailerMagic[8] = { 'L', 'R', 'A', 'W', 'E', 'N', 'D', '\0' };
+        constexpr uint32_t kFrameMagic = 0x5246524C;   // "LRFR"
+
+        // RawFrameHeader::flags
+        constexpr uint32_t kFrameDirtyKnown = 1u << 0;
+        constexpr uint32_t kFrameDelta = 1u << 1;       // 数据是 DeltaCodec 编码
+        constexpr uint32_t kFrameKeyframe = 1u << 2;    // 可以独立解码
+
+        struct FileHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t alignment;
+            int64_t createdTime;    // 录制开始的系统时间，Unix 毫秒
+            uint8_t reserved[40];
+        };
+
+        struct RawFrameHeader
+        {
+            uint32_t magic;
+            uint32_t headerSize;    // 记录头、脏区和填充，像素从记录起点 + headerSize 开始
+            uint64_t sequence;
+            int64_t captureTime;
+            uint32_t sourceId;
+            uint32_t width;
+            uint32_t height;
+            uint32_t format;        // TextureFormat
+            uint32_t rowPitch;      // 解码后的行字节数
+            uint32_t flags;
+            uint32_t dirtyCount;    // 紧跟记录头的 DirtyRect 个数
+            uint32_t reserved;
+            uint64_t pixelBytes;    // 像素或编码数据的字节数
+        };
+
+        struct RawIndexEntry
+        {
+            uint64_t offset;        // 帧记录在文件中的位置
+            uint64_t size;          // 记录总长度，含填充
+            uint64_t sequence;
+            int64_t captureTime;
+        };
+
+        struct RawTrailer
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t reserved0;
+            uint64_t frameCount;
+            uint64_t indexOffset;
+            int64_t firstTime;
+            int64_t lastTime;
+            uint8_t reserved[16];
+        };
+
+        static_assert(sizeof(FileHeader) == 64);
+        static_assert(sizeof(RawFrameHeader) == 64);
+        static_assert(sizeof(RawIndexEntry) == 32);
+        static_assert(sizeof(RawTrailer) == 64);
+        static_assert(sizeof(DirtyRect) == 16);
+    }
+
+    // 录制写入端：帧先复制进对齐的大块缓冲，写满一块交给后台线程顺序写出，
+    // Append 只在所有缓冲都在写盘时才等待。只允许一个线程调用
+    class RawRecordingWriter
+    {
+    public:
+        struct Desc
+        {
+            std::filesystem::path path;
+            uint32_t chunkSize = 4u << 20;  // 每次写入的字节数，按 4 KB 取整
+            uint32_t bufferCount = 3;       // 一块在填充，其余在排队写盘
+            bool unbuffered = true;         // 绕过系统文件缓存，长时间录制不挤占内存
+            uint32_t queueCapacity = 4;     // 等待编码的帧数，满了丢弃新帧
+
+            // 增量压缩：关键帧加变化块，桌面内容通常只有原始数据量的几十分之一
+            bool deltaCompression = false;
+            DeltaEncoder::Desc delta;
+        };
+
+        struct Stats
+        {
+            uint64_t frames = 0;
+            uint64_t keyframes = 0;
+            uint64_t dropped = 0;           // 编码队列已满被丢弃的帧
+            uint64_t inputBytes = 0;        // 未压缩的像素字节数
+            uint64_t bytesWritten = 0;
+            uint64_t writes = 0;
+            uint32_t stalls = 0;            // 填充线程等待空闲缓冲的次数
+            double writeMs = 0.0;           // 后台线程写盘的总耗时
+            double encodeMs = 0.0;          // 编码线程压缩和填充缓冲的总耗时
+        };
+
+        RawRecordingWriter();
+        ~RawRecordingWriter();
+
+        RawRecordingWriter(const RawRecordingWriter&) = delete;
+        RawRecordingWriter& operator=(const RawRecordingWriter&) = delete;
+
+        bool Open(const Desc& desc);
+
+        // 图像尺寸和格式可以逐帧变化。只把图像放入队列，压缩和写盘在编码线程，持有图像直到写入缓冲
+        bool Append(std::shared_ptr<const lens::graphics::CpuImage> image, const FrameDescriptor& descriptor);
+
+        // 在调用线程同步追加已经由 DeltaEncoder 编码好的一帧，尺寸和格式取自编码数据的帧头。
+        // 不能和 Append 用在同一次录制里
+        bool AppendEncoded(const uint8_t* data, size_t size, const FrameDescriptor& descriptor);
+
+        // 写完队列中的帧，写出索引和尾部并关闭文件，析构时自动调用
+        bool Close();
+
+        bool IsOpen() const { return m_file != INVALID_HANDLE_VALUE; }
+        Stats GetStats() const;
+
+    private:
+        struct Chunk
+        {
+            uint8_t* data = nullptr;
+            size_t size = 0;
+        };
+
+        struct AlignedDeleter
+        {
+            void operator()(uint8_t* data) const;
+        };
+
+        struct Job
+        {
+            std::shared_ptr<const lens::graphics::CpuImage> image;
+            FrameDescriptor descriptor;
+        };
+
+        bool WriteFrame(const lens::graphics::CpuImage& image, const FrameDescriptor& descriptor);
+        void PutRecordHeader(const FrameDescriptor& descriptor, uint32_t width, uint32_t height,
+            lens::graphics::TextureFormat format, uint32_t rowPitch, uint32_t flags, uint64_t pixelBytes);
+        void Put(const void* data, size_t size);
+        void PutZeros(size_t size);
+        void SubmitChunk(bool acquireNext);
+        void WriterLoop();
+        void EncoderLoop();
+
+        Desc m_desc;
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        uint64_t m_offset = 0;      // 已经放入缓冲的文件长度
+
+        std::vector<rawformat::RawIndexEntry> m_index;
+
+        std::unique_ptr<DeltaEncoder> m_encoder;
+        std::vector<uint8_t> m_encoded;
+
+        // 对齐缓冲：m_current 在编码线程（或 AppendEncoded 的调用线程）填充，m_pending 由写盘线程写出后放回 m_free
+        std::vector<std::unique_ptr<uint8_t, AlignedDeleter>> m_buffers;
+        Chunk m_current;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_chunkReady;
+        std::condition_variable m_chunkFree;
+        std::deque<Chunk> m_pending;
+        std::vector<uint8_t*> m_free;
+        bool m_stopping = false;
+        bool m_failed = false;
+        std::thread m_thread;
+
+        // 等待编码的帧，Close 先让编码线程写完再停写盘线程
+        std::condition_variable m_jobReady;
+        std::deque<Job> m_jobs;
+        bool m_draining = false;
+        std::thread m_encoderThread;
+
+        Stats m_stats;
+    };
+
+    // 录制读取端：整个文件只读映射，按索引 O(1) 定位任意帧，像素直接指向映射内存。
+    // 32 位进程映射不下整个文件时改为按帧映射
+    class RawRecordingReader
+    {
+    public:
+        struct FrameView
+        {
+            FrameDescriptor descriptor;
+            lens::graphics::TextureFormat format = lens::graphics::TextureFormat::BGRA8_UNorm;
+            uint32_t rowPitch = 0;
+            const uint8_t* pixels = nullptr;
+
+            // 增量压缩的帧 pixels 指向编码数据，需要经 ReadFrame 解码
+            bool delta = false;
+            bool keyframe = false;
+            uint64_t dataSize = 0;
+
+            // 持有映射，读取端关闭后像素指针仍然有效
+            std::shared_ptr<const void> mapping;
+        };
+
+        RawRecordingReader();
+        ~RawRecordingReader();
+
+        RawRecordingReader(const RawRecordingReader&) = delete;
+        RawRecordingReader& operator=(const RawRecordingReader&) = delete;
+
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        bool IsOpen() const { return m_file != INVALID_HANDLE_VALUE; }
+        size_t GetFrameCount() const { return m_index.size(); }
+        const std::vector<rawformat::RawIndexEntry>& GetIndex() const { return m_index; }
+
+        // 索引是扫描记录重建的（录制没有正常结束）
+        bool IsRecovered() const { return m_recovered; }
+
+        bool GetFrame(size_t index, FrameView& view) const;
+
+        // 复制到 CpuImage，供需要独立所有权的消费端使用。
+        // 增量帧从最近的关键帧解码，顺序读取时每帧只应用一次增量；非线程安全
+        bool ReadFrame(size_t index, lens::graphics::CpuImage& image, FrameDescriptor* descriptor = nullptr) const;
+
+        // captureTime 不大于 time 的最后一帧，time 早于第一帧时返回 0
+        size_t FindFrame(int64_t time) const;
+
+    private:
+        std::shared_ptr<const uint8_t> MapRange(uint64_t offset, uint64_t size) const;
+        bool LoadIndex();
+        bool RebuildIndex();
+        bool IsKeyframe(size_t index) const;
+        bool DecodeFrame(size_t index) const;
+
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+        uint64_t m_fileSize = 0;
+        std::shared_ptr<const uint8_t> m_view;     // 整个文件的映射，映射失败时为空
+        uint32_t m_granularity = 65536;
+        std::vector<rawformat::RawIndexEntry> m_index;
+        bool m_recovered = false;
+
+        // 增量帧的解码状态，m_decodedIndex 为解码器当前持有的帧
+        mutable DeltaDecoder m_decoder;
+        mutable size_t m_decodedIndex = SIZE_MAX;
+    };
+}
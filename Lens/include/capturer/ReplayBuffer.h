@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include "capturer/DeltaCodec.h"
+#include "capturer/Frame.h"
+#include "graphics/CpuImage.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lens::capturer
+{
+    // 即时回放：最近一段时间的帧经 DeltaCodec 压缩后放在固定大小的环形内存区里，
+    // 放不下或超过时长时整组淘汰最旧的关键帧组（关键帧 + 其后的增量帧），内存占用不随录制时长增长。
+    // 压缩在后台编码线程，需要时在另一个后台线程把当前内容保存为 .lensraw，保存期间继续缓存新帧
+    class ReplayBuffer
+    {
+    public:
+        struct Desc
+        {
+            uint64_t arenaBytes = 256ull << 20;
+            uint32_t maxSeconds = 60;           // 0 表示只受内存限制
+            uint32_t queueCapacity = 4;         // 等待压缩的帧数，满了丢弃新帧
+
+            // 关键帧间隔决定淘汰的粒度，默认 60 fps 下每秒一组
+            DeltaEncoder::Desc delta = { 64, 60, nullptr };
+        };
+
+        struct Stats
+        {
+            uint64_t appended = 0;
+            uint64_t evicted = 0;               // 被淘汰的帧
+            uint64_t dropped = 0;               // 队列已满或单组放不下而丢弃的帧
+            uint64_t saves = 0;
+            uint32_t frames = 0;                // 当前缓存的帧数
+            uint32_t groups = 0;                // 当前缓存的关键帧组数
+            uint64_t usedBytes = 0;
+            uint64_t arenaBytes = 0;
+            double seconds = 0.0;               // 缓存覆盖的时长
+            bool saving = false;
+        };
+
+        using SaveCallback = std::function<void(bool success, const std::filesystem::path& path)>;
+
+        ReplayBuffer();
+        explicit ReplayBuffer(const Desc& desc);
+        ~ReplayBuffer();
+
+        ReplayBuffer(const ReplayBuffer&) = delete;
+        ReplayBuffer& operator=(const ReplayBuffer&) = delete;
+
+        // 只把图像放入压缩队列，持有图像直到压缩完成，不复制像素。队列已满时丢弃并返回 false
+        bool Append(std::shared_ptr<const lens::graphics::CpuImage> image, const FrameDescriptor& descriptor);
+
+        // 清空缓存和尚未压缩的帧，之后的第一帧重新作为关键帧
+        void Clear();
+
+        // 把调用时缓存的内容写入文件。已有保存在进行时返回 false；回调在后台线程上执行
+        bool SaveAsync(const std::filesystem::path& path, SaveCallback callback = {});
+
+        Stats GetStats() const;
+
+    private:
+        struct Job
+        {
+            std::shared_ptr<const lens::graphics::CpuImage> image;
+            FrameDescriptor descriptor;
+        };
+
+        struct Entry
+        {
+            uint64_t id;            // 连续递增，id - 队首 id 即为队列下标
+            size_t offset;          // 在环形区中的位置
+            uint32_t size;
+            bool keyframe;
+            uint32_t sourceId;
+            uint64_t sequence;
+            int64_t captureTime;
+        };
+
+        void EncoderLoop();
+        void Store(bool keyframe, const FrameDescriptor& descriptor);
+        bool Reserve(uint32_t size, size_t& offset) const;
+        size_t FindNextGroup() const;
+        void EvictGroup();
+        void SaveLoop(std::filesystem::path path, uint64_t firstId, uint64_t lastId, SaveCallback callback);
+
+        Desc m_desc;
+        std::unique_ptr<uint8_t[]> m_arena;
+
+        // 只在编码线程访问
+        DeltaEncoder m_encoder;
+        std::vector<uint8_t> m_encoded;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_jobReady;
+        std::deque<Job> m_jobs;
+        bool m_forceKeyframe = false;   // Clear 之后由编码线程执行
+        bool m_stopping = false;
+        std::thread m_encoderThread;
+
+        std::deque<Entry> m_entries;
+        size_t m_tail = 0;          // 下一条记录的写入位置
+        uint64_t m_nextId = 0;
+        uint64_t m_usedBytes = 0;
+        uint32_t m_groups = 0;
+        bool m_saving = false;
+        std::thread m_saveThread;
+
+        Stats m_stats;
+    };
+}
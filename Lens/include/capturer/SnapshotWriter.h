@@ -0,0 +1,138 @@
+﻿#pragma once
+
+#include "capturer/Frame.h"
+#include "graphics/ImageEncoder.h"
+#include "graphics/ReadbackRing.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lens::capturer
+{
+    // 后台截图保存：调用方只把帧句柄放进有界队列，编码和写文件在工作线程上完成。
+    // GPU 帧先经自带的回读环异步复制到内存，渲染线程不会等待 GPU、编码或磁盘
+    class SnapshotWriter
+    {
+    public:
+        // 队列满时的处理方式
+        enum class DropPolicy
+        {
+            DropNewest,     // 拒绝新的截图
+            DropOldest,     // 丢弃队列中最早的截图，为新的让位
+            Block           // 等待空位，最多 blockTimeout；不要在渲染线程上使用
+        };
+
+        enum class Status
+        {
+            Saved,
+            Dropped,        // 因队列或回读槽位已满被丢弃
+            Failed          // 回读、编码或写文件失败
+        };
+
+        struct Result
+        {
+            Status status = Status::Failed;
+            std::filesystem::path path;
+            uint64_t bytes = 0;         // 写入文件的字节数
+            double queueMs = 0.0;       // 提交到开始编码的时间，含 GPU 回读
+            double encodeMs = 0.0;
+            double writeMs = 0.0;
+        };
+
+        // 回调在工作线程上执行（被丢弃时在提交线程上执行），先于 future 就绪
+        using Callback = std::function<void(const Result& result)>;
+
+        struct Desc
+        {
+            uint32_t queueCapacity = 8;     // 排队等待编码的截图上限，4K 帧每张约 32 MB
+            uint32_t workerCount = 2;
+            DropPolicy dropPolicy = DropPolicy::DropNewest;
+            std::chrono::milliseconds blockTimeout{ 100 };
+            uint32_t readbackSlots = 4;     // 同时在途的 GPU 回读数
+            lens::graphics::ImageEncodeOptions encode;  // codec 为 Auto 时按文件扩展名选择
+        };
+
+        struct Stats
+        {
+            uint64_t submitted = 0;
+            uint64_t saved = 0;
+            uint64_t dropped = 0;
+            uint64_t failed = 0;
+            uint64_t bytesWritten = 0;
+            uint32_t queued = 0;            // 当前排队数
+            uint32_t maxQueued = 0;
+            uint32_t inFlight = 0;          // 排队、回读中和正在编码的总数
+            double avgEncodeMs = 0.0;
+            double avgWriteMs = 0.0;
+        };
+
+        SnapshotWriter();
+        // readbackDevice 为空时只接受带 CPU 图像的帧
+        explicit SnapshotWriter(const Desc& desc, std::unique_ptr<lens::graphics::IReadbackDevice> readbackDevice = nullptr);
+        ~SnapshotWriter();
+
+        SnapshotWriter(const SnapshotWriter&) = delete;
+        SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+        // CPU 图像直接入队，可在任意线程调用；图像通过引用计数共享，不复制像素
+        std::future<Result> Submit(std::shared_ptr<const lens::graphics::CpuImage> image,
+            std::filesystem::path path, Callback callback = {});
+
+        // 帧带 CPU 图像时同上；只有纹理时提交回读，必须在渲染线程调用，回读完成后在 Poll 里入队
+        std::future<Result> Submit(const Frame& frame, std::filesystem::path path, Callback callback = {});
+
+        // 渲染线程每帧调用，交付已完成的回读
+        void Poll();
+
+        // 等待回读和队列中的截图全部处理完，需在渲染线程调用
+        void Flush();
+
+        Stats GetStats() const;
+
+        // directory/lens_YYYYMMDD_HHMMSS_NNN<extension>，同一进程内序号递增保证不重名
+        static std::filesystem::path MakeSnapshotPath(const std::filesystem::path& directory, const char* extension = ".png");
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Job
+        {
+            std::shared_ptr<const lens::graphics::CpuImage> image;
+            std::filesystem::path path;
+            Callback callback;
+            std::promise<Result> promise;
+            Clock::time_point submitTime;
+            bool delivered = false;     // 回读已交付或已按丢弃处理
+        };
+
+        void Enqueue(Job job);
+        void Complete(Job& job, Result result);
+        void WorkerLoop();
+
+        Desc m_desc;
+        std::unique_ptr<lens::graphics::ReadbackRing> m_readback;
+        std::atomic<uint32_t> m_pendingReadbacks{ 0 };
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_spaceAvailable;
+        std::condition_variable m_idle;
+        std::deque<Job> m_queue;
+        uint32_t m_active = 0;
+        bool m_stopping = false;
+        std::vector<std::thread> m_workers;
+
+        Stats m_stats;
+        double m_totalEncodeMs = 0.0;
+        double m_totalWriteMs = 0.0;
+    };
+}
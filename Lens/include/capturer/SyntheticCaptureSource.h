@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include "capturer/CpuCaptureSource.h"
+
+namespace lens::capturer
+{
+    // 合成帧源：按设定的分辨率、帧率和运动模式生成画面，不依赖桌面和 WinRT，
+    // 用于在无界面环境下对帧管线做基准测试和长时间压测
+    class SyntheticCaptureSource : public CpuCaptureSource
+    {
+    public:
+        enum class Pattern
+        {
+            Static,             // 静止画面，只生成一次内容
+            MovingBox,          // 纯色背景上移动的方块，模拟局部变化
+            ScrollingGradient,  // 整屏滚动渐变，模拟全屏变化
+            Noise,              // 每帧随机噪声，最坏情况
+            Desktop             // 近似静止的桌面：光标闪烁、时钟跳动，偶尔移动窗口
+        };
+
+        struct SyntheticDesc
+        {
+            uint32_t width = 1920;
+            uint32_t height = 1080;
+            Pattern pattern = Pattern::MovingBox;
+        };
+
+        SyntheticCaptureSource(lens::graphics::GraphicsDevice* device, const SyntheticDesc& synthDesc);
+        ~SyntheticCaptureSource() override;
+
+        const char* GetName() const override { return "Synthetic"; }
+
+    protected:
+        bool OnInitialize() override;
+        std::shared_ptr<const lens::graphics::CpuImage> ProduceFrame(uint64_t frameIndex) override;
+
+    private:
+        SyntheticDesc m_synthDesc;
+        std::shared_ptr<const lens::graphics::CpuImage> m_staticImage;
+
+        void GenerateFrame(lens::graphics::CpuImage& image, uint64_t frameIndex);
+    };
+}
@@ -1,15 +1,23 @@
 ﻿#pragma once
 
-#include "graphics/GraphicsDevice.h"
+#include "capturer/DirtyRegion.h"
+#include "capturer/FrameMailbox.h"
+#include "capturer/ICaptureSource.h"
+#include "graphics/D3D11GraphicsDevice.h"
 #include "graphics/Texture.h"
+#include "graphics/TexturePool.h"
 #include <windows.graphics.capture.h>
 #include <winrt/Windows.Graphics.Capture.h>
 #include <winrt/Windows.Graphics.DirectX.h>
 #include <winrt/Windows.System.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace lens::capturer
 {
-    class WGCCapturer
+    class WGCCapturer : public ICaptureSource
     {
     public:
         struct CaptureSource
@@ -19,52 +27,94 @@ namespace lens::capturer
             RECT windowRect;
         };
 
-        struct CaptureDesc
-        {
-            uint32_t frameRate = 30;
-            lens::graphics::TextureFormat format = lens::graphics::TextureFormat::BGRA8_UNorm;
-            bool captureCursor = true;
-            bool captureBorder = true;
-        };
+        // WGC 的帧是 D3D11 表面，只能在 D3D11 后端上使用
+        WGCCapturer(lens::graphics::D3D11GraphicsDevice* device);
+        ~WGCCapturer() override;
+
+        const char* GetName() const override { return "WGC"; }
 
-        WGCCapturer(lens::graphics::GraphicsDevice* device);
-        ~WGCCapturer();
         // 初始化和清理
-        bool Initialize(const CaptureDesc& desc);
-        void Shutdown();
+        bool Initialize(const CaptureDesc& desc) override;
+        void Shutdown() override;
 
         // 捕获控制
+        void SetTargetWindow(HWND window) { m_targetWindow = window; }
+        bool StartCapture() override;
         bool StartCapture(HWND window);
-        void StopCapture();
-        bool IsCapturing() const { return m_isCapturing; }
+        void StopCapture() override;
+        bool IsCapturing() const override { return m_isCapturing; }
 
         // 帧获取
-        std::shared_ptr<lens::graphics::Texture> GetLatestFrame();
-        bool HasNewFrame() const { return m_frameAvailable; }
+        Frame GetLatestFrame() override;
+        bool AcquireFrame(Frame& frame, std::chrono::milliseconds timeout) override;
+        bool HasNewFrame() const override { return m_frames.HasNew(); }
+        FrameStats GetFrameStats() const override;
 
         // 源枚举
         static std::vector<CaptureSource> EnumerateWindows();
 
+        // 目标窗口尺寸变化的统计，延迟为检测到变化到收到第一帧完整新尺寸画面的时间
+        struct ResizeStats
+        {
+            uint32_t resizeCount = 0;
+            double lastLatencyMs = 0.0;
+            double maxLatencyMs = 0.0;
+        };
+        ResizeStats GetResizeStats() const;
+
     private:
-        lens::graphics::GraphicsDevice* m_device;
+        lens::graphics::D3D11GraphicsDevice* m_device;
         CaptureDesc m_desc;
+        HWND m_targetWindow = nullptr;
+        FramePacer m_pacer;
 
         // WinRT WGC 对象
         winrt::Windows::Graphics::Capture::GraphicsCaptureItem m_captureItem{ nullptr };
         winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool m_framePool{ nullptr };
         winrt::Windows::Graphics::Capture::GraphicsCaptureSession m_session{ nullptr };
+        winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice m_winrtDevice{ nullptr };
+        winrt::Windows::Graphics::DirectX::DirectXPixelFormat m_pixelFormat =
+            winrt::Windows::Graphics::DirectX::DirectXPixelFormat::B8G8R8A8UIntNormalized;
+
+        // 帧池尺寸跟随内容尺寸，变化时原地 Recreate
+        winrt::Windows::Graphics::SizeInt32 m_poolSize{};
+        bool m_resizePending = false;
+        std::chrono::steady_clock::time_point m_resizeStart;
+        std::atomic<uint32_t> m_resizeCount{ 0 };
+        std::atomic<double> m_lastResizeLatencyMs{ 0.0 };
+        std::atomic<double> m_maxResizeLatencyMs{ 0.0 };
 
-        // 帧存储
-        std::shared_ptr<lens::graphics::Texture> m_currentFrame;
-        std::atomic<bool> m_frameAvailable{ false };
+        // 帧存储，OnFrameArrived 从池中取纹理复制后生产，GetLatestFrame 消费
+        std::unique_ptr<lens::graphics::TexturePool> m_texturePool;
+        FrameMailbox<Frame> m_frames;
+        uint64_t m_sequence = 0;
+
+        // 系统报告的脏区（Windows 11 起支持）。被节流丢弃的帧的脏区累积到下一次转发；
+        // 没有变化时直接复用上一张纹理，不再复制
+        bool m_dirtyRegionsSupported = false;
+        std::vector<DirtyRect> m_pendingDirty;
+        bool m_pendingDirtyKnown = true;
+        std::shared_ptr<lens::graphics::Texture> m_lastTexture;
+        std::atomic<uint64_t> m_unchangedCount{ 0 };
         std::atomic<bool> m_isCapturing{ false };
 
+        // 自由线程模式：FrameArrived 只负责唤醒，取帧和复制都在捕获线程上完成
+        std::thread m_captureThread;
+        std::mutex m_signalMutex;
+        std::condition_variable m_signal;
+        bool m_framePending = false;
+        bool m_captureThreadRunning = false;
+
         // 事件处理
         winrt::event_token m_frameArrivedToken;
 
+        void HandleContentResize(winrt::Windows::Graphics::SizeInt32 contentSize);
         void OnFrameArrived(
             winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool const& sender,
             winrt::Windows::Foundation::IInspectable const& args
         );
+        void ProcessFrame(winrt::Windows::Graphics::Capture::Direct3D11CaptureFrame const& frame);
+        void CaptureThreadLoop();
+        void StopCaptureThread();
     };
 }
\ No newline at end of file
@@ -1,23 +1,22 @@
 ﻿#pragma once
 
 #include "GraphicsDevice.h"
-#include <d3d11.h>
-#include <wrl/client.h>
+#include <cstddef>
 
 namespace lens::graphics 
 {
 
-    using Microsoft::WRL::ComPtr;
-
+    // 取值与 D3D11_BIND_FLAG 相同
     enum class BufferType 
     {
-        Vertex = D3D11_BIND_VERTEX_BUFFER,
-        Index = D3D11_BIND_INDEX_BUFFER,
-        Constant = D3D11_BIND_CONSTANT_BUFFER,
-        ShaderResource = D3D11_BIND_SHADER_RESOURCE,
-        UnorderedAccess = D3D11_BIND_UNORDERED_ACCESS
+        Vertex = 0x1,
+        Index = 0x2,
+        Constant = 0x4,
+        ShaderResource = 0x8,
+        UnorderedAccess = 0x80
     };
 
+    // 与后端无关的缓冲区接口，由 GraphicsDevice::CreateBuffer 创建，实现见 D3D11Buffer 和 NullBuffer
     class Buffer 
     {
     public:
@@ -30,24 +29,18 @@ namespace lens::graphics
             bool isUAV = false;
         };
 
-        Buffer() = default;
-        ~Buffer() = default;
-
-        bool Create(GraphicsDevice* device, const Desc& desc, const void* initialData = nullptr);
+        virtual ~Buffer() = default;
 
-        // 直接访问
-        ID3D11Buffer* GetD3DBuffer() const { return m_buffer.Get(); }
-        ID3D11ShaderResourceView* GetSRV() const { return m_srv.Get(); }
-        ID3D11UnorderedAccessView* GetUAV() const { return m_uav.Get(); }
+        virtual bool Create(GraphicsDevice* device, const Desc& desc, const void* initialData = nullptr) = 0;
 
         // 属性
         const Desc& GetDesc() const { return m_desc; }
         size_t GetSize() const { return m_desc.size; }
 
         // 数据操作
-        void UpdateData(GraphicsDevice* device, const void* data, size_t size, size_t offset = 0);
-        D3D11_MAPPED_SUBRESOURCE Map(GraphicsDevice* device, D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD);
-        void Unmap(GraphicsDevice* device);
+        virtual void UpdateData(GraphicsDevice* device, const void* data, size_t size, size_t offset = 0) = 0;
+        virtual MappedData Map(GraphicsDevice* device, MapMode mode = MapMode::WriteDiscard) = 0;
+        virtual void Unmap(GraphicsDevice* device) = 0;
 
         // 模板辅助方法
         template<typename T>
@@ -59,15 +52,11 @@ namespace lens::graphics
         template<typename T>
         T* MapAs(GraphicsDevice* device) 
         {
-            return static_cast<T*>(Map(device).pData);
+            return static_cast<T*>(Map(device).data);
         }
 
-    private:
-        ComPtr<ID3D11Buffer> m_buffer;
-        ComPtr<ID3D11ShaderResourceView> m_srv;
-        ComPtr<ID3D11UnorderedAccessView> m_uav;
-
+    protected:
         Desc m_desc{};
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include "GraphicsDevice.h"
+#include <cstdint>
+#include <vector>
+
+namespace lens::graphics
+{
+    // 每像素字节数，未知格式返回 0
+    inline uint32_t GetFormatBytesPerPixel(TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::RGBA8_UNorm:
+        case TextureFormat::BGRA8_UNorm:
+        case TextureFormat::R32_Float:
+        case TextureFormat::D24_UNorm_S8_UInt:
+            return 4;
+        case TextureFormat::RG32_Float:
+            return 8;
+        case TextureFormat::RGBA32_Float:
+            return 16;
+        case TextureFormat::R16_UInt:
+            return 2;
+        default:
+            return 0;
+        }
+    }
+
+    // 位于系统内存中的图像，供不依赖 GPU 的 CPU 侧处理使用
+    struct CpuImage
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t rowPitch = 0;
+        TextureFormat format = TextureFormat::BGRA8_UNorm;
+        std::vector<uint8_t> pixels;
+
+        void Allocate(uint32_t w, uint32_t h, TextureFormat fmt)
+        {
+            width = w;
+            height = h;
+            format = fmt;
+            rowPitch = w * GetFormatBytesPerPixel(fmt);
+            pixels.resize(static_cast<size_t>(rowPitch) * h);
+        }
+
+        bool IsEmpty() const { return pixels.empty(); }
+        size_t GetSizeInBytes() const { return pixels.size(); }
+
+        uint8_t* Row(uint32_t y) { return pixels.data() + static_cast<size_t>(y) * rowPitch; }
+        const uint8_t* Row(uint32_t y) const { return pixels.data() + static_cast<size_t>(y) * rowPitch; }
+    };
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include "graphics/GraphicsDevice.h"
+#include "graphics/ReadbackRing.h"
+#include <vector>
+
+namespace lens::graphics
+{
+    // 空后端的回读实现：纹理本来就在系统内存里，SubmitCopy 立即复制到槽位图像，
+    // ReadSlot 总是就绪。走的仍是 ReadbackRing 的完整流程，可以单独测出回读的 CPU 开销
+    class CpuReadbackDevice : public IReadbackDevice
+    {
+    public:
+        bool PrepareSlot(uint32_t slot, uint32_t width, uint32_t height, TextureFormat format) override;
+        bool SubmitCopy(uint32_t slot, Texture* source) override;
+        bool IsSlotReady(uint32_t slot) override { return true; }
+        ReadResult ReadSlot(uint32_t slot, CpuImage& image) override;
+        void ReleaseSlots() override;
+
+    private:
+        std::vector<CpuImage> m_slots;
+    };
+
+    // 按设备的后端创建对应的回读实现
+    std::unique_ptr<IReadbackDevice> CreateReadbackDevice(GraphicsDevice* device);
+}
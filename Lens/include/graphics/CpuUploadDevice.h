@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include "graphics/GraphicsDevice.h"
+#include "graphics/UploadRing.h"
+#include <deque>
+#include <vector>
+
+namespace lens::graphics
+{
+    // 空后端的上传实现：缓冲区在系统内存里，没有 GPU。
+    // fenceLatency 模拟 GPU 落后的帧数：围栏插入后再经过这么多次不等待的查询才完成，
+    // 等待的查询立即完成全部围栏；默认 0，插入即完成，环永远不会等待
+    class CpuUploadDevice : public IUploadDevice
+    {
+    public:
+        struct Stats
+        {
+            uint64_t discards = 0;
+            uint64_t waits = 0;         // GetCompletedFence(true) 的次数
+        };
+
+        explicit CpuUploadDevice(uint32_t fenceLatency = 0);
+
+        bool Create(uint64_t capacity) override;
+        uint8_t* Map(bool discard) override;
+        void Unmap() override;
+        void SignalFence(uint64_t value) override;
+        uint64_t GetCompletedFence(bool wait) override;
+
+        const uint8_t* GetData() const { return m_memory.data(); }
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        struct PendingFence
+        {
+            uint64_t value;
+            uint32_t pollsRemaining;
+        };
+
+        std::vector<uint8_t> m_memory;
+        uint32_t m_fenceLatency;
+        std::deque<PendingFence> m_pending;
+        uint64_t m_completedFence = 0;
+        Stats m_stats;
+    };
+
+    // 按设备的后端创建对应的上传实现，设备不支持按偏移绑定常量缓冲区时返回 nullptr
+    std::unique_ptr<IUploadDevice> CreateUploadDevice(GraphicsDevice* device);
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include "graphics/Buffer.h"
+#include "graphics/D3D11GraphicsDevice.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+
+namespace lens::graphics 
+{
+    class D3D11Buffer : public Buffer 
+    {
+    public:
+        D3D11Buffer() = default;
+        ~D3D11Buffer() override = default;
+
+        bool Create(GraphicsDevice* device, const Desc& desc, const void* initialData = nullptr) override;
+
+        // 直接访问
+        ID3D11Buffer* GetD3DBuffer() const { return m_buffer.Get(); }
+        ID3D11ShaderResourceView* GetSRV() const { return m_srv.Get(); }
+        ID3D11UnorderedAccessView* GetUAV() const { return m_uav.Get(); }
+
+        // 数据操作
+        void UpdateData(GraphicsDevice* device, const void* data, size_t size, size_t offset = 0) override;
+        MappedData Map(GraphicsDevice* device, MapMode mode = MapMode::WriteDiscard) override;
+        void Unmap(GraphicsDevice* device) override;
+
+    private:
+        Microsoft::WRL::ComPtr<ID3D11Buffer> m_buffer;
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_srv;
+        Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> m_uav;
+    };
+
+}
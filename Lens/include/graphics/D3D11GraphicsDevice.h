@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include "graphics/GraphicsDevice.h"
+#include <d3d11.h>
+#include <d3d11_4.h>
+#include <dxgi.h>
+#include <wrl/client.h>
+
+namespace lens::graphics
+{
+    // D3D11 设备和交换链，窗口模式使用；需要原生对象的模块（ImGui、WGC、回读/上传实现）
+    // 在确认 GetBackend() 为 D3D11 后转换到这个类型
+    class D3D11GraphicsDevice : public GraphicsDevice
+    {
+    public:
+        D3D11GraphicsDevice() = default;
+        ~D3D11GraphicsDevice() override;
+
+        bool Initialize(const Desc& desc) override;
+        GraphicsBackend GetBackend() const override { return GraphicsBackend::D3D11; }
+
+        // 帧控制
+        void BeginFrame() override;
+        void EndFrame() override;
+        void Present(bool vsync = true) override;
+        void Resize(uint32_t width, uint32_t height) override;
+
+        std::unique_ptr<Texture> CreateTexture() override;
+        std::unique_ptr<Buffer> CreateBuffer() override;
+        std::unique_ptr<Shader> CreateShader() override;
+
+        bool EnableMultithreadProtection() override;
+        bool IsMultithreadProtected() const override { return m_multithread != nullptr; }
+
+        // 视口操作
+        void SetViewport(float x, float y, float width, float height, float minDepth = 0.0f, float maxDepth = 1.0f) override;
+        void SetScissor(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override;
+
+        // 直接访问对象
+        ID3D11Device* GetDevice() const { return m_device.Get(); }
+        ID3D11DeviceContext* GetContext() const { return m_context.Get(); }
+        IDXGISwapChain* GetSwapChain() const { return m_swapChain.Get(); }
+
+        // 渲染资源
+        ID3D11RenderTargetView* GetRenderTargetView() const { return m_renderTargetView.Get(); }
+        ID3D11DepthStencilView* GetDepthStencilView() const { return m_depthStencilView.Get(); }
+
+        // 着色器设置
+        void SetVertexShader(ID3D11VertexShader* shader);
+        void SetPixelShader(ID3D11PixelShader* shader);
+        void SetComputeShader(ID3D11ComputeShader* shader);
+        void SetInputLayout(ID3D11InputLayout* layout);
+
+        template<typename T>
+        void DeferRelease(Microsoft::WRL::ComPtr<T>& object, uint64_t bytes)
+        {
+            if (object)
+            {
+                m_releaseQueue.Retire(std::shared_ptr<void>(object.Detach(),
+                    [](void* ptr) { static_cast<IUnknown*>(ptr)->Release(); }), bytes);
+            }
+        }
+
+    protected:
+        void LockContext() override;
+        void UnlockContext() override;
+
+    private:
+        Microsoft::WRL::ComPtr<ID3D11Device> m_device;
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_context;
+        Microsoft::WRL::ComPtr<IDXGISwapChain> m_swapChain;
+        Microsoft::WRL::ComPtr<ID3D11Multithread> m_multithread;
+
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_renderTargetView;
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilView> m_depthStencilView;
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_depthStencilBuffer;
+
+        D3D11_VIEWPORT m_viewport{};
+    };
+}
@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include "graphics/D3D11GraphicsDevice.h"
+#include "graphics/ReadbackRing.h"
+#include <d3d11.h>
+#include <vector>
+#include <wrl/client.h>
+
+namespace lens::graphics
+{
+    // D3D11 回读实现：每个槽位一张 STAGING 纹理和一个 EVENT 查询，
+    // 查询完成后用 DO_NOT_WAIT 映射，任何一步没就绪都返回 NotReady
+    class D3D11ReadbackDevice : public IReadbackDevice
+    {
+    public:
+        D3D11ReadbackDevice(D3D11GraphicsDevice* device);
+
+        bool PrepareSlot(uint32_t slot, uint32_t width, uint32_t height, TextureFormat format) override;
+        bool SubmitCopy(uint32_t slot, Texture* source) override;
+        bool IsSlotReady(uint32_t slot) override;
+        ReadResult ReadSlot(uint32_t slot, CpuImage& image) override;
+        void ReleaseSlots() override;
+
+    private:
+        struct StagingSlot
+        {
+            Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+            Microsoft::WRL::ComPtr<ID3D11Query> query;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            TextureFormat format = TextureFormat::BGRA8_UNorm;
+        };
+
+        D3D11GraphicsDevice* m_device;
+        std::vector<StagingSlot> m_slots;
+    };
+}
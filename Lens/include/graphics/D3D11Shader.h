@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "graphics/D3D11GraphicsDevice.h"
+#include "graphics/Shader.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+
+namespace lens::graphics 
+{
+    class D3D11Shader : public Shader 
+    {
+    public:
+        D3D11Shader() = default;
+        ~D3D11Shader() override = default;
+
+        // 从已编译字节码加载
+        bool LoadVertexShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) override;
+        bool LoadPixelShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) override;
+        bool LoadComputeShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) override;
+
+        // 直接访问
+        ID3D11VertexShader* GetVertexShader() const { return m_vertexShader.Get(); }
+        ID3D11PixelShader* GetPixelShader() const { return m_pixelShader.Get(); }
+        ID3D11ComputeShader* GetComputeShader() const { return m_computeShader.Get(); }
+        ID3D11InputLayout* GetInputLayout() const { return m_inputLayout.Get(); }
+
+        // 状态检查
+        bool HasVertexShader() const override { return m_vertexShader != nullptr; }
+        bool HasPixelShader() const override { return m_pixelShader != nullptr; }
+        bool HasComputeShader() const override { return m_computeShader != nullptr; }
+
+        // 输入布局设置
+        bool SetInputLayout(GraphicsDevice* device, const D3D11_INPUT_ELEMENT_DESC* layout, uint32_t layoutCount);
+
+    private:
+        Microsoft::WRL::ComPtr<ID3D11VertexShader> m_vertexShader;
+        Microsoft::WRL::ComPtr<ID3D11PixelShader> m_pixelShader;
+        Microsoft::WRL::ComPtr<ID3D11ComputeShader> m_computeShader;
+        Microsoft::WRL::ComPtr<ID3D11InputLayout> m_inputLayout;
+
+        std::vector<char> m_vertexShaderBytecode;
+    };
+
+}
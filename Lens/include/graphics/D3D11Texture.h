@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include "graphics/D3D11GraphicsDevice.h"
+#include "graphics/Texture.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+
+namespace lens::graphics 
+{
+    class D3D11Texture : public Texture 
+    {
+    public:
+        D3D11Texture() = default;
+        ~D3D11Texture() override = default;
+
+        // 创建方法
+        bool Create(GraphicsDevice* device, const Desc& desc) override;
+        bool CreateFromMemory(GraphicsDevice* device, const Desc& desc, const void* data) override;
+        bool CreateFromD3DTexture(GraphicsDevice* device, ID3D11Texture2D* texture);
+
+        // 从同格式的 D3D 纹理复制内容，用于复用已创建的纹理；
+        // 源纹理更大时只复制左上角与本纹理同尺寸的区域
+        bool CopyFrom(GraphicsDevice* device, ID3D11Texture2D* source);
+        bool CopyFrom(GraphicsDevice* device, const Texture& source) override;
+
+        void* GetNativeView() const override { return m_srv.Get(); }
+
+        // 直接访问 D3D11 资源
+        ID3D11Texture2D* GetD3DTexture() const { return m_texture.Get(); }
+        ID3D11ShaderResourceView* GetSRV() const { return m_srv.Get(); }
+        ID3D11RenderTargetView* GetRTV() const { return m_rtv.Get(); }
+        ID3D11UnorderedAccessView* GetUAV() const { return m_uav.Get(); }
+
+        // 数据操作
+        void UpdateData(GraphicsDevice* device, const void* data, size_t size, uint32_t mipLevel = 0) override;
+        void UpdateRegion(GraphicsDevice* device, const void* data, uint32_t rowPitch,
+            uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+        MappedData Map(GraphicsDevice* device, uint32_t mipLevel = 0, MapMode mode = MapMode::WriteDiscard) override;
+        void Unmap(GraphicsDevice* device, uint32_t mipLevel = 0) override;
+
+        // Mipmap 生成
+        void GenerateMipmaps(GraphicsDevice* device) override;
+
+        bool SaveToFile(GraphicsDevice* device, const char* filename, const ImageEncodeOptions& options = {}) override;
+
+    private:
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_texture;
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_srv;
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_rtv;
+        Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> m_uav;
+    };
+
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include "graphics/D3D11GraphicsDevice.h"
+#include "graphics/UploadRing.h"
+#include <d3d11_1.h>
+#include <deque>
+#include <vector>
+#include <wrl/client.h>
+
+namespace lens::graphics
+{
+    // D3D11 上传实现：一个 DYNAMIC 常量缓冲区，围栏用 EVENT 查询模拟（按提交顺序完成），
+    // 完成的查询放回空闲列表复用。分配出的片段用 *SetConstantBuffers1 按偏移绑定，
+    // 需要 D3D11.1 的 ConstantBufferOffsetting 和 MapNoOverwriteOnDynamicConstantBuffer
+    class D3D11UploadDevice : public IUploadDevice
+    {
+    public:
+        D3D11UploadDevice(D3D11GraphicsDevice* device);
+
+        static bool IsSupported(D3D11GraphicsDevice* device);
+
+        bool Create(uint64_t capacity) override;
+        uint8_t* Map(bool discard) override;
+        void Unmap() override;
+        void SignalFence(uint64_t value) override;
+        uint64_t GetCompletedFence(bool wait) override;
+
+        ID3D11Buffer* GetBuffer() const { return m_buffer.Get(); }
+
+        // 把一次分配绑定到常量缓冲区槽位，大小按 16 个常量取整
+        void BindVS(uint32_t slot, const UploadRing::Allocation& allocation) const;
+        void BindPS(uint32_t slot, const UploadRing::Allocation& allocation) const;
+
+    private:
+        struct PendingFence
+        {
+            uint64_t value;
+            Microsoft::WRL::ComPtr<ID3D11Query> query;
+        };
+
+        D3D11GraphicsDevice* m_device;
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext1> m_context1;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> m_buffer;
+        std::deque<PendingFence> m_pending;
+        std::vector<Microsoft::WRL::ComPtr<ID3D11Query>> m_freeQueries;
+        uint64_t m_completedFence = 0;
+    };
+}
@@ -0,0 +1,100 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace lens::graphics
+{
+    // 延迟销毁队列：资源的最后一个引用交给队列，记下当前帧号，N 帧之后再在渲染线程上成批销毁。
+    // 这时 GPU 一定已经执行完引用它的命令，销毁也不会落在捕获回调等线程上，
+    // 不会因为 GPU 还在使用而在驱动里隐式同步。
+    // 空闲时没有新帧，帧号不再前进，改由 Poll 按交给队列后经过的时间回收。
+    // Retire 可在任意线程调用；EndFrame、Poll 和 Flush 只在渲染线程调用
+    class DeferredReleaseQueue
+    {
+    public:
+        struct Desc
+        {
+            // 交换链最多排队 3 帧，再多一帧留余量
+            uint32_t frameLatency = 3;
+            // 每帧最多销毁多少个，0 表示不限；到期的多出部分顺延到之后的帧，削平尺寸变化时的尖峰
+            uint32_t maxReleasesPerFrame = 0;
+            // 交给队列超过这个时间的资源也视为 GPU 已经用完（远大于 frameLatency 帧的延迟），0 表示只按帧计
+            std::chrono::milliseconds maxAge{ 250 };
+        };
+
+        struct Stats
+        {
+            uint64_t retired = 0;           // 交给队列的资源数
+            uint64_t released = 0;          // 已销毁的资源数
+            uint64_t releasedBytes = 0;
+            uint64_t batches = 0;           // 有销毁动作的 EndFrame/Flush 次数
+            uint64_t pendingCount = 0;      // 等待销毁的资源数
+            uint64_t pendingBytes = 0;      // 等待销毁的字节数（显存或系统内存的估算值）
+            uint64_t peakPendingBytes = 0;
+            uint64_t frame = 0;             // 当前帧号
+            double releaseMs = 0.0;         // 累计销毁耗时
+            double maxBatchMs = 0.0;
+        };
+
+        DeferredReleaseQueue();
+        explicit DeferredReleaseQueue(const Desc& desc);
+        ~DeferredReleaseQueue();
+
+        DeferredReleaseQueue(const DeferredReleaseQueue&) = delete;
+        DeferredReleaseQueue& operator=(const DeferredReleaseQueue&) = delete;
+
+        // bytes 只用于统计。传入的引用如果还有其他持有者，到期时只是释放队列这一份
+        void Retire(std::shared_ptr<void> object, uint64_t bytes);
+
+        template<typename T>
+        void Retire(std::unique_ptr<T> object, uint64_t bytes)
+        {
+            if (object)
+            {
+                Retire(std::shared_ptr<void>(std::move(object)), bytes);
+            }
+        }
+
+        // 每帧提交后调用一次：帧号加一，销毁已经过了 frameLatency 帧的资源，返回销毁的个数
+        size_t EndFrame();
+
+        // 不增加帧号，销毁按帧或按 maxAge 已经到期的资源；渲染线程每次醒来调用，不论是否重绘
+        size_t Poll();
+
+        // 立即销毁全部，只在 GPU 空闲（如关闭设备）时调用
+        size_t Flush();
+
+        const Desc& GetDesc() const { return m_desc; }
+        Stats GetStats() const;
+
+    private:
+        struct Entry
+        {
+            uint64_t frame;     // 交给队列时的帧号
+            std::chrono::steady_clock::time_point time;
+            uint64_t bytes;
+            std::shared_ptr<void> object;
+        };
+
+        enum class ReleaseMode
+        {
+            EndFrame,
+            Poll,
+            All
+        };
+
+        size_t ReleaseBatch(ReleaseMode mode);
+
+        Desc m_desc;
+
+        mutable std::mutex m_mutex;
+        std::deque<Entry> m_entries;    // 按帧号和时间递增排列
+        uint64_t m_frame = 0;
+
+        Stats m_stats;
+    };
+}
@@ -1,39 +1,68 @@
 ﻿#pragma once
 
+#include "graphics/DeferredReleaseQueue.h"
 #include <cstdint>
-#include <span>
 #include <memory>
-#include <vector>
-#include <d3d11.h>
-#include <dxgi.h>
-#include <wrl/client.h>
 
 
 namespace lens::graphics
 {
+    class Texture;
+    class Buffer;
+    class Shader;
 
-    enum class TextureFormat 
+    // 取值与 DXGI_FORMAT 相同，D3D11 后端直接转换
+    enum class TextureFormat
     {
-        RGBA8_UNorm     = DXGI_FORMAT_R8G8B8A8_UNORM,
-        BGRA8_UNorm     = DXGI_FORMAT_B8G8R8A8_UNORM,
-        R32_Float       = DXGI_FORMAT_R32_FLOAT,
-        RG32_Float      = DXGI_FORMAT_R32G32_FLOAT,
-        RGBA32_Float    = DXGI_FORMAT_R32G32B32A32_FLOAT,
-        R16_UInt        = DXGI_FORMAT_R16_UINT,
-        D24_UNorm_S8_UInt = DXGI_FORMAT_D24_UNORM_S8_UINT
+        RGBA8_UNorm     = 28,   // DXGI_FORMAT_R8G8B8A8_UNORM
+        BGRA8_UNorm     = 87,   // DXGI_FORMAT_B8G8R8A8_UNORM
+        R32_Float       = 41,   // DXGI_FORMAT_R32_FLOAT
+        RG32_Float      = 16,   // DXGI_FORMAT_R32G32_FLOAT
+        RGBA32_Float    = 2,    // DXGI_FORMAT_R32G32B32A32_FLOAT
+        R16_UInt        = 57,   // DXGI_FORMAT_R16_UINT
+        D24_UNorm_S8_UInt = 45  // DXGI_FORMAT_D24_UNORM_S8_UINT
     };
 
-    enum class BufferUsage 
+    // 取值与 D3D11_USAGE 相同
+    enum class BufferUsage
     {
-        Static  = D3D11_USAGE_DEFAULT,      // GPU只读，CPU一次性写入
-        Dynamic = D3D11_USAGE_DYNAMIC,     // CPU读写，GPU只读
-        Staging = D3D11_USAGE_STAGING      // CPU读写，GPU访问禁用
+        Static  = 0,    // GPU只读，CPU一次性写入
+        Dynamic = 2,    // CPU读写，GPU只读
+        Staging = 3     // CPU读写，GPU访问禁用
     };
 
-    class GraphicsDevice 
+    // 取值与 D3D11_MAP 相同
+    enum class MapMode
+    {
+        Read             = 1,
+        Write            = 2,
+        ReadWrite        = 3,
+        WriteDiscard     = 4,
+        WriteNoOverwrite = 5
+    };
+
+    // Map 的结果，失败时 data 为空
+    struct MappedData
+    {
+        void* data = nullptr;
+        uint32_t rowPitch = 0;
+        uint32_t depthPitch = 0;
+    };
+
+    enum class GraphicsBackend
+    {
+        D3D11,
+        // 不创建 GPU 设备和交换链：纹理、缓冲区放在系统内存，更新、复制和映射都是 memcpy，
+        // 用于无窗口运行和单独测量管线的 CPU 开销
+        Null
+    };
+
+    // 与后端无关的设备接口，实现见 D3D11GraphicsDevice 和 NullGraphicsDevice。
+    // 纹理、缓冲区和着色器由设备创建，只能交回创建它们的设备使用
+    class GraphicsDevice
     {
     public:
-        struct Desc 
+        struct Desc
         {
             void* windowHandle = nullptr;
             uint32_t width = 1920;
@@ -41,46 +70,65 @@ namespace lens::graphics
             bool enableDebug = false;
         };
 
-        GraphicsDevice() = default;
-        ~GraphicsDevice() = default;
+        virtual ~GraphicsDevice() = default;
 
-        bool Initialize(const Desc& desc);
+        virtual bool Initialize(const Desc& desc) = 0;
+        virtual GraphicsBackend GetBackend() const = 0;
 
         // 帧控制
-        void BeginFrame();
-        void EndFrame();
-        void Present(bool vsync = true);
-        void Resize(uint32_t width, uint32_t height);
-
-        // 直接访问对象
-        ID3D11Device* GetDevice() const { return m_device.Get(); }
-        ID3D11DeviceContext* GetContext() const { return m_context.Get(); }
-        IDXGISwapChain* GetSwapChain() const { return m_swapChain.Get(); }
-
-        // 渲染资源
-        ID3D11RenderTargetView* GetRenderTargetView() const { return m_renderTargetView.Get(); }
-        ID3D11DepthStencilView* GetDepthStencilView() const { return m_depthStencilView.Get(); }
+        virtual void BeginFrame() = 0;
+        virtual void EndFrame() = 0;
+        virtual void Present(bool vsync = true) = 0;
+        virtual void Resize(uint32_t width, uint32_t height) = 0;
+
+        // 资源创建，返回的对象还需调用各自的 Create / Load
+        virtual std::unique_ptr<Texture> CreateTexture() = 0;
+        virtual std::unique_ptr<Buffer> CreateBuffer() = 0;
+        virtual std::unique_ptr<Shader> CreateShader() = 0;
+
+        // 多线程访问：开启后立即上下文的每次调用都由运行时串行化，
+        // 需要几次调用连续执行时再用 ContextLock 包住
+        virtual bool EnableMultithreadProtection() = 0;
+        virtual bool IsMultithreadProtected() const = 0;
+
+        class ContextLock
+        {
+        public:
+            explicit ContextLock(GraphicsDevice* device)
+                : m_device(device)
+            {
+                if (m_device)
+                    m_device->LockContext();
+            }
+            ~ContextLock()
+            {
+                if (m_device)
+                    m_device->UnlockContext();
+            }
+
+            ContextLock(const ContextLock&) = delete;
+            ContextLock& operator=(const ContextLock&) = delete;
+
+        private:
+            GraphicsDevice* m_device;
+        };
 
         // 视口操作
-        void SetViewport(float x, float y, float width, float height, float minDepth = 0.0f, float maxDepth = 1.0f);
-        void SetScissor(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom);
-
-        // 着色器设置
-        void SetVertexShader(ID3D11VertexShader* shader);
-        void SetPixelShader(ID3D11PixelShader* shader);
-        void SetComputeShader(ID3D11ComputeShader* shader);
-        void SetInputLayout(ID3D11InputLayout* layout);
+        virtual void SetViewport(float x, float y, float width, float height, float minDepth = 0.0f, float maxDepth = 1.0f) = 0;
+        virtual void SetScissor(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) = 0;
 
-    private:
-        Microsoft::WRL::ComPtr<ID3D11Device> m_device;
-        Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_context;
-        Microsoft::WRL::ComPtr<IDXGISwapChain> m_swapChain;
+        // 延迟销毁：可能还在 GPU 命令里的资源交给这里，渲染线程每帧调用一次 EndFrame 回收
+        DeferredReleaseQueue& GetReleaseQueue() { return m_releaseQueue; }
 
-        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_renderTargetView;
-        Microsoft::WRL::ComPtr<ID3D11DepthStencilView> m_depthStencilView;
-        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_depthStencilBuffer;
+    protected:
+        // ContextLock 使用，没有开启多线程保护时什么都不做
+        virtual void LockContext() {}
+        virtual void UnlockContext() {}
 
-        D3D11_VIEWPORT m_viewport{};
+        // 基类成员最后析构，派生类析构时须先 Flush，排队中的资源先于设备释放
+        DeferredReleaseQueue m_releaseQueue;
     };
 
+    std::unique_ptr<GraphicsDevice> CreateGraphicsDevice(GraphicsBackend backend);
+
 }
@@ -0,0 +1,64 @@
+﻿#pragma once
+
+#include "graphics/CpuImage.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace lens
+{
+    class ThreadPool;
+}
+
+namespace lens::graphics
+{
+    // 截图编码：BMP 不压缩，QOI 最快，PNG 压缩率最高，以上均无损；JPEG 有损，用于录制。
+    // 输入为 BGRA8/RGBA8，按行带在线程池上并行编码
+    enum class ImageCodec
+    {
+        Auto,   // 按文件扩展名选择，无法识别时使用 PNG
+        BMP,
+        QOI,
+        PNG,
+        JPEG
+    };
+
+    const char* GetImageCodecName(ImageCodec codec);
+
+    // .bmp / .qoi / .png / .jpg / .jpeg（不区分大小写），其它扩展名返回 Auto
+    ImageCodec GetImageCodecForPath(const std::filesystem::path& path);
+
+    struct ImageEncodeOptions
+    {
+        ImageCodec codec = ImageCodec::Auto;
+        uint32_t pngLevel = 3;      // deflate 级别 0~9
+        uint32_t jpegQuality = 90;  // 1~100，与 libjpeg 的质量参数一致
+        bool keepAlpha = false;     // 截图的 alpha 通常没有意义，默认 QOI/PNG 只保存 RGB
+        ThreadPool* pool = nullptr; // 为空时使用共享线程池
+    };
+
+    // stride 以字节为单位，允许带行尾填充（如映射后的 RowPitch）。codec 为 Auto 时按 PNG 编码
+    bool EncodeImage(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, TextureFormat format,
+        std::vector<uint8_t>& output, const ImageEncodeOptions& options = {});
+    bool EncodeImage(const CpuImage& image, std::vector<uint8_t>& output, const ImageEncodeOptions& options = {});
+
+    // 编码后一次写入文件，codec 为 Auto 时按扩展名选择
+    bool SaveImage(const std::filesystem::path& path, const uint8_t* pixels, uint32_t stride,
+        uint32_t width, uint32_t height, TextureFormat format, const ImageEncodeOptions& options = {});
+    bool SaveImage(const std::filesystem::path& path, const CpuImage& image, const ImageEncodeOptions& options = {});
+
+    // QOI 解码，输出 BGRA8
+    bool DecodeQoi(const uint8_t* data, size_t size, CpuImage& image);
+
+    namespace detail
+    {
+        bool EncodeBmp(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, bool bgra,
+            std::vector<uint8_t>& output);
+        bool EncodeQoi(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, bool bgra,
+            bool keepAlpha, ThreadPool& pool, std::vector<uint8_t>& output);
+        bool EncodePng(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, bool bgra,
+            bool keepAlpha, uint32_t level, ThreadPool& pool, std::vector<uint8_t>& output);
+        bool EncodeJpeg(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, bool bgra,
+            uint32_t quality, ThreadPool& pool, std::vector<uint8_t>& output);
+    }
+}
@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include "graphics/Buffer.h"
+#include <vector>
+
+namespace lens::graphics 
+{
+    // 空后端下缓冲区只是一块系统内存，没有视图
+    class NullBuffer : public Buffer 
+    {
+    public:
+        NullBuffer() = default;
+        ~NullBuffer() override = default;
+
+        bool Create(GraphicsDevice* device, const Desc& desc, const void* initialData = nullptr) override;
+
+        // 存储
+        const uint8_t* GetData() const { return m_data.data(); }
+
+        void UpdateData(GraphicsDevice* device, const void* data, size_t size, size_t offset = 0) override;
+        MappedData Map(GraphicsDevice* device, MapMode mode = MapMode::WriteDiscard) override;
+        void Unmap(GraphicsDevice* device) override {}
+
+    private:
+        std::vector<uint8_t> m_data;
+    };
+
+}
@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "graphics/GraphicsDevice.h"
+
+namespace lens::graphics
+{
+    // 空后端：不需要窗口和 GPU，创建的纹理、缓冲区都在系统内存里，
+    // 帧控制和视口操作只记录状态
+    class NullGraphicsDevice : public GraphicsDevice
+    {
+    public:
+        NullGraphicsDevice() = default;
+        ~NullGraphicsDevice() override;
+
+        bool Initialize(const Desc& desc) override;
+        GraphicsBackend GetBackend() const override { return GraphicsBackend::Null; }
+
+        // 帧控制
+        void BeginFrame() override {}
+        void EndFrame() override {}
+        void Present(bool vsync = true) override {}
+        void Resize(uint32_t width, uint32_t height) override;
+
+        std::unique_ptr<Texture> CreateTexture() override;
+        std::unique_ptr<Buffer> CreateBuffer() override;
+        std::unique_ptr<Shader> CreateShader() override;
+
+        // 没有立即上下文，资源操作都在调用线程上直接完成，这里只记录开关
+        bool EnableMultithreadProtection() override { m_multithreadProtected = true; return true; }
+        bool IsMultithreadProtected() const override { return m_multithreadProtected; }
+
+        // 视口操作
+        void SetViewport(float x, float y, float width, float height, float minDepth = 0.0f, float maxDepth = 1.0f) override;
+        void SetScissor(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override {}
+
+        uint32_t GetWidth() const { return m_width; }
+        uint32_t GetHeight() const { return m_height; }
+
+    private:
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        bool m_multithreadProtected = false;
+    };
+}
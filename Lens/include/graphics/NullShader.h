@@ -0,0 +1,33 @@
+﻿#pragma once
+
+#include "graphics/Shader.h"
+
+namespace lens::graphics 
+{
+    // 空后端下仍然编译 HLSL，但不创建着色器对象，只记录加载了哪些阶段
+    class NullShader : public Shader 
+    {
+    public:
+        NullShader() = default;
+        ~NullShader() override = default;
+
+        bool LoadVertexShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) override;
+        bool LoadPixelShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) override;
+        bool LoadComputeShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) override;
+
+        bool HasVertexShader() const override { return (m_stages & kVertexStage) != 0; }
+        bool HasPixelShader() const override { return (m_stages & kPixelStage) != 0; }
+        bool HasComputeShader() const override { return (m_stages & kComputeStage) != 0; }
+
+    private:
+        enum : uint32_t
+        {
+            kVertexStage  = 1,
+            kPixelStage   = 2,
+            kComputeStage = 4
+        };
+
+        uint32_t m_stages = 0;     // 已加载的阶段
+    };
+
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include "graphics/CpuImage.h"
+#include "graphics/Texture.h"
+
+namespace lens::graphics 
+{
+    // 空后端的纹理是系统内存中的图像（只保存第 0 级 mip），没有视图，
+    // 更新、复制和映射都直接操作这块内存
+    class NullTexture : public Texture 
+    {
+    public:
+        NullTexture() = default;
+        ~NullTexture() override = default;
+
+        bool Create(GraphicsDevice* device, const Desc& desc) override;
+        bool CreateFromMemory(GraphicsDevice* device, const Desc& desc, const void* data) override;
+        bool CopyFrom(GraphicsDevice* device, const Texture& source) override;
+
+        void* GetNativeView() const override { return nullptr; }
+
+        // 像素存储
+        const CpuImage& GetImage() const { return m_image; }
+
+        void UpdateData(GraphicsDevice* device, const void* data, size_t size, uint32_t mipLevel = 0) override;
+        void UpdateRegion(GraphicsDevice* device, const void* data, uint32_t rowPitch,
+            uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+        // 直接返回系统内存，读写都有效，WriteDiscard 也保留原内容
+        MappedData Map(GraphicsDevice* device, uint32_t mipLevel = 0, MapMode mode = MapMode::WriteDiscard) override;
+        void Unmap(GraphicsDevice* device, uint32_t mipLevel = 0) override {}
+
+        void GenerateMipmaps(GraphicsDevice* device) override {}
+
+        bool SaveToFile(GraphicsDevice* device, const char* filename, const ImageEncodeOptions& options = {}) override;
+
+    private:
+        CpuImage m_image;
+    };
+
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include "graphics/CpuImage.h"
+#include "graphics/GraphicsDevice.h"
+#include <cstdint>
+
+namespace lens::graphics
+{
+    // CPU 像素格式转换。每个函数处理整幅图像，stride 均以字节为单位，允许带行尾填充；
+    // 内部按运行时检测到的指令集（SSE2/AVX2/AVX-512）选择实现，结果与标量版本逐位一致
+    enum class CpuIsa
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512     // AVX-512F + AVX-512BW
+    };
+
+    CpuIsa DetectCpuIsa();
+    const char* GetCpuIsaName(CpuIsa isa);
+
+    // 当前使用的指令集；Set 不会超过检测到的级别，用于基准测试和一致性校验
+    CpuIsa GetPixelConvertIsa();
+    void SetPixelConvertIsa(CpuIsa isa);
+
+    // BGRA <-> RGBA，交换 R/B 通道，可原地转换
+    void ConvertBGRAToRGBA(const uint8_t* src, uint32_t srcStride, uint8_t* dst, uint32_t dstStride,
+        uint32_t width, uint32_t height);
+    inline void ConvertRGBAToBGRA(const uint8_t* src, uint32_t srcStride, uint8_t* dst, uint32_t dstStride,
+        uint32_t width, uint32_t height)
+    {
+        ConvertBGRAToRGBA(src, srcStride, dst, dstStride, width, height);
+    }
+
+    // BGRA -> 8 位灰度，Y = (77R + 150G + 29B + 128) >> 8
+    void ConvertBGRAToGray(const uint8_t* src, uint32_t srcStride, uint8_t* dst, uint32_t dstStride,
+        uint32_t width, uint32_t height);
+
+    // BGRA -> BT.601 有限范围 YUV 4:2:0，色度取 2x2 平均，奇数宽高时复制边缘像素。
+    // 色度平面尺寸为 ((width + 1) / 2) x ((height + 1) / 2)
+    void ConvertBGRAToI420(const uint8_t* src, uint32_t srcStride,
+        uint8_t* y, uint32_t yStride, uint8_t* u, uint32_t uStride, uint8_t* v, uint32_t vStride,
+        uint32_t width, uint32_t height);
+    void ConvertBGRAToNV12(const uint8_t* src, uint32_t srcStride,
+        uint8_t* y, uint32_t yStride, uint8_t* uv, uint32_t uvStride,
+        uint32_t width, uint32_t height);
+
+    // RGBA32F -> RGBA8，先钳制到 [0, 1] 再四舍五入，NaN 视为 1
+    void ConvertRGBA32FToRGBA8(const uint8_t* src, uint32_t srcStride, uint8_t* dst, uint32_t dstStride,
+        uint32_t width, uint32_t height);
+
+    // 四通道格式之间的整图转换：BGRA8/RGBA8 互转，RGBA32F 转 BGRA8/RGBA8，同格式时直接复制。
+    // 不支持的组合返回 false
+    bool ConvertImage(const CpuImage& src, TextureFormat dstFormat, CpuImage& dst);
+}
@@ -0,0 +1,38 @@
+﻿#pragma once
+
+#include <cstdint>
+
+namespace lens::graphics::detail
+{
+    // 单行转换内核，由 PixelConvert 按指令集分派。
+    // 每个 SIMD 实现只处理能整块处理的部分，剩余像素交给标量版本
+    struct PixelConvertKernels
+    {
+        void (*swapRB)(const uint8_t* src, uint8_t* dst, uint32_t width);
+        void (*bgraToGray)(const uint8_t* src, uint8_t* dst, uint32_t width);
+        void (*bgraToLuma)(const uint8_t* src, uint8_t* dst, uint32_t width);
+        // 两行 BGRA 生成一行 U、V，width 为像素数（奇数时最后一列复制）
+        void (*bgraToChroma)(const uint8_t* row0, const uint8_t* row1, uint8_t* u, uint8_t* v, uint32_t width);
+        void (*interleaveUV)(const uint8_t* u, const uint8_t* v, uint8_t* uv, uint32_t count);
+        void (*rgba32fToRgba8)(const float* src, uint8_t* dst, uint32_t width);
+    };
+
+    extern const PixelConvertKernels kScalarKernels;
+    extern const PixelConvertKernels kSSE2Kernels;
+    extern const PixelConvertKernels kAVX2Kernels;
+    extern const PixelConvertKernels kAVX512Kernels;
+
+    // 标量参考实现，SIMD 版本用它处理行尾
+    void SwapRBScalar(const uint8_t* src, uint8_t* dst, uint32_t width);
+    void BGRAToGrayScalar(const uint8_t* src, uint8_t* dst, uint32_t width);
+    void BGRAToLumaScalar(const uint8_t* src, uint8_t* dst, uint32_t width);
+    void BGRAToChromaScalar(const uint8_t* row0, const uint8_t* row1, uint8_t* u, uint8_t* v, uint32_t width);
+    void InterleaveUVScalar(const uint8_t* u, const uint8_t* v, uint8_t* uv, uint32_t count);
+    void RGBA32FToRGBA8Scalar(const float* src, uint8_t* dst, uint32_t width);
+
+    // 系数，SIMD 实现共用
+    constexpr int kGrayB = 29, kGrayG = 150, kGrayR = 77;
+    constexpr int kLumaB = 25, kLumaG = 129, kLumaR = 66;
+    constexpr int kUB = 112, kUG = -74, kUR = -38;
+    constexpr int kVB = -18, kVG = -94, kVR = 112;
+}
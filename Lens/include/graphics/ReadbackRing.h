@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include "graphics/CpuImage.h"
+#include "graphics/ResourcePool.h"
+#include "graphics/Texture.h"
+#include "graphics/TexturePool.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace lens::graphics
+{
+    // 回读用的设备操作，按槽位编号管理暂存表面。
+    // 环形队列的逻辑只依赖这个接口，可以换成假设备单独测试
+    class IReadbackDevice
+    {
+    public:
+        enum class ReadResult
+        {
+            Ok,
+            NotReady,   // 复制还没有完成，稍后再试
+            Failed
+        };
+
+        virtual ~IReadbackDevice() = default;
+
+        // 准备槽位的暂存表面，尺寸或格式不变时应直接复用
+        virtual bool PrepareSlot(uint32_t slot, uint32_t width, uint32_t height, TextureFormat format) = 0;
+        // 提交复制并在其后插入完成标记，不等待
+        virtual bool SubmitCopy(uint32_t slot, Texture* source) = 0;
+        // 复制是否已经完成，不映射、不阻塞；出错时返回 true，由 ReadSlot 报告失败
+        virtual bool IsSlotReady(uint32_t slot) = 0;
+        // 复制完成后才映射，不阻塞；image 已按槽位尺寸分配好
+        virtual ReadResult ReadSlot(uint32_t slot, CpuImage& image) = 0;
+        virtual void ReleaseSlots() = 0;
+    };
+
+    // GPU 到 CPU 的异步回读：N 个暂存表面轮转使用，提交时只记录复制命令，
+    // 之后每帧 Poll 检查最早的槽位，复制完成才映射并回调，不会让渲染线程等 GPU。
+    // 所有方法都在渲染线程（持有设备上下文的线程）调用，回调也在 Poll 里执行
+    class ReadbackRing
+    {
+    public:
+        using Callback = std::function<void(std::shared_ptr<const CpuImage> image)>;
+
+        struct Stats
+        {
+            uint64_t submitted = 0;     // 成功提交复制的帧
+            uint64_t completed = 0;     // 已交给回调的帧
+            uint64_t dropped = 0;       // 槽位用尽被拒绝的帧
+            uint64_t failed = 0;        // 复制或映射失败的帧
+            uint64_t notReadyPolls = 0; // Poll 时最早的槽位还没完成的次数
+            uint64_t bytesRead = 0;
+            double readMs = 0.0;        // 映射和拷贝出数据的总耗时
+            double stallMs = 0.0;       // Flush 阻塞等待 GPU 的总耗时
+            double avgLatencyMs = 0.0;  // 提交到数据可读的平均时间
+            double maxLatencyMs = 0.0;
+            double throughputMBps = 0.0;
+        };
+
+        // slotCount 即允许在途的帧数，3 个通常足够覆盖 GPU 落后 CPU 的帧数
+        ReadbackRing(std::unique_ptr<IReadbackDevice> device, uint32_t slotCount = 3);
+        ~ReadbackRing();
+
+        ReadbackRing(const ReadbackRing&) = delete;
+        ReadbackRing& operator=(const ReadbackRing&) = delete;
+
+        // 槽位用尽时丢弃这一帧并返回 false
+        bool Submit(Texture* source, Callback callback);
+
+        // 按提交顺序交付已完成的帧，返回本次交付的数量
+        uint32_t Poll();
+
+        // 阻塞直到所有在途的帧都交付，等待时间计入 stallMs
+        void Flush();
+
+        uint32_t GetInFlightCount() const { return m_count; }
+        uint32_t GetSlotCount() const { return static_cast<uint32_t>(m_slots.size()); }
+        Stats GetStats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Slot
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            TextureFormat format = TextureFormat::BGRA8_UNorm;
+            Callback callback;
+            Clock::time_point submitTime;
+        };
+
+        std::unique_ptr<IReadbackDevice> m_device;
+        std::vector<Slot> m_slots;
+        uint32_t m_head = 0;    // 最早提交的槽位
+        uint32_t m_count = 0;   // 在途槽位数
+
+        // CPU 侧图像复用，回调释放后回到池中
+        ResourcePool<CpuImage, TextureKey> m_images;
+
+        Stats m_stats;
+        double m_totalLatencyMs = 0.0;
+        Clock::time_point m_firstSubmit;
+        Clock::time_point m_lastComplete;
+    };
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include "graphics/CpuImage.h"
+#include <cstdint>
+#include <vector>
+
+namespace lens
+{
+    class ThreadPool;
+}
+
+namespace lens::graphics
+{
+    enum class ResampleFilter
+    {
+        Box,        // 面积平均，缩小时等同于按覆盖面积求均值
+        Bilinear,   // 三角形滤波，缩小时按比例加宽
+        Lanczos3
+    };
+
+    const char* GetResampleFilterName(ResampleFilter filter);
+
+    // 4 通道 8 位图像（BGRA8/RGBA8）的 CPU 缩放。
+    // 可分离的两遍滤波：输出按行带切分，每个行带先对所需源行做水平滤波，结果留在缓存里再做垂直滤波，
+    // 行带之间互不依赖，由线程池并行处理。系数表按尺寸和滤波器缓存，同尺寸重复缩放时不再计算
+    // 同一实例不能被多个线程同时调用，各线程应持有自己的 Resampler
+    class Resampler
+    {
+    public:
+        Resampler() = default;
+
+        // stride 以字节为单位，允许行尾填充。pool 为空时使用共享线程池
+        bool Resample(const uint8_t* src, uint32_t srcStride, uint32_t srcWidth, uint32_t srcHeight,
+            uint8_t* dst, uint32_t dstStride, uint32_t dstWidth, uint32_t dstHeight,
+            ResampleFilter filter, ThreadPool* pool = nullptr);
+
+        bool Resample(const CpuImage& src, uint32_t dstWidth, uint32_t dstHeight, ResampleFilter filter,
+            CpuImage& dst, ThreadPool* pool = nullptr);
+
+        // 按比例缩放到不超过 maxWidth x maxHeight，不放大
+        bool ResampleToFit(const CpuImage& src, uint32_t maxWidth, uint32_t maxHeight, ResampleFilter filter,
+            CpuImage& dst, ThreadPool* pool = nullptr);
+
+        // 生成逐级减半的预览层级（不含原图），直到宽高都不大于 minSize。
+        // 每级由上一级盒式滤波得到，开销约为原图的三分之一
+        bool BuildPreviewLevels(const CpuImage& src, uint32_t minSize, std::vector<CpuImage>& levels,
+            ThreadPool* pool = nullptr);
+
+        // 输出行带高度，默认 16 行
+        void SetBandHeight(uint32_t rows) { m_bandHeight = rows > 0 ? rows : 1; }
+
+    private:
+        // 一个方向上的系数表：每个输出位置对应一段连续源像素及其定点权重
+        struct Contributors
+        {
+            uint32_t srcSize = 0;
+            uint32_t dstSize = 0;
+            ResampleFilter filter = ResampleFilter::Box;
+            uint32_t taps = 0;                  // 每个输出的最大权重数
+            std::vector<uint32_t> first;        // 首个源像素
+            std::vector<uint32_t> count;        // 实际权重数
+            std::vector<int16_t> weights;       // dstSize * taps，和为 1 << kWeightBits
+
+            bool Matches(uint32_t src, uint32_t dst, ResampleFilter f) const
+            {
+                return srcSize == src && dstSize == dst && filter == f;
+            }
+        };
+
+        static void BuildContributors(Contributors& table, uint32_t srcSize, uint32_t dstSize, ResampleFilter filter);
+
+        Contributors m_horizontal;
+        Contributors m_vertical;
+        uint32_t m_bandHeight = 16;
+    };
+}
@@ -0,0 +1,224 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace lens::graphics
+{
+    // 按 Key 分类回收对象的通用池，不依赖任何图形 API。
+    // Acquire 返回的 shared_ptr 在最后一个持有者释放时自动把对象还给池；
+    // 池先于对象销毁时，对象直接 delete。
+    // 设置了 Disposer 时，被裁剪的对象交给它处理（例如延迟到 GPU 用完再销毁），否则在调用线程上直接销毁。
+    // 空闲对象总数超过高水位时，从最久未用的开始裁剪到低水位；
+    // 调用方每帧调用 EndFrame 时，空闲超过 maxIdleFrames 帧的对象也会被裁剪，池不用时会缩回去
+    template<typename T, typename Key>
+    class ResourcePool
+    {
+    public:
+        using Factory = std::function<std::unique_ptr<T>(const Key&)>;
+        using Disposer = std::function<void(const Key&, std::unique_ptr<T>)>;
+
+        struct Desc
+        {
+            size_t lowWatermark = 2;
+            size_t highWatermark = 8;
+            uint32_t maxIdleFrames = 120;   // 0 表示只按水位裁剪
+        };
+
+        struct Stats
+        {
+            uint64_t allocations = 0;   // 调用工厂创建的次数
+            uint64_t reuses = 0;        // 命中空闲对象的次数
+            uint64_t trimmed = 0;       // 被裁剪销毁的空闲对象数
+            size_t liveCount = 0;       // 已借出的对象
+            size_t idleCount = 0;       // 池中空闲的对象
+        };
+
+        ResourcePool(Factory factory, const Desc& desc = {})
+            : m_state(std::make_shared<State>())
+        {
+            m_state->factory = std::move(factory);
+            m_state->desc = desc;
+        }
+
+        ResourcePool(const ResourcePool&) = delete;
+        ResourcePool& operator=(const ResourcePool&) = delete;
+
+        // 须在第一次 Acquire 之前设置
+        void SetDisposer(Disposer disposer)
+        {
+            m_state->disposer = std::move(disposer);
+        }
+
+        std::shared_ptr<T> Acquire(const Key& key)
+        {
+            std::unique_ptr<T> object;
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                auto& idle = m_state->idle;
+                auto it = std::find_if(idle.begin(), idle.end(),
+                    [&key](const Entry& entry) { return entry.key == key; });
+                if (it != idle.end())
+                {
+                    object = std::move(it->object);
+                    idle.erase(it);
+                    m_state->stats.reuses++;
+                    m_state->stats.liveCount++;
+                }
+            }
+
+            // 工厂调用放在锁外，避免创建资源时阻塞其他线程归还
+            if (!object)
+            {
+                object = m_state->factory(key);
+                if (!object)
+                    return nullptr;
+
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                m_state->stats.allocations++;
+                m_state->stats.liveCount++;
+            }
+
+            std::weak_ptr<State> weakState = m_state;
+            return std::shared_ptr<T>(object.release(), [weakState, key](T* ptr)
+            {
+                if (auto state = weakState.lock())
+                {
+                    state->Release(key, std::unique_ptr<T>(ptr));
+                }
+                else
+                {
+                    delete ptr;
+                }
+            });
+        }
+
+        // 帧号加一，裁剪空闲超过 maxIdleFrames 帧的对象
+        void EndFrame()
+        {
+            std::deque<Entry> removed;
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                m_state->frame++;
+                const uint32_t maxIdle = m_state->desc.maxIdleFrames;
+                auto& idle = m_state->idle;
+                while (maxIdle > 0 && !idle.empty() && m_state->frame - idle.front().releasedFrame > maxIdle)
+                {
+                    removed.push_back(std::move(idle.front()));
+                    idle.pop_front();
+                }
+                m_state->stats.trimmed += removed.size();
+            }
+            m_state->Dispose(removed);
+        }
+
+        // 裁剪空闲对象：只保留 keep 个最近归还的
+        void Trim(size_t keep = 0)
+        {
+            std::deque<Entry> removed;
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                removed = m_state->TrimLocked(keep);
+            }
+            m_state->Dispose(removed);
+        }
+
+        // 丢弃与 key 不同的空闲对象，用于尺寸或格式变化之后
+        void TrimOtherKeys(const Key& key)
+        {
+            std::deque<Entry> removed;
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                auto& idle = m_state->idle;
+                for (auto it = idle.begin(); it != idle.end();)
+                {
+                    if (!(it->key == key))
+                    {
+                        removed.push_back(std::move(*it));
+                        it = idle.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+                m_state->stats.trimmed += removed.size();
+            }
+            m_state->Dispose(removed);
+        }
+
+        Stats GetStats() const
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            Stats stats = m_state->stats;
+            stats.idleCount = m_state->idle.size();
+            return stats;
+        }
+
+    private:
+        struct Entry
+        {
+            Key key;
+            std::unique_ptr<T> object;
+            uint64_t releasedFrame = 0;     // 归还时的帧号
+        };
+
+        struct State
+        {
+            Factory factory;
+            Disposer disposer;
+            Desc desc;
+            mutable std::mutex mutex;
+            std::deque<Entry> idle;     // 队尾为最近归还
+            uint64_t frame = 0;
+            Stats stats;
+
+            void Release(const Key& key, std::unique_ptr<T> object)
+            {
+                std::deque<Entry> removed;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stats.liveCount--;
+                    idle.push_back(Entry{ key, std::move(object), frame });
+                    if (idle.size() > desc.highWatermark)
+                    {
+                        removed = TrimLocked(desc.lowWatermark);
+                    }
+                }
+                // removed 在锁外处理
+                Dispose(removed);
+            }
+
+            void Dispose(std::deque<Entry>& removed)
+            {
+                if (disposer)
+                {
+                    for (auto& entry : removed)
+                    {
+                        disposer(entry.key, std::move(entry.object));
+                    }
+                }
+                removed.clear();
+            }
+
+            std::deque<Entry> TrimLocked(size_t keep)
+            {
+                std::deque<Entry> removed;
+                while (idle.size() > keep)
+                {
+                    removed.push_back(std::move(idle.front()));
+                    idle.pop_front();
+                }
+                stats.trimmed += removed.size();
+                return removed;
+            }
+        };
+
+        std::shared_ptr<State> m_state;
+    };
+}
@@ -1,22 +1,21 @@
 ﻿#pragma once
 
 #include "GraphicsDevice.h"
-#include <d3d11.h>
-#include <d3dcompiler.h>
-#include <wrl/client.h>
+#include "ShaderCache.h"
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace lens::graphics 
 {
 
-    using Microsoft::WRL::ComPtr;
-
+    // 与后端无关的着色器接口，由 GraphicsDevice::CreateShader 创建，实现见 D3D11Shader 和 NullShader。
+    // HLSL 编译（D3DCompile 不需要 GPU）和磁盘缓存在这里，两个后端共用
     class Shader 
     {
     public:
-        Shader() = default;
-        ~Shader() = default;
+        virtual ~Shader() = default;
 
         // 从文件编译加载
         bool LoadVertexShader(GraphicsDevice* device, const std::string& filename, const char* entryPoint = "main");
@@ -24,33 +23,23 @@ namespace lens::graphics
         bool LoadComputeShader(GraphicsDevice* device, const std::string& filename, const char* entryPoint = "main");
 
         // 从已编译字节码加载
-        bool LoadVertexShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size);
-        bool LoadPixelShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size);
-        bool LoadComputeShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size);
-
-        // 直接访问
-        ID3D11VertexShader* GetVertexShader() const { return m_vertexShader.Get(); }
-        ID3D11PixelShader* GetPixelShader() const { return m_pixelShader.Get(); }
-        ID3D11ComputeShader* GetComputeShader() const { return m_computeShader.Get(); }
-        ID3D11InputLayout* GetInputLayout() const { return m_inputLayout.Get(); }
+        virtual bool LoadVertexShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) = 0;
+        virtual bool LoadPixelShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) = 0;
+        virtual bool LoadComputeShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) = 0;
 
         // 状态检查
-        bool HasVertexShader() const { return m_vertexShader != nullptr; }
-        bool HasPixelShader() const { return m_pixelShader != nullptr; }
-        bool HasComputeShader() const { return m_computeShader != nullptr; }
+        virtual bool HasVertexShader() const = 0;
+        virtual bool HasPixelShader() const = 0;
+        virtual bool HasComputeShader() const = 0;
 
-        // 输入布局设置
-        bool SetInputLayout(GraphicsDevice* device, const D3D11_INPUT_ELEMENT_DESC* layout, uint32_t layoutCount);
+        // 编译 HLSL 源码，结果缓存到磁盘，cache 为空时使用 ShaderCache::GetShared()。不支持 #include，
+        // 源码本身就是完整输入；sourceName 用于错误信息和调试信息，也参与缓存键。flags 为 D3DCOMPILE_* 标志
+        static bool CompileSource(std::string_view source, const char* sourceName, const char* entryPoint, const char* target,
+            uint32_t flags, std::vector<uint8_t>& bytecode, std::span<const ShaderCache::Define> defines = {},
+            ShaderCache* cache = nullptr);
 
     private:
-        ComPtr<ID3D11VertexShader> m_vertexShader;
-        ComPtr<ID3D11PixelShader> m_pixelShader;
-        ComPtr<ID3D11ComputeShader> m_computeShader;
-        ComPtr<ID3D11InputLayout> m_inputLayout;
-
-        std::vector<char> m_vertexShaderBytecode;
-
-        bool CompileShader(const std::string& filename, const char* entryPoint, const char* target, ComPtr<ID3DBlob>& blob);
+        static bool CompileShader(const std::string& filename, const char* entryPoint, const char* target, std::vector<uint8_t>& bytecode);
     };
 
-}
\ No newline at end of file
+}
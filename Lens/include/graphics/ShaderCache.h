@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lens::graphics
+{
+    // 按内容寻址的着色器字节码缓存：键是源码、源名称、入口、目标、宏定义、编译选项和编译器版本的哈希，
+    // 任何一项变化都会得到新的键，旧文件自然失效，不需要手动清理。
+    // 每个键一个文件 <目录>/<哈希>.shader，带魔数、版本、键校验和字节码 CRC，读取时逐项验证，
+    // 损坏或不匹配的文件会被删除并按未命中处理。只依赖标准库，不涉及 D3D
+    class ShaderCache
+    {
+    public:
+        struct Define
+        {
+            std::string name;
+            std::string value;
+        };
+
+        struct Key
+        {
+            uint64_t hash = 0;      // 决定文件名
+            uint32_t check = 0;     // 同一组输入的另一种哈希，写在文件里，防止文件名碰撞
+
+            bool operator==(const Key& other) const = default;
+        };
+
+        struct Desc
+        {
+            std::filesystem::path directory = "shadercache";
+            bool readOnly = false;      // 只读取不写入
+        };
+
+        struct Stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t rejected = 0;      // 验证失败被删除的文件
+            uint64_t stores = 0;
+            uint64_t bytesRead = 0;
+            uint64_t bytesWritten = 0;
+            double loadMs = 0.0;        // 命中时读取和验证的总耗时
+            double compileMs = 0.0;     // 未命中时 GetOrCompile 里编译的总耗时
+            double storeMs = 0.0;
+        };
+
+        using CompileFunction = std::function<bool(std::vector<uint8_t>& bytecode)>;
+
+        ShaderCache();
+        explicit ShaderCache(const Desc& desc);
+
+        static Key MakeKey(std::string_view source, std::string_view sourceName, std::string_view entryPoint,
+            std::string_view target, std::span<const Define> defines, uint32_t flags, uint32_t compilerVersion);
+
+        // 命中且验证通过时返回 true
+        bool Load(const Key& key, std::vector<uint8_t>& bytecode);
+        // 先写临时文件再改名，多个进程同时写同一个键也不会读到半个文件
+        bool Store(const Key& key, const uint8_t* data, size_t size);
+
+        // 先查缓存，未命中时调用 compile 并写回；编译失败时返回 false 且不写入
+        bool GetOrCompile(const Key& key, std::vector<uint8_t>& bytecode, const CompileFunction& compile);
+
+        std::filesystem::path GetPath(const Key& key) const;
+        Stats GetStats() const;
+
+        // 进程共享的缓存，位于当前目录下的 shadercache
+        static ShaderCache& GetShared();
+
+    private:
+        Desc m_desc;
+
+        mutable std::mutex m_mutex;
+        Stats m_stats;
+    };
+}
@@ -1,8 +1,7 @@
 ﻿#pragma once
 
 #include "GraphicsDevice.h"
-#include <d3d11.h>
-#include <wrl/client.h>
+#include "ImageEncoder.h"
 
 namespace lens::graphics 
 {
@@ -13,6 +12,8 @@ namespace lens::graphics
         Texture3D
     };
 
+    // 与后端无关的纹理接口，由 GraphicsDevice::CreateTexture 创建，实现见 D3D11Texture 和 NullTexture。
+    // 各方法的 device 须是创建它的设备
     class Texture 
     {
     public:
@@ -31,19 +32,18 @@ namespace lens::graphics
             bool bindUnorderedAccess = false;
         };
 
-        Texture() = default;
-        ~Texture() = default;
+        virtual ~Texture() = default;
 
         // 创建方法
-        bool Create(GraphicsDevice* device, const Desc& desc);
-        bool CreateFromMemory(GraphicsDevice* device, const Desc& desc, const void* data);
-        bool CreateFromD3DTexture(GraphicsDevice* device, ID3D11Texture2D* texture);
+        virtual bool Create(GraphicsDevice* device, const Desc& desc) = 0;
+        virtual bool CreateFromMemory(GraphicsDevice* device, const Desc& desc, const void* data) = 0;
 
-        // 直接访问 D3D11 资源
-        ID3D11Texture2D* GetD3DTexture() const { return m_texture.Get(); }
-        ID3D11ShaderResourceView* GetSRV() const { return m_srv.Get(); }
-        ID3D11RenderTargetView* GetRTV() const { return m_rtv.Get(); }
-        ID3D11UnorderedAccessView* GetUAV() const { return m_uav.Get(); }
+        // 从同一设备上同格式的纹理复制内容；源纹理更大时只复制左上角与本纹理同尺寸的区域
+        virtual bool CopyFrom(GraphicsDevice* device, const Texture& source) = 0;
+
+        // 原生着色器资源视图（D3D11 为 ID3D11ShaderResourceView*），
+        // 给 ImGui 这类只认原生句柄的库使用；没有视图时返回 nullptr
+        virtual void* GetNativeView() const = 0;
 
         // 属性访问
         const Desc& GetDesc() const { return m_desc; }
@@ -52,23 +52,21 @@ namespace lens::graphics
         TextureFormat GetFormat() const { return m_desc.format; }
 
         // 数据操作
-        void UpdateData(GraphicsDevice* device, const void* data, size_t size, uint32_t mipLevel = 0);
-        D3D11_MAPPED_SUBRESOURCE Map(GraphicsDevice* device, uint32_t mipLevel = 0, D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD);
-        void Unmap(GraphicsDevice* device, uint32_t mipLevel = 0);
+        virtual void UpdateData(GraphicsDevice* device, const void* data, size_t size, uint32_t mipLevel = 0) = 0;
+        // 只更新一个矩形区域，data 指向该区域左上角像素，rowPitch 为源数据的行跨度
+        virtual void UpdateRegion(GraphicsDevice* device, const void* data, uint32_t rowPitch,
+            uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+        virtual MappedData Map(GraphicsDevice* device, uint32_t mipLevel = 0, MapMode mode = MapMode::WriteDiscard) = 0;
+        virtual void Unmap(GraphicsDevice* device, uint32_t mipLevel = 0) = 0;
 
         // Mipmap 生成
-        void GenerateMipmaps(GraphicsDevice* device);
-
-        // 保存到文件
-        bool SaveToFile(GraphicsDevice* device, const char* filename);
+        virtual void GenerateMipmaps(GraphicsDevice* device) = 0;
 
-    private:
-        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_texture;
-        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_srv;
-        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_rtv;
-        Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> m_uav;
+        // 保存到文件，BGRA8/RGBA8 纹理可存为 .png/.qoi/.bmp，按扩展名或 options.codec 选择编码器
+        virtual bool SaveToFile(GraphicsDevice* device, const char* filename, const ImageEncodeOptions& options = {}) = 0;
 
+    protected:
         Desc m_desc{};
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include "graphics/GraphicsDevice.h"
+#include "graphics/ResourcePool.h"
+#include "graphics/Texture.h"
+
+namespace lens::graphics
+{
+    struct TextureKey
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        TextureFormat format = TextureFormat::BGRA8_UNorm;
+
+        bool operator==(const TextureKey& other) const = default;
+    };
+
+    // 捕获帧纹理池：按尺寸和格式复用只读着色器资源纹理，
+    // 避免每帧 CreateTexture2D / CreateShaderResourceView
+    class TexturePool
+    {
+    public:
+        using Pool = ResourcePool<Texture, TextureKey>;
+
+        TexturePool(GraphicsDevice* device, const Pool::Desc& desc = {});
+
+        std::shared_ptr<Texture> Acquire(uint32_t width, uint32_t height, TextureFormat format);
+
+        // 尺寸变化后丢弃旧尺寸的空闲纹理
+        void TrimOtherSizes(uint32_t width, uint32_t height, TextureFormat format);
+        void Trim(size_t keep = 0) { m_pool.Trim(keep); }
+        // 每帧调用一次，长时间没用到的空闲纹理被释放
+        void EndFrame() { m_pool.EndFrame(); }
+
+        Pool::Stats GetStats() const { return m_pool.GetStats(); }
+
+    private:
+        GraphicsDevice* m_device;
+        Pool m_pool;
+    };
+}
@@ -0,0 +1,130 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+
+namespace lens::graphics
+{
+    // 上传环用的设备操作：一块 CPU 可写、GPU 可读的缓冲区，以及按提交顺序完成的围栏。
+    // 环的分配和回收逻辑只依赖这个接口，可以换成假设备单独测试
+    class IUploadDevice
+    {
+    public:
+        virtual ~IUploadDevice() = default;
+
+        virtual bool Create(uint64_t capacity) = 0;
+        // discard 为 true 时丢弃整块旧内容（WRITE_DISCARD），否则承诺不写 GPU 还在用的区域（NO_OVERWRITE）
+        virtual uint8_t* Map(bool discard) = 0;
+        virtual void Unmap() = 0;
+        // 在命令流中插入围栏，GPU 执行到这里之后 GetCompletedFence 返回不小于 value 的值
+        virtual void SignalFence(uint64_t value) = 0;
+        // wait 为 true 时允许刷新命令缓冲，用于空间不足时等待
+        virtual uint64_t GetCompletedFence(bool wait) = 0;
+    };
+
+    // 每帧的线性上传分配器：常量等小块数据从一块大的动态缓冲区里按顺序切出，
+    // 映射一次写很多块，除第一次外都用 NO_OVERWRITE 映射，不再每次更新都 Map(WRITE_DISCARD)。
+    // 每帧结束时插入围栏，GPU 完成该帧后它用过的区域才会被回收复用；空间不足时等待最早的帧完成。
+    //
+    //   [tail ... 在途的帧 ... | 当前帧 | head ... 空闲 ...]   分配不跨越末尾，放不下时从开头继续
+    //
+    // 所有方法都在渲染线程调用
+    class UploadRing
+    {
+    public:
+        struct Desc
+        {
+            uint64_t capacity = 1ull << 20;
+            uint32_t alignment = 256;       // 常量缓冲区按偏移绑定时须为 256 字节（16 个常量）的倍数
+        };
+
+        struct Allocation
+        {
+            uint8_t* data = nullptr;        // 只在映射期间有效，Unmap 或 EndFrame 之后不能再写
+            uint64_t offset = 0;            // 在缓冲区中的字节偏移
+            uint32_t size = 0;              // 对齐后的大小
+
+            explicit operator bool() const { return data != nullptr; }
+        };
+
+        struct Stats
+        {
+            uint64_t allocations = 0;
+            uint64_t bytesAllocated = 0;    // 按对齐后的大小计
+            uint64_t maps = 0;
+            uint64_t discards = 0;
+            uint64_t frames = 0;
+            uint64_t stalls = 0;            // 空间不足、等待 GPU 完成旧帧的次数
+            uint64_t failed = 0;            // 等到所有旧帧完成仍放不下，即当前帧用量超过容量
+            uint64_t wrapWaste = 0;         // 绕回开头时末尾跳过的字节
+            uint64_t usedBytes = 0;         // 还没有回收的字节，含跳过的部分
+            uint64_t peakUsedBytes = 0;
+            uint32_t framesInFlight = 0;
+        };
+
+        explicit UploadRing(std::unique_ptr<IUploadDevice> device);
+        UploadRing(std::unique_ptr<IUploadDevice> device, const Desc& desc);
+        ~UploadRing();
+
+        UploadRing(const UploadRing&) = delete;
+        UploadRing& operator=(const UploadRing&) = delete;
+
+        bool IsValid() const { return m_valid; }
+
+        // 每帧开始时调用，回收 GPU 已经完成的帧
+        void BeginFrame();
+
+        // 放不下时返回空分配
+        Allocation Allocate(uint32_t size);
+
+        template<typename T>
+        Allocation Push(const T& value)
+        {
+            Allocation allocation = Allocate(static_cast<uint32_t>(sizeof(T)));
+            if (allocation)
+            {
+                memcpy(allocation.data, &value, sizeof(T));
+            }
+            return allocation;
+        }
+
+        // 绘制命令使用分配出的数据之前调用；之后再分配会重新映射
+        void Unmap();
+
+        // 每帧提交完绘制命令后调用：解除映射并插入围栏
+        void EndFrame();
+
+        uint64_t GetCapacity() const { return m_desc.capacity; }
+        IUploadDevice* GetDevice() const { return m_device.get(); }
+        Stats GetStats() const;
+
+    private:
+        struct FrameRecord
+        {
+            uint64_t fence;
+            uint64_t end;       // 该帧结束时的 head
+            uint64_t bytes;     // 该帧占用的字节，含绕回跳过的部分
+        };
+
+        bool Reserve(uint64_t size, uint64_t& offset);
+        void Retire(uint64_t completedFence);
+
+        std::unique_ptr<IUploadDevice> m_device;
+        Desc m_desc;
+        bool m_valid = false;
+
+        uint8_t* m_mapped = nullptr;
+        bool m_needDiscard = true;      // 新建的缓冲区第一次必须以 DISCARD 映射
+
+        uint64_t m_head = 0;            // 下一次分配的位置
+        uint64_t m_tail = 0;            // 最早的在途帧的起点
+        uint64_t m_used = 0;
+        uint64_t m_frameBytes = 0;      // 当前帧已占用的字节
+        uint64_t m_nextFence = 1;
+        std::deque<FrameRecord> m_frames;
+
+        Stats m_stats;
+    };
+}
@@ -1,7 +1,14 @@
 ﻿#pragma once
 
 #include "UIPanel.h"
-#include "capturer/WGCCapturer.h"
+#include "capturer/FrameDiff.h"
+#include "capturer/ICaptureSource.h"
+#include "capturer/MjpegRecorder.h"
+#include "capturer/RawRecording.h"
+#include "capturer/ReplayBuffer.h"
+#include "capturer/SnapshotWriter.h"
+#include "graphics/ReadbackRing.h"
+#include "graphics/Resampler.h"
 
 namespace lens
 {
@@ -10,14 +17,57 @@ namespace lens
     {
     private:
         bool m_visible = true;
-        capturer::WGCCapturer* m_capturer;
-        std::shared_ptr<lens::graphics::Texture> m_lastFrame; // Cache the latest frame
+        capturer::ICaptureSource* m_capturer;
+        capturer::Frame m_lastFrame; // Cache the latest frame
+        bool m_lastFramePresented = false;
+
+        // 开启后每个新帧都提交回读，供 CPU 侧分析
+        lens::graphics::ReadbackRing* m_readback = nullptr;
+        bool m_readbackEnabled = false;
+
+        // 相邻两次回读之间的变化块统计
+        capturer::FrameDiff m_frameDiff{ 16 };
+        capturer::FrameDiff::Result m_diffResult;
+        std::shared_ptr<const lens::graphics::CpuImage> m_lastReadback;
+        double m_diffMs = 0.0;
+
+        // 回读后在 CPU 上按显示尺寸滤波缩小，避免 GPU 对整帧点采样产生锯齿
+        lens::graphics::GraphicsDevice* m_device = nullptr;
+        bool m_filteredPreview = false;
+        int m_previewFilter = static_cast<int>(lens::graphics::ResampleFilter::Bilinear);
+        uint32_t m_previewWidth = 0;
+        uint32_t m_previewHeight = 0;
+        lens::graphics::Resampler m_resampler;
+        lens::graphics::CpuImage m_previewImage;
+        std::unique_ptr<lens::graphics::Texture> m_previewTexture;
+        double m_previewMs = 0.0;
+
+        // 截图交给后台写入，连拍时每个新帧提交一张
+        capturer::SnapshotWriter* m_snapshots = nullptr;
+        uint32_t m_burstRemaining = 0;
+
+        // 录制回读到的帧，写盘在录制器的后台线程
+        capturer::RawRecordingWriter m_recorder;
+        bool m_recording = false;
+
+        // 有损录制为 AVI，编码在录制器的后台线程
+        capturer::MjpegRecorder m_videoRecorder;
+        bool m_recordingVideo = false;
+
+        // 即时回放：开启时分配固定大小的缓存，按需保存最近一段
+        std::unique_ptr<capturer::ReplayBuffer> m_replay;
+
+        void OnReadback(std::shared_ptr<const lens::graphics::CpuImage> image, const capturer::FrameDescriptor& descriptor);
+        void UpdatePreview(const lens::graphics::CpuImage& image);
 
     public:
         CapturePanel();
         virtual ~CapturePanel() = default;
 
-        void SetCapturer(capturer::WGCCapturer* capturer) { m_capturer = capturer; }
+        void SetCapturer(capturer::ICaptureSource* capturer) { m_capturer = capturer; }
+        void SetReadback(lens::graphics::ReadbackRing* readback) { m_readback = readback; }
+        void SetDevice(lens::graphics::GraphicsDevice* device) { m_device = device; }
+        void SetSnapshotWriter(capturer::SnapshotWriter* snapshots) { m_snapshots = snapshots; }
 
         const char* GetName() const override { return "Capture"; }
         bool IsVisible() const override { return m_visible; }
@@ -11,7 +11,7 @@ namespace lens
     // 前向声明
     namespace capturer
     {
-        class WGCCapturer;
+        class ICaptureSource;
     }
 
     class UIManager
@@ -24,14 +24,14 @@ namespace lens
         // 注册所有默认面板
         void RegisterDefaultPanels();
         void RegisterCorePanels();
-        void RegisterCapturePanels(capturer::WGCCapturer* capturer);
+        void RegisterCapturePanels(capturer::ICaptureSource* capturer);
 
     public:
         UIManager() = default;
         ~UIManager() = default;
 
         // 统一初始化所有面板（推荐使用）
-        void InitializeAllPanels(capturer::WGCCapturer* capturer = nullptr);
+        void InitializeAllPanels(capturer::ICaptureSource* capturer = nullptr);
 
         // 手动添加面板的方法
         template<typename T, typename... Args>
@@ -0,0 +1,25 @@
+﻿#pragma once
+
+#include <string>
+
+namespace lens::tests
+{
+    // 命令行 --test [名称] 进入自检模式，不创建窗口，结果写入日志；不带名称时运行全部。
+    // 只覆盖不依赖 GPU 的逻辑（GPU 相关部分通过假设备或空后端测试）。返回失败的测试数
+    int RunTests(const std::string& name);
+
+    // 检查失败时记录表达式和位置，测试继续执行
+    void ReportFailure(const char* expression, const char* file, int line);
+
+    // 各项测试
+    void TestFrameMailbox();
+    void TestResourcePool();
+    void TestFramePacer();
+    void TestReadbackRing();
+    void TestFrameScheduler();
+    void TestShaderCache();
+    void TestUploadRing();
+}
+
+#define LENS_CHECK(expr) \
+    do { if (!(expr)) ::lens::tests::ReportFailure(#expr, __FILE__, __LINE__); } while (0)
@@ -5,11 +5,33 @@
 #include "gui/DemoPanel.h"
 #include "gui/DebugPanel.h"
 #include "gui/CapturePanel.h"
+#include "capturer/SyntheticCaptureSource.h"
+#include "capturer/FileReplaySource.h"
+#include "graphics/CpuReadbackDevice.h"
+#include "graphics/CpuUploadDevice.h"
 #include "Log.h"
+#include <chrono>
+#include <thread>
 
 
 namespace lens
 {
+    namespace
+    {
+        // 有回读在途时的轮询间隔，GPU 完成复制不会产生可等待的事件
+        constexpr auto kReadbackPollInterval = std::chrono::milliseconds(4);
+
+        DWORD ToWaitMilliseconds(FrameScheduler::Clock::duration timeout)
+        {
+            if (timeout == FrameScheduler::Clock::duration::max())
+                return INFINITE;
+
+            // 向上取整，避免提前醒来空转一轮
+            const auto ms = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+            return static_cast<DWORD>((std::min<long long>)(ms, INFINITE - 1));
+        }
+    }
+
     Application::Application(HINSTANCE hInstance, int mCmdShow,
         const wchar_t* className, const wchar_t* title)
         : m_hInstance(hInstance), 
@@ -23,25 +45,38 @@ namespace lens
 
     Application::~Application()
     {
+        // 面板关闭时还会 Flush 回读和截图，必须先于它们销毁
         if (m_imgui) {
             delete m_imgui;
             m_imgui = nullptr;
         }
-        if (m_graphicsDevice) {
-            delete m_graphicsDevice;
-            m_graphicsDevice = nullptr;
-        }
+        m_snapshots.reset();
+        m_readback.reset();
+        m_uploads.reset();
+        // 捕获源的纹理池会把裁剪的纹理交给设备的延迟销毁队列
+        m_capturer.reset();
+        m_captureShader.reset();
+        m_graphicsDevice.reset();
     }
 
     void Application::Initialize()
     {
+        if (m_headless)
+        {
+            if (!InitializeHeadless())
+            {
+                LOG_ERROR("Failed to initialize headless pipeline");
+            }
+            return;
+        }
+
         if (!CreateLenWindow(800, 600))
         {
             LOG_ERROR("Failed to create window");
             return;
         }
         // 初始化device
-        m_graphicsDevice = new graphics::GraphicsDevice();
+        m_graphicsDevice = graphics::CreateGraphicsDevice(graphics::GraphicsBackend::D3D11);
         graphics::GraphicsDevice::Desc deviceDesc{};
         {
             deviceDesc.windowHandle = m_hwnd;
@@ -56,9 +91,14 @@ namespace lens
             return;
         }
 
+        m_readback = std::make_unique<graphics::ReadbackRing>(graphics::CreateReadbackDevice(m_graphicsDevice.get()));
+        m_snapshots = std::make_unique<capturer::SnapshotWriter>(capturer::SnapshotWriter::Desc{},
+            graphics::CreateReadbackDevice(m_graphicsDevice.get()));
+        CreateUploadRing();
+
         // 初始化imgui
         m_imgui = new ImguiManager();
-        m_imgui->Initialize(m_hwnd, m_graphicsDevice->GetDevice(), m_graphicsDevice->GetContext());
+        m_imgui->Initialize(m_hwnd, GetD3D11Device()->GetDevice(), GetD3D11Device()->GetContext());
 
         // 置 ImGui 的 DisplaySize
         ImGuiIO& io = ImGui::GetIO();
@@ -87,67 +127,197 @@ namespace lens
         }
 
         // 初始化Capturer，后续需要修改
-        m_capturer = std::make_unique<capturer::WGCCapturer>(m_graphicsDevice);
-        capturer::WGCCapturer::CaptureDesc captureDesc{};
-        captureDesc.frameRate = 60;
-        captureDesc.format = graphics::TextureFormat::BGRA8_UNorm;
-        captureDesc.captureCursor = true;
-        captureDesc.captureBorder = true;
+        m_capturer = CreateCaptureSource();
+        m_frameEvent.attach(CreateEventW(nullptr, FALSE, FALSE, nullptr));
+        if (m_frameEvent)
+        {
+            m_capturer->SetFrameListener([event = m_frameEvent.get()] { SetEvent(event); });
+        }
 
-        if (!m_capturer->Initialize(captureDesc))
+        if (!m_capturer->Initialize(GetCaptureDesc()))
         {
             LOG_ERROR("Failed to initialize capturer");
         }
         else
         {
-            LOG_INFO("Capturer initialized successfully");
+            LOG_INFO("Capturer initialized successfully: {}", m_capturer->GetName());
 
             // Capturer 初始化成功后，注册 CapturePanel
             auto* capturePanel = uiManager->AddPanel<CapturePanel>();
             if (capturePanel)
             {
                 capturePanel->SetCapturer(m_capturer.get());
+                capturePanel->SetReadback(m_readback.get());
+                capturePanel->SetSnapshotWriter(m_snapshots.get());
+                capturePanel->SetDevice(m_graphicsDevice.get());
                 capturePanel->SetVisible(true);
                 LOG_INFO("CapturePanel registered and configured");
             }
 
-            auto windows = capturer::WGCCapturer::EnumerateWindows();
-            LOG_INFO("Found {} windows", windows.size());
-
-            for (size_t i = 0; i < windows.size() && i < 10; ++i)
+            bool started = false;
+            if (m_captureBackend == CaptureBackend::WGC)
             {
-                std::wstring title(windows[i].windowTitle);
-                LOG_INFO("  [{}] {}", i, winrt::to_string(title));
+                started = StartWindowCapture(static_cast<capturer::WGCCapturer*>(m_capturer.get()));
             }
-
-            if (!windows.empty())
+            else
             {
-                HWND captureWindow = nullptr;
-                for (size_t i = 0; i < windows.size(); ++i)
-                {
-                    if (windows[i].windowHandle != m_hwnd)
-                    {
-                        captureWindow = windows[i].windowHandle;
-                        LOG_INFO("Auto-capturing window [{}]: {}", i, winrt::to_string(windows[i].windowTitle));
-                        break;
-                    }
-                }
+                started = m_capturer->StartCapture();
+            }
 
-                if (captureWindow && m_capturer->StartCapture(captureWindow))
-                {
-                    LOG_INFO("Capture started successfully");
-                }
+            if (started)
+            {
+                LOG_INFO("Capture started successfully");
             }
         }
 
         LOG_INFO("Application initialized successfully ");
     }
 
+    bool Application::InitializeHeadless()
+    {
+        // 没有窗口可捕获，WGC 退回合成源
+        if (m_captureBackend == CaptureBackend::WGC)
+        {
+            LOG_WARN("WGC capture is not available in headless mode, using synthetic source");
+            m_captureBackend = CaptureBackend::Synthetic;
+        }
+
+        this->width = 800;
+        this->height = 600;
+
+        m_graphicsDevice = graphics::CreateGraphicsDevice(graphics::GraphicsBackend::Null);
+        graphics::GraphicsDevice::Desc deviceDesc{};
+        {
+            deviceDesc.width = this->width;
+            deviceDesc.height = this->height;
+        }
+
+        if (!m_graphicsDevice->Initialize(deviceDesc))
+        {
+            LOG_ERROR("Failed to initialize graphics device");
+            return false;
+        }
+
+        m_readback = std::make_unique<graphics::ReadbackRing>(graphics::CreateReadbackDevice(m_graphicsDevice.get()));
+        m_snapshots = std::make_unique<capturer::SnapshotWriter>(capturer::SnapshotWriter::Desc{},
+            graphics::CreateReadbackDevice(m_graphicsDevice.get()));
+        CreateUploadRing();
+
+        // 空后端下着色器仍会编译，能检查 HLSL 是否有效
+        if (!CreateCaptureShaders())
+        {
+            LOG_ERROR("Failed to create capture shaders");
+        }
+
+        m_capturer = CreateCaptureSource();
+        if (!m_capturer->Initialize(GetCaptureDesc()) || !m_capturer->StartCapture())
+        {
+            LOG_ERROR("Failed to start capturer");
+            return false;
+        }
+
+        LOG_INFO("Headless pipeline initialized: {}, {} frames", m_capturer->GetName(), m_headlessFrames);
+        return true;
+    }
+
+    capturer::ICaptureSource::CaptureDesc Application::GetCaptureDesc() const
+    {
+        capturer::ICaptureSource::CaptureDesc captureDesc{};
+        captureDesc.frameRate = 60;
+        captureDesc.format = graphics::TextureFormat::BGRA8_UNorm;
+        captureDesc.captureCursor = true;
+        captureDesc.captureBorder = true;
+        captureDesc.freeThreaded = true;
+        captureDesc.dedup = m_frameDedup;
+        return captureDesc;
+    }
+
+    void Application::SetCaptureBackend(CaptureBackend backend, const std::filesystem::path& replayPath)
+    {
+        m_captureBackend = backend;
+        m_replayPath = replayPath;
+    }
+
+    std::unique_ptr<capturer::ICaptureSource> Application::CreateCaptureSource()
+    {
+        switch (m_captureBackend)
+        {
+        case CaptureBackend::Synthetic:
+        {
+            capturer::SyntheticCaptureSource::SyntheticDesc synthDesc{};
+            return std::make_unique<capturer::SyntheticCaptureSource>(m_graphicsDevice.get(), synthDesc);
+        }
+        case CaptureBackend::FileReplay:
+        {
+            capturer::FileReplaySource::ReplayDesc replayDesc{};
+            replayDesc.path = m_replayPath;
+            return std::make_unique<capturer::FileReplaySource>(m_graphicsDevice.get(), replayDesc);
+        }
+        case CaptureBackend::WGC:
+        default:
+            // 无窗口模式在这之前已经退回合成源，这里一定是 D3D11 设备
+            return std::make_unique<capturer::WGCCapturer>(GetD3D11Device());
+        }
+    }
+
+    // 自动捕获第一个不是本程序的窗口
+    bool Application::StartWindowCapture(capturer::WGCCapturer* wgcCapturer)
+    {
+        auto windows = capturer::WGCCapturer::EnumerateWindows();
+        LOG_INFO("Found {} windows", windows.size());
+
+        for (size_t i = 0; i < windows.size() && i < 10; ++i)
+        {
+            std::wstring title(windows[i].windowTitle);
+            LOG_INFO("  [{}] {}", i, winrt::to_string(title));
+        }
+
+        for (size_t i = 0; i < windows.size(); ++i)
+        {
+            if (windows[i].windowHandle != m_hwnd)
+            {
+                LOG_INFO("Auto-capturing window [{}]: {}", i, winrt::to_string(windows[i].windowTitle));
+                return wgcCapturer->StartCapture(windows[i].windowHandle);
+            }
+        }
+
+        return false;
+    }
+
     int Application::Run()
     {
+        if (m_headless)
+        {
+            return RunHeadless();
+        }
+
+        m_scheduler.Configure(m_schedulerDesc);
+
         MSG msg = { 0 };
         while (!isExit)
         {
+            // 没有消息、新帧和到期的定时器时阻塞在这里，而不是每个 vblank 都重绘一次
+            auto timeout = m_scheduler.GetWaitTimeout(FrameScheduler::Clock::now());
+            if (m_readback->GetInFlightCount() > 0 || m_snapshots->GetStats().inFlight > 0)
+            {
+                timeout = (std::min)(timeout, std::chrono::duration_cast<FrameScheduler::Clock::duration>(kReadbackPollInterval));
+            }
+            // 空闲时帧号不前进，还有待销毁的资源就按 maxAge 醒来回收
+            auto& releaseQueue = m_graphicsDevice->GetReleaseQueue();
+            if (releaseQueue.GetDesc().maxAge.count() > 0 && releaseQueue.GetStats().pendingCount > 0)
+            {
+                timeout = (std::min)(timeout, std::chrono::duration_cast<FrameScheduler::Clock::duration>(releaseQueue.GetDesc().maxAge));
+            }
+
+            HANDLE frameEvent = m_frameEvent.get();
+            const DWORD waitResult = MsgWaitForMultipleObjectsEx(frameEvent ? 1 : 0, frameEvent ? &frameEvent : nullptr,
+                ToWaitMilliseconds(timeout), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            if ((frameEvent && waitResult == WAIT_OBJECT_0) || (m_capturer && m_capturer->HasNewFrame()))
+            {
+                m_scheduler.Invalidate(FrameScheduler::Reason::NewFrame);
+            }
+
+            bool hadMessage = false;
             while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
             {
                 if (msg.message == WM_QUIT)
@@ -158,12 +328,33 @@ namespace lens
                 TranslateMessage(&msg);
                 DispatchMessage(&msg);
                 m_imgui->HandleMessage(msg);
+                hadMessage = true;
             }
 
             if (isExit)
                 break;
+            if (hadMessage)
+            {
+                m_scheduler.Invalidate(FrameScheduler::Reason::Input);
+            }
+
+            // 交付上一帧之前提交、GPU 已完成的回读，交付的结果会更新预览
+            if (m_readback->Poll() > 0)
+            {
+                m_scheduler.Invalidate(FrameScheduler::Reason::NewFrame);
+            }
+            m_snapshots->Poll();
+            releaseQueue.Poll();
+
+            const auto now = FrameScheduler::Clock::now();
+            if (!m_scheduler.ShouldRedraw(now))
+                continue;
 
             m_graphicsDevice->BeginFrame();
+            if (m_uploads)
+            {
+                m_uploads->BeginFrame();
+            }
 
             m_imgui->BeginFrame();
 
@@ -172,12 +363,140 @@ namespace lens
             m_imgui->EndFrame();
 
             m_graphicsDevice->EndFrame();
+            if (m_uploads)
+            {
+                m_uploads->EndFrame();
+            }
             m_graphicsDevice->Present(true);
+            releaseQueue.EndFrame();
+            m_scheduler.OnRedrawn(now);
+
+            // 文本框光标闪烁需要持续刷新
+            if (ImGui::GetIO().WantTextInput)
+            {
+                m_scheduler.ScheduleAt(now + std::chrono::milliseconds(100));
+            }
         }
 
+        const auto& schedulerStats = m_scheduler.GetStats();
+        LOG_INFO("Scheduler: {} redraws in {} wakeups ({} idle); input {}, new frame {}, timer {}, min refresh {}, settle {}",
+            schedulerStats.redraws, schedulerStats.wakeups, schedulerStats.idleWakeups, schedulerStats.byInput,
+            schedulerStats.byNewFrame, schedulerStats.byTimer, schedulerStats.byMinRefresh, schedulerStats.bySettle);
+        LogPipelineStats();
+
         return static_cast<int>(msg.wParam);
     }
 
+    int Application::RunHeadless()
+    {
+        using Clock = std::chrono::steady_clock;
+        // 每隔这么多帧保存一张截图，覆盖编码和写盘路径
+        constexpr uint32_t kSnapshotInterval = 60;
+
+        if (!m_capturer || !m_capturer->IsCapturing())
+        {
+            return 1;
+        }
+
+        uint32_t frames = 0;
+        uint64_t readbackFrames = 0;
+        double totalMs = 0.0;
+        double uploadMs = 0.0;
+        double maxMs = 0.0;
+        auto lastFrame = Clock::now();
+        while (frames < m_headlessFrames)
+        {
+            // 等待新帧的时间不计入 CPU 开销
+            if (!m_capturer->HasNewFrame())
+            {
+                if (Clock::now() - lastFrame > std::chrono::seconds(2))
+                {
+                    LOG_WARN("Headless run: no new frame for 2 s, stopping");
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+
+            const auto start = Clock::now();
+            m_readback->Poll();
+            m_snapshots->Poll();
+
+            // CPU 源在这里上传到纹理，也就是窗口模式下预览前的那一步
+            capturer::Frame frame = m_capturer->GetLatestFrame();
+            const auto uploaded = Clock::now();
+            if (frame.texture)
+            {
+                m_readback->Submit(frame.texture.get(),
+                    [&readbackFrames](std::shared_ptr<const graphics::CpuImage>) { readbackFrames++; });
+                if (frames % kSnapshotInterval == 0)
+                {
+                    m_snapshots->Submit(frame, capturer::SnapshotWriter::MakeSnapshotPath("snapshots"));
+                }
+                frames++;
+            }
+
+            m_graphicsDevice->GetReleaseQueue().EndFrame();
+
+            lastFrame = Clock::now();
+            const double frameMs = std::chrono::duration<double, std::milli>(lastFrame - start).count();
+            uploadMs += std::chrono::duration<double, std::milli>(uploaded - start).count();
+            totalMs += frameMs;
+            maxMs = (std::max)(maxMs, frameMs);
+        }
+
+        m_readback->Flush();
+        m_snapshots->Flush();
+        m_capturer->StopCapture();
+
+        if (frames > 0)
+        {
+            LOG_INFO("Headless run: {} frames, {} read back, CPU per frame avg {:.3f} ms (poll + upload {:.3f} ms), max {:.3f} ms",
+                frames, readbackFrames, totalMs / frames, uploadMs / frames, maxMs);
+        }
+        LogPipelineStats();
+        return frames > 0 ? 0 : 1;
+    }
+
+    void Application::LogPipelineStats() const
+    {
+        auto readbackStats = m_readback->GetStats();
+        if (readbackStats.submitted > 0)
+        {
+            LOG_INFO("Readback: {} frames, {} dropped, {:.1f} MB/s, latency avg {:.2f} ms max {:.2f} ms, read {:.2f} ms, stall {:.2f} ms",
+                readbackStats.completed, readbackStats.dropped, readbackStats.throughputMBps,
+                readbackStats.avgLatencyMs, readbackStats.maxLatencyMs, readbackStats.readMs, readbackStats.stallMs);
+        }
+
+        if (m_uploads)
+        {
+            auto uploadStats = m_uploads->GetStats();
+            if (uploadStats.allocations > 0)
+            {
+                LOG_INFO("Uploads: {} allocations, {:.1f} KB in {} frames, {} maps ({} discard), {} stalls, {} failed, peak {:.1f} KB",
+                    uploadStats.allocations, uploadStats.bytesAllocated / 1024.0, uploadStats.frames, uploadStats.maps,
+                    uploadStats.discards, uploadStats.stalls, uploadStats.failed, uploadStats.peakUsedBytes / 1024.0);
+            }
+        }
+
+        auto releaseStats = m_graphicsDevice->GetReleaseQueue().GetStats();
+        if (releaseStats.retired > 0)
+        {
+            LOG_INFO("Deferred release: {} released ({:.1f} MB) in {} batches, {} pending ({:.1f} MB, peak {:.1f} MB), release {:.2f} ms max {:.2f} ms",
+                releaseStats.released, releaseStats.releasedBytes / (1024.0 * 1024.0), releaseStats.batches,
+                releaseStats.pendingCount, releaseStats.pendingBytes / (1024.0 * 1024.0), releaseStats.peakPendingBytes / (1024.0 * 1024.0),
+                releaseStats.releaseMs, releaseStats.maxBatchMs);
+        }
+
+        auto snapshotStats = m_snapshots->GetStats();
+        if (snapshotStats.submitted > 0)
+        {
+            LOG_INFO("Snapshots: {} saved, {} dropped, {} failed, {:.1f} MB, encode avg {:.1f} ms, write avg {:.1f} ms",
+                snapshotStats.saved, snapshotStats.dropped, snapshotStats.failed, snapshotStats.bytesWritten / (1024.0 * 1024.0),
+                snapshotStats.avgEncodeMs, snapshotStats.avgWriteMs);
+        }
+    }
+
     // 窗口回调，算是标准写法，会转发到类内的函数处理
     LRESULT CALLBACK Application::WindowProcProxy(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     {
@@ -293,6 +612,9 @@ namespace lens
     // 临时使用的shader
     bool Application::CreateCaptureShaders()
     {
+        const auto start = std::chrono::steady_clock::now();
+        const auto cacheBefore = graphics::ShaderCache::GetShared().GetStats();
+
         // Simple fullscreen triangle shaders
         const char* vsCode = R"(
             float4 main(uint vertexID : SV_VertexID) : SV_Position
@@ -328,85 +650,63 @@ namespace lens
         )";
 
         // Compile vertex shader
-        Microsoft::WRL::ComPtr<ID3DBlob> vsBlob;
-        if (!CompileShader(vsCode, "main", "vs_5_0", vsBlob))
+        std::vector<uint8_t> vsBytecode;
+        if (!graphics::Shader::CompileSource(vsCode, "CaptureVS", "main", "vs_5_0", D3DCOMPILE_ENABLE_STRICTNESS, vsBytecode))
         {
             LOG_ERROR("Failed to compile vertex shader");
             return false;
         }
 
-        if (!m_captureShader.LoadVertexShaderFromBytecode(m_graphicsDevice, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize()))
+        m_captureShader = m_graphicsDevice->CreateShader();
+        if (!m_captureShader->LoadVertexShaderFromBytecode(m_graphicsDevice.get(), vsBytecode.data(), vsBytecode.size()))
         {
             LOG_ERROR("Failed to load vertex shader from bytecode");
             return false;
         }
 
         // Compile pixel shader
-        Microsoft::WRL::ComPtr<ID3DBlob> psBlob;
-        if (!CompileShader(psCode, "main", "ps_5_0", psBlob))
+        std::vector<uint8_t> psBytecode;
+        if (!graphics::Shader::CompileSource(psCode, "CapturePS", "main", "ps_5_0", D3DCOMPILE_ENABLE_STRICTNESS, psBytecode))
         {
             LOG_ERROR("Failed to compile pixel shader");
             return false;
         }
 
-        if (!m_captureShader.LoadPixelShaderFromBytecode(m_graphicsDevice, psBlob->GetBufferPointer(), psBlob->GetBufferSize()))
+        if (!m_captureShader->LoadPixelShaderFromBytecode(m_graphicsDevice.get(), psBytecode.data(), psBytecode.size()))
         {
             LOG_ERROR("Failed to load pixel shader from bytecode");
             return false;
         }
 
-        // Create constant buffer
-        D3D11_BUFFER_DESC cbDesc = {};
-        cbDesc.ByteWidth = sizeof(float) * 4;  // 2 floats for WindowSize + 2 floats for TextureSize
-        cbDesc.Usage = D3D11_USAGE_DYNAMIC;
-        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-        cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-        cbDesc.MiscFlags = 0;
-        cbDesc.StructureByteStride = 0;
-
-        HRESULT hr = m_graphicsDevice->GetDevice()->CreateBuffer(&cbDesc, nullptr, &m_captureConstantBuffer);
-        if (FAILED(hr))
-        {
-            LOG_ERROR("Failed to create constant buffer: 0x{:X}", hr);
-            return false;
-        }
-
-        LOG_INFO("Capture shaders loaded successfully");
+        // 冷启动时全部编译，之后从磁盘缓存读取
+        const auto cacheAfter = graphics::ShaderCache::GetShared().GetStats();
+        LOG_INFO("Capture shaders loaded in {:.2f} ms ({} cached, {} compiled, compile {:.2f} ms, load {:.2f} ms)",
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+            cacheAfter.hits - cacheBefore.hits, cacheAfter.misses - cacheBefore.misses,
+            cacheAfter.compileMs - cacheBefore.compileMs, cacheAfter.loadMs - cacheBefore.loadMs);
         return true;
     }
 
-    bool Application::CompileShader(const std::string& code, const char* entryPoint, const char* target, Microsoft::WRL::ComPtr<ID3DBlob>& blob)
+    void Application::CreateUploadRing()
     {
-        Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
-        HRESULT hr = D3DCompile(
-            code.c_str(),
-            code.size(),
-            nullptr,
-            nullptr,
-            nullptr,
-            entryPoint,
-            target,
-            D3DCOMPILE_ENABLE_STRICTNESS,
-            0,
-            &blob,
-            &errorBlob
-        );
+        auto device = graphics::CreateUploadDevice(m_graphicsDevice.get());
+        if (!device)
+            return;
 
-        if (FAILED(hr))
+        m_uploads = std::make_unique<graphics::UploadRing>(std::move(device));
+        if (!m_uploads->IsValid())
         {
-            if (errorBlob)
-            {
-                LOG_ERROR("Shader compilation error: {}", static_cast<char*>(errorBlob->GetBufferPointer()));
-            }
-            else
-            {
-                LOG_ERROR("Shader compilation failed: 0x{:X}", hr);
-            }
-            return false;
+            m_uploads.reset();
         }
+    }
 
-        return true;
+    graphics::D3D11GraphicsDevice* Application::GetD3D11Device() const
+    {
+        if (!m_graphicsDevice || m_graphicsDevice->GetBackend() != graphics::GraphicsBackend::D3D11)
+            return nullptr;
+        return static_cast<graphics::D3D11GraphicsDevice*>(m_graphicsDevice.get());
     }
+
     // 临时放这，后续调整
     bool Application::CreateCaptureSampler()
     {
@@ -421,7 +721,7 @@ namespace lens
         samplerDesc.MinLOD = 0.0f;
         samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
 
-        HRESULT hr = m_graphicsDevice->GetDevice()->CreateSamplerState(&samplerDesc, &m_captureSampler);
+        HRESULT hr = GetD3D11Device()->GetDevice()->CreateSamplerState(&samplerDesc, &m_captureSampler);
         if (FAILED(hr))
         {
             LOG_ERROR("Failed to create sampler state: 0x{:X}", hr);
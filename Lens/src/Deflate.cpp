@@ -0,0 +1,693 @@
+﻿#include "LensPch.h"
+#include "Deflate.h"
+#include <bit>
+#include <cstring>
+#include <queue>
+
+namespace lens
+{
+    namespace
+    {
+        constexpr uint32_t kWindowSize = 32768;
+        constexpr uint32_t kMinMatch = 3;
+        constexpr uint32_t kMaxMatch = 258;
+        constexpr uint32_t kHashBits = 15;
+        constexpr size_t kBlockSymbols = 1 << 15;
+        constexpr uint32_t kLitLenCodes = 286;
+        constexpr uint32_t kDistCodes = 30;
+        constexpr uint32_t kCodeLengthCodes = 19;
+        constexpr uint32_t kAdlerBase = 65521;
+
+        constexpr uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        constexpr uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        constexpr uint16_t kDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        constexpr uint8_t kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+        constexpr uint8_t kCodeLengthOrder[kCodeLengthCodes] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+        // 各压缩级别的匹配参数：链长度上限、够长即停的匹配长度、匹配内部逐位置插入哈希的长度上限
+        struct LevelParams
+        {
+            uint32_t maxChain;
+            uint32_t niceLength;
+            uint32_t maxInsert;
+        };
+
+        constexpr LevelParams kLevels[10] =
+        {
+            { 0, 0, 0 },
+            { 4, 32, 4 },
+            { 6, 64, 8 },
+            { 12, 128, 16 },
+            { 24, 128, kMaxMatch },
+            { 48, kMaxMatch, kMaxMatch },
+            { 96, kMaxMatch, kMaxMatch },
+            { 256, kMaxMatch, kMaxMatch },
+            { 1024, kMaxMatch, kMaxMatch },
+            { 4096, kMaxMatch, kMaxMatch },
+        };
+
+        struct Tables
+        {
+            uint8_t lengthCode[kMaxMatch + 1] = {};
+            uint8_t fixedLitLengths[288] = {};
+            uint16_t fixedLitCodes[288] = {};
+            uint8_t fixedDistLengths[kDistCodes] = {};
+            uint16_t fixedDistCodes[kDistCodes] = {};
+            uint32_t crc[8][256] = {};
+        };
+
+        uint16_t ReverseBits(uint32_t code, uint32_t length)
+        {
+            uint32_t result = 0;
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                result = (result << 1) | (code & 1);
+                code >>= 1;
+            }
+            return static_cast<uint16_t>(result);
+        }
+
+        // 由码长生成规范 Huffman 码，按 deflate 的位序预先反转
+        void AssignCodes(const uint8_t* lengths, uint32_t count, uint16_t* codes)
+        {
+            uint32_t lengthCount[16] = {};
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                lengthCount[lengths[i]]++;
+            }
+            lengthCount[0] = 0;
+
+            uint32_t nextCode[16] = {};
+            uint32_t code = 0;
+            for (uint32_t bits = 1; bits < 16; ++bits)
+            {
+                code = (code + lengthCount[bits - 1]) << 1;
+                nextCode[bits] = code;
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                codes[i] = lengths[i] ? ReverseBits(nextCode[lengths[i]]++, lengths[i]) : 0;
+            }
+        }
+
+        const Tables& GetTables()
+        {
+            static const Tables tables = []
+            {
+                Tables t;
+                for (uint32_t code = 0; code < 29; ++code)
+                {
+                    const uint32_t end = code == 28 ? kMaxMatch + 1 : kLengthBase[code + 1];
+                    for (uint32_t length = kLengthBase[code]; length < end; ++length)
+                    {
+                        t.lengthCode[length] = static_cast<uint8_t>(code);
+                    }
+                }
+
+                for (uint32_t i = 0; i < 288; ++i)
+                {
+                    t.fixedLitLengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+                }
+                AssignCodes(t.fixedLitLengths, 288, t.fixedLitCodes);
+                std::fill(std::begin(t.fixedDistLengths), std::end(t.fixedDistLengths), uint8_t(5));
+                AssignCodes(t.fixedDistLengths, kDistCodes, t.fixedDistCodes);
+
+                for (uint32_t n = 0; n < 256; ++n)
+                {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    }
+                    t.crc[0][n] = c;
+                }
+                for (uint32_t n = 0; n < 256; ++n)
+                {
+                    for (uint32_t k = 1; k < 8; ++k)
+                    {
+                        t.crc[k][n] = (t.crc[k - 1][n] >> 8) ^ t.crc[0][t.crc[k - 1][n] & 0xFF];
+                    }
+                }
+                return t;
+            }();
+            return tables;
+        }
+
+        inline uint32_t GetDistCode(uint32_t distance)
+        {
+            const uint32_t value = distance - 1;
+            if (value < 4)
+                return value;
+            const uint32_t log = static_cast<uint32_t>(std::bit_width(value)) - 1;
+            return 2 * log + ((value >> (log - 1)) & 1);
+        }
+
+        inline uint32_t LoadU32(const uint8_t* p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline uint32_t Hash3(const uint8_t* p)
+        {
+            const uint32_t value = p[0] | (p[1] << 8) | (p[2] << 16);
+            return (value * 0x9E3779B1u) >> (32 - kHashBits);
+        }
+
+        inline uint32_t MatchLength(const uint8_t* a, const uint8_t* b, uint32_t limit)
+        {
+            uint32_t length = 0;
+            while (length + 8 <= limit)
+            {
+                uint64_t x, y;
+                std::memcpy(&x, a + length, 8);
+                std::memcpy(&y, b + length, 8);
+                if (x != y)
+                    return length + static_cast<uint32_t>(std::countr_zero(x ^ y) / 8);
+                length += 8;
+            }
+            while (length < limit && a[length] == b[length])
+            {
+                length++;
+            }
+            return length;
+        }
+
+        // 限长 Huffman：先建普通 Huffman 树，超长的码截到 maxBits 后调整各长度的个数使 Kraft 和恰好为 1，
+        // 最后按频率从高到低依次分配从短到长的码长
+        void BuildLengths(const uint32_t* freq, uint32_t count, uint32_t maxBits, uint8_t* lengths)
+        {
+            std::fill(lengths, lengths + count, uint8_t(0));
+
+            std::vector<uint32_t> used;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (freq[i])
+                    used.push_back(i);
+            }
+            if (used.empty())
+                return;
+            if (used.size() == 1)
+            {
+                // 单个符号也给出完整的 1 位码
+                lengths[used[0]] = 1;
+                lengths[used[0] == 0 ? 1 : 0] = 1;
+                return;
+            }
+
+            struct Node
+            {
+                uint64_t weight;
+                int32_t parent;
+            };
+            std::vector<Node> nodes;
+            nodes.reserve(used.size() * 2);
+            using Entry = std::pair<uint64_t, uint32_t>;
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+            for (uint32_t symbol : used)
+            {
+                heap.push({ freq[symbol], static_cast<uint32_t>(nodes.size()) });
+                nodes.push_back({ freq[symbol], -1 });
+            }
+            while (heap.size() > 1)
+            {
+                const Entry a = heap.top();
+                heap.pop();
+                const Entry b = heap.top();
+                heap.pop();
+                const uint32_t parent = static_cast<uint32_t>(nodes.size());
+                nodes.push_back({ a.first + b.first, -1 });
+                nodes[a.second].parent = static_cast<int32_t>(parent);
+                nodes[b.second].parent = static_cast<int32_t>(parent);
+                heap.push({ a.first + b.first, parent });
+            }
+
+            uint32_t lengthCount[64] = {};
+            for (uint32_t i = 0; i < used.size(); ++i)
+            {
+                uint32_t depth = 0;
+                for (int32_t node = nodes[i].parent; node >= 0; node = nodes[node].parent)
+                {
+                    depth++;
+                }
+                lengthCount[(std::min)(depth, 63u)]++;
+            }
+
+            for (uint32_t bits = maxBits + 1; bits < 64; ++bits)
+            {
+                lengthCount[maxBits] += lengthCount[bits];
+                lengthCount[bits] = 0;
+            }
+            uint64_t total = 0;
+            for (uint32_t bits = 1; bits <= maxBits; ++bits)
+            {
+                total += static_cast<uint64_t>(lengthCount[bits]) << (maxBits - bits);
+            }
+            while (total != (1ull << maxBits))
+            {
+                lengthCount[maxBits]--;
+                for (uint32_t bits = maxBits - 1; bits > 0; --bits)
+                {
+                    if (lengthCount[bits])
+                    {
+                        lengthCount[bits]--;
+                        lengthCount[bits + 1] += 2;
+                        break;
+                    }
+                }
+                total--;
+            }
+
+            std::stable_sort(used.begin(), used.end(), [freq](uint32_t a, uint32_t b) { return freq[a] < freq[b]; });
+            size_t next = used.size();
+            for (uint32_t bits = 1; bits <= maxBits; ++bits)
+            {
+                for (uint32_t n = lengthCount[bits]; n > 0; --n)
+                {
+                    lengths[used[--next]] = static_cast<uint8_t>(bits);
+                }
+            }
+        }
+
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& output) : m_output(output) {}
+
+            void Put(uint32_t value, uint32_t count)
+            {
+                m_bits |= static_cast<uint64_t>(value) << m_count;
+                m_count += count;
+                if (m_count >= 32)
+                {
+                    const uint32_t low = static_cast<uint32_t>(m_bits);
+                    const size_t offset = m_output.size();
+                    m_output.resize(offset + 4);
+                    std::memcpy(m_output.data() + offset, &low, 4);
+                    m_bits >>= 32;
+                    m_count -= 32;
+                }
+            }
+
+            // 补齐到字节边界
+            void Flush()
+            {
+                while (m_count > 0)
+                {
+                    m_output.push_back(static_cast<uint8_t>(m_bits));
+                    m_bits >>= 8;
+                    m_count = m_count > 8 ? m_count - 8 : 0;
+                }
+                m_bits = 0;
+            }
+
+            void PutBytes(const uint8_t* data, size_t size)
+            {
+                m_output.insert(m_output.end(), data, data + size);
+            }
+
+        private:
+            std::vector<uint8_t>& m_output;
+            uint64_t m_bits = 0;
+            uint32_t m_count = 0;
+        };
+
+        // dist 为 0 表示字面量
+        struct Symbol
+        {
+            uint16_t litLen;
+            uint16_t dist;
+        };
+
+        void WriteStored(BitWriter& writer, const uint8_t* data, size_t size, bool final)
+        {
+            size_t offset = 0;
+            do
+            {
+                const size_t chunk = (std::min)(size - offset, size_t(65535));
+                const bool last = offset + chunk == size;
+                writer.Put(final && last ? 1 : 0, 1);
+                writer.Put(0, 2);
+                writer.Flush();
+                const uint8_t header[4] =
+                {
+                    static_cast<uint8_t>(chunk), static_cast<uint8_t>(chunk >> 8),
+                    static_cast<uint8_t>(~chunk), static_cast<uint8_t>(~chunk >> 8)
+                };
+                writer.PutBytes(header, 4);
+                writer.PutBytes(data + offset, chunk);
+                offset += chunk;
+            } while (offset < size);
+        }
+
+        void WriteSymbols(BitWriter& writer, const Symbol* symbols, size_t count,
+            const uint8_t* litLengths, const uint16_t* litCodes, const uint8_t* distLengths, const uint16_t* distCodes)
+        {
+            const Tables& tables = GetTables();
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Symbol& symbol = symbols[i];
+                if (symbol.dist == 0)
+                {
+                    writer.Put(litCodes[symbol.litLen], litLengths[symbol.litLen]);
+                    continue;
+                }
+
+                const uint32_t lengthCode = tables.lengthCode[symbol.litLen];
+                writer.Put(litCodes[257 + lengthCode], litLengths[257 + lengthCode]);
+                if (kLengthExtra[lengthCode])
+                    writer.Put(symbol.litLen - kLengthBase[lengthCode], kLengthExtra[lengthCode]);
+
+                const uint32_t distCode = GetDistCode(symbol.dist);
+                writer.Put(distCodes[distCode], distLengths[distCode]);
+                if (kDistExtra[distCode])
+                    writer.Put(symbol.dist - kDistBase[distCode], kDistExtra[distCode]);
+            }
+            writer.Put(litCodes[256], litLengths[256]);
+        }
+
+        // 估算动态、固定 Huffman 和存储三种块的位数，写出最小的一种
+        void WriteBlock(BitWriter& writer, const Symbol* symbols, size_t count, const uint8_t* raw, size_t rawSize, bool final)
+        {
+            const Tables& tables = GetTables();
+
+            uint32_t litFreq[kLitLenCodes] = {};
+            uint32_t distFreq[kDistCodes] = {};
+            uint64_t extraBits = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Symbol& symbol = symbols[i];
+                if (symbol.dist == 0)
+                {
+                    litFreq[symbol.litLen]++;
+                }
+                else
+                {
+                    const uint32_t lengthCode = tables.lengthCode[symbol.litLen];
+                    const uint32_t distCode = GetDistCode(symbol.dist);
+                    litFreq[257 + lengthCode]++;
+                    distFreq[distCode]++;
+                    extraBits += kLengthExtra[lengthCode] + kDistExtra[distCode];
+                }
+            }
+            litFreq[256] = 1;
+
+            uint8_t litLengths[kLitLenCodes];
+            uint8_t distLengths[kDistCodes];
+            BuildLengths(litFreq, kLitLenCodes, 15, litLengths);
+            BuildLengths(distFreq, kDistCodes, 15, distLengths);
+
+            uint32_t litCount = kLitLenCodes;
+            while (litCount > 257 && litLengths[litCount - 1] == 0)
+                litCount--;
+            uint32_t distCount = kDistCodes;
+            while (distCount > 1 && distLengths[distCount - 1] == 0)
+                distCount--;
+
+            // 码长序列的游程编码：16 重复前一个 3~6 次，17/18 为 3~10 / 11~138 个 0
+            uint8_t allLengths[kLitLenCodes + kDistCodes];
+            std::memcpy(allLengths, litLengths, litCount);
+            std::memcpy(allLengths + litCount, distLengths, distCount);
+            const uint32_t totalLengths = litCount + distCount;
+
+            std::vector<std::pair<uint8_t, uint8_t>> runs;
+            uint32_t clFreq[kCodeLengthCodes] = {};
+            auto emitRun = [&](uint8_t symbol, uint8_t extra)
+            {
+                runs.push_back({ symbol, extra });
+                clFreq[symbol]++;
+            };
+            for (uint32_t i = 0; i < totalLengths;)
+            {
+                const uint8_t length = allLengths[i];
+                uint32_t run = 1;
+                while (i + run < totalLengths && allLengths[i + run] == length)
+                    run++;
+                i += run;
+
+                if (length == 0)
+                {
+                    while (run >= 11)
+                    {
+                        const uint32_t n = (std::min)(run, 138u);
+                        emitRun(18, static_cast<uint8_t>(n - 11));
+                        run -= n;
+                    }
+                    if (run >= 3)
+                    {
+                        emitRun(17, static_cast<uint8_t>(run - 3));
+                        run = 0;
+                    }
+                }
+                else
+                {
+                    emitRun(length, 0);
+                    run--;
+                    while (run >= 3)
+                    {
+                        const uint32_t n = (std::min)(run, 6u);
+                        emitRun(16, static_cast<uint8_t>(n - 3));
+                        run -= n;
+                    }
+                }
+                while (run > 0)
+                {
+                    emitRun(length, 0);
+                    run--;
+                }
+            }
+
+            uint8_t clLengths[kCodeLengthCodes];
+            BuildLengths(clFreq, kCodeLengthCodes, 7, clLengths);
+            uint32_t clCount = kCodeLengthCodes;
+            while (clCount > 4 && clLengths[kCodeLengthOrder[clCount - 1]] == 0)
+                clCount--;
+
+            uint64_t dynamicBits = 3 + 14 + 3ull * clCount + extraBits;
+            for (const auto& run : runs)
+            {
+                dynamicBits += clLengths[run.first] + (run.first == 16 ? 2 : run.first == 17 ? 3 : run.first == 18 ? 7 : 0);
+            }
+            uint64_t fixedBits = 3 + extraBits;
+            for (uint32_t i = 0; i < kLitLenCodes; ++i)
+            {
+                dynamicBits += static_cast<uint64_t>(litFreq[i]) * litLengths[i];
+                fixedBits += static_cast<uint64_t>(litFreq[i]) * tables.fixedLitLengths[i];
+            }
+            for (uint32_t i = 0; i < kDistCodes; ++i)
+            {
+                dynamicBits += static_cast<uint64_t>(distFreq[i]) * distLengths[i];
+                fixedBits += static_cast<uint64_t>(distFreq[i]) * 5;
+            }
+            const uint64_t storedBits = (rawSize / 65535 + 1) * (3 + 7 + 32) + rawSize * 8;
+
+            if (storedBits < dynamicBits && storedBits < fixedBits)
+            {
+                WriteStored(writer, raw, rawSize, final);
+                return;
+            }
+
+            if (fixedBits <= dynamicBits)
+            {
+                writer.Put(final ? 1 : 0, 1);
+                writer.Put(1, 2);
+                WriteSymbols(writer, symbols, count, tables.fixedLitLengths, tables.fixedLitCodes,
+                    tables.fixedDistLengths, tables.fixedDistCodes);
+                return;
+            }
+
+            uint16_t litCodes[kLitLenCodes];
+            uint16_t distCodes[kDistCodes];
+            uint16_t clCodes[kCodeLengthCodes];
+            AssignCodes(litLengths, kLitLenCodes, litCodes);
+            AssignCodes(distLengths, kDistCodes, distCodes);
+            AssignCodes(clLengths, kCodeLengthCodes, clCodes);
+
+            writer.Put(final ? 1 : 0, 1);
+            writer.Put(2, 2);
+            writer.Put(litCount - 257, 5);
+            writer.Put(distCount - 1, 5);
+            writer.Put(clCount - 4, 4);
+            for (uint32_t i = 0; i < clCount; ++i)
+            {
+                writer.Put(clLengths[kCodeLengthOrder[i]], 3);
+            }
+            for (const auto& run : runs)
+            {
+                writer.Put(clCodes[run.first], clLengths[run.first]);
+                if (run.first == 16)
+                    writer.Put(run.second, 2);
+                else if (run.first == 17)
+                    writer.Put(run.second, 3);
+                else if (run.first == 18)
+                    writer.Put(run.second, 7);
+            }
+            WriteSymbols(writer, symbols, count, litLengths, litCodes, distLengths, distCodes);
+        }
+    }
+
+    uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc)
+    {
+        const auto& table = GetTables().crc;
+        crc = ~crc;
+        while (size >= 8)
+        {
+            const uint32_t low = LoadU32(data) ^ crc;
+            const uint32_t high = LoadU32(data + 4);
+            crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24] ^
+                table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^ table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+            data += 8;
+            size -= 8;
+        }
+        while (size--)
+        {
+            crc = table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler)
+    {
+        uint32_t a = adler & 0xFFFF;
+        uint32_t b = adler >> 16;
+        while (size > 0)
+        {
+            // 5552 是保证 b 不溢出 32 位的最大批量
+            size_t n = (std::min)(size, size_t(5552));
+            size -= n;
+            while (n--)
+            {
+                a += *data++;
+                b += a;
+            }
+            a %= kAdlerBase;
+            b %= kAdlerBase;
+        }
+        return (b << 16) | a;
+    }
+
+    uint32_t Adler32Combine(uint32_t first, uint32_t second, uint64_t secondLength)
+    {
+        const uint32_t remainder = static_cast<uint32_t>(secondLength % kAdlerBase);
+        uint32_t sum1 = first & 0xFFFF;
+        uint32_t sum2 = static_cast<uint32_t>((static_cast<uint64_t>(remainder) * sum1) % kAdlerBase);
+        sum1 += (second & 0xFFFF) + kAdlerBase - 1;
+        sum2 += (first >> 16) + (second >> 16) + kAdlerBase - remainder;
+        if (sum1 >= kAdlerBase)
+            sum1 -= kAdlerBase;
+        if (sum1 >= kAdlerBase)
+            sum1 -= kAdlerBase;
+        if (sum2 >= kAdlerBase * 2)
+            sum2 -= kAdlerBase * 2;
+        if (sum2 >= kAdlerBase)
+            sum2 -= kAdlerBase;
+        return sum1 | (sum2 << 16);
+    }
+
+    void Deflate(const uint8_t* data, size_t size, uint32_t level, bool finalBlock, std::vector<uint8_t>& output)
+    {
+        BitWriter writer(output);
+        level = (std::min)(level, 9u);
+
+        if (level == 0 || size == 0)
+        {
+            if (size > 0 || finalBlock)
+                WriteStored(writer, data, size, finalBlock);
+        }
+        else
+        {
+            const LevelParams& params = kLevels[level];
+
+            // 哈希表在同一线程的多次调用之间复用
+            thread_local std::vector<int32_t> head;
+            thread_local std::vector<int32_t> prev;
+            thread_local std::vector<Symbol> symbols;
+            head.assign(size_t(1) << kHashBits, -1);
+            prev.resize(kWindowSize);
+            symbols.clear();
+            symbols.reserve(kBlockSymbols);
+
+            auto insert = [&](size_t position)
+            {
+                const uint32_t hash = Hash3(data + position);
+                prev[position & (kWindowSize - 1)] = head[hash];
+                head[hash] = static_cast<int32_t>(position);
+            };
+
+            size_t blockStart = 0;
+            size_t pos = 0;
+            while (pos < size)
+            {
+                uint32_t bestLength = 0;
+                uint32_t bestDistance = 0;
+                if (pos + kMinMatch <= size)
+                {
+                    const uint32_t limit = static_cast<uint32_t>((std::min)(size_t(kMaxMatch), size - pos));
+                    int32_t candidate = head[Hash3(data + pos)];
+                    for (uint32_t chain = params.maxChain; candidate >= 0 && chain > 0; --chain)
+                    {
+                        const size_t distance = pos - static_cast<size_t>(candidate);
+                        if (distance > kWindowSize)
+                            break;
+
+                        const uint8_t* match = data + candidate;
+                        if (match[bestLength] == data[pos + bestLength] && match[0] == data[pos])
+                        {
+                            const uint32_t length = MatchLength(match, data + pos, limit);
+                            if (length > bestLength)
+                            {
+                                bestLength = length;
+                                bestDistance = static_cast<uint32_t>(distance);
+                                if (length >= params.niceLength || length == limit)
+                                    break;
+                            }
+                        }
+                        candidate = prev[static_cast<size_t>(candidate) & (kWindowSize - 1)];
+                    }
+                    insert(pos);
+                }
+
+                if (bestLength >= kMinMatch)
+                {
+                    symbols.push_back({ static_cast<uint16_t>(bestLength), static_cast<uint16_t>(bestDistance) });
+                    if (bestLength <= params.maxInsert)
+                    {
+                        const size_t end = (std::min)(pos + bestLength, size - kMinMatch + 1);
+                        for (size_t p = pos + 1; p < end; ++p)
+                            insert(p);
+                    }
+                    pos += bestLength;
+                }
+                else
+                {
+                    symbols.push_back({ data[pos], 0 });
+                    pos++;
+                }
+
+                if (symbols.size() == kBlockSymbols && pos < size)
+                {
+                    WriteBlock(writer, symbols.data(), symbols.size(), data + blockStart, pos - blockStart, false);
+                    symbols.clear();
+                    blockStart = pos;
+                }
+            }
+            WriteBlock(writer, symbols.data(), symbols.size(), data + blockStart, pos - blockStart, finalBlock);
+        }
+
+        if (!finalBlock)
+        {
+            // 空存储块：对齐到字节，后面可以直接接另一段的输出
+            writer.Put(0, 3);
+            writer.Flush();
+            const uint8_t marker[4] = { 0x00, 0x00, 0xFF, 0xFF };
+            writer.PutBytes(marker, 4);
+        }
+        writer.Flush();
+    }
+}
@@ -0,0 +1,100 @@
+﻿#include "LensPch.h"
+#include "FrameScheduler.h"
+
+namespace lens
+{
+    FrameScheduler::FrameScheduler()
+        : FrameScheduler(Desc{})
+    {
+    }
+
+    FrameScheduler::FrameScheduler(const Desc& desc)
+    {
+        Configure(desc);
+        // 第一帧总是绘制，按输入处理，初始布局也需要几帧稳定
+        Invalidate(Reason::Input);
+    }
+
+    void FrameScheduler::Configure(const Desc& desc)
+    {
+        m_desc = desc;
+        m_minInterval = desc.minRefreshHz > 0.0
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / desc.minRefreshHz))
+            : Clock::duration::zero();
+    }
+
+    void FrameScheduler::Invalidate(Reason reason)
+    {
+        m_pending |= Bit(reason);
+    }
+
+    void FrameScheduler::ScheduleAt(Clock::time_point deadline)
+    {
+        m_timerDeadline = (std::min)(m_timerDeadline, deadline);
+    }
+
+    FrameScheduler::Clock::duration FrameScheduler::GetWaitTimeout(Clock::time_point now) const
+    {
+        if (m_pending != 0 || m_settleRemaining > 0)
+            return Clock::duration::zero();
+
+        Clock::time_point deadline = m_timerDeadline;
+        if (m_minInterval > Clock::duration::zero())
+        {
+            deadline = (std::min)(deadline, m_lastRedraw + m_minInterval);
+        }
+
+        if (deadline == Clock::time_point::max())
+            return Clock::duration::max();
+        return deadline > now ? deadline - now : Clock::duration::zero();
+    }
+
+    bool FrameScheduler::ShouldRedraw(Clock::time_point now)
+    {
+        m_stats.wakeups++;
+
+        if (now >= m_timerDeadline)
+        {
+            m_pending |= Bit(Reason::Timer);
+            m_timerDeadline = Clock::time_point::max();
+        }
+        if (m_minInterval > Clock::duration::zero() && now - m_lastRedraw >= m_minInterval)
+        {
+            m_pending |= Bit(Reason::MinRefresh);
+        }
+        if (m_settleRemaining > 0)
+        {
+            m_pending |= Bit(Reason::Settle);
+        }
+
+        if (m_pending == 0)
+        {
+            m_stats.idleWakeups++;
+            return false;
+        }
+        return true;
+    }
+
+    void FrameScheduler::OnRedrawn(Clock::time_point now)
+    {
+        m_stats.redraws++;
+        m_stats.byInput += (m_pending & Bit(Reason::Input)) ? 1 : 0;
+        m_stats.byNewFrame += (m_pending & Bit(Reason::NewFrame)) ? 1 : 0;
+        m_stats.byTimer += (m_pending & Bit(Reason::Timer)) ? 1 : 0;
+        m_stats.byMinRefresh += (m_pending & Bit(Reason::MinRefresh)) ? 1 : 0;
+        m_stats.bySettle += (m_pending & Bit(Reason::Settle)) ? 1 : 0;
+
+        // 新的输入重新开始补帧，否则消耗一帧
+        if (m_pending & Bit(Reason::Input))
+        {
+            m_settleRemaining = m_desc.settleFrames;
+        }
+        else if (m_settleRemaining > 0)
+        {
+            m_settleRemaining--;
+        }
+
+        m_pending = 0;
+        m_lastRedraw = now;
+    }
+}
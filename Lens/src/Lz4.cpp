@@ -0,0 +1,248 @@
+﻿#include "LensPch.h"
+#include "Lz4.h"
+#include <bit>
+#include <cstring>
+
+namespace lens
+{
+    namespace
+    {
+        constexpr uint32_t kHashBits = 12;
+        constexpr size_t kMinMatch = 4;
+        constexpr size_t kLastLiterals = 5;     // 块末尾至少保留的字面量
+        constexpr size_t kMatchFindLimit = 12;  // 距块末尾不足这么多字节时不再找匹配
+        constexpr size_t kMaxOffset = 65535;
+        constexpr uint32_t kSkipTrigger = 6;    // 连续找不到匹配时逐渐加大步长
+
+        uint32_t Read32(const uint8_t* p)
+        {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint64_t Read64(const uint8_t* p)
+        {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint32_t Hash(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - kHashBits);
+        }
+
+        // 从 a、b 开始的公共前缀长度，a 不超过 limit
+        size_t CommonLength(const uint8_t* a, const uint8_t* b, const uint8_t* limit)
+        {
+            const uint8_t* start = a;
+            while (a + 8 <= limit)
+            {
+                const uint64_t diff = Read64(a) ^ Read64(b);
+                if (diff != 0)
+                {
+                    return static_cast<size_t>(a - start) + (std::countr_zero(diff) >> 3);
+                }
+                a += 8;
+                b += 8;
+            }
+            while (a < limit && *a == *b)
+            {
+                ++a;
+                ++b;
+            }
+            return static_cast<size_t>(a - start);
+        }
+
+        uint8_t* WriteLength(uint8_t* op, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                *op++ = 255;
+            }
+            *op++ = static_cast<uint8_t>(length);
+            return op;
+        }
+
+        uint8_t* WriteLiterals(uint8_t* op, const uint8_t* literals, size_t count, uint8_t*& token)
+        {
+            token = op++;
+            if (count >= 15)
+            {
+                *token = 15 << 4;
+                op = WriteLength(op, count - 15);
+            }
+            else
+            {
+                *token = static_cast<uint8_t>(count << 4);
+            }
+            std::memcpy(op, literals, count);
+            return op + count;
+        }
+
+        bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length)
+        {
+            uint8_t byte;
+            do
+            {
+                if (ip >= end)
+                    return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+    }
+
+    size_t Lz4Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& output)
+    {
+        const size_t start = output.size();
+        output.resize(start + Lz4CompressBound(size));
+        uint8_t* op = output.data() + start;
+
+        const uint8_t* ip = data;
+        const uint8_t* anchor = data;
+        const uint8_t* end = data + size;
+        uint8_t* token = nullptr;
+
+        if (size > kMatchFindLimit)
+        {
+            const uint8_t* findLimit = end - kMatchFindLimit;
+            const uint8_t* matchLimit = end - kLastLiterals;
+
+            // 位置相对 data 保存；表项初值 0 指向块首，由内容比较排除假匹配
+            uint32_t table[1u << kHashBits] = {};
+            ++ip;
+
+            while (ip < findLimit)
+            {
+                const uint32_t sequence = Read32(ip);
+                const uint32_t hash = Hash(sequence);
+                const uint8_t* ref = data + table[hash];
+                table[hash] = static_cast<uint32_t>(ip - data);
+
+                if (ref >= ip || static_cast<size_t>(ip - ref) > kMaxOffset || Read32(ref) != sequence)
+                {
+                    ip += 1 + ((ip - anchor) >> kSkipTrigger);
+                    continue;
+                }
+
+                // 向前扩展进字面量
+                while (ip > anchor && ref > data && ip[-1] == ref[-1])
+                {
+                    --ip;
+                    --ref;
+                }
+
+                const size_t matchLength = kMinMatch + CommonLength(ip + kMinMatch, ref + kMinMatch, matchLimit);
+                op = WriteLiterals(op, anchor, static_cast<size_t>(ip - anchor), token);
+
+                const size_t offset = static_cast<size_t>(ip - ref);
+                *op++ = static_cast<uint8_t>(offset);
+                *op++ = static_cast<uint8_t>(offset >> 8);
+
+                const size_t extra = matchLength - kMinMatch;
+                if (extra >= 15)
+                {
+                    *token |= 15;
+                    op = WriteLength(op, extra - 15);
+                }
+                else
+                {
+                    *token |= static_cast<uint8_t>(extra);
+                }
+
+                ip += matchLength;
+                anchor = ip;
+
+                // 匹配末尾附近的位置补进哈希表，提高下一次命中率
+                if (ip < findLimit)
+                {
+                    table[Hash(Read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - data);
+                }
+            }
+        }
+
+        // 最后一段只有字面量
+        op = WriteLiterals(op, anchor, static_cast<size_t>(end - anchor), token);
+
+        const size_t written = static_cast<size_t>(op - (output.data() + start));
+        output.resize(start + written);
+        return written;
+    }
+
+    bool Lz4Decompress(const uint8_t* data, size_t size, uint8_t* output, size_t outputSize)
+    {
+        const uint8_t* ip = data;
+        const uint8_t* end = data + size;
+        uint8_t* op = output;
+        uint8_t* outEnd = output + outputSize;
+
+        for (;;)
+        {
+            if (ip >= end)
+                return false;
+
+            const uint8_t token = *ip++;
+            size_t literals = token >> 4;
+            if (literals == 15 && !ReadLength(ip, end, literals))
+                return false;
+
+            if (literals > static_cast<size_t>(end - ip) || literals > static_cast<size_t>(outEnd - op))
+                return false;
+            std::memcpy(op, ip, literals);
+            ip += literals;
+            op += literals;
+
+            // 最后一个序列没有匹配部分
+            if (ip == end)
+                break;
+
+            if (end - ip < 2)
+                return false;
+            const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<size_t>(op - output))
+                return false;
+
+            size_t length = token & 15;
+            if (length == 15 && !ReadLength(ip, end, length))
+                return false;
+            length += kMinMatch;
+            if (length > static_cast<size_t>(outEnd - op))
+                return false;
+
+            const uint8_t* ref = op - offset;
+            if (offset == 1)
+            {
+                // 单字节重复，XOR 后的零值区最常见
+                std::memset(op, *ref, length);
+                op += length;
+            }
+            else if (offset >= 8)
+            {
+                while (length >= 8)
+                {
+                    std::memcpy(op, ref, 8);
+                    op += 8;
+                    ref += 8;
+                    length -= 8;
+                }
+                while (length-- > 0)
+                {
+                    *op++ = *ref++;
+                }
+            }
+            else
+            {
+                while (length-- > 0)
+                {
+                    *op++ = *ref++;
+                }
+            }
+        }
+
+        return op == outEnd;
+    }
+}
@@ -0,0 +1,137 @@
+﻿#include "LensPch.h"
+#include "ThreadPool.h"
+#include <atomic>
+
+namespace lens
+{
+    ThreadPool::ThreadPool(uint32_t threadCount)
+    {
+        m_threads.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+
+    ThreadPool& ThreadPool::GetShared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    uint32_t ThreadPool::GetDefaultThreadCount()
+    {
+        const uint32_t hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 1;
+    }
+
+    std::future<void> ThreadPool::Submit(Task task)
+    {
+        if (m_threads.empty())
+        {
+            // 没有工作线程时直接执行
+            std::packaged_task<void()> packaged(std::move(task));
+            std::future<void> future = packaged.get_future();
+            packaged();
+            return future;
+        }
+
+        auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+        std::future<void> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace_back([packaged]() { (*packaged)(); });
+        }
+        m_cv.notify_one();
+        return future;
+    }
+
+    void ThreadPool::ParallelFor(uint32_t count, uint32_t grain, const RangeFunction& fn)
+    {
+        if (count == 0)
+            return;
+
+        grain = (std::max)(grain, 1u);
+        const uint32_t chunkCount = (count + grain - 1) / grain;
+        if (chunkCount == 1 || m_threads.empty())
+        {
+            fn(0, count);
+            return;
+        }
+
+        // 任务块由原子计数领取；辅助任务可能在全部完成后才被调度，所以状态放在共享指针里
+        struct State
+        {
+            std::atomic<uint32_t> next{ 0 };
+            std::atomic<uint32_t> done{ 0 };
+            std::mutex mutex;
+            std::condition_variable cv;
+        };
+        auto state = std::make_shared<State>();
+
+        auto runChunks = [state, count, grain, chunkCount, &fn]()
+        {
+            uint32_t chunk;
+            while ((chunk = state->next.fetch_add(1, std::memory_order_relaxed)) < chunkCount)
+            {
+                const uint32_t begin = chunk * grain;
+                fn(begin, (std::min)(begin + grain, count));
+
+                if (state->done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunkCount)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->cv.notify_all();
+                }
+            }
+        };
+
+        const uint32_t helpers = (std::min)(chunkCount - 1, GetThreadCount());
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (uint32_t i = 0; i < helpers; ++i)
+            {
+                m_tasks.emplace_back(runChunks);
+            }
+        }
+        m_cv.notify_all();
+
+        runChunks();
+
+        // fn 只在领到块时被引用，全部块完成后辅助任务不会再触碰它
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [&]() { return state->done.load(std::memory_order_acquire) == chunkCount; });
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        for (;;)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping && m_tasks.empty())
+                    return;
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+}
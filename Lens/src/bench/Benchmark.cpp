@@ -0,0 +1,99 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "graphics/CpuImage.h"
+#include <random>
+
+namespace lens::bench
+{
+    namespace
+    {
+        struct BenchmarkEntry
+        {
+            const char* name;
+            const char* usage;
+            void (*run)(const std::vector<std::string>& args);
+        };
+
+        const BenchmarkEntry kBenchmarks[] =
+        {
+            { "capture-scaling", "[maxSources=16] [width=1920] [height=1080] [fps=240] [seconds=2]", &BenchCaptureScaling },
+            { "pixel-convert", "[iterations=20]", &BenchPixelConvert },
+            { "resample", "[iterations=10] [width=3840] [height=2160]", &BenchResample },
+            { "frame-diff", "[iterations=50] [width=3840] [height=2160]", &BenchFrameDiff },
+            { "dedup", "[seconds=3] [fps=60] [maxDistance=2]", &BenchDedup },
+            { "image-encode", "[iterations=3] [width=3840] [height=2160]", &BenchImageEncode },
+            { "delta-codec", "[frames=240] [width=3840] [height=2160]", &BenchDeltaCodec },
+            { "mjpeg", "[frames=20] [quality=85] [maxThreads=hardware]", &BenchMjpeg },
+            { "shader-cache", "[iterations=5]", &BenchShaderCache },
+            { "mailbox", "[milliseconds=1000]", &BenchMailbox },
+        };
+    }
+
+    int RunBenchmark(const std::string& name, const std::vector<std::string>& args)
+    {
+        for (const auto& entry : kBenchmarks)
+        {
+            if (name == entry.name)
+            {
+                LOG_INFO("Running benchmark: {}", entry.name);
+                entry.run(args);
+                return 0;
+            }
+        }
+
+        LOG_ERROR("Unknown benchmark: {}", name);
+        for (const auto& entry : kBenchmarks)
+        {
+            LOG_INFO("  --bench {} {}", entry.name, entry.usage);
+        }
+        return 1;
+    }
+
+    uint32_t GetArgU32(const std::vector<std::string>& args, size_t index, uint32_t fallback)
+    {
+        if (index >= args.size())
+            return fallback;
+
+        try
+        {
+            return static_cast<uint32_t>(std::stoul(args[index]));
+        }
+        catch (const std::exception&)
+        {
+            return fallback;
+        }
+    }
+
+    void FillScreenshot(graphics::CpuImage& image)
+    {
+        std::mt19937 rng(11);
+        const uint32_t width = image.width;
+        const uint32_t height = image.height;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            uint8_t* row = image.Row(y);
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint8_t* p = row + x * 4;
+                const bool photo = x > width * 2 / 3 && y > height / 2;
+                if (photo)
+                {
+                    const uint32_t noise = rng() & 15;
+                    p[0] = static_cast<uint8_t>((x * 3 + noise) & 0xFF);
+                    p[1] = static_cast<uint8_t>((y * 2 + noise) & 0xFF);
+                    p[2] = static_cast<uint8_t>(((x ^ y) >> 2) + noise);
+                }
+                else
+                {
+                    const bool window = (x / 480 + y / 360) % 3 != 0;
+                    const bool text = window && (y % 24) < 10 && (x % 480) > 24 && ((x * 7 + y * 13) % 11) < 6;
+                    const uint8_t base = window ? 0xF3 : 0x2D;
+                    p[0] = text ? 0x30 : base;
+                    p[1] = text ? 0x30 : base;
+                    p[2] = text ? 0x30 : static_cast<uint8_t>(base + (window ? 0 : 3));
+                }
+                p[3] = 0xFF;
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "capturer/CaptureManager.h"
+#include "capturer/SyntheticCaptureSource.h"
+
+namespace lens::bench
+{
+    // 多源并发捕获的扩展性：合成源数量从 1 翻倍到 maxSources，统计总分发帧率
+    void BenchCaptureScaling(const std::vector<std::string>& args)
+    {
+        const uint32_t maxSources = GetArgU32(args, 0, 16);
+        const uint32_t width = GetArgU32(args, 1, 1920);
+        const uint32_t height = GetArgU32(args, 2, 1080);
+        const uint32_t fps = GetArgU32(args, 3, 240);
+        const uint32_t seconds = GetArgU32(args, 4, 2);
+
+        LOG_INFO("capture-scaling: {}x{} @ {} fps per source, {} s per step, {} hw threads",
+            width, height, fps, seconds, std::thread::hardware_concurrency());
+
+        for (uint32_t count = 1; count <= maxSources; count *= 2)
+        {
+            // 不传设备，帧只在系统内存中流转
+            capturer::CaptureManager manager(nullptr);
+
+            std::atomic<uint64_t> checksum{ 0 };
+            manager.SetFrameCallback([&checksum](const capturer::Frame& frame)
+            {
+                // 触碰像素，避免消费端被完全优化掉
+                if (frame.image && !frame.image->IsEmpty())
+                {
+                    checksum.fetch_add(frame.image->pixels[frame.image->pixels.size() / 2], std::memory_order_relaxed);
+                }
+            });
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                capturer::SyntheticCaptureSource::SyntheticDesc synthDesc{};
+                synthDesc.width = width;
+                synthDesc.height = height;
+                synthDesc.pattern = capturer::SyntheticCaptureSource::Pattern::MovingBox;
+
+                auto source = std::make_unique<capturer::SyntheticCaptureSource>(nullptr, synthDesc);
+                capturer::ICaptureSource::CaptureDesc captureDesc{};
+                captureDesc.frameRate = fps;
+                if (source->Initialize(captureDesc))
+                {
+                    manager.AddSource(std::move(source));
+                }
+            }
+
+            manager.Start();
+            std::this_thread::sleep_for(std::chrono::seconds(seconds));
+            auto stats = manager.GetStats();
+            manager.Stop();
+
+            LOG_INFO("  sources: {:2}  total: {:8.1f} frames/s  per source: {:6.1f}  dropped: {}",
+                count, stats.totalFps, stats.totalFps / count, stats.totalDropped);
+        }
+    }
+}
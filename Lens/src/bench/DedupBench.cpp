@@ -0,0 +1,116 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "capturer/FrameFingerprint.h"
+#include "capturer/SyntheticCaptureSource.h"
+#include "ThreadPool.h"
+#include <thread>
+
+namespace lens::bench
+{
+    namespace
+    {
+        struct DedupRun
+        {
+            uint64_t received = 0;
+            uint64_t receivedBytes = 0;
+            capturer::ICaptureSource::FrameStats stats;
+        };
+
+        DedupRun RunDesktop(uint32_t width, uint32_t height, uint32_t fps, uint32_t seconds,
+            capturer::FramePacer::Policy pacing, bool dedup, uint32_t maxDistance)
+        {
+            capturer::SyntheticCaptureSource::SyntheticDesc synthDesc{};
+            synthDesc.width = width;
+            synthDesc.height = height;
+            synthDesc.pattern = capturer::SyntheticCaptureSource::Pattern::Desktop;
+
+            capturer::ICaptureSource::CaptureDesc captureDesc{};
+            captureDesc.frameRate = fps;
+            captureDesc.pacing = pacing;
+            captureDesc.dedup = dedup;
+            captureDesc.dedupMaxDistance = maxDistance;
+
+            DedupRun run;
+            capturer::SyntheticCaptureSource source(nullptr, synthDesc);
+            if (!source.Initialize(captureDesc) || !source.StartCapture())
+                return run;
+
+            // 消费端只统计收到的帧和字节，模拟下游编码/保存的输入量
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+            capturer::Frame frame;
+            while (std::chrono::steady_clock::now() < deadline)
+            {
+                if (source.AcquireFrame(frame, std::chrono::milliseconds(50)) && frame.image)
+                {
+                    run.received++;
+                    run.receivedBytes += frame.image->GetSizeInBytes();
+                }
+            }
+
+            run.stats = source.GetFrameStats();
+            source.StopCapture();
+            source.Shutdown();
+            return run;
+        }
+    }
+
+    // 近似静止桌面下的去重效果：固定帧率、只要变化帧、变化帧加指纹去重三种配置对比下游收到的帧数和字节数
+    void BenchDedup(const std::vector<std::string>& args)
+    {
+        const uint32_t seconds = (std::max)(GetArgU32(args, 0, 3), 1u);
+        const uint32_t fps = (std::max)(GetArgU32(args, 1, 60), 1u);
+        const uint32_t maxDistance = GetArgU32(args, 2, 2);
+        const uint32_t width = 1920;
+        const uint32_t height = 1080;
+
+        // 单帧指纹耗时
+        graphics::CpuImage image;
+        image.Allocate(width, height, graphics::TextureFormat::BGRA8_UNorm);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            uint8_t* row = image.Row(y);
+            for (uint32_t x = 0; x < width * 4; ++x)
+            {
+                row[x] = static_cast<uint8_t>((x * 7 + y * 13) & 0xFF);
+            }
+        }
+
+        const uint32_t iterations = 50;
+        ThreadPool serial(0);
+        capturer::FrameFingerprint fingerprint;
+        const double serialSeconds = MeasureSeconds([&]
+        {
+            for (uint32_t i = 0; i < iterations; ++i)
+                fingerprint = capturer::ComputeFingerprint(image, &serial);
+        }) / iterations;
+        const double parallelSeconds = MeasureSeconds([&]
+        {
+            for (uint32_t i = 0; i < iterations; ++i)
+                fingerprint = capturer::ComputeFingerprint(image);
+        }) / iterations;
+
+        LOG_INFO("dedup: {}x{} desktop @ {} fps, {} s per run, maxDistance {}", width, height, fps, seconds, maxDistance);
+        LOG_INFO("  fingerprint 1080p: 1 thread {:.2f} ms  pool {:.2f} ms", serialSeconds * 1000.0, parallelSeconds * 1000.0);
+
+        struct Config
+        {
+            const char* name;
+            capturer::FramePacer::Policy pacing;
+            bool dedup;
+        };
+        const Config configs[] =
+        {
+            { "fixed-rate", capturer::FramePacer::Policy::FixedRate, false },
+            { "on-change", capturer::FramePacer::Policy::OnChangeOnly, false },
+            { "on-change+dedup", capturer::FramePacer::Policy::OnChangeOnly, true },
+        };
+
+        for (const auto& config : configs)
+        {
+            const DedupRun run = RunDesktop(width, height, fps, seconds, config.pacing, config.dedup, maxDistance);
+            LOG_INFO("  {:<16} delivered: {:5}  received: {:5} ({:8.1f} MB)  unchanged: {:5}  dedup: {:5} ({:8.1f} MB saved)",
+                config.name, run.stats.delivered, run.received, run.receivedBytes / (1024.0 * 1024.0),
+                run.stats.unchanged, run.stats.deduplicated, run.stats.dedupBytes / (1024.0 * 1024.0));
+        }
+    }
+}
@@ -0,0 +1,151 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "capturer/DeltaCodec.h"
+#include <cstring>
+
+namespace lens::bench
+{
+    namespace
+    {
+        enum class Scene
+        {
+            Desktop,    // 光标闪烁、时钟每秒变化，每 1.5 秒窗口内容滚动一次
+            Scrolling,  // 半屏窗口每帧滚动 2 行
+            Video       // 720p 区域每帧整体变化，其余静止
+        };
+
+        void FillRect(graphics::CpuImage& image, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color)
+        {
+            const uint32_t right = (std::min)(x + w, image.width);
+            const uint32_t bottom = (std::min)(y + h, image.height);
+            for (uint32_t row = y; row < bottom; ++row)
+            {
+                auto* pixels = reinterpret_cast<uint32_t*>(image.Row(row));
+                if (x < right)
+                    std::fill(pixels + x, pixels + right, color);
+            }
+        }
+
+        // 把区域内容上移 lines 行，底部补新的"文字"
+        void ScrollRegion(graphics::CpuImage& image, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t lines, uint32_t frameIndex)
+        {
+            const size_t rowBytes = static_cast<size_t>(w) * 4;
+            for (uint32_t row = y; row + lines < y + h; ++row)
+            {
+                std::memcpy(image.Row(row) + x * 4, image.Row(row + lines) + x * 4, rowBytes);
+            }
+            for (uint32_t row = y + h - lines; row < y + h; ++row)
+            {
+                auto* pixels = reinterpret_cast<uint32_t*>(image.Row(row)) + x;
+                const bool text = ((row + frameIndex * lines) % 24) < 10;
+                for (uint32_t i = 0; i < w; ++i)
+                {
+                    pixels[i] = text && ((i * 7 + row * 13) % 11) < 6 ? 0xFF303030 : 0xFFF3F3F3;
+                }
+            }
+        }
+
+        void UpdateScene(graphics::CpuImage& image, Scene scene, uint32_t frameIndex)
+        {
+            const uint32_t width = image.width;
+            const uint32_t height = image.height;
+
+            // 各场景共有：光标和时钟
+            FillRect(image, width / 3, height / 3, 2, 18, (frameIndex / 30) % 2 ? 0xFF000000 : 0xFFF3F3F3);
+            const uint32_t seconds = frameIndex / 60;
+            for (uint32_t digit = 0; digit < 4; ++digit)
+            {
+                FillRect(image, width - 80 + digit * 16, height - 30, 10, 20, ((seconds >> digit) & 1) ? 0xFFE0E0E0 : 0xFF1F1F1F);
+            }
+
+            switch (scene)
+            {
+            case Scene::Desktop:
+                if (frameIndex % 90 == 89)
+                {
+                    ScrollRegion(image, width / 8, height / 8, width / 2, height / 2, 72, frameIndex);
+                }
+                break;
+            case Scene::Scrolling:
+                ScrollRegion(image, width / 8, height / 8, width / 2, height / 2, 2, frameIndex);
+                break;
+            case Scene::Video:
+            {
+                // 平滑运动的渐变加少量纹理，近似播放中的视频
+                const uint32_t videoW = (std::min)(1280u, width);
+                const uint32_t videoH = (std::min)(720u, height);
+                for (uint32_t y = 0; y < videoH; ++y)
+                {
+                    uint8_t* p = image.Row(y) + static_cast<size_t>(width - videoW) * 4;
+                    for (uint32_t x = 0; x < videoW; ++x, p += 4)
+                    {
+                        const uint32_t t = frameIndex * 3;
+                        p[0] = static_cast<uint8_t>((x + t) / 3 + ((x * y) >> 11 & 3));
+                        p[1] = static_cast<uint8_t>((y * 2 + t) / 4);
+                        p[2] = static_cast<uint8_t>((x + y + t * 2) / 5);
+                    }
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    // 录制编码：不同内容下 60 fps 所需的写盘带宽，以及编码、解码单帧耗时（线程池）
+    void BenchDeltaCodec(const std::vector<std::string>& args)
+    {
+        const uint32_t frames = (std::max)(GetArgU32(args, 0, 240), 1u);
+        const uint32_t width = GetArgU32(args, 1, 3840);
+        const uint32_t height = GetArgU32(args, 2, 2160);
+
+        graphics::CpuImage base;
+        base.Allocate(width, height, graphics::TextureFormat::BGRA8_UNorm);
+        FillScreenshot(base);
+        const double rawMBps = base.GetSizeInBytes() * 60.0 / (1024.0 * 1024.0);
+
+        LOG_INFO("delta-codec: {}x{}, {} frames, raw 60 fps = {:.0f} MB/s", width, height, frames, rawMBps);
+
+        struct Config
+        {
+            const char* name;
+            Scene scene;
+        };
+        const Config configs[] =
+        {
+            { "desktop", Scene::Desktop },
+            { "scrolling", Scene::Scrolling },
+            { "video", Scene::Video },
+        };
+
+        std::vector<uint8_t> encoded;
+        for (const auto& config : configs)
+        {
+            graphics::CpuImage image = base;
+            capturer::DeltaEncoder encoder;
+            capturer::DeltaDecoder decoder;
+
+            double maxEncodeMs = 0.0;
+            double decodeMs = 0.0;
+            uint64_t keyframeBytes = 0;
+            bool lossless = true;
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                UpdateScene(image, config.scene, i);
+
+                bool keyframe = false;
+                const double encodeSeconds = MeasureSeconds([&] { encoder.Encode(image, encoded, &keyframe); });
+                maxEncodeMs = (std::max)(maxEncodeMs, encodeSeconds * 1000.0);
+                keyframeBytes += keyframe ? encoded.size() : 0;
+
+                decodeMs += MeasureSeconds([&] { lossless = decoder.Decode(encoded.data(), encoded.size()) && lossless; }) * 1000.0;
+            }
+            lossless = lossless && decoder.GetImage().pixels == image.pixels;
+
+            const auto& stats = encoder.GetStats();
+            const double mbps = stats.outputBytes * 60.0 / stats.frames / (1024.0 * 1024.0);
+            LOG_INFO("  {:<10} {:7.1f} MB/s at 60 fps ({:5.2f}% of raw, keyframes {:.0f}%)  encode avg {:6.2f} ms max {:6.2f} ms  decode avg {:6.2f} ms  {}",
+                config.name, mbps, stats.outputBytes * 100.0 / stats.inputBytes, keyframeBytes * 100.0 / stats.outputBytes,
+                stats.encodeMs / stats.frames, maxEncodeMs, decodeMs / frames, lossless ? "lossless" : "MISMATCH");
+        }
+    }
+}
@@ -0,0 +1,90 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "capturer/FrameDiff.h"
+#include "ThreadPool.h"
+#include <random>
+
+namespace lens::bench
+{
+    // 两帧差异检测耗时：完全相同（必须读完整帧）、局部变化、每行都有变化三种情况，
+    // 16 与 64 像素块，单线程与线程池对比
+    void BenchFrameDiff(const std::vector<std::string>& args)
+    {
+        const uint32_t iterations = (std::max)(GetArgU32(args, 0, 50), 1u);
+        const uint32_t width = GetArgU32(args, 1, 3840);
+        const uint32_t height = GetArgU32(args, 2, 2160);
+
+        graphics::CpuImage previous;
+        previous.Allocate(width, height, graphics::TextureFormat::BGRA8_UNorm);
+        std::mt19937 rng(99);
+        for (auto& value : previous.pixels)
+        {
+            value = static_cast<uint8_t>(rng());
+        }
+
+        // 局部变化：中间一块 200x120 的矩形
+        graphics::CpuImage partial = previous;
+        for (uint32_t y = height / 2; y < (std::min)(height, height / 2 + 120); ++y)
+        {
+            for (uint32_t x = width / 2; x < (std::min)(width, width / 2 + 200); ++x)
+            {
+                partial.Row(y)[x * 4] ^= 0xFF;
+            }
+        }
+
+        // 每行开头一个像素变化，每个块行的首块在第一行就判定为变化
+        graphics::CpuImage full = previous;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; x += 16)
+            {
+                full.Row(y)[x * 4 + 1] ^= 0x01;
+            }
+        }
+
+        // 内容相同但不是同一块内存，避免被直接判定为无变化
+        graphics::CpuImage identical = previous;
+
+        struct Case
+        {
+            const char* name;
+            const graphics::CpuImage* current;
+        };
+        const Case cases[] =
+        {
+            { "identical", &identical },
+            { "partial",   &partial },
+            { "full",      &full },
+        };
+
+        ThreadPool serial(0);
+        ThreadPool& parallel = ThreadPool::GetShared();
+
+        LOG_INFO("frame-diff: {}x{}, {} iterations, {} worker threads", width, height, iterations, parallel.GetThreadCount());
+
+        for (uint32_t tileSize : { 16u, 64u })
+        {
+            capturer::FrameDiff diff(tileSize);
+            capturer::FrameDiff::Result result;
+
+            for (const auto& testCase : cases)
+            {
+                double serialSeconds = MeasureSeconds([&]
+                {
+                    for (uint32_t i = 0; i < iterations; ++i)
+                        diff.Compare(&previous, *testCase.current, result, &serial);
+                }) / iterations;
+
+                double parallelSeconds = MeasureSeconds([&]
+                {
+                    for (uint32_t i = 0; i < iterations; ++i)
+                        diff.Compare(&previous, *testCase.current, result, &parallel);
+                }) / iterations;
+
+                LOG_INFO("  tile {:2}  {:<9}  1 thread: {:6.3f} ms  pool: {:6.3f} ms  dirty tiles: {}/{}  rects: {}",
+                    tileSize, testCase.name, serialSeconds * 1000.0, parallelSeconds * 1000.0,
+                    result.dirtyTiles, result.tilesX * result.tilesY, result.rects.size());
+            }
+        }
+    }
+}
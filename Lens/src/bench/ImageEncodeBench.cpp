@@ -0,0 +1,80 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "graphics/ImageEncoder.h"
+#include "ThreadPool.h"
+
+namespace lens::bench
+{
+    // 各编码器的编码吞吐（按未压缩像素计 MB/s）和输出大小，单线程与线程池对比
+    void BenchImageEncode(const std::vector<std::string>& args)
+    {
+        const uint32_t iterations = (std::max)(GetArgU32(args, 0, 3), 1u);
+        const uint32_t width = GetArgU32(args, 1, 3840);
+        const uint32_t height = GetArgU32(args, 2, 2160);
+
+        graphics::CpuImage image;
+        image.Allocate(width, height, graphics::TextureFormat::BGRA8_UNorm);
+        FillScreenshot(image);
+        const double inputMB = image.GetSizeInBytes() / (1024.0 * 1024.0);
+
+        ThreadPool serial(0);
+        ThreadPool& parallel = ThreadPool::GetShared();
+
+        LOG_INFO("image-encode: {}x{} ({:.1f} MB), {} iterations, {} worker threads",
+            width, height, inputMB, iterations, parallel.GetThreadCount());
+
+        struct Config
+        {
+            graphics::ImageCodec codec;
+            uint32_t pngLevel;
+        };
+        const Config configs[] =
+        {
+            { graphics::ImageCodec::BMP, 0 },
+            { graphics::ImageCodec::QOI, 0 },
+            { graphics::ImageCodec::PNG, 1 },
+            { graphics::ImageCodec::PNG, 3 },
+            { graphics::ImageCodec::PNG, 6 },
+            { graphics::ImageCodec::JPEG, 0 },
+        };
+
+        std::vector<uint8_t> encoded;
+        for (const auto& config : configs)
+        {
+            graphics::ImageEncodeOptions options;
+            options.codec = config.codec;
+            options.pngLevel = config.pngLevel;
+
+            options.pool = &serial;
+            const double serialSeconds = MeasureSeconds([&]
+            {
+                for (uint32_t i = 0; i < iterations; ++i)
+                    graphics::EncodeImage(image, encoded, options);
+            }) / iterations;
+
+            options.pool = &parallel;
+            const double parallelSeconds = MeasureSeconds([&]
+            {
+                for (uint32_t i = 0; i < iterations; ++i)
+                    graphics::EncodeImage(image, encoded, options);
+            }) / iterations;
+
+            // QOI 可以在进程内解码，顺便校验无损
+            const char* check = "";
+            if (config.codec == graphics::ImageCodec::QOI)
+            {
+                graphics::CpuImage decoded;
+                const bool lossless = graphics::DecodeQoi(encoded.data(), encoded.size(), decoded) &&
+                    decoded.pixels == image.pixels;
+                check = lossless ? "  lossless" : "  MISMATCH";
+            }
+
+            const std::string name = config.codec == graphics::ImageCodec::PNG
+                ? "PNG-" + std::to_string(config.pngLevel)
+                : std::string(graphics::GetImageCodecName(config.codec));
+            LOG_INFO("  {:<6} 1 thread: {:7.1f} ms ({:6.0f} MB/s)  pool: {:7.1f} ms ({:6.0f} MB/s)  size: {:7.2f} MB ({:5.1f}%){}",
+                name, serialSeconds * 1000.0, inputMB / serialSeconds, parallelSeconds * 1000.0, inputMB / parallelSeconds,
+                encoded.size() / (1024.0 * 1024.0), encoded.size() * 100.0 / image.GetSizeInBytes(), check);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "capturer/FrameMailbox.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace lens::bench
+{
+    namespace
+    {
+        // 原来的交接方式：锁保护的 shared_ptr 加一个新帧标记，作为对照
+        class LockedHandoff
+        {
+        public:
+            void Publish(std::shared_ptr<uint64_t> value)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_published++;
+                m_dropped += m_hasNew ? 1 : 0;
+                m_value = std::move(value);
+                m_hasNew = true;
+            }
+
+            bool TryTake(std::shared_ptr<uint64_t>& out)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_hasNew)
+                    return false;
+                out = m_value;
+                m_hasNew = false;
+                return true;
+            }
+
+            uint64_t GetPublishedCount() const { return m_published; }
+            uint64_t GetDroppedCount() const { return m_dropped; }
+
+        private:
+            std::mutex m_mutex;
+            std::shared_ptr<uint64_t> m_value;
+            bool m_hasNew = false;
+            uint64_t m_published = 0;
+            uint64_t m_dropped = 0;
+        };
+
+        struct HandoffResult
+        {
+            uint64_t published = 0;
+            uint64_t taken = 0;
+            uint64_t dropped = 0;
+            double seconds = 0.0;
+        };
+
+        // 生产者尽快发布，消费者尽快取；帧内容是 shared_ptr，和捕获管线中的 Frame 一样有引用计数开销
+        template<typename Handoff, typename TakeFn>
+        HandoffResult RunHandoff(Handoff& handoff, uint32_t milliseconds, TakeFn take)
+        {
+            std::atomic<bool> stop{ false };
+            HandoffResult result;
+            std::thread producer([&]
+            {
+                uint64_t sequence = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    handoff.Publish(std::make_shared<uint64_t>(++sequence));
+                }
+            });
+
+            std::shared_ptr<uint64_t> value;
+            result.seconds = MeasureSeconds([&]
+            {
+                const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+                while (std::chrono::steady_clock::now() < end)
+                {
+                    result.taken += take(handoff, value) ? 1 : 0;
+                }
+                stop = true;
+                producer.join();
+            });
+
+            result.published = handoff.GetPublishedCount();
+            result.dropped = handoff.GetDroppedCount();
+            return result;
+        }
+
+        void LogResult(const char* name, const HandoffResult& result)
+        {
+            LOG_INFO("  {:<22} published {:>7.2f} M/s  taken {:>7.2f} M/s  dropped {:5.1f}%",
+                name, result.published / result.seconds / 1e6, result.taken / result.seconds / 1e6,
+                result.published > 0 ? result.dropped * 100.0 / result.published : 0.0);
+        }
+    }
+
+    // 生产者/消费者交接吞吐：三缓冲邮箱（轮询和阻塞等待）对比锁保护的 shared_ptr
+    void BenchMailbox(const std::vector<std::string>& args)
+    {
+        const uint32_t milliseconds = (std::max)(GetArgU32(args, 0, 1000), 10u);
+        LOG_INFO("mailbox: {} ms per run", milliseconds);
+
+        {
+            capturer::FrameMailbox<std::shared_ptr<uint64_t>> mailbox;
+            LogResult("mailbox TryTake", RunHandoff(mailbox, milliseconds,
+                [](auto& handoff, auto& value) { return handoff.TryTake(value); }));
+        }
+        {
+            capturer::FrameMailbox<std::shared_ptr<uint64_t>> mailbox;
+            LogResult("mailbox WaitTake", RunHandoff(mailbox, milliseconds,
+                [](auto& handoff, auto& value) { return handoff.WaitTake(value, std::chrono::milliseconds(1)); }));
+        }
+        {
+            LockedHandoff locked;
+            LogResult("mutex + shared_ptr", RunHandoff(locked, milliseconds,
+                [](auto& handoff, auto& value) { return handoff.TryTake(value); }));
+        }
+    }
+}
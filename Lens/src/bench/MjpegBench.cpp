@@ -0,0 +1,59 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "graphics/ImageEncoder.h"
+#include "ThreadPool.h"
+#include <thread>
+
+namespace lens::bench
+{
+    // JPEG 编码帧率随线程数的变化，1080p 与 4K。单帧按 MCU 行（重启间隔）切分到线程池
+    void BenchMjpeg(const std::vector<std::string>& args)
+    {
+        const uint32_t frames = (std::max)(GetArgU32(args, 0, 20), 1u);
+        const uint32_t quality = GetArgU32(args, 1, 85);
+        const uint32_t hardware = (std::max)(std::thread::hardware_concurrency(), 1u);
+        const uint32_t maxThreads = (std::max)(GetArgU32(args, 2, hardware), 1u);
+
+        LOG_INFO("mjpeg: {} frames per run, quality {}, up to {} threads ({} hardware)", frames, quality, maxThreads, hardware);
+
+        std::vector<uint32_t> threadCounts;
+        for (uint32_t count = 1; count < maxThreads; count *= 2)
+        {
+            threadCounts.push_back(count);
+        }
+        threadCounts.push_back(maxThreads);
+
+        const std::pair<uint32_t, uint32_t> sizes[] = { { 1920, 1080 }, { 3840, 2160 } };
+        std::vector<uint8_t> encoded;
+        for (const auto& [width, height] : sizes)
+        {
+            graphics::CpuImage image;
+            image.Allocate(width, height, graphics::TextureFormat::BGRA8_UNorm);
+            FillScreenshot(image);
+
+            LOG_INFO("  {}x{}", width, height);
+            double baseline = 0.0;
+            for (uint32_t threads : threadCounts)
+            {
+                // 调用线程也参与 ParallelFor，工作线程数少一个
+                ThreadPool pool(threads - 1);
+                graphics::ImageEncodeOptions options;
+                options.codec = graphics::ImageCodec::JPEG;
+                options.jpegQuality = quality;
+                options.pool = &pool;
+
+                graphics::EncodeImage(image, encoded, options);
+                const double seconds = MeasureSeconds([&]
+                {
+                    for (uint32_t i = 0; i < frames; ++i)
+                        graphics::EncodeImage(image, encoded, options);
+                }) / frames;
+
+                if (baseline == 0.0)
+                    baseline = seconds;
+                LOG_INFO("    {:>2} threads: {:6.1f} fps  {:6.2f} ms/frame  x{:.2f}  {:.0f} KB/frame",
+                    threads, 1.0 / seconds, seconds * 1000.0, baseline / seconds, encoded.size() / 1024.0);
+            }
+        }
+    }
+}
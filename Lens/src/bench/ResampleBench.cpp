@@ -0,0 +1,99 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "graphics/Resampler.h"
+#include "ThreadPool.h"
+#include <cstring>
+#include <random>
+
+namespace lens::bench
+{
+    // 4K 源图缩放到各预览尺寸的耗时，单线程与线程池对比，并以整帧复制耗时作参照
+    void BenchResample(const std::vector<std::string>& args)
+    {
+        const uint32_t iterations = (std::max)(GetArgU32(args, 0, 10), 1u);
+        const uint32_t srcWidth = GetArgU32(args, 1, 3840);
+        const uint32_t srcHeight = GetArgU32(args, 2, 2160);
+
+        // 渐变加噪声，避免纯随机数据让所有滤波器表现相同
+        graphics::CpuImage source;
+        source.Allocate(srcWidth, srcHeight, graphics::TextureFormat::BGRA8_UNorm);
+        std::mt19937 rng(7);
+        for (uint32_t y = 0; y < srcHeight; ++y)
+        {
+            uint8_t* row = source.Row(y);
+            for (uint32_t x = 0; x < srcWidth; ++x)
+            {
+                const uint32_t noise = rng() & 31;
+                row[x * 4 + 0] = static_cast<uint8_t>((x * 255 / srcWidth + noise) & 0xFF);
+                row[x * 4 + 1] = static_cast<uint8_t>((y * 255 / srcHeight + noise) & 0xFF);
+                row[x * 4 + 2] = static_cast<uint8_t>(((x + y) & 0xFF) ^ noise);
+                row[x * 4 + 3] = 255;
+            }
+        }
+
+        std::vector<uint8_t> copy(source.GetSizeInBytes());
+        const double copySeconds = MeasureSeconds([&]
+        {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                std::memcpy(copy.data(), source.pixels.data(), copy.size());
+            }
+        }) / iterations;
+
+        ThreadPool serial(0);
+        ThreadPool& parallel = ThreadPool::GetShared();
+
+        LOG_INFO("resample: {}x{} source, {} iterations, {} worker threads, full-frame copy {:.3f} ms",
+            srcWidth, srcHeight, iterations, parallel.GetThreadCount(), copySeconds * 1000.0);
+
+        const uint32_t divisors[] = { 2, 4, 12 };
+        const graphics::ResampleFilter filters[] =
+        {
+            graphics::ResampleFilter::Box,
+            graphics::ResampleFilter::Bilinear,
+            graphics::ResampleFilter::Lanczos3,
+        };
+
+        for (uint32_t divisor : divisors)
+        {
+            const uint32_t dstWidth = (std::max)(1u, srcWidth / divisor);
+            const uint32_t dstHeight = (std::max)(1u, srcHeight / divisor);
+
+            for (auto filter : filters)
+            {
+                graphics::Resampler resampler;
+                graphics::CpuImage output;
+
+                // 首次调用构建系数表，不计入耗时
+                resampler.Resample(source, dstWidth, dstHeight, filter, output, &serial);
+
+                const double serialSeconds = MeasureSeconds([&]
+                {
+                    for (uint32_t i = 0; i < iterations; ++i)
+                        resampler.Resample(source, dstWidth, dstHeight, filter, output, &serial);
+                }) / iterations;
+
+                const double parallelSeconds = MeasureSeconds([&]
+                {
+                    for (uint32_t i = 0; i < iterations; ++i)
+                        resampler.Resample(source, dstWidth, dstHeight, filter, output, &parallel);
+                }) / iterations;
+
+                LOG_INFO("  {:>4}x{:<4} {:<8}  1 thread: {:7.2f} ms  pool: {:7.2f} ms  speedup: {:4.1f}x  vs copy: {:5.2f}x",
+                    dstWidth, dstHeight, graphics::GetResampleFilterName(filter),
+                    serialSeconds * 1000.0, parallelSeconds * 1000.0,
+                    serialSeconds / parallelSeconds, parallelSeconds / copySeconds);
+            }
+        }
+
+        // 逐级减半的预览层级
+        graphics::Resampler resampler;
+        std::vector<graphics::CpuImage> levels;
+        const double levelSeconds = MeasureSeconds([&]
+        {
+            for (uint32_t i = 0; i < iterations; ++i)
+                resampler.BuildPreviewLevels(source, 64, levels, &parallel);
+        }) / iterations;
+        LOG_INFO("  preview levels down to 64 px: {} levels, {:.2f} ms", levels.size(), levelSeconds * 1000.0);
+    }
+}
@@ -0,0 +1,91 @@
+﻿#include "LensPch.h"
+#include "bench/Benchmark.h"
+#include "graphics/Shader.h"
+#include "graphics/ShaderCache.h"
+
+namespace lens::bench
+{
+    namespace
+    {
+        const char* kVertexSource = R"(
+            float4 main(uint vertexID : SV_VertexID) : SV_Position
+            {
+                float2 positions[3] = { float2(-1.0, -1.0), float2(-1.0, 3.0), float2(3.0, -1.0) };
+                return float4(positions[vertexID], 0.0, 1.0);
+            }
+        )";
+
+        const char* kPixelSource = R"(
+            Texture2D tex0 : register(t0);
+            SamplerState sampler0 : register(s0);
+            cbuffer CaptureParams : register(b0)
+            {
+                float2 WindowSize;
+                float2 TextureSize;
+            }
+            float4 main(float4 position : SV_Position) : SV_Target0
+            {
+                float4 color = tex0.Sample(sampler0, position.xy / WindowSize);
+            #if GAMMA
+                color.rgb = pow(abs(color.rgb), 1.0 / 2.2);
+            #endif
+                return color;
+            }
+        )";
+
+        // 启动时的一组着色器：一个顶点着色器和两个宏变体的像素着色器
+        bool CompileStartupSet(graphics::ShaderCache& cache)
+        {
+            const graphics::ShaderCache::Define gamma[] = { { "GAMMA", "1" } };
+            std::vector<uint8_t> bytecode;
+            return graphics::Shader::CompileSource(kVertexSource, "BenchVS", "main", "vs_5_0",
+                       D3DCOMPILE_ENABLE_STRICTNESS, bytecode, {}, &cache) &&
+                   graphics::Shader::CompileSource(kPixelSource, "BenchPS", "main", "ps_5_0",
+                       D3DCOMPILE_ENABLE_STRICTNESS, bytecode, {}, &cache) &&
+                   graphics::Shader::CompileSource(kPixelSource, "BenchPS", "main", "ps_5_0",
+                       D3DCOMPILE_ENABLE_STRICTNESS, bytecode, gamma, &cache);
+        }
+    }
+
+    // 着色器冷启动（缓存为空，全部编译并写入）与热启动（全部从缓存读取）的耗时
+    void BenchShaderCache(const std::vector<std::string>& args)
+    {
+        const uint32_t iterations = (std::max)(GetArgU32(args, 0, 5), 1u);
+
+        graphics::ShaderCache::Desc desc;
+        desc.directory = std::filesystem::temp_directory_path() / "lens_shadercache_bench";
+        LOG_INFO("shader-cache: {} iterations, cache at {}", iterations, desc.directory.string());
+
+        double coldSeconds = 0.0;
+        double warmSeconds = 0.0;
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            std::error_code ec;
+            std::filesystem::remove_all(desc.directory, ec);
+
+            graphics::ShaderCache cache(desc);
+            bool ok = true;
+            coldSeconds += MeasureSeconds([&] { ok = CompileStartupSet(cache); });
+            warmSeconds += MeasureSeconds([&] { ok = CompileStartupSet(cache) && ok; });
+            if (!ok)
+            {
+                LOG_ERROR("shader-cache: compilation failed");
+                return;
+            }
+
+            const auto stats = cache.GetStats();
+            if (stats.hits != stats.stores)
+            {
+                LOG_WARN("shader-cache: {} stored but {} hit", stats.stores, stats.hits);
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::remove_all(desc.directory, ec);
+
+        const double coldMs = coldSeconds * 1000.0 / iterations;
+        const double warmMs = warmSeconds * 1000.0 / iterations;
+        LOG_INFO("  cold start: {:8.2f} ms  (compile + store)", coldMs);
+        LOG_INFO("  warm start: {:8.2f} ms  (load + validate)  x{:.1f}", warmMs, coldMs / (std::max)(warmMs, 1e-6));
+    }
+}
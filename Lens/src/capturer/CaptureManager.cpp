@@ -0,0 +1,212 @@
+﻿#include "LensPch.h"
+#include "capturer/CaptureManager.h"
+
+namespace lens::capturer
+{
+    CaptureManager::CaptureManager(lens::graphics::GraphicsDevice* device)
+        : m_device(device)
+    {
+    }
+
+    CaptureManager::~CaptureManager()
+    {
+        Stop();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& session : m_sessions)
+        {
+            session->source->Shutdown();
+        }
+        m_sessions.clear();
+    }
+
+    uint32_t CaptureManager::AddSource(std::unique_ptr<ICaptureSource> source, uint32_t fpsBudget)
+    {
+        if (!source)
+        {
+            LOG_ERROR("CaptureManager: null source");
+            return 0;
+        }
+
+        auto session = std::make_unique<Session>();
+        session->source = std::move(source);
+
+        FramePacer::Desc budgetDesc{};
+        budgetDesc.policy = fpsBudget > 0 ? FramePacer::Policy::FixedRate : FramePacer::Policy::Unlimited;
+        budgetDesc.frameRate = fpsBudget;
+        session->budget.Configure(budgetDesc);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        session->id = m_nextId++;
+        if (m_running && !StartSession(*session))
+        {
+            return 0;
+        }
+
+        uint32_t id = session->id;
+        LOG_INFO("CaptureManager: added source {} ({}), fps budget: {}", id, session->source->GetName(), fpsBudget);
+        m_sessions.push_back(std::move(session));
+        return id;
+    }
+
+    bool CaptureManager::RemoveSource(uint32_t id)
+    {
+        std::unique_ptr<Session> removed;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = std::find_if(m_sessions.begin(), m_sessions.end(),
+                [id](const std::unique_ptr<Session>& session) { return session->id == id; });
+            if (it == m_sessions.end())
+            {
+                return false;
+            }
+            removed = std::move(*it);
+            m_sessions.erase(it);
+        }
+
+        StopSession(*removed);
+        removed->source->Shutdown();
+        LOG_INFO("CaptureManager: removed source {}", id);
+        return true;
+    }
+
+    size_t CaptureManager::GetSourceCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_sessions.size();
+    }
+
+    bool CaptureManager::Start()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_running)
+        {
+            LOG_WARN("CaptureManager already running");
+            return false;
+        }
+
+        bool allStarted = true;
+        for (auto& session : m_sessions)
+        {
+            allStarted &= StartSession(*session);
+        }
+
+        m_running = true;
+        LOG_INFO("CaptureManager started {} sources", m_sessions.size());
+        return allStarted;
+    }
+
+    void CaptureManager::Stop()
+    {
+        // 回调里可能调用 GetStats 或 RemoveSource，等待线程时不能持有锁。
+        // 在锁内取走所有会话，期间 RemoveSource 找不到它们，也就不会在线程退出前销毁
+        std::vector<std::unique_ptr<Session>> sessions;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_running)
+                return;
+
+            m_running = false;
+            sessions = std::move(m_sessions);
+            m_sessions.clear();
+        }
+
+        // 先通知所有线程退出，再逐个等待，避免串行等待超时
+        for (auto& session : sessions)
+        {
+            session->running = false;
+        }
+        for (auto& session : sessions)
+        {
+            StopSession(*session);
+        }
+
+        // 放回原来的位置，停止期间新加的源排在后面
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_sessions.insert(m_sessions.begin(),
+                std::make_move_iterator(sessions.begin()), std::make_move_iterator(sessions.end()));
+        }
+        LOG_INFO("CaptureManager stopped");
+    }
+
+    bool CaptureManager::StartSession(Session& session)
+    {
+        if (!session.source->IsCapturing() && !session.source->StartCapture())
+        {
+            LOG_ERROR("CaptureManager: failed to start source {} ({})", session.id, session.source->GetName());
+            return false;
+        }
+
+        session.budget.Reset();
+        session.startTime = std::chrono::steady_clock::now();
+        session.running = true;
+        session.worker = std::thread(&CaptureManager::WorkerLoop, this, std::ref(session));
+        return true;
+    }
+
+    void CaptureManager::StopSession(Session& session)
+    {
+        session.running = false;
+        if (session.worker.joinable())
+        {
+            session.worker.join();
+        }
+        session.source->StopCapture();
+    }
+
+    void CaptureManager::WorkerLoop(Session& session)
+    {
+        while (session.running)
+        {
+            // 带超时等待，保证 Stop 时能及时退出
+            Frame frame;
+            if (!session.source->AcquireFrame(frame, std::chrono::milliseconds(50)))
+            {
+                continue;
+            }
+
+            if (!session.budget.ShouldForward(GetTimestamp()))
+            {
+                continue;
+            }
+
+            frame.descriptor.sourceId = session.id;
+            if (m_callback)
+            {
+                m_callback(frame);
+            }
+        }
+    }
+
+    CaptureManager::Stats CaptureManager::GetStats() const
+    {
+        Stats stats;
+        auto now = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& session : m_sessions)
+        {
+            SourceStats sourceStats;
+            sourceStats.id = session->id;
+            sourceStats.name = session->source->GetName();
+            sourceStats.received = session->budget.GetDeliveredCount();
+            sourceStats.dispatched = session->budget.GetForwardedCount();
+            sourceStats.budgetDropped = session->budget.GetDecimatedCount();
+            sourceStats.sourceDropped = session->source->GetFrameStats().dropped;
+
+            double elapsed = std::chrono::duration<double>(now - session->startTime).count();
+            if (session->running && elapsed > 0.0)
+            {
+                sourceStats.fps = static_cast<double>(sourceStats.dispatched) / elapsed;
+            }
+
+            stats.totalReceived += sourceStats.received;
+            stats.totalDispatched += sourceStats.dispatched;
+            stats.totalDropped += sourceStats.budgetDropped + sourceStats.sourceDropped;
+            stats.totalFps += sourceStats.fps;
+            stats.sources.push_back(std::move(sourceStats));
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,271 @@
+﻿#include "LensPch.h"
+#include "capturer/CpuCaptureSource.h"
+
+namespace lens::capturer
+{
+    CpuCaptureSource::CpuCaptureSource(lens::graphics::GraphicsDevice* device)
+        : m_device(device)
+    {
+    }
+
+    CpuCaptureSource::~CpuCaptureSource()
+    {
+        // 子类析构时应先调用 Shutdown，这里兜底停止工作线程
+        StopCapture();
+    }
+
+    bool CpuCaptureSource::Initialize(const CaptureDesc& desc)
+    {
+        if (desc.frameRate == 0)
+        {
+            LOG_ERROR("{}: frame rate must be non-zero", GetName());
+            return false;
+        }
+
+        m_desc = desc;
+        m_dedup.Configure(FrameDeduplicator::Desc{ m_desc.dedup, m_desc.dedupMaxDistance });
+        if (!OnInitialize())
+        {
+            return false;
+        }
+
+        LOG_INFO("{} source initialized, fps: {}", GetName(), m_desc.frameRate);
+        return true;
+    }
+
+    void CpuCaptureSource::Shutdown()
+    {
+        StopCapture();
+
+        m_frames.Reset();
+        m_texture = nullptr;
+        m_texturePool = nullptr;
+        m_previousImage = nullptr;
+        m_hasUploaded = false;
+    }
+
+    bool CpuCaptureSource::StartCapture()
+    {
+        if (m_isCapturing)
+        {
+            LOG_WARN("Already capturing");
+            return false;
+        }
+
+        m_frames.Reset();
+        m_latency.Reset();
+        m_previousImage = nullptr;
+        m_unchangedCount = 0;
+        m_dedup.Reset();
+        m_lastFingerprint = {};
+        m_pendingDirty.clear();
+        m_isCapturing = true;
+        m_worker = std::thread(&CpuCaptureSource::WorkerLoop, this);
+
+        LOG_INFO("{} capture started", GetName());
+        return true;
+    }
+
+    void CpuCaptureSource::StopCapture()
+    {
+        if (!m_isCapturing)
+            return;
+
+        m_isCapturing = false;
+        if (m_worker.joinable())
+        {
+            m_worker.join();
+        }
+
+        LOG_INFO("{} capture stopped, {} frames produced, {} dropped",
+            GetName(), m_frames.GetPublishedCount(), m_frames.GetDroppedCount());
+        m_latency.LogSummary(GetName());
+    }
+
+    CpuCaptureSource::FrameStats CpuCaptureSource::GetFrameStats() const
+    {
+        // 工作线程本身按帧率产出，交付即转发
+        FrameStats stats;
+        stats.delivered = m_frames.GetPublishedCount();
+        stats.forwarded = stats.delivered;
+        stats.dropped = m_frames.GetDroppedCount();
+        stats.unchanged = m_unchangedCount.load(std::memory_order_relaxed);
+        stats.deduplicated = m_dedup.GetDroppedCount();
+        stats.dedupBytes = m_dedup.GetDroppedBytes();
+        return stats;
+    }
+
+    std::shared_ptr<const lens::graphics::CpuImage> CpuCaptureSource::GetLatestImage()
+    {
+        Frame frame;
+        if (m_frames.TryTake(frame))
+        {
+            m_latency.Record(FrameLatency::Stage::Pickup, frame.descriptor.captureTime);
+        }
+        return frame.image;
+    }
+
+    bool CpuCaptureSource::AcquireFrame(Frame& frame, std::chrono::milliseconds timeout)
+    {
+        if (!m_frames.WaitTake(frame, timeout))
+            return false;
+
+        m_latency.Record(FrameLatency::Stage::Pickup, frame.descriptor.captureTime);
+        return true;
+    }
+
+    Frame CpuCaptureSource::GetLatestFrame()
+    {
+        // 没有设备时不取帧，留给 GetLatestImage / AcquireFrame
+        if (!m_device)
+            return {};
+
+        Frame frame;
+        if (!m_frames.TryTake(frame))
+            return {};
+
+        m_latency.Record(FrameLatency::Stage::Pickup, frame.descriptor.captureTime);
+        UploadFrame(frame);
+        if (!m_texture)
+            return {};
+
+        // CPU 源的"复制"就是上传
+        m_latency.Record(FrameLatency::Stage::CopyDone, frame.descriptor.captureTime);
+        frame.texture = m_texture;
+        return frame;
+    }
+
+    void CpuCaptureSource::UploadFrame(const Frame& frame)
+    {
+        const auto& image = frame.image;
+        const auto& descriptor = frame.descriptor;
+
+        if (!m_texturePool)
+        {
+            m_texturePool = std::make_unique<lens::graphics::TexturePool>(m_device);
+        }
+        m_texturePool->EndFrame();
+
+        const bool sizeChanged = !m_texture ||
+            m_texture->GetWidth() != image->width || m_texture->GetHeight() != image->height ||
+            m_texture->GetFormat() != image->format;
+        const bool incremental = !sizeChanged && m_hasUploaded && descriptor.dirtyKnown &&
+            descriptor.sequence == m_uploadedSequence + 1;
+
+        // 写时复制：消费端还持有上一帧的纹理时不能原地更新，换一张池里的纹理，
+        // 增量更新时先复制上一帧内容再写脏区
+        auto target = m_texture;
+        if (sizeChanged || m_texture.use_count() > 1)
+        {
+            if (sizeChanged)
+            {
+                m_texturePool->TrimOtherSizes(image->width, image->height, image->format);
+            }
+
+            target = m_texturePool->Acquire(image->width, image->height, image->format);
+            if (!target || (incremental && !target->CopyFrom(m_device, *m_texture)))
+            {
+                LOG_ERROR("Failed to create texture for {} frame", GetName());
+                m_texture = nullptr;
+                m_hasUploaded = false;
+                return;
+            }
+        }
+
+        if (incremental)
+        {
+            // 纹理里已经是上一帧，只更新变化的区域，没有变化时什么都不做
+            const uint32_t bytesPerPixel = lens::graphics::GetFormatBytesPerPixel(image->format);
+            for (const auto& rect : descriptor.dirtyRects)
+            {
+                target->UpdateRegion(m_device, image->Row(rect.y) + static_cast<size_t>(rect.x) * bytesPerPixel,
+                    image->rowPitch, rect.x, rect.y, rect.width, rect.height);
+            }
+        }
+        else
+        {
+            target->UpdateData(m_device, image->pixels.data(), image->GetSizeInBytes());
+        }
+
+        m_texture = std::move(target);
+        m_uploadedSequence = descriptor.sequence;
+        m_hasUploaded = true;
+    }
+
+    void CpuCaptureSource::WorkerLoop()
+    {
+        using clock = std::chrono::steady_clock;
+        const auto interval = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(1.0 / m_desc.frameRate));
+
+        auto nextFrameTime = clock::now();
+        uint64_t frameIndex = 0;
+        uint64_t sequence = 0;
+
+        while (m_isCapturing)
+        {
+            int64_t captureTime = GetTimestamp();
+            auto image = ProduceFrame(frameIndex);
+            if (image)
+            {
+                Frame frame;
+                m_frameDiff.Compare(m_previousImage.get(), *image, m_diffResult);
+                frame.descriptor.dirtyRects = m_diffResult.rects;
+                frame.descriptor.dirtyKnown = true;
+                m_previousImage = image;
+
+                bool unchanged = frame.descriptor.dirtyRects.empty();
+                if (unchanged)
+                {
+                    m_unchangedCount.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                if (m_desc.dedup)
+                {
+                    if (!unchanged || !m_lastFingerprint.valid)
+                    {
+                        m_lastFingerprint = ComputeFingerprint(*image);
+                    }
+                    frame.descriptor.fingerprint = m_lastFingerprint;
+                }
+
+                // 只要变化帧时，没变化的帧不进入管线；去重丢弃的帧把脏区留给下一次发布
+                bool publish = !unchanged || m_desc.pacing != FramePacer::Policy::OnChangeOnly;
+                if (publish && m_dedup.ShouldDrop(frame.descriptor.fingerprint, image->GetSizeInBytes()))
+                {
+                    AccumulateDirtyRects(m_pendingDirty, frame.descriptor.dirtyRects);
+                    publish = false;
+                }
+
+                if (publish)
+                {
+                    if (!m_pendingDirty.empty())
+                    {
+                        AccumulateDirtyRects(m_pendingDirty, frame.descriptor.dirtyRects);
+                        frame.descriptor.dirtyRects.swap(m_pendingDirty);
+                        m_pendingDirty.clear();
+                    }
+
+                    frame.descriptor.sequence = sequence++;
+                    frame.descriptor.captureTime = captureTime;
+                    frame.descriptor.width = image->width;
+                    frame.descriptor.height = image->height;
+                    frame.image = std::move(image);
+                    m_latency.Record(FrameLatency::Stage::Arrival, captureTime);
+                    m_frames.Publish(std::move(frame));
+                    NotifyFrameListener();
+                }
+            }
+            frameIndex++;
+
+            // 落后时不补帧，直接对齐到当前时间
+            nextFrameTime += interval;
+            auto now = clock::now();
+            if (nextFrameTime < now)
+            {
+                nextFrameTime = now;
+            }
+            std::this_thread::sleep_until(nextFrameTime);
+        }
+    }
+}
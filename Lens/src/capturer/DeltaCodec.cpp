@@ -0,0 +1,347 @@
+﻿#include "LensPch.h"
+#include "capturer/DeltaCodec.h"
+#include "Lz4.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstring>
+
+namespace lens::capturer
+{
+    using namespace deltaformat;
+
+    namespace
+    {
+        // dst = a ^ b，按 8 字节处理，编译器会进一步向量化
+        void XorBytes(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t size)
+        {
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                uint64_t x, y;
+                std::memcpy(&x, a + i, 8);
+                std::memcpy(&y, b + i, 8);
+                x ^= y;
+                std::memcpy(dst + i, &x, 8);
+            }
+            for (; i < size; ++i)
+            {
+                dst[i] = a[i] ^ b[i];
+            }
+        }
+
+        // 块在帧内的像素范围
+        struct TileRect
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+            uint32_t height;
+        };
+
+        TileRect GetTileRect(uint32_t index, uint32_t tilesX, uint32_t tileSize, uint32_t width, uint32_t height)
+        {
+            TileRect rect;
+            rect.x = (index % tilesX) * tileSize;
+            rect.y = (index / tilesX) * tileSize;
+            rect.width = (std::min)(tileSize, width - rect.x);
+            rect.height = (std::min)(tileSize, height - rect.y);
+            return rect;
+        }
+    }
+
+    DeltaEncoder::DeltaEncoder()
+        : DeltaEncoder(Desc{})
+    {
+    }
+
+    DeltaEncoder::DeltaEncoder(const Desc& desc)
+        : m_desc(desc), m_diff((std::max)(desc.tileSize, 8u))
+    {
+        m_desc.tileSize = m_diff.GetTileSize();
+    }
+
+    bool DeltaEncoder::Encode(const lens::graphics::CpuImage& image, std::vector<uint8_t>& output, bool* keyframe)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        const uint32_t bytesPerPixel = lens::graphics::GetFormatBytesPerPixel(image.format);
+        if (image.IsEmpty() || bytesPerPixel == 0)
+        {
+            LOG_ERROR("Cannot encode an empty frame or unknown format");
+            return false;
+        }
+
+        const uint32_t tileSize = m_desc.tileSize;
+        const uint32_t tilesX = (image.width + tileSize - 1) / tileSize;
+        const uint32_t tilesY = (image.height + tileSize - 1) / tileSize;
+        const bool key = m_forceKeyframe ||
+            m_previous.width != image.width || m_previous.height != image.height || m_previous.format != image.format ||
+            (m_desc.keyframeInterval > 0 && m_sinceKeyframe >= m_desc.keyframeInterval);
+
+        ThreadPool& threads = m_desc.pool ? *m_desc.pool : ThreadPool::GetShared();
+
+        m_tiles.clear();
+        if (key)
+        {
+            m_previous.Allocate(image.width, image.height, image.format);
+            m_tiles.resize(static_cast<size_t>(tilesX) * tilesY);
+            for (uint32_t i = 0; i < m_tiles.size(); ++i)
+            {
+                m_tiles[i] = i;
+            }
+        }
+        else
+        {
+            m_diff.Compare(&m_previous, image, m_diffResult, &threads);
+            for (uint32_t ty = 0; ty < tilesY; ++ty)
+            {
+                for (uint32_t tx = 0; tx < tilesX; ++tx)
+                {
+                    if (m_diffResult.IsTileDirty(tx, ty))
+                    {
+                        m_tiles.push_back(ty * tilesX + tx);
+                    }
+                }
+            }
+        }
+
+        const uint32_t tileCount = static_cast<uint32_t>(m_tiles.size());
+        if (m_tileData.size() < tileCount)
+        {
+            m_tileData.resize(tileCount);
+        }
+
+        // 每块：取出（增量帧与上一帧异或）、同步更新保存的上一帧、压缩；不可压缩的块原样保存
+        std::vector<uint32_t> sizes(tileCount);
+        threads.ParallelFor(tileCount, 16, [&](uint32_t begin, uint32_t end)
+        {
+            std::vector<uint8_t> tile;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const TileRect rect = GetTileRect(m_tiles[i], tilesX, tileSize, image.width, image.height);
+                const size_t rowBytes = static_cast<size_t>(rect.width) * bytesPerPixel;
+                const size_t offset = static_cast<size_t>(rect.x) * bytesPerPixel;
+                tile.resize(rowBytes * rect.height);
+
+                for (uint32_t row = 0; row < rect.height; ++row)
+                {
+                    const uint8_t* current = image.Row(rect.y + row) + offset;
+                    uint8_t* previous = m_previous.Row(rect.y + row) + offset;
+                    uint8_t* dst = tile.data() + row * rowBytes;
+                    if (key)
+                    {
+                        std::memcpy(dst, current, rowBytes);
+                    }
+                    else
+                    {
+                        XorBytes(dst, current, previous, rowBytes);
+                    }
+                    std::memcpy(previous, current, rowBytes);
+                }
+
+                auto& data = m_tileData[i];
+                data.clear();
+                Lz4Compress(tile.data(), tile.size(), data);
+                if (data.size() >= tile.size())
+                {
+                    data.assign(tile.begin(), tile.end());
+                    sizes[i] = static_cast<uint32_t>(data.size()) | kStoredTile;
+                }
+                else
+                {
+                    sizes[i] = static_cast<uint32_t>(data.size());
+                }
+            }
+        });
+
+        DeltaFrameHeader header{};
+        header.magic = kMagic;
+        header.flags = key ? kKeyframe : 0;
+        header.width = image.width;
+        header.height = image.height;
+        header.format = static_cast<uint32_t>(image.format);
+        header.tileSize = tileSize;
+        header.tileCount = tileCount;
+
+        size_t dataBytes = 0;
+        for (uint32_t i = 0; i < tileCount; ++i)
+        {
+            dataBytes += m_tileData[i].size();
+        }
+
+        output.resize(sizeof(header) + static_cast<size_t>(tileCount) * sizeof(DeltaTileEntry) + dataBytes);
+        uint8_t* op = output.data();
+        std::memcpy(op, &header, sizeof(header));
+        op += sizeof(header);
+        for (uint32_t i = 0; i < tileCount; ++i)
+        {
+            const DeltaTileEntry entry{ m_tiles[i], sizes[i] };
+            std::memcpy(op, &entry, sizeof(entry));
+            op += sizeof(entry);
+        }
+        for (uint32_t i = 0; i < tileCount; ++i)
+        {
+            std::memcpy(op, m_tileData[i].data(), m_tileData[i].size());
+            op += m_tileData[i].size();
+        }
+
+        m_forceKeyframe = false;
+        m_sinceKeyframe = key ? 1 : m_sinceKeyframe + 1;
+
+        m_stats.frames++;
+        m_stats.keyframes += key ? 1 : 0;
+        m_stats.tiles += tileCount;
+        m_stats.inputBytes += image.GetSizeInBytes();
+        m_stats.outputBytes += output.size();
+        m_stats.encodeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (keyframe)
+        {
+            *keyframe = key;
+        }
+        return true;
+    }
+
+    DeltaDecoder::DeltaDecoder(ThreadPool* pool)
+        : m_pool(pool)
+    {
+    }
+
+    bool DeltaDecoder::IsKeyframe(const uint8_t* data, size_t size)
+    {
+        DeltaFrameHeader header{};
+        if (size < sizeof(header))
+            return false;
+        std::memcpy(&header, data, sizeof(header));
+        return header.magic == kMagic && (header.flags & kKeyframe) != 0;
+    }
+
+    bool DeltaDecoder::Decode(const uint8_t* data, size_t size)
+    {
+        DeltaFrameHeader header{};
+        if (size < sizeof(header))
+            return false;
+        std::memcpy(&header, data, sizeof(header));
+
+        const auto format = static_cast<lens::graphics::TextureFormat>(header.format);
+        const uint32_t bytesPerPixel = lens::graphics::GetFormatBytesPerPixel(format);
+        if (header.magic != kMagic || bytesPerPixel == 0 || header.width == 0 || header.height == 0 || header.tileSize == 0)
+        {
+            LOG_ERROR("Invalid delta frame header");
+            return false;
+        }
+
+        const uint32_t tilesX = (header.width + header.tileSize - 1) / header.tileSize;
+        const uint32_t tilesY = (header.height + header.tileSize - 1) / header.tileSize;
+        const uint64_t totalTiles = static_cast<uint64_t>(tilesX) * tilesY;
+        const size_t entriesOffset = sizeof(header);
+        if (header.tileCount > totalTiles ||
+            header.tileCount > (size - entriesOffset) / sizeof(DeltaTileEntry))
+        {
+            LOG_ERROR("Truncated delta frame");
+            return false;
+        }
+
+        const bool key = (header.flags & kKeyframe) != 0;
+        if (key)
+        {
+            if (m_image.width != header.width || m_image.height != header.height || m_image.format != format)
+            {
+                m_image.Allocate(header.width, header.height, format);
+            }
+            if (header.tileCount != totalTiles)
+            {
+                std::fill(m_image.pixels.begin(), m_image.pixels.end(), uint8_t(0));
+            }
+        }
+        else if (!m_valid || m_image.width != header.width || m_image.height != header.height || m_image.format != format)
+        {
+            LOG_ERROR("Delta frame without a matching keyframe");
+            return false;
+        }
+
+        // 块按编号递增排列，先算出各块数据的位置
+        const uint8_t* entries = data + entriesOffset;
+        const size_t dataOffset = entriesOffset + static_cast<size_t>(header.tileCount) * sizeof(DeltaTileEntry);
+        m_offsets.resize(static_cast<size_t>(header.tileCount) + 1);
+        m_offsets[0] = dataOffset;
+        int64_t lastIndex = -1;
+        for (uint32_t i = 0; i < header.tileCount; ++i)
+        {
+            DeltaTileEntry entry;
+            std::memcpy(&entry, entries + i * sizeof(entry), sizeof(entry));
+            const size_t length = entry.size & ~kStoredTile;
+            if (entry.index >= totalTiles || static_cast<int64_t>(entry.index) <= lastIndex || length > size - m_offsets[i])
+            {
+                LOG_ERROR("Corrupt delta tile table");
+                m_valid = false;
+                return false;
+            }
+            lastIndex = entry.index;
+            m_offsets[i + 1] = m_offsets[i] + length;
+        }
+
+        // 中途失败时当前帧已不完整，需要等下一个关键帧
+        m_valid = false;
+        std::atomic<bool> failed{ false };
+        ThreadPool& threads = m_pool ? *m_pool : ThreadPool::GetShared();
+        threads.ParallelFor(header.tileCount, 16, [&](uint32_t begin, uint32_t end)
+        {
+            std::vector<uint8_t> tile;
+            for (uint32_t i = begin; i < end && !failed.load(std::memory_order_relaxed); ++i)
+            {
+                DeltaTileEntry entry;
+                std::memcpy(&entry, entries + i * sizeof(entry), sizeof(entry));
+
+                const TileRect rect = GetTileRect(entry.index, tilesX, header.tileSize, header.width, header.height);
+                const size_t rowBytes = static_cast<size_t>(rect.width) * bytesPerPixel;
+                const size_t tileBytes = rowBytes * rect.height;
+                const uint8_t* source = data + m_offsets[i];
+                const size_t length = m_offsets[i + 1] - m_offsets[i];
+
+                const uint8_t* pixels = source;
+                if (entry.size & kStoredTile)
+                {
+                    if (length != tileBytes)
+                    {
+                        failed = true;
+                        break;
+                    }
+                }
+                else
+                {
+                    tile.resize(tileBytes);
+                    if (!Lz4Decompress(source, length, tile.data(), tileBytes))
+                    {
+                        failed = true;
+                        break;
+                    }
+                    pixels = tile.data();
+                }
+
+                const size_t offset = static_cast<size_t>(rect.x) * bytesPerPixel;
+                for (uint32_t row = 0; row < rect.height; ++row)
+                {
+                    uint8_t* dst = m_image.Row(rect.y + row) + offset;
+                    if (key)
+                    {
+                        std::memcpy(dst, pixels + row * rowBytes, rowBytes);
+                    }
+                    else
+                    {
+                        XorBytes(dst, dst, pixels + row * rowBytes, rowBytes);
+                    }
+                }
+            }
+        });
+
+        if (failed)
+        {
+            LOG_ERROR("Corrupt delta tile data");
+            return false;
+        }
+
+        m_valid = true;
+        return true;
+    }
+}
@@ -0,0 +1,53 @@
+﻿#include "LensPch.h"
+#include "capturer/DirtyRegion.h"
+#include "capturer/FrameDiff.h"
+
+namespace lens::capturer
+{
+    void CompareTiles(const lens::graphics::CpuImage* previous, const lens::graphics::CpuImage& current,
+        uint32_t tileSize, std::vector<DirtyRect>& rects)
+    {
+        FrameDiff diff(tileSize);
+        FrameDiff::Result result;
+        diff.Compare(previous, current, result);
+        rects = std::move(result.rects);
+    }
+
+    DirtyRect GetBoundingRect(const std::vector<DirtyRect>& rects)
+    {
+        if (rects.empty())
+            return {};
+
+        uint32_t left = UINT32_MAX, top = UINT32_MAX, right = 0, bottom = 0;
+        for (const auto& rect : rects)
+        {
+            left = (std::min)(left, rect.x);
+            top = (std::min)(top, rect.y);
+            right = (std::max)(right, rect.x + rect.width);
+            bottom = (std::max)(bottom, rect.y + rect.height);
+        }
+        return DirtyRect{ left, top, right - left, bottom - top };
+    }
+
+    void AccumulateDirtyRects(std::vector<DirtyRect>& accumulated, const std::vector<DirtyRect>& rects, size_t maxRects)
+    {
+        accumulated.insert(accumulated.end(), rects.begin(), rects.end());
+        if (accumulated.size() > maxRects)
+        {
+            DirtyRect bounds = GetBoundingRect(accumulated);
+            accumulated.assign(1, bounds);
+        }
+    }
+
+    void ClipDirtyRects(std::vector<DirtyRect>& rects, uint32_t width, uint32_t height)
+    {
+        for (auto& rect : rects)
+        {
+            uint32_t right = (std::min)(rect.x + rect.width, width);
+            uint32_t bottom = (std::min)(rect.y + rect.height, height);
+            rect.width = right > rect.x ? right - rect.x : 0;
+            rect.height = bottom > rect.y ? bottom - rect.y : 0;
+        }
+        std::erase_if(rects, [](const DirtyRect& rect) { return rect.width == 0 || rect.height == 0; });
+    }
+}
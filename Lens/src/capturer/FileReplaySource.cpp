@@ -0,0 +1,254 @@
+﻿#include "LensPch.h"
+#include "capturer/FileReplaySource.h"
+#include "graphics/ImageEncoder.h"
+#include "graphics/PixelConvert.h"
+#include <cstring>
+#include <fstream>
+
+namespace lens::capturer
+{
+    FileReplaySource::FileReplaySource(lens::graphics::GraphicsDevice* device, const ReplayDesc& replayDesc)
+        : CpuCaptureSource(device), m_replayDesc(replayDesc)
+    {
+    }
+
+    FileReplaySource::~FileReplaySource()
+    {
+        Shutdown();
+    }
+
+    bool FileReplaySource::OnInitialize()
+    {
+        m_files.clear();
+        m_preloaded.clear();
+        m_recording.reset();
+
+        auto extension = m_replayDesc.path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        std::error_code ec;
+        if (extension == ".lensraw")
+        {
+            m_recording = std::make_unique<RawRecordingReader>();
+            if (!m_recording->Open(m_replayDesc.path) || m_recording->GetFrameCount() == 0)
+            {
+                LOG_ERROR("No replay frames found at: {}", m_replayDesc.path.string());
+                m_recording.reset();
+                return false;
+            }
+        }
+        else if (std::filesystem::is_directory(m_replayDesc.path, ec))
+        {
+            for (const auto& entry : std::filesystem::directory_iterator(m_replayDesc.path, ec))
+            {
+                auto ext = entry.path().extension().string();
+                std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                if (entry.is_regular_file() && (ext == ".bmp" || ext == ".qoi"))
+                {
+                    m_files.push_back(entry.path());
+                }
+            }
+            std::sort(m_files.begin(), m_files.end());
+        }
+        else if (std::filesystem::is_regular_file(m_replayDesc.path, ec))
+        {
+            m_files.push_back(m_replayDesc.path);
+        }
+
+        if (!m_recording && m_files.empty())
+        {
+            LOG_ERROR("No replay frames found at: {}", m_replayDesc.path.string());
+            return false;
+        }
+
+        if (m_replayDesc.preload)
+        {
+            m_preloaded.reserve(GetFrameCount());
+            for (size_t i = 0; i < GetFrameCount(); ++i)
+            {
+                auto image = std::make_shared<lens::graphics::CpuImage>();
+                if (m_recording ? !LoadRecordedFrame(i, *image) : !LoadFrame(m_files[i], *image))
+                {
+                    return false;
+                }
+                m_preloaded.push_back(std::move(image));
+            }
+        }
+
+        // 回放源输出固定为 BGRA8
+        m_desc.format = lens::graphics::TextureFormat::BGRA8_UNorm;
+
+        LOG_INFO("Replay source: {} frames from {}, loop: {}, preload: {}",
+            GetFrameCount(), m_replayDesc.path.string(), m_replayDesc.loop, m_replayDesc.preload);
+        return true;
+    }
+
+    std::shared_ptr<const lens::graphics::CpuImage> FileReplaySource::ProduceFrame(uint64_t frameIndex)
+    {
+        const size_t frameCount = GetFrameCount();
+        if (!m_replayDesc.loop && frameIndex >= frameCount)
+        {
+            return nullptr;
+        }
+
+        size_t index = static_cast<size_t>(frameIndex % frameCount);
+        if (!m_preloaded.empty())
+        {
+            return m_preloaded[index];
+        }
+
+        auto image = std::make_shared<lens::graphics::CpuImage>();
+        if (m_recording ? !LoadRecordedFrame(index, *image) : !LoadFrame(m_files[index], *image))
+        {
+            return nullptr;
+        }
+        return image;
+    }
+
+    bool FileReplaySource::LoadRecordedFrame(size_t index, lens::graphics::CpuImage& image) const
+    {
+        // 像素直接从映射内存转换或复制，不经过文件读取
+        RawRecordingReader::FrameView view;
+        if (!m_recording->GetFrame(index, view))
+        {
+            return false;
+        }
+
+        // 增量帧先解码，再按需原地转换通道顺序
+        if (view.delta)
+        {
+            if (!m_recording->ReadFrame(index, image))
+            {
+                return false;
+            }
+            if (image.format == lens::graphics::TextureFormat::RGBA8_UNorm)
+            {
+                lens::graphics::ConvertRGBAToBGRA(image.pixels.data(), image.rowPitch, image.pixels.data(), image.rowPitch, image.width, image.height);
+                image.format = lens::graphics::TextureFormat::BGRA8_UNorm;
+            }
+            if (image.format != lens::graphics::TextureFormat::BGRA8_UNorm)
+            {
+                LOG_ERROR("Unsupported recorded frame format: {}", static_cast<uint32_t>(image.format));
+                return false;
+            }
+            return true;
+        }
+
+        image.Allocate(view.descriptor.width, view.descriptor.height, lens::graphics::TextureFormat::BGRA8_UNorm);
+        if (view.format == lens::graphics::TextureFormat::BGRA8_UNorm)
+        {
+            for (uint32_t y = 0; y < image.height; ++y)
+            {
+                std::memcpy(image.Row(y), view.pixels + static_cast<size_t>(y) * view.rowPitch, image.rowPitch);
+            }
+            return true;
+        }
+        if (view.format == lens::graphics::TextureFormat::RGBA8_UNorm)
+        {
+            lens::graphics::ConvertRGBAToBGRA(view.pixels, view.rowPitch, image.pixels.data(), image.rowPitch, image.width, image.height);
+            return true;
+        }
+
+        LOG_ERROR("Unsupported recorded frame format: {}", static_cast<uint32_t>(view.format));
+        return false;
+    }
+
+    bool FileReplaySource::LoadFrame(const std::filesystem::path& file, lens::graphics::CpuImage& image)
+    {
+        if (lens::graphics::GetImageCodecForPath(file) == lens::graphics::ImageCodec::QOI)
+        {
+            return LoadQoi(file, image);
+        }
+        return LoadBmp(file, image);
+    }
+
+    bool FileReplaySource::LoadQoi(const std::filesystem::path& file, lens::graphics::CpuImage& image)
+    {
+        std::ifstream in(file, std::ios::binary | std::ios::ate);
+        if (!in.is_open())
+        {
+            LOG_ERROR("Failed to open replay frame: {}", file.string());
+            return false;
+        }
+
+        std::vector<uint8_t> data(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())) ||
+            !lens::graphics::DecodeQoi(data.data(), data.size(), image))
+        {
+            LOG_ERROR("Failed to decode QOI frame: {}", file.string());
+            return false;
+        }
+        return true;
+    }
+
+    bool FileReplaySource::LoadBmp(const std::filesystem::path& file, lens::graphics::CpuImage& image)
+    {
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open())
+        {
+            LOG_ERROR("Failed to open replay frame: {}", file.string());
+            return false;
+        }
+
+        unsigned char header[54] = { 0 };
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != 'B' || header[1] != 'M')
+        {
+            LOG_ERROR("Not a BMP file: {}", file.string());
+            return false;
+        }
+
+        auto readU16 = [&](int offset) { uint16_t v; std::memcpy(&v, header + offset, sizeof(v)); return v; };
+        auto readI32 = [&](int offset) { int32_t v; std::memcpy(&v, header + offset, sizeof(v)); return v; };
+
+        const uint32_t dataOffset = static_cast<uint32_t>(readI32(10));
+        const int32_t width = readI32(18);
+        const int32_t rawHeight = readI32(22);
+        const uint16_t bitCount = readU16(28);
+        const uint32_t compression = static_cast<uint32_t>(readI32(30));
+
+        // 0 = BI_RGB，3 = BI_BITFIELDS（32 位时按 BGRA 处理）
+        if (width <= 0 || rawHeight == 0 || (bitCount != 24 && bitCount != 32) || (compression != 0 && compression != 3))
+        {
+            LOG_ERROR("Unsupported BMP layout in {}: {} bpp, compression {}", file.string(), bitCount, compression);
+            return false;
+        }
+
+        // 高度为负表示自上而下存储
+        const bool topDown = rawHeight < 0;
+        const uint32_t height = static_cast<uint32_t>(topDown ? -rawHeight : rawHeight);
+        const uint32_t srcBytesPerPixel = bitCount / 8;
+        const size_t srcRowSize = (static_cast<size_t>(width) * srcBytesPerPixel + 3) & ~size_t(3);
+
+        image.Allocate(static_cast<uint32_t>(width), height, lens::graphics::TextureFormat::BGRA8_UNorm);
+
+        std::vector<uint8_t> rowBuffer(srcRowSize);
+        in.seekg(dataOffset);
+        for (uint32_t i = 0; i < height; ++i)
+        {
+            if (!in.read(reinterpret_cast<char*>(rowBuffer.data()), srcRowSize))
+            {
+                LOG_ERROR("Truncated BMP file: {}", file.string());
+                return false;
+            }
+
+            uint8_t* dst = image.Row(topDown ? i : height - 1 - i);
+            if (srcBytesPerPixel == 4)
+            {
+                std::memcpy(dst, rowBuffer.data(), static_cast<size_t>(width) * 4);
+            }
+            else
+            {
+                for (int32_t x = 0; x < width; ++x)
+                {
+                    dst[x * 4 + 0] = rowBuffer[x * 3 + 0];
+                    dst[x * 4 + 1] = rowBuffer[x * 3 + 1];
+                    dst[x * 4 + 2] = rowBuffer[x * 3 + 2];
+                    dst[x * 4 + 3] = 0xFF;
+                }
+            }
+        }
+
+        return true;
+    }
+}
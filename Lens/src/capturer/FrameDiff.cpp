@@ -0,0 +1,261 @@
+﻿#include "LensPch.h"
+#include "capturer/FrameDiff.h"
+#include "graphics/PixelConvert.h"
+#include "ThreadPool.h"
+#include <emmintrin.h>
+
+namespace lens::capturer
+{
+    namespace detail
+    {
+        // FrameDiffAVX2.cpp，只在检测到 AVX2 时调用
+        bool SegmentEqualAVX2(const uint8_t* a, const uint8_t* b, uint32_t length);
+    }
+
+    namespace
+    {
+        using SegmentEqualFn = bool (*)(const uint8_t* a, const uint8_t* b, uint32_t length);
+
+        bool SegmentEqualSSE2(const uint8_t* a, const uint8_t* b, uint32_t length)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            uint32_t i = 0;
+            for (; i + 64 <= length; i += 64)
+            {
+                __m128i x0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+                __m128i x1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+                __m128i x2 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 32)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 32)));
+                __m128i x3 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 48)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 48)));
+                __m128i any = _mm_or_si128(_mm_or_si128(x0, x1), _mm_or_si128(x2, x3));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xFFFF)
+                    return false;
+            }
+            for (; i + 16 <= length; i += 16)
+            {
+                __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero)) != 0xFFFF)
+                    return false;
+            }
+            return i == length || memcmp(a + i, b + i, length - i) == 0;
+        }
+
+        SegmentEqualFn GetSegmentEqual()
+        {
+            static const SegmentEqualFn fn =
+                lens::graphics::DetectCpuIsa() >= lens::graphics::CpuIsa::AVX2 ? &detail::SegmentEqualAVX2 : &SegmentEqualSSE2;
+            return fn;
+        }
+
+        // 一行内逐块比较，跳过已变化的块，返回新标记的块数
+        uint32_t CompareTileRow(SegmentEqualFn equal, const uint8_t* a, const uint8_t* b,
+            uint32_t rowBytes, uint32_t tileBytes, uint8_t* dirty)
+        {
+            uint32_t marked = 0;
+            for (uint32_t offset = 0, tx = 0; offset < rowBytes; offset += tileBytes, ++tx)
+            {
+                if (dirty[tx])
+                    continue;
+                if (!equal(a + offset, b + offset, (std::min)(tileBytes, rowBytes - offset)))
+                {
+                    dirty[tx] = 1;
+                    marked++;
+                }
+            }
+            return marked;
+        }
+    }
+
+    FrameDiff::FrameDiff(uint32_t tileSize)
+        : m_tileSize((std::max)(tileSize, 1u))
+    {
+    }
+
+    void FrameDiff::PrepareResult(uint32_t width, uint32_t height, uint32_t tileSize, Result& result)
+    {
+        result.tileSize = tileSize;
+        result.tilesX = (width + tileSize - 1) / tileSize;
+        result.tilesY = (height + tileSize - 1) / tileSize;
+        result.wordsPerRow = (result.tilesX + 63) / 64;
+        result.bitmap.assign(static_cast<size_t>(result.wordsPerRow) * result.tilesY, 0);
+        result.dirtyTiles = 0;
+        result.rects.clear();
+    }
+
+    void FrameDiff::MarkAllDirty(uint32_t width, uint32_t height, Result& result) const
+    {
+        PrepareResult(width, height, m_tileSize, result);
+        for (uint32_t ty = 0; ty < result.tilesY; ++ty)
+        {
+            uint64_t* words = result.bitmap.data() + static_cast<size_t>(ty) * result.wordsPerRow;
+            for (uint32_t tx = 0; tx < result.tilesX; ++tx)
+            {
+                words[tx / 64] |= 1ull << (tx % 64);
+            }
+        }
+        result.dirtyTiles = result.tilesX * result.tilesY;
+        if (width > 0 && height > 0)
+        {
+            result.rects.push_back(DirtyRect{ 0, 0, width, height });
+        }
+    }
+
+    bool FrameDiff::Compare(const lens::graphics::CpuImage* previous, const lens::graphics::CpuImage& current,
+        Result& result, ThreadPool* pool)
+    {
+        if (current.IsEmpty())
+        {
+            PrepareResult(0, 0, m_tileSize, result);
+            return true;
+        }
+
+        if (!previous || previous->IsEmpty() || previous->width != current.width || previous->height != current.height ||
+            previous->format != current.format)
+        {
+            MarkAllDirty(current.width, current.height, result);
+            return true;
+        }
+
+        return Compare(previous->pixels.data(), previous->rowPitch, current.pixels.data(), current.rowPitch,
+            current.width, current.height, lens::graphics::GetFormatBytesPerPixel(current.format), result, pool);
+    }
+
+    bool FrameDiff::Compare(const uint8_t* previous, uint32_t previousStride, const uint8_t* current, uint32_t currentStride,
+        uint32_t width, uint32_t height, uint32_t bytesPerPixel, Result& result, ThreadPool* pool)
+    {
+        if (!current || bytesPerPixel == 0)
+        {
+            LOG_ERROR("Invalid frame diff input ({} bytes per pixel)", bytesPerPixel);
+            return false;
+        }
+        if (!previous)
+        {
+            MarkAllDirty(width, height, result);
+            return true;
+        }
+
+        PrepareResult(width, height, m_tileSize, result);
+        if (previous == current && previousStride == currentStride)
+            return true;
+
+        const uint32_t tileSize = m_tileSize;
+        const uint32_t rowBytes = width * bytesPerPixel;
+        const uint32_t tileBytes = tileSize * bytesPerPixel;
+        const SegmentEqualFn equal = GetSegmentEqual();
+        std::vector<uint32_t> bandDirty(result.tilesY, 0);
+
+        // 每个块行只写自己那几个 bitmap 字，不需要同步
+        auto compareBands = [&](uint32_t bandBegin, uint32_t bandEnd)
+        {
+            std::vector<uint8_t> dirty(result.tilesX);
+            for (uint32_t ty = bandBegin; ty < bandEnd; ++ty)
+            {
+                std::fill(dirty.begin(), dirty.end(), 0);
+                uint32_t marked = 0;
+
+                const uint32_t yEnd = (std::min)(height, (ty + 1) * tileSize);
+                for (uint32_t y = ty * tileSize; y < yEnd && marked < result.tilesX; ++y)
+                {
+                    const uint8_t* a = previous + static_cast<size_t>(y) * previousStride;
+                    const uint8_t* b = current + static_cast<size_t>(y) * currentStride;
+
+                    // 还没有变化的块时先整行比较，相同帧只需一遍连续扫描
+                    if (marked == 0 && equal(a, b, rowBytes))
+                        continue;
+                    marked += CompareTileRow(equal, a, b, rowBytes, tileBytes, dirty.data());
+                }
+
+                uint64_t* words = result.bitmap.data() + static_cast<size_t>(ty) * result.wordsPerRow;
+                for (uint32_t tx = 0; tx < result.tilesX; ++tx)
+                {
+                    if (dirty[tx])
+                        words[tx / 64] |= 1ull << (tx % 64);
+                }
+                bandDirty[ty] = marked;
+            }
+        };
+
+        if (pool != nullptr || static_cast<uint64_t>(width) * height >= m_parallelThreshold)
+        {
+            // 每个任务至少覆盖 64 行，避免任务太碎
+            ThreadPool& threads = pool ? *pool : ThreadPool::GetShared();
+            threads.ParallelFor(result.tilesY, (std::max)(1u, 64 / tileSize), compareBands);
+        }
+        else
+        {
+            compareBands(0, result.tilesY);
+        }
+
+        for (uint32_t count : bandDirty)
+        {
+            result.dirtyTiles += count;
+        }
+        if (result.dirtyTiles > 0)
+        {
+            BuildRects(width, height, result);
+        }
+        return true;
+    }
+
+    void FrameDiff::BuildRects(uint32_t width, uint32_t height, Result& result)
+    {
+        const uint32_t tileSize = result.tileSize;
+        std::vector<DirtyRect>& rects = result.rects;
+
+        // 同一块行内相邻的块合并成一段，与上一块行左右对齐的段再向下延伸
+        std::vector<size_t> previousRow;
+        std::vector<size_t> currentRow;
+
+        for (uint32_t ty = 0; ty < result.tilesY; ++ty)
+        {
+            const uint32_t tileY = ty * tileSize;
+            const uint32_t tileHeight = (std::min)(tileSize, height - tileY);
+
+            currentRow.clear();
+            for (uint32_t tx = 0; tx < result.tilesX;)
+            {
+                if (!result.IsTileDirty(tx, ty))
+                {
+                    tx++;
+                    continue;
+                }
+
+                uint32_t end = tx;
+                while (end < result.tilesX && result.IsTileDirty(end, ty))
+                {
+                    end++;
+                }
+
+                DirtyRect run{};
+                run.x = tx * tileSize;
+                run.y = tileY;
+                run.width = (std::min)(end * tileSize, width) - run.x;
+                run.height = tileHeight;
+
+                bool merged = false;
+                for (size_t index : previousRow)
+                {
+                    DirtyRect& above = rects[index];
+                    if (above.x == run.x && above.width == run.width && above.y + above.height == run.y)
+                    {
+                        above.height += run.height;
+                        currentRow.push_back(index);
+                        merged = true;
+                        break;
+                    }
+                }
+                if (!merged)
+                {
+                    currentRow.push_back(rects.size());
+                    rects.push_back(run);
+                }
+                tx = end;
+            }
+            previousRow.swap(currentRow);
+        }
+    }
+}
@@ -0,0 +1,36 @@
+﻿#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+// 本文件以 /arch:AVX2 编译，只在运行时检测到 AVX2 后才会被调用
+// 不包含预编译头和其他项目头文件：那里的内联函数在这里会按 AVX 指令生成，链接器可能选中这一份
+namespace lens::capturer::detail
+{
+    bool SegmentEqualAVX2(const uint8_t* a, const uint8_t* b, uint32_t length)
+    {
+        uint32_t i = 0;
+        // 64 像素的 BGRA 块正好是 256 字节，一次比较 128 字节
+        for (; i + 128 <= length; i += 128)
+        {
+            __m256i x0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32)));
+            __m256i x2 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 64)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 64)));
+            __m256i x3 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 96)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 96)));
+            __m256i any = _mm256_or_si256(_mm256_or_si256(x0, x1), _mm256_or_si256(x2, x3));
+            if (!_mm256_testz_si256(any, any))
+                return false;
+        }
+        for (; i + 32 <= length; i += 32)
+        {
+            __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            if (!_mm256_testz_si256(x, x))
+                return false;
+        }
+        return i == length || memcmp(a + i, b + i, length - i) == 0;
+    }
+}
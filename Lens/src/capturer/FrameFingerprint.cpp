@@ -0,0 +1,293 @@
+﻿#include "LensPch.h"
+#include "capturer/FrameFingerprint.h"
+#include "ThreadPool.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace lens::capturer
+{
+    namespace
+    {
+        constexpr uint32_t kGridSize = 32;
+        constexpr uint32_t kLowFrequencies = 8;
+
+        constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+
+        inline uint64_t RotateLeft(uint64_t value, int bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        inline uint64_t Round(uint64_t acc, uint64_t input)
+        {
+            return RotateLeft(acc + input * kPrime2, 31) * kPrime1;
+        }
+
+        inline uint64_t Mix(uint64_t hash)
+        {
+            hash ^= hash >> 33;
+            hash *= kPrime2;
+            hash ^= hash >> 29;
+            hash *= kPrime3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        inline uint64_t LoadU64(const uint8_t* p)
+        {
+            uint64_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        // 4 路独立累加的行哈希，32 字节一块，便于流水线并行
+        struct RowHasher
+        {
+            uint64_t lanes[4] = { kPrime1 + kPrime2, kPrime2, 0, 0ull - kPrime1 };
+
+            void Update(const uint8_t* data, size_t length)
+            {
+                size_t i = 0;
+                for (; i + 32 <= length; i += 32)
+                {
+                    lanes[0] = Round(lanes[0], LoadU64(data + i));
+                    lanes[1] = Round(lanes[1], LoadU64(data + i + 8));
+                    lanes[2] = Round(lanes[2], LoadU64(data + i + 16));
+                    lanes[3] = Round(lanes[3], LoadU64(data + i + 24));
+                }
+                for (; i + 8 <= length; i += 8)
+                {
+                    lanes[0] = Round(lanes[0], LoadU64(data + i));
+                }
+                for (; i < length; ++i)
+                {
+                    lanes[1] = Round(lanes[1], data[i]);
+                }
+            }
+
+            uint64_t Finish() const
+            {
+                uint64_t hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) +
+                    RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+                return Mix(hash);
+            }
+        };
+
+        // DCT-II 的前 8 个基函数在 32 个采样点上的值
+        const std::array<float, kLowFrequencies * kGridSize>& GetDctTable()
+        {
+            static const auto table = []
+            {
+                std::array<float, kLowFrequencies * kGridSize> values{};
+                const double pi = 3.14159265358979323846;
+                for (uint32_t u = 0; u < kLowFrequencies; ++u)
+                {
+                    for (uint32_t x = 0; x < kGridSize; ++x)
+                    {
+                        values[u * kGridSize + x] = static_cast<float>(std::cos((2.0 * x + 1.0) * u * pi / (2.0 * kGridSize)));
+                    }
+                }
+                return values;
+            }();
+            return table;
+        }
+
+        uint64_t ComputeDHash(const float* grid)
+        {
+            // 32x32 网格缩成 9x8，比较每行相邻两格
+            float reduced[8][9];
+            for (uint32_t gy = 0; gy < 8; ++gy)
+            {
+                for (uint32_t gx = 0; gx < 9; ++gx)
+                {
+                    const uint32_t x0 = gx * kGridSize / 9;
+                    const uint32_t x1 = (gx + 1) * kGridSize / 9;
+                    float sum = 0.0f;
+                    for (uint32_t y = gy * 4; y < gy * 4 + 4; ++y)
+                    {
+                        for (uint32_t x = x0; x < x1; ++x)
+                        {
+                            sum += grid[y * kGridSize + x];
+                        }
+                    }
+                    reduced[gy][gx] = sum / static_cast<float>((x1 - x0) * 4);
+                }
+            }
+
+            uint64_t hash = 0;
+            for (uint32_t gy = 0; gy < 8; ++gy)
+            {
+                for (uint32_t gx = 0; gx < 8; ++gx)
+                {
+                    if (reduced[gy][gx] < reduced[gy][gx + 1])
+                        hash |= 1ull << (gy * 8 + gx);
+                }
+            }
+            return hash;
+        }
+
+        uint64_t ComputePHash(const float* grid)
+        {
+            // 可分离的二维 DCT，只算左上角 8x8 低频
+            const auto& table = GetDctTable();
+            float columns[kLowFrequencies][kGridSize];
+            for (uint32_t u = 0; u < kLowFrequencies; ++u)
+            {
+                for (uint32_t x = 0; x < kGridSize; ++x)
+                {
+                    float sum = 0.0f;
+                    for (uint32_t y = 0; y < kGridSize; ++y)
+                    {
+                        sum += table[u * kGridSize + y] * grid[y * kGridSize + x];
+                    }
+                    columns[u][x] = sum;
+                }
+            }
+
+            float coefficients[kLowFrequencies * kLowFrequencies];
+            for (uint32_t u = 0; u < kLowFrequencies; ++u)
+            {
+                for (uint32_t v = 0; v < kLowFrequencies; ++v)
+                {
+                    float sum = 0.0f;
+                    for (uint32_t x = 0; x < kGridSize; ++x)
+                    {
+                        sum += columns[u][x] * table[v * kGridSize + x];
+                    }
+                    coefficients[u * kLowFrequencies + v] = sum;
+                }
+            }
+
+            // 中位数不含直流分量，避免整体亮度主导
+            float sorted[kLowFrequencies * kLowFrequencies - 1];
+            std::copy(coefficients + 1, coefficients + kLowFrequencies * kLowFrequencies, sorted);
+            const size_t middle = std::size(sorted) / 2;
+            std::nth_element(sorted, sorted + middle, sorted + std::size(sorted));
+            const float median = sorted[middle];
+
+            uint64_t hash = 0;
+            for (uint32_t i = 0; i < kLowFrequencies * kLowFrequencies; ++i)
+            {
+                if (coefficients[i] > median)
+                    hash |= 1ull << i;
+            }
+            return hash;
+        }
+    }
+
+    uint32_t GetFingerprintDistance(const FrameFingerprint& a, const FrameFingerprint& b)
+    {
+        if (a.contentHash == b.contentHash)
+            return 0;
+        return (std::max)(HammingDistance(a.dHash, b.dHash), HammingDistance(a.pHash, b.pHash));
+    }
+
+    FrameFingerprint ComputeFingerprint(const lens::graphics::CpuImage& image, ThreadPool* pool)
+    {
+        FrameFingerprint fingerprint;
+        const bool bgra = image.format == lens::graphics::TextureFormat::BGRA8_UNorm;
+        const bool rgba = image.format == lens::graphics::TextureFormat::RGBA8_UNorm;
+        if (image.IsEmpty() || (!bgra && !rgba))
+            return fingerprint;
+
+        const uint32_t width = image.width;
+        const uint32_t height = image.height;
+        const size_t rowBytes = static_cast<size_t>(width) * 4;
+
+        // 亮度权重按通道顺序排列
+        const uint32_t w0 = bgra ? 29 : 77;
+        const uint32_t w1 = 150;
+        const uint32_t w2 = bgra ? 77 : 29;
+
+        std::array<float, kGridSize * kGridSize> grid{};
+        std::array<uint64_t, kGridSize> bandHashes{};
+
+        // 每个任务处理一个网格行：内容哈希只覆盖本行带自己的像素行，
+        // 亮度格在图像小于 32 像素时至少取一行一列
+        auto processBands = [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t gy = begin; gy < end; ++gy)
+            {
+                const uint32_t hashBegin = gy * height / kGridSize;
+                const uint32_t hashEnd = (gy + 1) * height / kGridSize;
+                RowHasher hasher;
+                for (uint32_t y = hashBegin; y < hashEnd; ++y)
+                {
+                    hasher.Update(image.Row(y), rowBytes);
+                }
+                bandHashes[gy] = hasher.Finish();
+
+                const uint32_t y0 = (std::min)(hashBegin, height - 1);
+                const uint32_t y1 = (std::max)(y0 + 1, hashEnd);
+                uint64_t sums[kGridSize] = {};
+                for (uint32_t y = y0; y < y1; ++y)
+                {
+                    const uint8_t* row = image.Row(y);
+                    for (uint32_t gx = 0; gx < kGridSize; ++gx)
+                    {
+                        const uint32_t x0 = (std::min)(gx * width / kGridSize, width - 1);
+                        const uint32_t x1 = (std::max)(x0 + 1, (gx + 1) * width / kGridSize);
+                        uint32_t sum = 0;
+                        for (uint32_t x = x0; x < x1; ++x)
+                        {
+                            const uint8_t* p = row + x * 4;
+                            sum += w0 * p[0] + w1 * p[1] + w2 * p[2];
+                        }
+                        sums[gx] += sum;
+                    }
+                }
+
+                for (uint32_t gx = 0; gx < kGridSize; ++gx)
+                {
+                    const uint32_t x0 = (std::min)(gx * width / kGridSize, width - 1);
+                    const uint32_t x1 = (std::max)(x0 + 1, (gx + 1) * width / kGridSize);
+                    const double count = static_cast<double>(x1 - x0) * (y1 - y0) * 256.0;
+                    grid[gy * kGridSize + gx] = static_cast<float>(sums[gx] / count);
+                }
+            }
+        };
+
+        ThreadPool& threads = pool ? *pool : ThreadPool::GetShared();
+        threads.ParallelFor(kGridSize, 4, processBands);
+
+        uint64_t contentHash = Mix(kPrime3 ^ (static_cast<uint64_t>(width) << 32 | height));
+        for (uint64_t bandHash : bandHashes)
+        {
+            contentHash = Round(contentHash, bandHash);
+        }
+
+        fingerprint.valid = true;
+        fingerprint.dHash = ComputeDHash(grid.data());
+        fingerprint.pHash = ComputePHash(grid.data());
+        fingerprint.contentHash = Mix(contentHash);
+        return fingerprint;
+    }
+
+    void FrameDeduplicator::Reset()
+    {
+        m_reference = {};
+        m_checked = 0;
+        m_dropped = 0;
+        m_droppedBytes = 0;
+    }
+
+    bool FrameDeduplicator::ShouldDrop(const FrameFingerprint& fingerprint, uint64_t frameBytes)
+    {
+        if (!m_desc.enabled || !fingerprint.valid)
+            return false;
+
+        m_checked.fetch_add(1, std::memory_order_relaxed);
+        if (m_reference.valid && GetFingerprintDistance(fingerprint, m_reference) <= m_desc.maxDistance)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_droppedBytes.fetch_add(frameBytes, std::memory_order_relaxed);
+            return true;
+        }
+
+        m_reference = fingerprint;
+        return false;
+    }
+}
@@ -0,0 +1,42 @@
+﻿#include "LensPch.h"
+#include "capturer/FrameLatency.h"
+
+namespace lens::capturer
+{
+    const char* FrameLatency::GetStageName(Stage stage)
+    {
+        switch (stage)
+        {
+        case Stage::Arrival:  return "arrival";
+        case Stage::CopyDone: return "copy";
+        case Stage::Pickup:   return "pickup";
+        case Stage::Present:  return "present";
+        default:              return "unknown";
+        }
+    }
+
+    void FrameLatency::Reset()
+    {
+        for (auto& histogram : m_histograms)
+        {
+            histogram.Reset();
+        }
+    }
+
+    void FrameLatency::LogSummary(const char* sourceName) const
+    {
+        for (size_t i = 0; i < m_histograms.size(); ++i)
+        {
+            const auto& histogram = m_histograms[i];
+            if (histogram.GetCount() == 0)
+                continue;
+
+            LOG_INFO("{} latency capture->{}: n={} p50={:.2f} ms p99={:.2f} ms p99.9={:.2f} ms max={:.2f} ms",
+                sourceName, GetStageName(static_cast<Stage>(i)), histogram.GetCount(),
+                TicksToMs(histogram.GetPercentile(0.50)),
+                TicksToMs(histogram.GetPercentile(0.99)),
+                TicksToMs(histogram.GetPercentile(0.999)),
+                TicksToMs(histogram.GetMax()));
+        }
+    }
+}
@@ -0,0 +1,84 @@
+﻿#include "LensPch.h"
+#include "capturer/FramePacer.h"
+
+namespace lens::capturer
+{
+    void FramePacer::Configure(const Desc& desc)
+    {
+        m_desc = desc;
+        m_interval = desc.frameRate > 0 ? kTicksPerSecond / desc.frameRate : 0;
+        m_tolerance = static_cast<int64_t>(static_cast<double>(m_interval) * desc.jitterTolerance);
+        Reset();
+    }
+
+    void FramePacer::Reset()
+    {
+        m_nextDeadline = 0;
+        m_lastForwarded = 0;
+        m_hasForwarded = false;
+        m_delivered.store(0, std::memory_order_relaxed);
+        m_forwarded.store(0, std::memory_order_relaxed);
+    }
+
+    bool FramePacer::ShouldForward(int64_t timestamp, bool contentChanged)
+    {
+        m_delivered.fetch_add(1, std::memory_order_relaxed);
+
+        bool forward = true;
+        if (m_interval > 0)
+        {
+            switch (m_desc.policy)
+            {
+            case Policy::Unlimited:
+                break;
+
+            case Policy::OnChangeOnly:
+                if (!contentChanged)
+                {
+                    forward = false;
+                    break;
+                }
+                [[fallthrough]];
+
+            case Policy::MaxRate:
+                // 上限是硬性的，不加抖动容差，否则 144 Hz 源限到 60 时会转发出 72 fps
+                if (m_hasForwarded && timestamp - m_lastForwarded < m_interval)
+                {
+                    forward = false;
+                }
+                break;
+
+            case Policy::FixedRate:
+                if (!m_hasForwarded)
+                {
+                    m_nextDeadline = timestamp;
+                }
+                if (timestamp + m_tolerance < m_nextDeadline)
+                {
+                    forward = false;
+                    break;
+                }
+                // 节拍从上一个截止时间推进，避免累积漂移；
+                // 源暂停过（落后超过一个间隔）则重新对齐到当前帧
+                m_nextDeadline += m_interval;
+                if (m_nextDeadline <= timestamp)
+                {
+                    m_nextDeadline = timestamp + m_interval;
+                }
+                break;
+            }
+        }
+        else if (m_desc.policy == Policy::OnChangeOnly && !contentChanged)
+        {
+            forward = false;
+        }
+
+        if (forward)
+        {
+            m_lastForwarded = timestamp;
+            m_hasForwarded = true;
+            m_forwarded.fetch_add(1, std::memory_order_relaxed);
+        }
+        return forward;
+    }
+}
@@ -0,0 +1,468 @@
+﻿#include "LensPch.h"
+#include "capturer/MjpegRecorder.h"
+#include "graphics/ImageEncoder.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstring>
+
+namespace lens::capturer
+{
+    namespace
+    {
+        // 每个 RIFF 段的上限。第一段的 idx1 偏移只有 32 位，旧播放器也只认 1 GB 以内的第一段
+        constexpr uint64_t kSegmentBytes = 1ull << 30;
+
+        // hdrl 中预留的超级索引项数，每项对应一段，共可记录约 256 GB
+        constexpr uint32_t kSuperIndexEntries = 256;
+
+        constexpr uint32_t kAviIndexOfIndexes = 0x00;
+        constexpr uint32_t kAviIndexOfChunks = 0x01;
+        constexpr uint32_t kAvifHasIndex = 0x10;
+        constexpr uint32_t kAviifKeyframe = 0x10;
+
+        constexpr uint32_t kAvihSize = 56;
+        constexpr uint32_t kStrhSize = 56;
+        constexpr uint32_t kStrfSize = 40;
+        constexpr uint32_t kIndxSize = 24 + 16 * kSuperIndexEntries;
+        constexpr uint32_t kDmlhSize = 248;
+
+        void PutFourCC(std::vector<uint8_t>& out, const char* fourcc)
+        {
+            out.insert(out.end(), fourcc, fourcc + 4);
+        }
+
+        void PutU16(std::vector<uint8_t>& out, uint32_t value)
+        {
+            out.push_back(static_cast<uint8_t>(value));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+        }
+
+        void PutU32(std::vector<uint8_t>& out, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+            }
+        }
+
+        void PutU64(std::vector<uint8_t>& out, uint64_t value)
+        {
+            PutU32(out, static_cast<uint32_t>(value));
+            PutU32(out, static_cast<uint32_t>(value >> 32));
+        }
+    }
+
+    MjpegRecorder::MjpegRecorder()
+    {
+    }
+
+    MjpegRecorder::~MjpegRecorder()
+    {
+        Close();
+    }
+
+    bool MjpegRecorder::Open(const Desc& desc)
+    {
+        Close();
+
+        m_desc = desc;
+        m_desc.frameRate = (std::max)(m_desc.frameRate, 1u);
+        m_desc.queueCapacity = (std::max)(m_desc.queueCapacity, 1u);
+
+        std::error_code ec;
+        if (m_desc.path.has_parent_path())
+        {
+            std::filesystem::create_directories(m_desc.path.parent_path(), ec);
+        }
+
+        m_file.open(m_desc.path, std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            LOG_ERROR("Failed to create video: {}", m_desc.path.string());
+            return false;
+        }
+
+        m_width = 0;
+        m_height = 0;
+        m_firstTime = 0;
+        m_nextSlot = 0;
+        m_frameCount = 0;
+        m_firstSegmentFrames = 0;
+        m_firstRiffSize = 0;
+        m_maxChunkSize = 0;
+        m_segment.clear();
+        m_superIndex.clear();
+        m_queue.clear();
+        m_stats = Stats{};
+        m_stopping = false;
+        m_failed = false;
+
+        // 头部在关闭时按实际尺寸和帧数重写，这里先占位
+        const auto header = BuildHeader(0);
+        m_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        m_riffStart = 0;
+        m_position = header.size();
+        BeginSegment();
+
+        m_thread = std::thread(&MjpegRecorder::EncoderLoop, this);
+
+        LOG_INFO("Recording MJPEG to {} ({} fps, quality {})", m_desc.path.string(), m_desc.frameRate, m_desc.quality);
+        return true;
+    }
+
+    bool MjpegRecorder::Submit(std::shared_ptr<const lens::graphics::CpuImage> image, int64_t captureTime)
+    {
+        if (!image || image->IsEmpty())
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_file.is_open() || m_stopping || m_failed)
+                return false;
+
+            m_stats.submitted++;
+            if (m_queue.size() >= m_desc.queueCapacity)
+            {
+                m_stats.dropped++;
+                return false;
+            }
+            m_queue.push_back(Job{ std::move(image), captureTime });
+        }
+        m_cv.notify_one();
+        return true;
+    }
+
+    bool MjpegRecorder::Close()
+    {
+        if (!IsOpen())
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        FinishSegment();
+
+        const auto header = BuildHeader(m_firstRiffSize);
+        m_file.seekp(0);
+        m_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        const bool ok = !m_failed && m_file.good();
+        m_file.close();
+
+        if (!ok)
+        {
+            LOG_ERROR("Failed to finish video: {}", m_desc.path.string());
+            return false;
+        }
+
+        LOG_INFO("Video closed: {} frames ({} repeated, {} skipped, {} dropped), {:.1f} MB, {} segment(s)",
+            m_frameCount, m_stats.repeated, m_stats.skipped, m_stats.dropped,
+            m_position / (1024.0 * 1024.0), m_superIndex.size());
+        return true;
+    }
+
+    MjpegRecorder::Stats MjpegRecorder::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void MjpegRecorder::EncoderLoop()
+    {
+        graphics::ImageEncodeOptions options;
+        options.codec = graphics::ImageCodec::JPEG;
+        options.jpegQuality = m_desc.quality;
+        options.pool = m_desc.pool;
+
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this] { return !m_queue.empty() || m_stopping; });
+                if (m_queue.empty())
+                    break;
+                job = std::move(m_queue.front());
+                m_queue.pop_front();
+                if (m_failed)
+                    continue;
+            }
+
+            const auto& image = *job.image;
+            if (m_width == 0)
+            {
+                m_width = image.width;
+                m_height = image.height;
+                m_firstTime = job.captureTime;
+            }
+            else if (image.width != m_width || image.height != m_height)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stats.dropped++;
+                continue;
+            }
+
+            // 捕获时间换算到固定帧率的时间轴上
+            const int64_t slot = std::llround(static_cast<double>(job.captureTime - m_firstTime) * m_desc.frameRate / 1e7);
+            if (slot < m_nextSlot)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stats.skipped++;
+                continue;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            const bool encoded = graphics::EncodeImage(image, m_encoded, options);
+            const double encodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            job.image.reset();
+
+            bool written = encoded;
+            const uint64_t repeats = static_cast<uint64_t>(slot - m_nextSlot);
+            for (uint64_t i = 0; i < repeats && written; ++i)
+            {
+                written = WriteFrame(nullptr, 0);
+            }
+            written = written && WriteFrame(m_encoded.data(), static_cast<uint32_t>(m_encoded.size()));
+            m_nextSlot = slot + 1;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!written)
+            {
+                m_failed = true;
+                continue;
+            }
+            m_stats.encoded++;
+            m_stats.repeated += repeats;
+            m_stats.bytesWritten = m_position;
+            m_stats.encodeMs += encodeMs;
+        }
+    }
+
+    bool MjpegRecorder::WriteFrame(const uint8_t* data, uint32_t size)
+    {
+        const uint64_t chunkBytes = 8 + size + (size & 1);
+
+        // 本段写不下这一帧和它的索引项时换到新的 AVIX 段
+        const uint64_t indexBytes = (m_segment.size() + 1) * (m_superIndex.empty() ? 24 : 8) + 48;
+        if (!m_segment.empty() && m_position + chunkBytes + indexBytes - m_riffStart > kSegmentBytes)
+        {
+            FinishSegment();
+            if (m_superIndex.size() >= kSuperIndexEntries)
+            {
+                LOG_ERROR("Video exceeds the maximum size: {}", m_desc.path.string());
+                return false;
+            }
+            BeginSegment();
+        }
+
+        std::vector<uint8_t> header;
+        PutFourCC(header, "00dc");
+        PutU32(header, size);
+        m_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        if (size > 0)
+        {
+            m_file.write(reinterpret_cast<const char*>(data), size);
+        }
+        if (size & 1)
+        {
+            m_file.put(0);
+        }
+        if (!m_file.good())
+        {
+            LOG_ERROR("Failed to write video frame: {}", m_desc.path.string());
+            return false;
+        }
+
+        m_segment.push_back(ChunkEntry{ m_position, size });
+        m_position += chunkBytes;
+        m_frameCount++;
+        m_maxChunkSize = (std::max)(m_maxChunkSize, size);
+        return true;
+    }
+
+    void MjpegRecorder::BeginSegment()
+    {
+        std::vector<uint8_t> header;
+        if (!m_superIndex.empty())
+        {
+            m_riffStart = m_position;
+            PutFourCC(header, "RIFF");
+            PutU32(header, 0);
+            PutFourCC(header, "AVIX");
+        }
+        m_moviStart = m_position + header.size();
+        PutFourCC(header, "LIST");
+        PutU32(header, 0);
+        PutFourCC(header, "movi");
+
+        m_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        m_position += header.size();
+    }
+
+    void MjpegRecorder::FinishSegment()
+    {
+        const uint32_t count = static_cast<uint32_t>(m_segment.size());
+        const bool first = m_superIndex.empty();
+
+        // movi 末尾的标准索引，偏移相对于 movi 列表起点，指向数据而不是块头
+        std::vector<uint8_t> index;
+        PutFourCC(index, "ix00");
+        PutU32(index, 24 + count * 8);
+        PutU16(index, 2);
+        index.push_back(0);
+        index.push_back(kAviIndexOfChunks);
+        PutU32(index, count);
+        PutFourCC(index, "00dc");
+        PutU64(index, m_moviStart);
+        PutU32(index, 0);
+        for (const auto& entry : m_segment)
+        {
+            PutU32(index, static_cast<uint32_t>(entry.offset + 8 - m_moviStart));
+            PutU32(index, entry.size);
+        }
+        m_superIndex.push_back(SuperIndexEntry{ m_position, static_cast<uint32_t>(index.size()), count });
+        m_position += index.size();
+
+        const uint64_t moviEnd = m_position;
+
+        // 第一段再写一份旧式索引，偏移相对于 'movi' 标识
+        if (first)
+        {
+            PutFourCC(index, "idx1");
+            PutU32(index, count * 16);
+            for (const auto& entry : m_segment)
+            {
+                PutFourCC(index, "00dc");
+                PutU32(index, kAviifKeyframe);
+                PutU32(index, static_cast<uint32_t>(entry.offset - (m_moviStart + 8)));
+                PutU32(index, entry.size);
+            }
+            m_position += 8 + count * 16;
+            m_firstSegmentFrames = count;
+        }
+        m_file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+
+        // 回填 movi 列表和 RIFF 段的长度
+        const uint32_t riffSize = static_cast<uint32_t>(m_position - m_riffStart - 8);
+        std::vector<uint8_t> size;
+        PutU32(size, static_cast<uint32_t>(moviEnd - m_moviStart - 8));
+        m_file.seekp(static_cast<std::streamoff>(m_moviStart + 4));
+        m_file.write(reinterpret_cast<const char*>(size.data()), 4);
+        if (first)
+        {
+            m_firstRiffSize = riffSize;
+        }
+        else
+        {
+            size.clear();
+            PutU32(size, riffSize);
+            m_file.seekp(static_cast<std::streamoff>(m_riffStart + 4));
+            m_file.write(reinterpret_cast<const char*>(size.data()), 4);
+        }
+        m_file.seekp(static_cast<std::streamoff>(m_position));
+
+        m_segment.clear();
+    }
+
+    std::vector<uint8_t> MjpegRecorder::BuildHeader(uint32_t riffSize) const
+    {
+        const uint32_t strlSize = 4 + (8 + kStrhSize) + (8 + kStrfSize) + (8 + kIndxSize);
+        const uint32_t odmlSize = 4 + 8 + kDmlhSize;
+        const uint32_t hdrlSize = 4 + (8 + kAvihSize) + (8 + strlSize) + (8 + odmlSize);
+        const uint32_t bufferSize = m_maxChunkSize + 8;
+
+        std::vector<uint8_t> out;
+        out.reserve(12 + 8 + hdrlSize);
+        PutFourCC(out, "RIFF");
+        PutU32(out, riffSize);
+        PutFourCC(out, "AVI ");
+
+        PutFourCC(out, "LIST");
+        PutU32(out, hdrlSize);
+        PutFourCC(out, "hdrl");
+
+        // MainAVIHeader
+        PutFourCC(out, "avih");
+        PutU32(out, kAvihSize);
+        PutU32(out, 1000000 / m_desc.frameRate);            // dwMicroSecPerFrame
+        PutU32(out, m_maxChunkSize * m_desc.frameRate);     // dwMaxBytesPerSec
+        PutU32(out, 0);                                     // dwPaddingGranularity
+        PutU32(out, kAvifHasIndex);
+        PutU32(out, m_firstSegmentFrames);                  // dwTotalFrames，只计第一段
+        PutU32(out, 0);                                     // dwInitialFrames
+        PutU32(out, 1);                                     // dwStreams
+        PutU32(out, bufferSize);
+        PutU32(out, m_width);
+        PutU32(out, m_height);
+        out.insert(out.end(), 16, 0);
+
+        PutFourCC(out, "LIST");
+        PutU32(out, strlSize);
+        PutFourCC(out, "strl");
+
+        // AVIStreamHeader
+        PutFourCC(out, "strh");
+        PutU32(out, kStrhSize);
+        PutFourCC(out, "vids");
+        PutFourCC(out, "MJPG");
+        PutU32(out, 0);                                     // dwFlags
+        PutU16(out, 0);                                     // wPriority
+        PutU16(out, 0);                                     // wLanguage
+        PutU32(out, 0);                                     // dwInitialFrames
+        PutU32(out, 1);                                     // dwScale
+        PutU32(out, m_desc.frameRate);                      // dwRate
+        PutU32(out, 0);                                     // dwStart
+        PutU32(out, m_frameCount);                          // dwLength
+        PutU32(out, bufferSize);
+        PutU32(out, 0xFFFFFFFF);                            // dwQuality
+        PutU32(out, 0);                                     // dwSampleSize
+        PutU16(out, 0);                                     // rcFrame
+        PutU16(out, 0);
+        PutU16(out, m_width);
+        PutU16(out, m_height);
+
+        // BITMAPINFOHEADER
+        PutFourCC(out, "strf");
+        PutU32(out, kStrfSize);
+        PutU32(out, kStrfSize);
+        PutU32(out, m_width);
+        PutU32(out, m_height);
+        PutU16(out, 1);                                     // biPlanes
+        PutU16(out, 24);                                    // biBitCount
+        PutFourCC(out, "MJPG");
+        PutU32(out, m_width * m_height * 3);                // biSizeImage
+        out.insert(out.end(), 16, 0);
+
+        // OpenDML 超级索引
+        PutFourCC(out, "indx");
+        PutU32(out, kIndxSize);
+        PutU16(out, 4);                                     // wLongsPerEntry
+        out.push_back(0);                                   // bIndexSubType
+        out.push_back(kAviIndexOfIndexes);
+        PutU32(out, static_cast<uint32_t>(m_superIndex.size()));
+        PutFourCC(out, "00dc");
+        out.insert(out.end(), 12, 0);
+        for (const auto& entry : m_superIndex)
+        {
+            PutU64(out, entry.offset);
+            PutU32(out, entry.size);
+            PutU32(out, entry.duration);
+        }
+        out.insert(out.end(), (kSuperIndexEntries - m_superIndex.size()) * 16, 0);
+
+        PutFourCC(out, "LIST");
+        PutU32(out, odmlSize);
+        PutFourCC(out, "odml");
+        PutFourCC(out, "dmlh");
+        PutU32(out, kDmlhSize);
+        PutU32(out, m_frameCount);                          // dwTotalFrames，所有段
+        out.insert(out.end(), kDmlhSize - 4, 0);
+        return out;
+    }
+}
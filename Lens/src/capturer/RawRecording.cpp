@@ -0,0 +1,786 @@
+﻿#include "LensPch.h"
+#include "capturer/RawRecording.h"
+#include <cstring>
+#include <new>
+
+namespace lens::capturer
+{
+    using namespace rawformat;
+
+    namespace
+    {
+        constexpr uint64_t AlignUp(uint64_t value)
+        {
+            return (value + kAlignment - 1) & ~uint64_t(kAlignment - 1);
+        }
+
+        const uint8_t kZeros[kAlignment] = {};
+    }
+
+    // ---------------------------------------------------------------------
+    // RawRecordingWriter
+    // ---------------------------------------------------------------------
+
+    void RawRecordingWriter::AlignedDeleter::operator()(uint8_t* data) const
+    {
+        ::operator delete(data, std::align_val_t{ kAlignment });
+    }
+
+    RawRecordingWriter::RawRecordingWriter()
+    {
+    }
+
+    RawRecordingWriter::~RawRecordingWriter()
+    {
+        Close();
+    }
+
+    bool RawRecordingWriter::Open(const Desc& desc)
+    {
+        Close();
+
+        m_desc = desc;
+        m_desc.chunkSize = static_cast<uint32_t>(AlignUp((std::max)(m_desc.chunkSize, kAlignment)));
+        m_desc.bufferCount = (std::max)(m_desc.bufferCount, 2u);
+
+        std::error_code ec;
+        if (m_desc.path.has_parent_path())
+        {
+            std::filesystem::create_directories(m_desc.path.parent_path(), ec);
+        }
+
+        // 每次写入都是 4 KB 对齐缓冲里的整块，满足无缓冲 IO 的对齐要求
+        DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+        if (m_desc.unbuffered)
+        {
+            flags |= FILE_FLAG_NO_BUFFERING;
+        }
+
+        m_file = CreateFileW(m_desc.path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, flags, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            LOG_ERROR("Failed to create recording: {} (error {})", m_desc.path.string(), GetLastError());
+            return false;
+        }
+
+        m_buffers.clear();
+        for (uint32_t i = 0; i < m_desc.bufferCount; ++i)
+        {
+            m_buffers.emplace_back(static_cast<uint8_t*>(::operator new(m_desc.chunkSize, std::align_val_t{ kAlignment })));
+        }
+
+        m_free.clear();
+        for (size_t i = 1; i < m_buffers.size(); ++i)
+        {
+            m_free.push_back(m_buffers[i].get());
+        }
+        m_current = Chunk{ m_buffers[0].get(), 0 };
+        m_pending.clear();
+        m_offset = 0;
+        m_index.clear();
+        m_encoder = m_desc.deltaCompression ? std::make_unique<DeltaEncoder>(m_desc.delta) : nullptr;
+        m_jobs.clear();
+        m_stats = Stats{};
+        m_stopping = false;
+        m_draining = false;
+        m_failed = false;
+        m_thread = std::thread(&RawRecordingWriter::WriterLoop, this);
+
+        FileHeader header{};
+        std::memcpy(header.magic, kFileMagic, sizeof(header.magic));
+        header.version = kVersion;
+        header.alignment = kAlignment;
+        header.createdTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        Put(&header, sizeof(header));
+        PutZeros(kAlignment - sizeof(header));
+
+        m_encoderThread = std::thread(&RawRecordingWriter::EncoderLoop, this);
+
+        LOG_INFO("Recording to {}", m_desc.path.string());
+        return true;
+    }
+
+    bool RawRecordingWriter::Append(std::shared_ptr<const lens::graphics::CpuImage> image, const FrameDescriptor& descriptor)
+    {
+        if (!IsOpen())
+            return false;
+
+        if (!image || image->IsEmpty() || lens::graphics::GetFormatBytesPerPixel(image->format) == 0)
+        {
+            LOG_ERROR("Cannot record an empty frame or unknown format");
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_draining || m_failed)
+                return false;
+
+            // 丢帧不算失败，录制继续
+            if (m_jobs.size() >= m_desc.queueCapacity)
+            {
+                m_stats.dropped++;
+                return true;
+            }
+            m_jobs.push_back(Job{ std::move(image), descriptor });
+        }
+        m_jobReady.notify_one();
+        return true;
+    }
+
+    void RawRecordingWriter::EncoderLoop()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobReady.wait(lock, [this] { return !m_jobs.empty() || m_draining; });
+                if (m_jobs.empty())
+                    break;
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                if (m_failed)
+                    continue;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            const bool ok = WriteFrame(*job.image, job.descriptor);
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.encodeMs += ms;
+            if (!ok)
+            {
+                m_failed = true;
+            }
+        }
+    }
+
+    bool RawRecordingWriter::WriteFrame(const lens::graphics::CpuImage& image, const FrameDescriptor& descriptor)
+    {
+        const uint32_t bytesPerPixel = lens::graphics::GetFormatBytesPerPixel(image.format);
+        bool keyframe = true;
+        if (m_encoder && !m_encoder->Encode(image, m_encoded, &keyframe))
+        {
+            return false;
+        }
+
+        const uint32_t rowBytes = image.width * bytesPerPixel;
+        uint32_t flags = 0;
+        uint64_t pixelBytes = static_cast<uint64_t>(rowBytes) * image.height;
+        if (m_encoder)
+        {
+            flags = kFrameDelta | (keyframe ? kFrameKeyframe : 0);
+            pixelBytes = m_encoded.size();
+        }
+        PutRecordHeader(descriptor, image.width, image.height, image.format, rowBytes, flags, pixelBytes);
+
+        if (m_encoder)
+        {
+            Put(m_encoded.data(), m_encoded.size());
+        }
+        else if (image.rowPitch == rowBytes)
+        {
+            Put(image.pixels.data(), static_cast<size_t>(pixelBytes));
+        }
+        else
+        {
+            for (uint32_t y = 0; y < image.height; ++y)
+            {
+                Put(image.Row(y), rowBytes);
+            }
+        }
+        PutZeros(static_cast<size_t>(AlignUp(pixelBytes) - pixelBytes));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.frames++;
+        m_stats.keyframes += m_encoder && keyframe ? 1 : 0;
+        m_stats.inputBytes += static_cast<uint64_t>(rowBytes) * image.height;
+        return true;
+    }
+
+    bool RawRecordingWriter::AppendEncoded(const uint8_t* data, size_t size, const FrameDescriptor& descriptor)
+    {
+        if (!IsOpen())
+            return false;
+
+        deltaformat::DeltaFrameHeader delta{};
+        if (size < sizeof(delta))
+        {
+            LOG_ERROR("Encoded frame is too small");
+            return false;
+        }
+        std::memcpy(&delta, data, sizeof(delta));
+
+        const auto format = static_cast<lens::graphics::TextureFormat>(delta.format);
+        const uint32_t bytesPerPixel = lens::graphics::GetFormatBytesPerPixel(format);
+        if (delta.magic != deltaformat::kMagic || bytesPerPixel == 0)
+        {
+            LOG_ERROR("Not a delta-encoded frame");
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_failed)
+                return false;
+        }
+
+        const bool keyframe = (delta.flags & deltaformat::kKeyframe) != 0;
+        const uint32_t rowBytes = delta.width * bytesPerPixel;
+        PutRecordHeader(descriptor, delta.width, delta.height, format, rowBytes,
+            kFrameDelta | (keyframe ? kFrameKeyframe : 0), size);
+        Put(data, size);
+        PutZeros(static_cast<size_t>(AlignUp(size) - size));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.frames++;
+        m_stats.keyframes += keyframe ? 1 : 0;
+        m_stats.inputBytes += static_cast<uint64_t>(rowBytes) * delta.height;
+        return true;
+    }
+
+    void RawRecordingWriter::PutRecordHeader(const FrameDescriptor& descriptor, uint32_t width, uint32_t height,
+        lens::graphics::TextureFormat format, uint32_t rowPitch, uint32_t flags, uint64_t pixelBytes)
+    {
+        const uint32_t dirtyCount = descriptor.dirtyKnown ? static_cast<uint32_t>(descriptor.dirtyRects.size()) : 0;
+        const size_t metaBytes = sizeof(RawFrameHeader) + static_cast<size_t>(dirtyCount) * sizeof(DirtyRect);
+
+        RawFrameHeader header{};
+        header.magic = kFrameMagic;
+        header.headerSize = static_cast<uint32_t>(AlignUp(metaBytes));
+        header.sequence = descriptor.sequence;
+        header.captureTime = descriptor.captureTime;
+        header.sourceId = descriptor.sourceId;
+        header.width = width;
+        header.height = height;
+        header.format = static_cast<uint32_t>(format);
+        header.rowPitch = rowPitch;
+        header.flags = flags | (descriptor.dirtyKnown ? kFrameDirtyKnown : 0);
+        header.dirtyCount = dirtyCount;
+        header.pixelBytes = pixelBytes;
+
+        RawIndexEntry entry{};
+        entry.offset = m_offset;
+        entry.size = header.headerSize + AlignUp(header.pixelBytes);
+        entry.sequence = descriptor.sequence;
+        entry.captureTime = descriptor.captureTime;
+        m_index.push_back(entry);
+
+        Put(&header, sizeof(header));
+        if (dirtyCount > 0)
+        {
+            Put(descriptor.dirtyRects.data(), static_cast<size_t>(dirtyCount) * sizeof(DirtyRect));
+        }
+        PutZeros(header.headerSize - metaBytes);
+    }
+
+    bool RawRecordingWriter::Close()
+    {
+        if (!IsOpen())
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_draining = true;
+        }
+        m_jobReady.notify_all();
+        if (m_encoderThread.joinable())
+        {
+            m_encoderThread.join();
+        }
+
+        // 索引之后补零，让尾部正好落在文件最后 64 字节，文件总长保持 4 KB 对齐
+        RawTrailer trailer{};
+        std::memcpy(trailer.magic, kTrailerMagic, sizeof(trailer.magic));
+        trailer.version = kVersion;
+        trailer.frameCount = m_index.size();
+        trailer.indexOffset = m_offset;
+        if (!m_index.empty())
+        {
+            trailer.firstTime = m_index.front().captureTime;
+            trailer.lastTime = m_index.back().captureTime;
+        }
+
+        if (!m_index.empty())
+        {
+            Put(m_index.data(), m_index.size() * sizeof(RawIndexEntry));
+        }
+        PutZeros(static_cast<size_t>(AlignUp(m_offset + sizeof(trailer)) - (m_offset + sizeof(trailer))));
+        Put(&trailer, sizeof(trailer));
+
+        if (m_current.size > 0)
+        {
+            SubmitChunk(false);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_chunkReady.notify_all();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+        m_current = Chunk{};
+
+        if (m_failed)
+        {
+            LOG_ERROR("Recording {} is incomplete", m_desc.path.string());
+            return false;
+        }
+
+        LOG_INFO("Recording closed: {} frames ({} dropped), {:.1f} MB ({:.1f} MB raw), {} writes, {:.1f} ms encoding, {:.1f} ms writing, {} stalls",
+            m_stats.frames, m_stats.dropped, m_stats.bytesWritten / (1024.0 * 1024.0), m_stats.inputBytes / (1024.0 * 1024.0),
+            m_stats.writes, m_stats.encodeMs, m_stats.writeMs, m_stats.stalls);
+        return true;
+    }
+
+    RawRecordingWriter::Stats RawRecordingWriter::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void RawRecordingWriter::Put(const void* data, size_t size)
+    {
+        const auto* src = static_cast<const uint8_t*>(data);
+        m_offset += size;
+        while (size > 0)
+        {
+            const size_t count = (std::min)(size, static_cast<size_t>(m_desc.chunkSize) - m_current.size);
+            std::memcpy(m_current.data + m_current.size, src, count);
+            m_current.size += count;
+            src += count;
+            size -= count;
+
+            if (m_current.size == m_desc.chunkSize)
+            {
+                SubmitChunk(true);
+            }
+        }
+    }
+
+    void RawRecordingWriter::PutZeros(size_t size)
+    {
+        while (size > 0)
+        {
+            const size_t count = (std::min)(size, sizeof(kZeros));
+            Put(kZeros, count);
+            size -= count;
+        }
+    }
+
+    void RawRecordingWriter::SubmitChunk(bool acquireNext)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_pending.push_back(m_current);
+        m_current = Chunk{};
+        m_chunkReady.notify_one();
+
+        if (!acquireNext)
+            return;
+
+        if (m_free.empty())
+        {
+            m_stats.stalls++;
+            m_chunkFree.wait(lock, [this] { return !m_free.empty(); });
+        }
+        m_current = Chunk{ m_free.back(), 0 };
+        m_free.pop_back();
+    }
+
+    void RawRecordingWriter::WriterLoop()
+    {
+        for (;;)
+        {
+            Chunk chunk;
+            bool failed = false;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_chunkReady.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+                if (m_pending.empty())
+                    break;
+
+                chunk = m_pending.front();
+                m_pending.pop_front();
+                failed = m_failed;
+            }
+
+            // 写入失败后继续回收缓冲，调用方在下一次 Append 时得知
+            const auto start = std::chrono::steady_clock::now();
+            DWORD written = 0;
+            const bool ok = !failed &&
+                WriteFile(m_file, chunk.data, static_cast<DWORD>(chunk.size), &written, nullptr) &&
+                written == chunk.size;
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (ok)
+                {
+                    m_stats.bytesWritten += chunk.size;
+                    m_stats.writes++;
+                    m_stats.writeMs += ms;
+                }
+                else if (!m_failed)
+                {
+                    m_failed = true;
+                    LOG_ERROR("Failed to write recording {} (error {})", m_desc.path.string(), GetLastError());
+                }
+                m_free.push_back(chunk.data);
+            }
+            m_chunkFree.notify_one();
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // RawRecordingReader
+    // ---------------------------------------------------------------------
+
+    RawRecordingReader::RawRecordingReader()
+    {
+    }
+
+    RawRecordingReader::~RawRecordingReader()
+    {
+        Close();
+    }
+
+    bool RawRecordingReader::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        // 允许打开正在录制的文件，此时按扫描恢复的索引读取已写出的部分
+        m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            LOG_ERROR("Failed to open recording: {} (error {})", path.string(), GetLastError());
+            return false;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(m_file, &size) || static_cast<uint64_t>(size.QuadPart) < kAlignment)
+        {
+            LOG_ERROR("Not a recording: {}", path.string());
+            Close();
+            return false;
+        }
+        m_fileSize = static_cast<uint64_t>(size.QuadPart);
+
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping)
+        {
+            LOG_ERROR("Failed to map recording: {} (error {})", path.string(), GetLastError());
+            Close();
+            return false;
+        }
+
+        SYSTEM_INFO info{};
+        GetSystemInfo(&info);
+        m_granularity = info.dwAllocationGranularity;
+
+        // 地址空间足够时一次映射整个文件，之后取帧只是指针运算
+        if (m_fileSize <= static_cast<uint64_t>(SIZE_MAX))
+        {
+            if (void* view = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0))
+            {
+                m_view = std::shared_ptr<const uint8_t>(static_cast<const uint8_t*>(view),
+                    [](const uint8_t* data) { UnmapViewOfFile(data); });
+            }
+        }
+
+        FileHeader header{};
+        auto headerView = MapRange(0, sizeof(header));
+        if (headerView)
+        {
+            std::memcpy(&header, headerView.get(), sizeof(header));
+        }
+        if (!headerView || std::memcmp(header.magic, kFileMagic, sizeof(header.magic)) != 0 ||
+            header.version != kVersion || header.alignment != kAlignment)
+        {
+            LOG_ERROR("Not a recording or unsupported version: {}", path.string());
+            Close();
+            return false;
+        }
+
+        if (!LoadIndex())
+        {
+            if (!RebuildIndex())
+            {
+                LOG_ERROR("Recording has no readable frames: {}", path.string());
+                Close();
+                return false;
+            }
+            m_recovered = true;
+            LOG_WARN("Recording {} has no index, recovered {} frames by scanning", path.string(), m_index.size());
+        }
+
+        LOG_INFO("Opened recording {}: {} frames, {:.1f} MB, mapped {}",
+            path.string(), m_index.size(), m_fileSize / (1024.0 * 1024.0), m_view ? "whole file" : "per frame");
+        return true;
+    }
+
+    void RawRecordingReader::Close()
+    {
+        // 已交出的 FrameView 各自持有映射，不受影响
+        m_view.reset();
+        m_index.clear();
+        m_recovered = false;
+        m_decoder.Reset();
+        m_decodedIndex = SIZE_MAX;
+        m_fileSize = 0;
+
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    bool RawRecordingReader::GetFrame(size_t index, FrameView& view) const
+    {
+        if (index >= m_index.size())
+            return false;
+
+        const RawIndexEntry& entry = m_index[index];
+        auto record = MapRange(entry.offset, entry.size);
+        if (!record)
+        {
+            LOG_ERROR("Failed to map frame {} (error {})", index, GetLastError());
+            return false;
+        }
+
+        RawFrameHeader header{};
+        std::memcpy(&header, record.get(), sizeof(header));
+
+        const auto format = static_cast<lens::graphics::TextureFormat>(header.format);
+        const uint32_t bytesPerPixel = lens::graphics::GetFormatBytesPerPixel(format);
+        const uint64_t metaBytes = sizeof(header) + static_cast<uint64_t>(header.dirtyCount) * sizeof(DirtyRect);
+        const bool delta = (header.flags & kFrameDelta) != 0;
+        if (header.magic != kFrameMagic || bytesPerPixel == 0 || header.headerSize < metaBytes ||
+            header.headerSize + header.pixelBytes > entry.size ||
+            header.rowPitch < static_cast<uint64_t>(header.width) * bytesPerPixel ||
+            (!delta && static_cast<uint64_t>(header.rowPitch) * header.height > header.pixelBytes))
+        {
+            LOG_ERROR("Corrupt frame record {} at offset {}", index, entry.offset);
+            return false;
+        }
+
+        view.descriptor = FrameDescriptor{};
+        view.descriptor.sourceId = header.sourceId;
+        view.descriptor.sequence = header.sequence;
+        view.descriptor.captureTime = header.captureTime;
+        view.descriptor.width = header.width;
+        view.descriptor.height = header.height;
+        view.descriptor.dirtyKnown = (header.flags & kFrameDirtyKnown) != 0;
+        view.descriptor.dirtyRects.resize(header.dirtyCount);
+        if (header.dirtyCount > 0)
+        {
+            std::memcpy(view.descriptor.dirtyRects.data(), record.get() + sizeof(header),
+                static_cast<size_t>(header.dirtyCount) * sizeof(DirtyRect));
+        }
+
+        view.format = format;
+        view.rowPitch = header.rowPitch;
+        view.pixels = record.get() + header.headerSize;
+        view.delta = delta;
+        view.keyframe = !delta || (header.flags & kFrameKeyframe) != 0;
+        view.dataSize = header.pixelBytes;
+        view.mapping = std::move(record);
+        return true;
+    }
+
+    bool RawRecordingReader::ReadFrame(size_t index, lens::graphics::CpuImage& image, FrameDescriptor* descriptor) const
+    {
+        FrameView view;
+        if (!GetFrame(index, view))
+            return false;
+
+        if (view.delta)
+        {
+            if (!DecodeFrame(index))
+                return false;
+            image = m_decoder.GetImage();
+        }
+        else
+        {
+            image.Allocate(view.descriptor.width, view.descriptor.height, view.format);
+            if (view.rowPitch == image.rowPitch)
+            {
+                std::memcpy(image.pixels.data(), view.pixels, image.pixels.size());
+            }
+            else
+            {
+                for (uint32_t y = 0; y < image.height; ++y)
+                {
+                    std::memcpy(image.Row(y), view.pixels + static_cast<size_t>(y) * view.rowPitch, image.rowPitch);
+                }
+            }
+        }
+
+        if (descriptor)
+        {
+            *descriptor = std::move(view.descriptor);
+        }
+        return true;
+    }
+
+    size_t RawRecordingReader::FindFrame(int64_t time) const
+    {
+        auto it = std::upper_bound(m_index.begin(), m_index.end(), time,
+            [](int64_t value, const RawIndexEntry& entry) { return value < entry.captureTime; });
+        return it == m_index.begin() ? 0 : static_cast<size_t>(it - m_index.begin()) - 1;
+    }
+
+    bool RawRecordingReader::IsKeyframe(size_t index) const
+    {
+        auto headerView = MapRange(m_index[index].offset, sizeof(RawFrameHeader));
+        if (!headerView)
+            return false;
+
+        RawFrameHeader header{};
+        std::memcpy(&header, headerView.get(), sizeof(header));
+        return (header.flags & kFrameDelta) == 0 || (header.flags & kFrameKeyframe) != 0;
+    }
+
+    bool RawRecordingReader::DecodeFrame(size_t index) const
+    {
+        if (m_decoder.HasImage() && m_decodedIndex == index)
+            return true;
+
+        // 往回找最近的关键帧；顺序读取时直接接着上一次解码的帧
+        size_t start = index;
+        while (!(m_decoder.HasImage() && m_decodedIndex + 1 == start) && !IsKeyframe(start))
+        {
+            if (start == 0)
+            {
+                LOG_ERROR("No keyframe before frame {}", index);
+                return false;
+            }
+            --start;
+        }
+
+        for (size_t i = start; i <= index; ++i)
+        {
+            FrameView view;
+            if (!GetFrame(i, view) || !view.delta || !m_decoder.Decode(view.pixels, static_cast<size_t>(view.dataSize)))
+            {
+                m_decoder.Reset();
+                m_decodedIndex = SIZE_MAX;
+                return false;
+            }
+            m_decodedIndex = i;
+        }
+        return true;
+    }
+
+    std::shared_ptr<const uint8_t> RawRecordingReader::MapRange(uint64_t offset, uint64_t size) const
+    {
+        if (!m_mapping || offset > m_fileSize || size > m_fileSize - offset)
+            return nullptr;
+
+        if (m_view)
+        {
+            return std::shared_ptr<const uint8_t>(m_view, m_view.get() + offset);
+        }
+
+        // 视图起点必须按分配粒度对齐
+        const uint64_t base = offset / m_granularity * m_granularity;
+        const uint64_t length = offset - base + size;
+        if (length > static_cast<uint64_t>(SIZE_MAX))
+            return nullptr;
+
+        void* view = MapViewOfFile(m_mapping, FILE_MAP_READ, static_cast<DWORD>(base >> 32),
+            static_cast<DWORD>(base & 0xFFFFFFFFu), static_cast<SIZE_T>(length));
+        if (!view)
+            return nullptr;
+
+        auto owner = std::shared_ptr<const uint8_t>(static_cast<const uint8_t*>(view),
+            [](const uint8_t* data) { UnmapViewOfFile(data); });
+        return std::shared_ptr<const uint8_t>(owner, owner.get() + (offset - base));
+    }
+
+    bool RawRecordingReader::LoadIndex()
+    {
+        if (m_fileSize < kAlignment + sizeof(RawTrailer))
+            return false;
+
+        auto trailerView = MapRange(m_fileSize - sizeof(RawTrailer), sizeof(RawTrailer));
+        if (!trailerView)
+            return false;
+
+        RawTrailer trailer{};
+        std::memcpy(&trailer, trailerView.get(), sizeof(trailer));
+        const uint64_t indexLimit = m_fileSize - sizeof(RawTrailer);
+        if (std::memcmp(trailer.magic, kTrailerMagic, sizeof(trailer.magic)) != 0 || trailer.version != kVersion ||
+            trailer.indexOffset > indexLimit || trailer.frameCount > (indexLimit - trailer.indexOffset) / sizeof(RawIndexEntry))
+        {
+            return false;
+        }
+
+        std::vector<RawIndexEntry> index(static_cast<size_t>(trailer.frameCount));
+        if (!index.empty())
+        {
+            auto indexView = MapRange(trailer.indexOffset, index.size() * sizeof(RawIndexEntry));
+            if (!indexView)
+                return false;
+            std::memcpy(index.data(), indexView.get(), index.size() * sizeof(RawIndexEntry));
+        }
+
+        for (const auto& entry : index)
+        {
+            if (entry.offset < kAlignment || entry.offset > trailer.indexOffset || entry.size > trailer.indexOffset - entry.offset)
+                return false;
+        }
+
+        m_index = std::move(index);
+        return true;
+    }
+
+    bool RawRecordingReader::RebuildIndex()
+    {
+        m_index.clear();
+
+        // 记录头自带长度，逐条跳过；遇到不完整或损坏的记录就停止
+        uint64_t offset = kAlignment;
+        while (offset + sizeof(RawFrameHeader) <= m_fileSize)
+        {
+            auto headerView = MapRange(offset, sizeof(RawFrameHeader));
+            if (!headerView)
+                break;
+
+            RawFrameHeader header{};
+            std::memcpy(&header, headerView.get(), sizeof(header));
+            if (header.magic != kFrameMagic || header.headerSize < sizeof(header) || header.headerSize % kAlignment != 0 ||
+                header.pixelBytes > m_fileSize)
+                break;
+
+            const uint64_t size = header.headerSize + AlignUp(header.pixelBytes);
+            if (size > m_fileSize - offset)
+                break;
+
+            RawIndexEntry entry{};
+            entry.offset = offset;
+            entry.size = size;
+            entry.sequence = header.sequence;
+            entry.captureTime = header.captureTime;
+            m_index.push_back(entry);
+            offset += size;
+        }
+
+        return !m_index.empty();
+    }
+}
@@ -0,0 +1,318 @@
+﻿#include "LensPch.h"
+#include "capturer/ReplayBuffer.h"
+#include "capturer/RawRecording.h"
+#include <cstring>
+
+namespace lens::capturer
+{
+    ReplayBuffer::ReplayBuffer()
+        : ReplayBuffer(Desc{})
+    {
+    }
+
+    ReplayBuffer::ReplayBuffer(const Desc& desc)
+        : m_desc(desc), m_encoder(desc.delta)
+    {
+        // 环形区一次分配到位，之后不再增长
+        m_arena = std::make_unique_for_overwrite<uint8_t[]>(static_cast<size_t>(m_desc.arenaBytes));
+        m_stats.arenaBytes = m_desc.arenaBytes;
+        m_encoderThread = std::thread(&ReplayBuffer::EncoderLoop, this);
+        LOG_INFO("Replay buffer: {:.0f} MB, up to {} s", m_desc.arenaBytes / (1024.0 * 1024.0), m_desc.maxSeconds);
+    }
+
+    ReplayBuffer::~ReplayBuffer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_jobs.clear();
+        }
+        m_jobReady.notify_all();
+        if (m_encoderThread.joinable())
+        {
+            m_encoderThread.join();
+        }
+        if (m_saveThread.joinable())
+        {
+            m_saveThread.join();
+        }
+    }
+
+    bool ReplayBuffer::Append(std::shared_ptr<const lens::graphics::CpuImage> image, const FrameDescriptor& descriptor)
+    {
+        if (!image || image->IsEmpty())
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping)
+                return false;
+
+            if (m_jobs.size() >= m_desc.queueCapacity)
+            {
+                m_stats.dropped++;
+                return false;
+            }
+            m_jobs.push_back(Job{ std::move(image), descriptor });
+        }
+        m_jobReady.notify_one();
+        return true;
+    }
+
+    void ReplayBuffer::EncoderLoop()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobReady.wait(lock, [this] { return !m_jobs.empty() || m_stopping; });
+                if (m_stopping)
+                    break;
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                if (m_forceKeyframe)
+                {
+                    m_encoder.ForceKeyframe();
+                    m_forceKeyframe = false;
+                }
+            }
+
+            bool keyframe = false;
+            if (m_encoder.Encode(*job.image, m_encoded, &keyframe))
+            {
+                Store(keyframe, job.descriptor);
+            }
+        }
+    }
+
+    void ReplayBuffer::Store(bool keyframe, const FrameDescriptor& descriptor)
+    {
+        const uint32_t size = static_cast<uint32_t>(m_encoded.size());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.appended++;
+
+        // 压缩期间被 Clear 清空时，增量帧已经没有可参照的关键帧
+        if (m_entries.empty() && !keyframe)
+        {
+            m_stats.dropped++;
+            m_encoder.ForceKeyframe();
+            return;
+        }
+
+        // 去掉最旧一组后仍覆盖 maxSeconds 时就淘汰它
+        if (m_desc.maxSeconds > 0)
+        {
+            const int64_t window = static_cast<int64_t>(m_desc.maxSeconds) * 10000000;
+            for (size_t next = FindNextGroup(); next < m_entries.size(); next = FindNextGroup())
+            {
+                if (descriptor.captureTime - m_entries[next].captureTime < window)
+                    break;
+                EvictGroup();
+            }
+        }
+
+        size_t offset = 0;
+        while (!Reserve(size, offset))
+        {
+            // 增量帧不能淘汰自己所在的组；连一组都放不下时清空，从下一个关键帧重新开始
+            if (m_entries.empty() || (!keyframe && FindNextGroup() >= m_entries.size()))
+            {
+                m_stats.evicted += m_entries.size();
+                m_stats.dropped++;
+                m_entries.clear();
+                m_usedBytes = 0;
+                m_groups = 0;
+                m_encoder.ForceKeyframe();
+                return;
+            }
+            EvictGroup();
+        }
+
+        std::memcpy(m_arena.get() + offset, m_encoded.data(), size);
+        m_tail = offset + size;
+        m_usedBytes += size;
+        m_groups += keyframe ? 1 : 0;
+        m_entries.push_back(Entry{ m_nextId++, offset, size, keyframe,
+            descriptor.sourceId, descriptor.sequence, descriptor.captureTime });
+    }
+
+    void ReplayBuffer::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.clear();
+        m_entries.clear();
+        m_usedBytes = 0;
+        m_groups = 0;
+        m_forceKeyframe = true;
+    }
+
+    bool ReplayBuffer::SaveAsync(const std::filesystem::path& path, SaveCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_saving)
+        {
+            LOG_WARN("Replay is already being saved");
+            return false;
+        }
+        if (m_entries.empty())
+        {
+            LOG_WARN("Replay buffer is empty");
+            return false;
+        }
+
+        // 上一次保存的线程已经结束，只差回收
+        if (m_saveThread.joinable())
+        {
+            m_saveThread.join();
+        }
+
+        m_saving = true;
+        m_saveThread = std::thread(&ReplayBuffer::SaveLoop, this, path,
+            m_entries.front().id, m_entries.back().id, std::move(callback));
+        return true;
+    }
+
+    ReplayBuffer::Stats ReplayBuffer::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats = m_stats;
+        stats.frames = static_cast<uint32_t>(m_entries.size());
+        stats.groups = m_groups;
+        stats.usedBytes = m_usedBytes;
+        stats.saving = m_saving;
+        if (!m_entries.empty())
+        {
+            stats.seconds = (m_entries.back().captureTime - m_entries.front().captureTime) / 1e7;
+        }
+        return stats;
+    }
+
+    bool ReplayBuffer::Reserve(uint32_t size, size_t& offset) const
+    {
+        if (m_entries.empty())
+        {
+            offset = 0;
+            return size <= m_desc.arenaBytes;
+        }
+
+        // 记录按写入顺序排列在 [head, tail) 或绕回后的 [head, 末尾) + [0, tail)，记录不跨越末尾
+        const size_t head = m_entries.front().offset;
+        if (m_tail > head)
+        {
+            if (m_desc.arenaBytes - m_tail >= size)
+            {
+                offset = m_tail;
+                return true;
+            }
+            if (head >= size)
+            {
+                offset = 0;
+                return true;
+            }
+            return false;
+        }
+
+        if (head - m_tail >= size)
+        {
+            offset = m_tail;
+            return true;
+        }
+        return false;
+    }
+
+    size_t ReplayBuffer::FindNextGroup() const
+    {
+        size_t next = 1;
+        while (next < m_entries.size() && !m_entries[next].keyframe)
+        {
+            ++next;
+        }
+        return next;
+    }
+
+    void ReplayBuffer::EvictGroup()
+    {
+        const size_t count = (std::min)(FindNextGroup(), m_entries.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_usedBytes -= m_entries.front().size;
+            m_entries.pop_front();
+        }
+        m_groups -= m_groups > 0 ? 1 : 0;
+        m_stats.evicted += count;
+    }
+
+    void ReplayBuffer::SaveLoop(std::filesystem::path path, uint64_t firstId, uint64_t lastId, SaveCallback callback)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        RawRecordingWriter writer;
+        RawRecordingWriter::Desc desc;
+        desc.path = path;
+        bool ok = writer.Open(desc);
+
+        // 每次只在锁内复制一帧，录制不会被整段保存阻塞。
+        // 保存赶不上淘汰时跳过已丢失的帧，从下一个关键帧继续
+        std::vector<uint8_t> data;
+        FrameDescriptor descriptor;
+        bool needKeyframe = true;
+        uint64_t saved = 0;
+        uint64_t skipped = 0;
+        for (uint64_t id = firstId; ok && id <= lastId; ++id)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_entries.empty())
+                    break;
+
+                const uint64_t frontId = m_entries.front().id;
+                if (id < frontId)
+                {
+                    skipped += frontId - id;
+                    id = frontId;
+                    needKeyframe = true;
+                    if (id > lastId)
+                        break;
+                }
+
+                const Entry& entry = m_entries[static_cast<size_t>(id - frontId)];
+                if (needKeyframe && !entry.keyframe)
+                {
+                    skipped++;
+                    continue;
+                }
+
+                data.assign(m_arena.get() + entry.offset, m_arena.get() + entry.offset + entry.size);
+                descriptor.sourceId = entry.sourceId;
+                descriptor.sequence = entry.sequence;
+                descriptor.captureTime = entry.captureTime;
+            }
+
+            needKeyframe = false;
+            ok = writer.AppendEncoded(data.data(), data.size(), descriptor);
+            saved++;
+        }
+
+        ok = writer.Close() && ok;
+        if (ok)
+        {
+            LOG_INFO("Replay saved: {} ({} frames, {} skipped, {:.1f} ms)", path.string(), saved, skipped,
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        else
+        {
+            LOG_ERROR("Failed to save replay: {}", path.string());
+        }
+
+        if (callback)
+        {
+            callback(ok, path);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_saving = false;
+        m_stats.saves += ok ? 1 : 0;
+    }
+}
@@ -0,0 +1,330 @@
+﻿#include "LensPch.h"
+#include "capturer/SnapshotWriter.h"
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+
+namespace lens::capturer
+{
+    namespace
+    {
+        double ElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+        {
+            return std::chrono::duration<double, std::milli>(to - from).count();
+        }
+
+        SnapshotWriter::Result MakeResult(SnapshotWriter::Status status)
+        {
+            SnapshotWriter::Result result;
+            result.status = status;
+            return result;
+        }
+    }
+
+    SnapshotWriter::SnapshotWriter()
+        : SnapshotWriter(Desc{})
+    {
+    }
+
+    SnapshotWriter::SnapshotWriter(const Desc& desc, std::unique_ptr<lens::graphics::IReadbackDevice> readbackDevice)
+        : m_desc(desc)
+    {
+        m_desc.queueCapacity = (std::max)(m_desc.queueCapacity, 1u);
+        m_desc.workerCount = (std::max)(m_desc.workerCount, 1u);
+
+        if (readbackDevice)
+        {
+            m_readback = std::make_unique<lens::graphics::ReadbackRing>(std::move(readbackDevice), (std::max)(m_desc.readbackSlots, 1u));
+        }
+
+        m_workers.reserve(m_desc.workerCount);
+        for (uint32_t i = 0; i < m_desc.workerCount; ++i)
+        {
+            m_workers.emplace_back(&SnapshotWriter::WorkerLoop, this);
+        }
+    }
+
+    SnapshotWriter::~SnapshotWriter()
+    {
+        // 未完成的回读按失败交付；已排队的截图仍然写完再退出
+        m_readback.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_workAvailable.notify_all();
+        m_spaceAvailable.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+
+    std::future<SnapshotWriter::Result> SnapshotWriter::Submit(std::shared_ptr<const lens::graphics::CpuImage> image,
+        std::filesystem::path path, Callback callback)
+    {
+        Job job;
+        job.image = std::move(image);
+        job.path = std::move(path);
+        job.callback = std::move(callback);
+        job.submitTime = Clock::now();
+        auto future = job.promise.get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.submitted++;
+            if (!job.image || job.image->IsEmpty())
+            {
+                m_stats.failed++;
+                job.image.reset();
+            }
+        }
+
+        if (!job.image)
+        {
+            Complete(job, MakeResult(Status::Failed));
+            return future;
+        }
+
+        Enqueue(std::move(job));
+        return future;
+    }
+
+    std::future<SnapshotWriter::Result> SnapshotWriter::Submit(const Frame& frame, std::filesystem::path path, Callback callback)
+    {
+        if (frame.image || !frame.texture || !m_readback)
+        {
+            return Submit(frame.image, std::move(path), std::move(callback));
+        }
+
+        Job job;
+        job.path = std::move(path);
+        job.callback = std::move(callback);
+        job.submitTime = Clock::now();
+        auto future = job.promise.get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.submitted++;
+        }
+
+        // 回读环在读取失败或自身销毁时直接丢弃回调而不调用，
+        // 这里借共享指针的删除器把这种情况补报为失败，保证 future 总会就绪
+        auto pending = std::shared_ptr<Job>(new Job(std::move(job)), [this](Job* orphan)
+        {
+            if (!orphan->delivered)
+            {
+                m_pendingReadbacks.fetch_sub(1, std::memory_order_relaxed);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stats.failed++;
+                }
+                Complete(*orphan, MakeResult(Status::Failed));
+            }
+            delete orphan;
+        });
+
+        const bool slotsFull = m_readback->GetInFlightCount() >= m_readback->GetSlotCount();
+        m_pendingReadbacks.fetch_add(1, std::memory_order_relaxed);
+        const bool submitted = m_readback->Submit(frame.texture.get(), [this, pending](std::shared_ptr<const lens::graphics::CpuImage> image)
+        {
+            pending->delivered = true;
+            m_pendingReadbacks.fetch_sub(1, std::memory_order_relaxed);
+            pending->image = std::move(image);
+            Enqueue(std::move(*pending));
+        });
+
+        if (!submitted && !pending->delivered)
+        {
+            // 槽位用尽按丢弃处理，复制提交失败才算失败
+            pending->delivered = true;
+            m_pendingReadbacks.fetch_sub(1, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                (slotsFull ? m_stats.dropped : m_stats.failed)++;
+            }
+            Complete(*pending, MakeResult(slotsFull ? Status::Dropped : Status::Failed));
+        }
+        return future;
+    }
+
+    void SnapshotWriter::Poll()
+    {
+        if (m_readback)
+        {
+            m_readback->Poll();
+        }
+    }
+
+    void SnapshotWriter::Flush()
+    {
+        if (m_readback)
+        {
+            m_readback->Flush();
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_queue.empty() && m_active == 0; });
+    }
+
+    SnapshotWriter::Stats SnapshotWriter::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats = m_stats;
+        stats.queued = static_cast<uint32_t>(m_queue.size());
+        stats.inFlight = stats.queued + m_active + m_pendingReadbacks.load(std::memory_order_relaxed);
+        if (stats.saved > 0)
+        {
+            stats.avgEncodeMs = m_totalEncodeMs / static_cast<double>(stats.saved);
+            stats.avgWriteMs = m_totalWriteMs / static_cast<double>(stats.saved);
+        }
+        return stats;
+    }
+
+    std::filesystem::path SnapshotWriter::MakeSnapshotPath(const std::filesystem::path& directory, const char* extension)
+    {
+        static std::atomic<uint32_t> counter{ 0 };
+
+        const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::tm local{};
+        localtime_s(&local, &now);
+
+        char name[64] = {};
+        const size_t length = std::strftime(name, sizeof(name), "lens_%Y%m%d_%H%M%S", &local);
+        std::snprintf(name + length, sizeof(name) - length, "_%03u", counter.fetch_add(1) % 1000);
+        return directory / (std::string(name) + (extension ? extension : ""));
+    }
+
+    void SnapshotWriter::Enqueue(Job job)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_queue.size() >= m_desc.queueCapacity)
+        {
+            if (m_desc.dropPolicy == DropPolicy::Block)
+            {
+                m_spaceAvailable.wait_for(lock, m_desc.blockTimeout,
+                    [this] { return m_queue.size() < m_desc.queueCapacity || m_stopping; });
+            }
+
+            if (m_desc.dropPolicy == DropPolicy::DropOldest && !m_queue.empty())
+            {
+                Job oldest = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_queue.push_back(std::move(job));
+                m_stats.dropped++;
+                lock.unlock();
+                m_workAvailable.notify_one();
+                Complete(oldest, MakeResult(Status::Dropped));
+                return;
+            }
+
+            if (m_queue.size() >= m_desc.queueCapacity || m_stopping)
+            {
+                m_stats.dropped++;
+                lock.unlock();
+                Complete(job, MakeResult(Status::Dropped));
+                return;
+            }
+        }
+
+        m_queue.push_back(std::move(job));
+        m_stats.maxQueued = (std::max)(m_stats.maxQueued, static_cast<uint32_t>(m_queue.size()));
+        lock.unlock();
+        m_workAvailable.notify_one();
+    }
+
+    void SnapshotWriter::Complete(Job& job, Result result)
+    {
+        result.path = job.path;
+        if (job.callback)
+        {
+            job.callback(result);
+        }
+        job.promise.set_value(std::move(result));
+    }
+
+    void SnapshotWriter::WorkerLoop()
+    {
+        std::vector<uint8_t> encoded;
+        for (;;)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_workAvailable.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+                if (m_queue.empty())
+                    break;
+
+                job = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_active++;
+            }
+            m_spaceAvailable.notify_one();
+
+            Result result;
+            const auto start = Clock::now();
+            result.queueMs = ElapsedMs(job.submitTime, start);
+
+            lens::graphics::ImageEncodeOptions options = m_desc.encode;
+            if (options.codec == lens::graphics::ImageCodec::Auto)
+            {
+                options.codec = lens::graphics::GetImageCodecForPath(job.path);
+            }
+
+            bool ok = lens::graphics::EncodeImage(*job.image, encoded, options);
+            const auto encodeEnd = Clock::now();
+            if (ok)
+            {
+                std::error_code ec;
+                if (job.path.has_parent_path())
+                {
+                    std::filesystem::create_directories(job.path.parent_path(), ec);
+                }
+
+                std::ofstream out(job.path, std::ios::binary | std::ios::trunc);
+                ok = out.is_open() && out.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+                if (!ok)
+                {
+                    LOG_ERROR("Failed to write snapshot: {}", job.path.string());
+                }
+            }
+            const auto writeEnd = Clock::now();
+
+            // 像素不再需要，先释放再回调
+            job.image.reset();
+            result.status = ok ? Status::Saved : Status::Failed;
+            result.bytes = ok ? encoded.size() : 0;
+            result.encodeMs = ElapsedMs(start, encodeEnd);
+            result.writeMs = ElapsedMs(encodeEnd, writeEnd);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (ok)
+                {
+                    m_stats.saved++;
+                    m_stats.bytesWritten += result.bytes;
+                    m_totalEncodeMs += result.encodeMs;
+                    m_totalWriteMs += result.writeMs;
+                }
+                else
+                {
+                    m_stats.failed++;
+                }
+            }
+
+            Complete(job, std::move(result));
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_active--;
+                if (m_queue.empty() && m_active == 0)
+                {
+                    m_idle.notify_all();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+﻿#include "LensPch.h"
+#include "capturer/SyntheticCaptureSource.h"
+
+namespace lens::capturer
+{
+    SyntheticCaptureSource::SyntheticCaptureSource(lens::graphics::GraphicsDevice* device, const SyntheticDesc& synthDesc)
+        : CpuCaptureSource(device), m_synthDesc(synthDesc)
+    {
+    }
+
+    SyntheticCaptureSource::~SyntheticCaptureSource()
+    {
+        Shutdown();
+    }
+
+    bool SyntheticCaptureSource::OnInitialize()
+    {
+        if (m_synthDesc.width == 0 || m_synthDesc.height == 0)
+        {
+            LOG_ERROR("Invalid synthetic source size: {}x{}", m_synthDesc.width, m_synthDesc.height);
+            return false;
+        }
+
+        // 合成源只生成 BGRA8
+        m_desc.format = lens::graphics::TextureFormat::BGRA8_UNorm;
+        m_staticImage = nullptr;
+
+        LOG_INFO("Synthetic pattern: {}, size: {}x{}",
+            static_cast<int>(m_synthDesc.pattern), m_synthDesc.width, m_synthDesc.height);
+        return true;
+    }
+
+    std::shared_ptr<const lens::graphics::CpuImage> SyntheticCaptureSource::ProduceFrame(uint64_t frameIndex)
+    {
+        // 静止画面只生成一次，之后重复提交同一帧
+        if (m_synthDesc.pattern == Pattern::Static && m_staticImage)
+        {
+            return m_staticImage;
+        }
+
+        auto image = std::make_shared<lens::graphics::CpuImage>();
+        image->Allocate(m_synthDesc.width, m_synthDesc.height, m_desc.format);
+        GenerateFrame(*image, frameIndex);
+
+        if (m_synthDesc.pattern == Pattern::Static)
+        {
+            m_staticImage = image;
+        }
+        return image;
+    }
+
+    void SyntheticCaptureSource::GenerateFrame(lens::graphics::CpuImage& image, uint64_t frameIndex)
+    {
+        const uint32_t width = image.width;
+        const uint32_t height = image.height;
+
+        switch (m_synthDesc.pattern)
+        {
+        case Pattern::Static:
+        case Pattern::MovingBox:
+        {
+            const uint32_t background = 0xFF202020;
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                auto* row = reinterpret_cast<uint32_t*>(image.Row(y));
+                std::fill(row, row + width, background);
+            }
+
+            if (m_synthDesc.pattern == Pattern::Static)
+                break;
+
+            // 方块在画面内往返移动
+            const uint32_t boxSize = (std::max)(1u, (std::min)(width, height) / 8);
+            const uint32_t rangeX = width - boxSize;
+            const uint32_t rangeY = height - boxSize;
+            const uint64_t stepX = frameIndex * 8;
+            const uint64_t stepY = frameIndex * 5;
+            auto bounce = [](uint64_t step, uint32_t range) -> uint32_t
+            {
+                if (range == 0)
+                    return 0;
+                uint64_t period = static_cast<uint64_t>(range) * 2;
+                uint64_t pos = step % period;
+                return static_cast<uint32_t>(pos < range ? pos : period - pos);
+            };
+            const uint32_t boxX = bounce(stepX, rangeX);
+            const uint32_t boxY = bounce(stepY, rangeY);
+
+            const uint32_t boxColor = 0xFF3080F0;
+            for (uint32_t y = boxY; y < boxY + boxSize; ++y)
+            {
+                auto* row = reinterpret_cast<uint32_t*>(image.Row(y));
+                std::fill(row + boxX, row + boxX + boxSize, boxColor);
+            }
+            break;
+        }
+        case Pattern::ScrollingGradient:
+        {
+            // 水平色带，每帧向下滚动 4 行
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                uint32_t v = static_cast<uint32_t>((y + frameIndex * 4) & 0xFF);
+                uint32_t color = 0xFF000000 | (v << 16) | ((255 - v) << 8) | ((v * 3) & 0xFF);
+                auto* row = reinterpret_cast<uint32_t*>(image.Row(y));
+                std::fill(row, row + width, color);
+            }
+            break;
+        }
+        case Pattern::Desktop:
+        {
+            // 以 60 fps 计：光标每 0.5 秒闪烁，时钟每秒变化，窗口每 5 秒移动一次
+            const uint32_t background = 0xFF2D2D30;
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                auto* row = reinterpret_cast<uint32_t*>(image.Row(y));
+                std::fill(row, row + width, background);
+            }
+
+            auto fillRect = [&](uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color)
+            {
+                const uint32_t right = (std::min)(x + w, width);
+                const uint32_t bottom = (std::min)(y + h, height);
+                for (uint32_t row = y; row < bottom; ++row)
+                {
+                    auto* pixels = reinterpret_cast<uint32_t*>(image.Row(row));
+                    if (x < right)
+                        std::fill(pixels + x, pixels + right, color);
+                }
+            };
+
+            const uint32_t taskbarHeight = (std::min)(40u, height / 8);
+            fillRect(0, height - taskbarHeight, width, taskbarHeight, 0xFF1F1F1F);
+
+            const uint32_t shift = static_cast<uint32_t>((frameIndex / 300) % 4) * (width / 8);
+            const uint32_t windowX = width / 8 + shift;
+            const uint32_t windowY = height / 8;
+            const uint32_t windowW = width / 2;
+            const uint32_t windowH = height / 2;
+            fillRect(windowX, windowY, windowW, windowH, 0xFFF3F3F3);
+            fillRect(windowX, windowY, windowW, 30, 0xFF3C6EB4);
+
+            // 窗口内几行"文字"
+            for (uint32_t line = 0; line < 12; ++line)
+            {
+                fillRect(windowX + 20, windowY + 50 + line * 24, (windowW / 2) + (line * 37) % (std::max)(1u, windowW / 3), 10, 0xFF505050);
+            }
+
+            if ((frameIndex / 30) % 2 == 0)
+            {
+                fillRect(windowX + 24 + windowW / 2, windowY + 50 + 12 * 24, 2, 18, 0xFF000000);
+            }
+
+            // 时钟：随秒数变化的小块图案
+            const uint64_t seconds = frameIndex / 60;
+            for (uint32_t digit = 0; digit < 4; ++digit)
+            {
+                const uint32_t value = static_cast<uint32_t>((seconds >> (digit * 3)) & 0x7);
+                for (uint32_t bit = 0; bit < 3; ++bit)
+                {
+                    const uint32_t color = (value >> bit) & 1 ? 0xFFE0E0E0 : 0xFF1F1F1F;
+                    fillRect(width - 80 + digit * 16, height - taskbarHeight + 8 + bit * 8, 10, 6, color);
+                }
+            }
+            break;
+        }
+        case Pattern::Noise:
+        {
+            uint64_t state = 0x9E3779B97F4A7C15ull ^ (frameIndex + 1);
+            auto* data = reinterpret_cast<uint64_t*>(image.pixels.data());
+            size_t count = image.GetSizeInBytes() / sizeof(uint64_t);
+            for (size_t i = 0; i < count; ++i)
+            {
+                // xorshift64
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                data[i] = state | 0xFF000000FF000000ull;
+            }
+            break;
+        }
+        }
+    }
+}
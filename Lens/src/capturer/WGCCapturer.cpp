@@ -1,13 +1,16 @@
 ﻿#include "LensPch.h"
 #include "capturer/WGCCapturer.h"
+#include "graphics/D3D11Texture.h"
 #include <windows.graphics.capture.interop.h>
 #include <Windows.Graphics.DirectX.Direct3D11.Interop.h>
 #include <windows.graphics.directx.direct3d11.interop.h>
+#include <winrt/Windows.Foundation.Metadata.h>
 
 namespace lens::capturer
 {
-    WGCCapturer::WGCCapturer(lens::graphics::GraphicsDevice* device)
-        : m_device(device)
+    WGCCapturer::WGCCapturer(lens::graphics::D3D11GraphicsDevice* device)
+        : m_device(device),
+          m_texturePool(std::make_unique<lens::graphics::TexturePool>(device))
     {
         init_apartment(winrt::apartment_type::single_threaded);
     }
@@ -20,7 +23,21 @@ namespace lens::capturer
     bool WGCCapturer::Initialize(const CaptureDesc& desc)
     {
         m_desc = desc;
-        LOG_INFO("WGCCapturer initialized with format: {}, fps: {}", static_cast<int>(desc.format), desc.frameRate);
+
+        FramePacer::Desc pacerDesc{};
+        pacerDesc.policy = desc.pacing;
+        pacerDesc.frameRate = desc.frameRate;
+        m_pacer.Configure(pacerDesc);
+
+        // 捕获线程和渲染线程共用立即上下文
+        if (desc.freeThreaded && !m_device->EnableMultithreadProtection())
+        {
+            LOG_ERROR("Free-threaded capture requires D3D11 multithread protection");
+            return false;
+        }
+
+        LOG_INFO("WGCCapturer initialized with format: {}, fps: {}, pacing: {}, free-threaded: {}",
+            static_cast<int>(desc.format), desc.frameRate, static_cast<int>(desc.pacing), desc.freeThreaded);
         return true;
     }
 
@@ -28,25 +45,31 @@ namespace lens::capturer
     {
         StopCapture();
 
-        if (m_frameArrivedToken)
-        {
-            if (m_framePool)
-            {
-                m_framePool.FrameArrived(m_frameArrivedToken);
-            }
-            m_frameArrivedToken = winrt::event_token{};
-        }
-
         m_framePool = nullptr;
         m_session = nullptr;
         m_captureItem = nullptr;
-        m_currentFrame = nullptr;
+        m_winrtDevice = nullptr;
+        m_frames.Reset();
+        m_lastTexture = nullptr;
 
         LOG_INFO("WGCCapturer shut down");
     }
 
     bool WGCCapturer::StartCapture(HWND window)
     {
+        SetTargetWindow(window);
+        return StartCapture();
+    }
+
+    bool WGCCapturer::StartCapture()
+    {
+        HWND window = m_targetWindow;
+        if (!window)
+        {
+            LOG_ERROR("No target window set for WGC capture");
+            return false;
+        }
+
         if (m_isCapturing)
         {
             LOG_WARN("Already capturing");
@@ -95,25 +118,62 @@ namespace lens::capturer
                 return false;
             }
 
-            auto winrtDevice = deviceInspectable.as<winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice>();
-            auto pixelFormat = winrt::Windows::Graphics::DirectX::DirectXPixelFormat::B8G8R8A8UIntNormalized;
+            m_winrtDevice = deviceInspectable.as<winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice>();
+            m_poolSize = m_captureItem.Size();
+            m_resizePending = false;
 
-            m_framePool = winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool::Create(
-                winrtDevice,
-                pixelFormat,
-                2, // 缓冲帧数
-                m_captureItem.Size());
+            // 自由线程帧池的事件在系统线程上触发，不依赖创建线程的消息循环
+            if (m_desc.freeThreaded)
+            {
+                m_framePool = winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool::CreateFreeThreaded(
+                    m_winrtDevice,
+                    m_pixelFormat,
+                    2, // 缓冲帧数
+                    m_poolSize);
+            }
+            else
+            {
+                m_framePool = winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool::Create(
+                    m_winrtDevice,
+                    m_pixelFormat,
+                    2, // 缓冲帧数
+                    m_poolSize);
+            }
 
             m_session = m_framePool.CreateCaptureSession(m_captureItem);
 
+            // 让系统随帧报告脏区，旧系统上没有这个属性
+            m_dirtyRegionsSupported = winrt::Windows::Foundation::Metadata::ApiInformation::IsPropertyPresent(
+                L"Windows.Graphics.Capture.GraphicsCaptureSession", L"DirtyRegionMode");
+            if (m_dirtyRegionsSupported)
+            {
+                m_session.DirtyRegionMode(winrt::Windows::Graphics::Capture::GraphicsCaptureDirtyRegionMode::ReportAndRender);
+            }
+            LOG_INFO("WGC dirty region reporting: {}", m_dirtyRegionsSupported ? "supported" : "unavailable");
+
             // 注册帧到达事件
             m_frameArrivedToken = m_framePool.FrameArrived(
                 { this, &WGCCapturer::OnFrameArrived });
 
             // 开始捕获
+            m_frames.Reset();
+            m_pacer.Reset();
+            m_latency.Reset();
+            m_sequence = 0;
+            m_pendingDirty.clear();
+            m_pendingDirtyKnown = true;
+            m_lastTexture = nullptr;
+            m_unchangedCount = 0;
+            m_framePending = false;
+
+            // StartCapture 抛出时还没有线程需要回收；之前到达的帧留在 m_framePending，线程启动后取走
             m_session.StartCapture();
+            if (m_desc.freeThreaded)
+            {
+                m_captureThreadRunning = true;
+                m_captureThread = std::thread(&WGCCapturer::CaptureThreadLoop, this);
+            }
             m_isCapturing = true;
-            m_frameAvailable = false;
 
             LOG_INFO("WGC capture started successfully");
             return true;
@@ -121,6 +181,23 @@ namespace lens::capturer
         catch (const winrt::hresult_error& e)
         {
             LOG_ERROR("WGC capture failed: {}", winrt::to_string(e.message()));
+
+            // 撤销已经注册的事件，下次 StartCapture 重新创建帧池和会话
+            if (m_frameArrivedToken && m_framePool)
+            {
+                m_framePool.FrameArrived(m_frameArrivedToken);
+            }
+            m_frameArrivedToken = winrt::event_token{};
+            if (m_session)
+            {
+                m_session.Close();
+                m_session = nullptr;
+            }
+            if (m_framePool)
+            {
+                m_framePool.Close();
+                m_framePool = nullptr;
+            }
             return false;
         }
     }
@@ -130,12 +207,25 @@ namespace lens::capturer
         if (!m_isCapturing)
             return;
 
+        // 先注销帧到达事件，帧池关闭置空后就无法再注销
+        if (m_frameArrivedToken)
+        {
+            if (m_framePool)
+            {
+                m_framePool.FrameArrived(m_frameArrivedToken);
+            }
+            m_frameArrivedToken = winrt::event_token{};
+        }
+
         if (m_session)
         {
             m_session.Close();
             m_session = nullptr;
         }
 
+        // 捕获线程还在访问帧池，先停线程再关闭
+        StopCaptureThread();
+
         if (m_framePool)
         {
             m_framePool.Close();
@@ -143,29 +233,225 @@ namespace lens::capturer
         }
 
         m_isCapturing = false;
-        m_frameAvailable = false;
-        LOG_INFO("WGC capture stopped");
+
+        // 不再有帧到达，池不会再按帧裁剪，空闲纹理现在就释放
+        m_texturePool->Trim();
+
+        auto stats = GetFrameStats();
+        auto poolStats = m_texturePool->GetStats();
+        LOG_INFO("WGC capture stopped, {} frames delivered, {} forwarded, {} dropped, {} textures allocated, {} reused",
+            stats.delivered, stats.forwarded, stats.dropped, poolStats.allocations, poolStats.reuses);
+        m_latency.LogSummary(GetName());
+    }
+
+    WGCCapturer::FrameStats WGCCapturer::GetFrameStats() const
+    {
+        FrameStats stats;
+        stats.delivered = m_pacer.GetDeliveredCount();
+        stats.forwarded = m_pacer.GetForwardedCount();
+        stats.dropped = m_frames.GetDroppedCount();
+        stats.unchanged = m_unchangedCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    WGCCapturer::ResizeStats WGCCapturer::GetResizeStats() const
+    {
+        ResizeStats stats;
+        stats.resizeCount = m_resizeCount.load();
+        stats.lastLatencyMs = m_lastResizeLatencyMs.load();
+        stats.maxLatencyMs = m_maxResizeLatencyMs.load();
+        return stats;
+    }
+
+    void WGCCapturer::HandleContentResize(winrt::Windows::Graphics::SizeInt32 contentSize)
+    {
+        LOG_INFO("Capture content resized: {}x{} -> {}x{}",
+            m_poolSize.Width, m_poolSize.Height, contentSize.Width, contentSize.Height);
+
+        // 已取出的帧都复制到了自己的纹理里，Recreate 不影响它们
+        m_poolSize = contentSize;
+        m_framePool.Recreate(m_winrtDevice, m_pixelFormat, 2, contentSize);
+
+        // 连续变化时从第一次检测开始计时
+        if (!m_resizePending)
+        {
+            m_resizePending = true;
+            m_resizeStart = std::chrono::steady_clock::now();
+        }
+    }
+
+    Frame WGCCapturer::GetLatestFrame()
+    {
+        Frame frame;
+        if (m_frames.TryTake(frame))
+        {
+            m_latency.Record(FrameLatency::Stage::Pickup, frame.descriptor.captureTime);
+        }
+        return frame;
     }
 
-    std::shared_ptr<lens::graphics::Texture> WGCCapturer::GetLatestFrame()
+    bool WGCCapturer::AcquireFrame(Frame& frame, std::chrono::milliseconds timeout)
     {
-        if (!m_frameAvailable || !m_currentFrame)
-            return nullptr;
+        if (!m_frames.WaitTake(frame, timeout))
+            return false;
 
-        m_frameAvailable = false;
-        return m_currentFrame;
+        m_latency.Record(FrameLatency::Stage::Pickup, frame.descriptor.captureTime);
+        return true;
     }
 
     void WGCCapturer::OnFrameArrived(
         winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool const& sender,
         winrt::Windows::Foundation::IInspectable const& args)
     {
+        if (m_desc.freeThreaded)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_signalMutex);
+                m_framePending = true;
+            }
+            m_signal.notify_one();
+            return;
+        }
+
         auto frame = sender.TryGetNextFrame();
-        if (!frame)
+        if (frame)
         {
+            ProcessFrame(frame);
+        }
+    }
+
+    void WGCCapturer::CaptureThreadLoop()
+    {
+        winrt::init_apartment(winrt::apartment_type::multi_threaded);
+        LOG_INFO("WGC capture thread started");
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_signalMutex);
+                m_signal.wait(lock, [this] { return m_framePending || !m_captureThreadRunning; });
+                if (!m_captureThreadRunning)
+                    break;
+                m_framePending = false;
+            }
+
+            // 一次唤醒可能对应多帧，全部取完交给节流决定去留
+            try
+            {
+                while (auto frame = m_framePool.TryGetNextFrame())
+                {
+                    ProcessFrame(frame);
+                }
+            }
+            catch (const winrt::hresult_error& e)
+            {
+                LOG_ERROR("WGC capture thread error: {}", winrt::to_string(e.message()));
+            }
+        }
+
+        LOG_INFO("WGC capture thread stopped");
+        winrt::uninit_apartment();
+    }
+
+    void WGCCapturer::StopCaptureThread()
+    {
+        if (!m_captureThread.joinable())
             return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_signalMutex);
+            m_captureThreadRunning = false;
         }
+        m_signal.notify_one();
+        m_captureThread.join();
+    }
+
+    void WGCCapturer::ProcessFrame(winrt::Windows::Graphics::Capture::Direct3D11CaptureFrame const& frame)
+    {
+        // 纹理池按到达的帧计时，一段时间没用到的空闲纹理被释放
+        m_texturePool->EndFrame();
 
+        // 尺寸检查放在节流之前，被丢弃的帧也要触发帧池重建
+        auto contentSize = frame.ContentSize();
+        if (contentSize.Width > 0 && contentSize.Height > 0 &&
+            (contentSize.Width != m_poolSize.Width || contentSize.Height != m_poolSize.Height))
+        {
+            HandleContentResize(contentSize);
+        }
+
+        if (m_resizePending)
+        {
+            auto surfaceDesc = frame.Surface().Description();
+            if (surfaceDesc.Width == contentSize.Width && surfaceDesc.Height == contentSize.Height)
+            {
+                double latencyMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - m_resizeStart).count();
+                m_resizePending = false;
+                m_resizeCount++;
+                m_lastResizeLatencyMs = latencyMs;
+                if (latencyMs > m_maxResizeLatencyMs)
+                {
+                    m_maxResizeLatencyMs = latencyMs;
+                }
+
+                // 旧尺寸的空闲纹理不会再用到，在途的那些归还后由水位线裁剪
+                m_texturePool->TrimOtherSizes(contentSize.Width, contentSize.Height,
+                    static_cast<lens::graphics::TextureFormat>(m_pixelFormat));
+                LOG_INFO("First frame at new size {}x{} after {:.2f} ms", contentSize.Width, contentSize.Height, latencyMs);
+            }
+        }
+
+        // 脏区先累积，被节流丢弃的帧的变化要算到下一次转发的帧上
+        if (m_dirtyRegionsSupported)
+        {
+            std::vector<DirtyRect> rects;
+            for (const auto& region : frame.DirtyRegions())
+            {
+                rects.push_back(DirtyRect{
+                    static_cast<uint32_t>((std::max)(region.X, 0)),
+                    static_cast<uint32_t>((std::max)(region.Y, 0)),
+                    static_cast<uint32_t>((std::max)(region.Width, 0)),
+                    static_cast<uint32_t>((std::max)(region.Height, 0)) });
+            }
+            ClipDirtyRects(rects, static_cast<uint32_t>(contentSize.Width), static_cast<uint32_t>(contentSize.Height));
+            AccumulateDirtyRects(m_pendingDirty, rects);
+        }
+        else
+        {
+            m_pendingDirtyKnown = false;
+        }
+
+        // 先节流再复制，被丢弃的帧随 frame 析构直接还给 WGC
+        int64_t captureTime = frame.SystemRelativeTime().count();
+        bool contentChanged = !m_pendingDirtyKnown || !m_pendingDirty.empty() || !m_lastTexture;
+        if (!m_pacer.ShouldForward(captureTime, contentChanged))
+        {
+            return;
+        }
+        m_latency.Record(FrameLatency::Stage::Arrival, captureTime);
+
+        Frame captured;
+        captured.descriptor.captureTime = captureTime;
+        captured.descriptor.dirtyKnown = m_pendingDirtyKnown;
+        captured.descriptor.dirtyRects.swap(m_pendingDirty);
+        m_pendingDirty.clear();
+        m_pendingDirtyKnown = true;
+
+        // 内容没变且尺寸相同，复用上一张纹理，省掉复制
+        if (!contentChanged && m_lastTexture->GetWidth() == static_cast<uint32_t>(contentSize.Width) &&
+            m_lastTexture->GetHeight() == static_cast<uint32_t>(contentSize.Height))
+        {
+            m_unchangedCount.fetch_add(1, std::memory_order_relaxed);
+            captured.descriptor.sequence = m_sequence++;
+            captured.descriptor.width = m_lastTexture->GetWidth();
+            captured.descriptor.height = m_lastTexture->GetHeight();
+            captured.texture = m_lastTexture;
+            m_frames.Publish(std::move(captured));
+            NotifyFrameListener();
+            return;
+        }
+
+        bool published = false;
         try
         {
             auto frameSurface = frame.Surface();
@@ -180,11 +466,45 @@ namespace lens::capturer
 
             if (SUCCEEDED(hr) && frameTexture)
             {
-                auto texture = std::make_shared<lens::graphics::Texture>();
-                if (texture->CreateFromD3DTexture(m_device, frameTexture.get()))
+                D3D11_TEXTURE2D_DESC srcDesc;
+                frameTexture->GetDesc(&srcDesc);
+
+                // 重建完成前表面可能比内容大，只复制有效区域
+                uint32_t width = (std::min)(srcDesc.Width, static_cast<uint32_t>(contentSize.Width));
+                uint32_t height = (std::min)(srcDesc.Height, static_cast<uint32_t>(contentSize.Height));
+
+                // WGC 的表面在帧关闭后会被回收，必须复制到自己的纹理里
+                auto texture = m_texturePool->Acquire(width, height,
+                    static_cast<lens::graphics::TextureFormat>(srcDesc.Format));
+
+                bool copied = false;
+                if (texture)
+                {
+                    // 池里的纹理由 D3D11 设备创建
+                    lens::graphics::GraphicsDevice::ContextLock contextLock(m_device);
+                    copied = static_cast<lens::graphics::D3D11Texture*>(texture.get())->CopyFrom(m_device, frameTexture.get());
+                }
+
+                if (copied)
                 {
-                    m_currentFrame = texture;
-                    m_frameAvailable = true;
+                    // 只是命令提交完成的时刻，GPU 实际执行要晚一些
+                    m_latency.Record(FrameLatency::Stage::CopyDone, captureTime);
+
+                    // 尺寸变了或者第一帧，脏区就是整帧
+                    if (!m_lastTexture || m_lastTexture->GetWidth() != width || m_lastTexture->GetHeight() != height)
+                    {
+                        captured.descriptor.dirtyRects.assign(1, DirtyRect{ 0, 0, width, height });
+                    }
+                    ClipDirtyRects(captured.descriptor.dirtyRects, width, height);
+
+                    captured.descriptor.sequence = m_sequence++;
+                    captured.descriptor.width = width;
+                    captured.descriptor.height = height;
+                    captured.texture = texture;
+                    m_lastTexture = std::move(texture);
+                    m_frames.Publish(std::move(captured));
+                    NotifyFrameListener();
+                    published = true;
                 }
             }
         }
@@ -192,6 +512,12 @@ namespace lens::capturer
         {
             LOG_ERROR("Error processing frame: {}", winrt::to_string(e.message()));
         }
+
+        // 这一帧的变化没能交付，下一帧必须完整复制
+        if (!published)
+        {
+            m_lastTexture = nullptr;
+        }
     }
 
     std::vector<WGCCapturer::CaptureSource> WGCCapturer::EnumerateWindows()
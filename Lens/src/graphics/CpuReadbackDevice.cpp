@@ -0,0 +1,58 @@
+﻿#include "LensPch.h"
+#include "graphics/CpuReadbackDevice.h"
+#include "graphics/NullTexture.h"
+
+namespace lens::graphics
+{
+    bool CpuReadbackDevice::PrepareSlot(uint32_t slot, uint32_t width, uint32_t height, TextureFormat format)
+    {
+        if (slot >= m_slots.size())
+        {
+            m_slots.resize(slot + 1);
+        }
+
+        CpuImage& staging = m_slots[slot];
+        if (staging.width != width || staging.height != height || staging.format != format || staging.IsEmpty())
+        {
+            staging.Allocate(width, height, format);
+        }
+        return !staging.IsEmpty();
+    }
+
+    bool CpuReadbackDevice::SubmitCopy(uint32_t slot, Texture* source)
+    {
+        // 空后端的纹理都是 NullTexture
+        if (slot >= m_slots.size() || !source)
+            return false;
+
+        const CpuImage& src = static_cast<NullTexture*>(source)->GetImage();
+        CpuImage& staging = m_slots[slot];
+        const uint32_t rowBytes = (std::min)(staging.rowPitch, src.rowPitch);
+        const uint32_t rows = (std::min)(staging.height, src.height);
+        for (uint32_t y = 0; y < rows; ++y)
+        {
+            memcpy(staging.Row(y), src.Row(y), rowBytes);
+        }
+        return true;
+    }
+
+    IReadbackDevice::ReadResult CpuReadbackDevice::ReadSlot(uint32_t slot, CpuImage& image)
+    {
+        if (slot >= m_slots.size())
+            return ReadResult::Failed;
+
+        const CpuImage& staging = m_slots[slot];
+        const uint32_t rowBytes = (std::min)(image.rowPitch, staging.rowPitch);
+        const uint32_t rows = (std::min)(image.height, staging.height);
+        for (uint32_t y = 0; y < rows; ++y)
+        {
+            memcpy(image.Row(y), staging.Row(y), rowBytes);
+        }
+        return ReadResult::Ok;
+    }
+
+    void CpuReadbackDevice::ReleaseSlots()
+    {
+        m_slots.clear();
+    }
+}
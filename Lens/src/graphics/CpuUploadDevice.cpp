@@ -0,0 +1,68 @@
+﻿#include "LensPch.h"
+#include "graphics/CpuUploadDevice.h"
+
+namespace lens::graphics
+{
+    CpuUploadDevice::CpuUploadDevice(uint32_t fenceLatency)
+        : m_fenceLatency(fenceLatency)
+    {
+    }
+
+    bool CpuUploadDevice::Create(uint64_t capacity)
+    {
+        m_memory.assign(static_cast<size_t>(capacity), 0);
+        return !m_memory.empty();
+    }
+
+    uint8_t* CpuUploadDevice::Map(bool discard)
+    {
+        // DISCARD 之后旧内容不再可用，清零让依赖旧内容的写法在空后端也能暴露出来
+        if (discard)
+        {
+            std::fill(m_memory.begin(), m_memory.end(), uint8_t{ 0 });
+            m_stats.discards++;
+        }
+        return m_memory.data();
+    }
+
+    void CpuUploadDevice::Unmap()
+    {
+    }
+
+    void CpuUploadDevice::SignalFence(uint64_t value)
+    {
+        if (m_fenceLatency == 0)
+        {
+            m_completedFence = value;
+            return;
+        }
+        m_pending.push_back(PendingFence{ value, m_fenceLatency });
+    }
+
+    uint64_t CpuUploadDevice::GetCompletedFence(bool wait)
+    {
+        if (wait)
+        {
+            m_stats.waits += m_pending.empty() ? 0 : 1;
+            for (auto& fence : m_pending)
+            {
+                fence.pollsRemaining = 0;
+            }
+        }
+        else
+        {
+            for (auto& fence : m_pending)
+            {
+                fence.pollsRemaining -= fence.pollsRemaining > 0 ? 1 : 0;
+            }
+        }
+
+        // 围栏按插入顺序完成
+        while (!m_pending.empty() && m_pending.front().pollsRemaining == 0)
+        {
+            m_completedFence = m_pending.front().value;
+            m_pending.pop_front();
+        }
+        return m_completedFence;
+    }
+}
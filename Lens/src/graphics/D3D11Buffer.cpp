@@ -1,11 +1,30 @@
 ﻿#include "LensPch.h"
-#include "graphics/Buffer.h"
+#include "graphics/D3D11Buffer.h"
 #include "Log.h"
 
 namespace lens::graphics 
 {
+    namespace
+    {
+        // 缓冲区由 D3D11GraphicsDevice 创建，传入的一定是同一个设备
+        ID3D11Device* GetD3DDevice(GraphicsDevice* device)
+        {
+            return static_cast<D3D11GraphicsDevice*>(device)->GetDevice();
+        }
+
+        ID3D11DeviceContext* GetContext(GraphicsDevice* device)
+        {
+            return static_cast<D3D11GraphicsDevice*>(device)->GetContext();
+        }
+    }
+
+    static_assert(static_cast<UINT>(BufferType::Vertex) == D3D11_BIND_VERTEX_BUFFER);
+    static_assert(static_cast<UINT>(BufferType::Index) == D3D11_BIND_INDEX_BUFFER);
+    static_assert(static_cast<UINT>(BufferType::Constant) == D3D11_BIND_CONSTANT_BUFFER);
+    static_assert(static_cast<UINT>(BufferType::ShaderResource) == D3D11_BIND_SHADER_RESOURCE);
+    static_assert(static_cast<UINT>(BufferType::UnorderedAccess) == D3D11_BIND_UNORDERED_ACCESS);
 
-    bool Buffer::Create(GraphicsDevice* device, const Desc& desc, const void* initialData) 
+    bool D3D11Buffer::Create(GraphicsDevice* device, const Desc& desc, const void* initialData) 
     {
         m_desc = desc;
 
@@ -39,7 +58,7 @@ namespace lens::graphics
             initData = &subresourceData;
         }
 
-        HRESULT hr = device->GetDevice()->CreateBuffer(&bufferDesc, initData, &m_buffer);
+        HRESULT hr = GetD3DDevice(device)->CreateBuffer(&bufferDesc, initData, &m_buffer);
         if (FAILED(hr)) 
         {
             return false;
@@ -54,7 +73,7 @@ namespace lens::graphics
             srvDesc.Buffer.FirstElement = 0;
             srvDesc.Buffer.NumElements = static_cast<UINT>(desc.size / desc.structureStride);
 
-            hr = device->GetDevice()->CreateShaderResourceView(m_buffer.Get(), &srvDesc, &m_srv);
+            hr = GetD3DDevice(device)->CreateShaderResourceView(m_buffer.Get(), &srvDesc, &m_srv);
             if (FAILED(hr)) {
                 return false;
             }
@@ -70,7 +89,7 @@ namespace lens::graphics
             uavDesc.Buffer.NumElements = static_cast<UINT>(desc.size / desc.structureStride);
             uavDesc.Buffer.Flags = 0;
 
-            hr = device->GetDevice()->CreateUnorderedAccessView(m_buffer.Get(), &uavDesc, &m_uav);
+            hr = GetD3DDevice(device)->CreateUnorderedAccessView(m_buffer.Get(), &uavDesc, &m_uav);
             if (FAILED(hr)) 
             {
                 return false;
@@ -80,16 +99,16 @@ namespace lens::graphics
         return true;
     }
 
-    void Buffer::UpdateData(GraphicsDevice* device, const void* data, size_t size, size_t offset) 
+    void D3D11Buffer::UpdateData(GraphicsDevice* device, const void* data, size_t size, size_t offset) 
     {
         if (m_desc.usage == BufferUsage::Dynamic) 
         {
             D3D11_MAPPED_SUBRESOURCE mappedResource;
-            HRESULT hr = device->GetContext()->Map(m_buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+            HRESULT hr = GetContext(device)->Map(m_buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
             if (SUCCEEDED(hr)) 
             {
                 memcpy(static_cast<char*>(mappedResource.pData) + offset, data, size);
-                device->GetContext()->Unmap(m_buffer.Get(), 0);
+                GetContext(device)->Unmap(m_buffer.Get(), 0);
             }
         }
         else 
@@ -102,26 +121,26 @@ namespace lens::graphics
             box.front = 0;
             box.back = 1;
 
-            device->GetContext()->UpdateSubresource(m_buffer.Get(), 0, &box, data, 0, 0);
+            GetContext(device)->UpdateSubresource(m_buffer.Get(), 0, &box, data, 0, 0);
         }
     }
 
-    D3D11_MAPPED_SUBRESOURCE Buffer::Map(GraphicsDevice* device, D3D11_MAP mapType) 
+    MappedData D3D11Buffer::Map(GraphicsDevice* device, MapMode mode) 
     {
         D3D11_MAPPED_SUBRESOURCE mappedResource;
-        HRESULT hr = device->GetContext()->Map(m_buffer.Get(), 0, mapType, 0, &mappedResource);
+        HRESULT hr = GetContext(device)->Map(m_buffer.Get(), 0, static_cast<D3D11_MAP>(mode), 0, &mappedResource);
 
         if (FAILED(hr)) 
         {
             return {};
         }
 
-        return mappedResource;
+        return MappedData{ mappedResource.pData, mappedResource.RowPitch, mappedResource.DepthPitch };
     }
 
-    void Buffer::Unmap(GraphicsDevice* device) 
+    void D3D11Buffer::Unmap(GraphicsDevice* device) 
     {
-        device->GetContext()->Unmap(m_buffer.Get(), 0);
+        GetContext(device)->Unmap(m_buffer.Get(), 0);
     }
 
 }
\ No newline at end of file
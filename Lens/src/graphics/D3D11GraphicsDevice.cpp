@@ -1,10 +1,36 @@
 ﻿#include "LensPch.h"
-#include "graphics/GraphicsDevice.h"
+#include "graphics/D3D11GraphicsDevice.h"
+#include "graphics/D3D11Buffer.h"
+#include "graphics/D3D11Shader.h"
+#include "graphics/D3D11Texture.h"
 #include "Log.h"
 
 namespace lens::graphics
 {
-    bool GraphicsDevice::Initialize(const Desc& desc) {
+    // 可移植的枚举按 D3D11 的取值定义，这里直接转换
+    static_assert(static_cast<DXGI_FORMAT>(TextureFormat::RGBA8_UNorm) == DXGI_FORMAT_R8G8B8A8_UNORM);
+    static_assert(static_cast<DXGI_FORMAT>(TextureFormat::BGRA8_UNorm) == DXGI_FORMAT_B8G8R8A8_UNORM);
+    static_assert(static_cast<DXGI_FORMAT>(TextureFormat::R32_Float) == DXGI_FORMAT_R32_FLOAT);
+    static_assert(static_cast<DXGI_FORMAT>(TextureFormat::RG32_Float) == DXGI_FORMAT_R32G32_FLOAT);
+    static_assert(static_cast<DXGI_FORMAT>(TextureFormat::RGBA32_Float) == DXGI_FORMAT_R32G32B32A32_FLOAT);
+    static_assert(static_cast<DXGI_FORMAT>(TextureFormat::R16_UInt) == DXGI_FORMAT_R16_UINT);
+    static_assert(static_cast<DXGI_FORMAT>(TextureFormat::D24_UNorm_S8_UInt) == DXGI_FORMAT_D24_UNORM_S8_UINT);
+    static_assert(static_cast<D3D11_USAGE>(BufferUsage::Static) == D3D11_USAGE_DEFAULT);
+    static_assert(static_cast<D3D11_USAGE>(BufferUsage::Dynamic) == D3D11_USAGE_DYNAMIC);
+    static_assert(static_cast<D3D11_USAGE>(BufferUsage::Staging) == D3D11_USAGE_STAGING);
+    static_assert(static_cast<D3D11_MAP>(MapMode::Read) == D3D11_MAP_READ);
+    static_assert(static_cast<D3D11_MAP>(MapMode::Write) == D3D11_MAP_WRITE);
+    static_assert(static_cast<D3D11_MAP>(MapMode::ReadWrite) == D3D11_MAP_READ_WRITE);
+    static_assert(static_cast<D3D11_MAP>(MapMode::WriteDiscard) == D3D11_MAP_WRITE_DISCARD);
+    static_assert(static_cast<D3D11_MAP>(MapMode::WriteNoOverwrite) == D3D11_MAP_WRITE_NO_OVERWRITE);
+
+    D3D11GraphicsDevice::~D3D11GraphicsDevice()
+    {
+        // 排队中的资源先于设备和上下文释放
+        m_releaseQueue.Flush();
+    }
+
+    bool D3D11GraphicsDevice::Initialize(const Desc& desc) {
         // 创建设备和交换链
         DXGI_SWAP_CHAIN_DESC swapChainDesc = {};
         {
@@ -94,7 +120,26 @@ namespace lens::graphics
         return true;
     }
 
-    void GraphicsDevice::BeginFrame()
+    bool D3D11GraphicsDevice::EnableMultithreadProtection()
+    {
+        if (m_multithread)
+            return true;
+
+        Microsoft::WRL::ComPtr<ID3D11Multithread> multithread;
+        HRESULT hr = m_context.As(&multithread);
+        if (FAILED(hr))
+        {
+            LOG_ERROR("Failed to query ID3D11Multithread, reason: {}", hr);
+            return false;
+        }
+
+        multithread->SetMultithreadProtected(TRUE);
+        m_multithread = multithread;
+        LOG_INFO("D3D11 multithread protection enabled");
+        return true;
+    }
+
+    void D3D11GraphicsDevice::BeginFrame()
     {
         float clearColor[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
         m_context->ClearRenderTargetView(m_renderTargetView.Get(), clearColor);
@@ -104,17 +149,17 @@ namespace lens::graphics
         m_context->RSSetViewports(1, &m_viewport);
     }
 
-    void GraphicsDevice::EndFrame()
+    void D3D11GraphicsDevice::EndFrame()
     {
 
     }
 
-    void GraphicsDevice::Present(bool vsync)
+    void D3D11GraphicsDevice::Present(bool vsync)
     {
         m_swapChain->Present(vsync ? 1 : 0, 0);
     }
 
-    void GraphicsDevice::Resize(uint32_t width, uint32_t height)
+    void D3D11GraphicsDevice::Resize(uint32_t width, uint32_t height)
     {
         // 释放现有的渲染目标视图
         m_context->OMSetRenderTargets(0, nullptr, nullptr);
@@ -157,7 +202,7 @@ namespace lens::graphics
         SetViewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
     }
 
-    void GraphicsDevice::SetViewport(float x, float y, float width, float height, float minDepth, float maxDepth)
+    void D3D11GraphicsDevice::SetViewport(float x, float y, float width, float height, float minDepth, float maxDepth)
     {
         m_viewport.TopLeftX = x;
         m_viewport.TopLeftY = y;
@@ -167,7 +212,7 @@ namespace lens::graphics
         m_viewport.MaxDepth = maxDepth;
     }
 
-    void GraphicsDevice::SetScissor(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom)
+    void D3D11GraphicsDevice::SetScissor(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom)
     {
         D3D11_RECT scissorRect;
         scissorRect.left = static_cast<LONG>(left);
@@ -177,23 +222,50 @@ namespace lens::graphics
         m_context->RSSetScissorRects(1, &scissorRect);
     }
 
-    void GraphicsDevice::SetVertexShader(ID3D11VertexShader* shader)
+    void D3D11GraphicsDevice::SetVertexShader(ID3D11VertexShader* shader)
     {
         m_context->VSSetShader(shader, nullptr, 0);
     }
 
-    void GraphicsDevice::SetPixelShader(ID3D11PixelShader* shader)
+    void D3D11GraphicsDevice::SetPixelShader(ID3D11PixelShader* shader)
     {
         m_context->PSSetShader(shader, nullptr, 0);
     }
 
-    void GraphicsDevice::SetComputeShader(ID3D11ComputeShader* shader)
+    void D3D11GraphicsDevice::SetComputeShader(ID3D11ComputeShader* shader)
     {
         m_context->CSSetShader(shader, nullptr, 0);
     }
 
-    void GraphicsDevice::SetInputLayout(ID3D11InputLayout* layout)
+    void D3D11GraphicsDevice::SetInputLayout(ID3D11InputLayout* layout)
     {
         m_context->IASetInputLayout(layout);
     }
+
+    std::unique_ptr<Texture> D3D11GraphicsDevice::CreateTexture()
+    {
+        return std::make_unique<D3D11Texture>();
+    }
+
+    std::unique_ptr<Buffer> D3D11GraphicsDevice::CreateBuffer()
+    {
+        return std::make_unique<D3D11Buffer>();
+    }
+
+    std::unique_ptr<Shader> D3D11GraphicsDevice::CreateShader()
+    {
+        return std::make_unique<D3D11Shader>();
+    }
+
+    void D3D11GraphicsDevice::LockContext()
+    {
+        if (m_multithread)
+            m_multithread->Enter();
+    }
+
+    void D3D11GraphicsDevice::UnlockContext()
+    {
+        if (m_multithread)
+            m_multithread->Leave();
+    }
 }
@@ -0,0 +1,136 @@
+﻿#include "LensPch.h"
+#include "graphics/D3D11ReadbackDevice.h"
+#include "graphics/D3D11Texture.h"
+
+namespace lens::graphics
+{
+    D3D11ReadbackDevice::D3D11ReadbackDevice(D3D11GraphicsDevice* device)
+        : m_device(device)
+    {
+    }
+
+    bool D3D11ReadbackDevice::PrepareSlot(uint32_t slot, uint32_t width, uint32_t height, TextureFormat format)
+    {
+        if (slot >= m_slots.size())
+        {
+            m_slots.resize(slot + 1);
+        }
+
+        StagingSlot& staging = m_slots[slot];
+        if (staging.texture && staging.width == width && staging.height == height && staging.format == format)
+            return true;
+
+        D3D11_TEXTURE2D_DESC stagingDesc = {};
+        {
+            stagingDesc.Width = width;
+            stagingDesc.Height = height;
+            stagingDesc.MipLevels = 1;
+            stagingDesc.ArraySize = 1;
+            stagingDesc.Format = static_cast<DXGI_FORMAT>(format);
+            stagingDesc.SampleDesc.Count = 1;
+            stagingDesc.Usage = D3D11_USAGE_STAGING;
+            stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        }
+
+        // 旧的暂存纹理可能还有复制没执行完
+        m_device->DeferRelease(staging.texture,
+            static_cast<uint64_t>(staging.width) * staging.height * GetFormatBytesPerPixel(staging.format));
+        HRESULT hr = m_device->GetDevice()->CreateTexture2D(&stagingDesc, nullptr, &staging.texture);
+        if (FAILED(hr))
+        {
+            LOG_ERROR("Failed to create readback staging texture: 0x{:X}", hr);
+            return false;
+        }
+
+        if (!staging.query)
+        {
+            D3D11_QUERY_DESC queryDesc = {};
+            queryDesc.Query = D3D11_QUERY_EVENT;
+            hr = m_device->GetDevice()->CreateQuery(&queryDesc, &staging.query);
+            if (FAILED(hr))
+            {
+                LOG_ERROR("Failed to create readback query: 0x{:X}", hr);
+                return false;
+            }
+        }
+
+        staging.width = width;
+        staging.height = height;
+        staging.format = format;
+        return true;
+    }
+
+    bool D3D11ReadbackDevice::SubmitCopy(uint32_t slot, Texture* source)
+    {
+        // 源纹理与本设备来自同一个 D3D11 设备
+        ID3D11Texture2D* texture = source ? static_cast<D3D11Texture*>(source)->GetD3DTexture() : nullptr;
+        if (slot >= m_slots.size() || !texture)
+            return false;
+
+        auto context = m_device->GetContext();
+        context->CopyResource(m_slots[slot].texture.Get(), texture);
+        context->End(m_slots[slot].query.Get());
+        return true;
+    }
+
+    bool D3D11ReadbackDevice::IsSlotReady(uint32_t slot)
+    {
+        if (slot >= m_slots.size())
+            return true;
+
+        // 允许 GetData 刷新命令缓冲，否则没有 Present 的循环里查询可能永远不完成
+        return m_device->GetContext()->GetData(m_slots[slot].query.Get(), nullptr, 0, 0) != S_FALSE;
+    }
+
+    IReadbackDevice::ReadResult D3D11ReadbackDevice::ReadSlot(uint32_t slot, CpuImage& image)
+    {
+        if (slot >= m_slots.size())
+            return ReadResult::Failed;
+
+        StagingSlot& staging = m_slots[slot];
+        auto context = m_device->GetContext();
+
+        // 调用方通常已经用 IsSlotReady 确认过，这里再查一次以便报告查询错误
+        HRESULT hr = context->GetData(staging.query.Get(), nullptr, 0, 0);
+        if (hr == S_FALSE)
+            return ReadResult::NotReady;
+        if (FAILED(hr))
+        {
+            LOG_ERROR("Readback query failed: 0x{:X}", hr);
+            return ReadResult::Failed;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        hr = context->Map(staging.texture.Get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+            return ReadResult::NotReady;
+        if (FAILED(hr))
+        {
+            LOG_ERROR("Failed to map readback staging texture: 0x{:X}", hr);
+            return ReadResult::Failed;
+        }
+
+        const uint8_t* src = static_cast<const uint8_t*>(mapped.pData);
+        uint32_t rowBytes = (std::min)(image.rowPitch, static_cast<uint32_t>(mapped.RowPitch));
+        uint32_t rows = (std::min)(image.height, staging.height);
+        for (uint32_t y = 0; y < rows; ++y)
+        {
+            memcpy(image.Row(y), src + static_cast<size_t>(y) * mapped.RowPitch, rowBytes);
+        }
+
+        context->Unmap(staging.texture.Get(), 0);
+        return ReadResult::Ok;
+    }
+
+    void D3D11ReadbackDevice::ReleaseSlots()
+    {
+        // 析构时可能还有未完成的复制，交给延迟销毁队列
+        for (auto& staging : m_slots)
+        {
+            m_device->DeferRelease(staging.texture,
+                static_cast<uint64_t>(staging.width) * staging.height * GetFormatBytesPerPixel(staging.format));
+            m_device->DeferRelease(staging.query, 0);
+        }
+        m_slots.clear();
+    }
+}
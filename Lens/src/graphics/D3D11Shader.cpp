@@ -0,0 +1,58 @@
+﻿#include "LensPch.h"
+#include "graphics/D3D11Shader.h"
+
+namespace lens::graphics 
+{
+    namespace
+    {
+        // 着色器由 D3D11GraphicsDevice 创建，传入的一定是同一个设备
+        ID3D11Device* GetD3DDevice(GraphicsDevice* device)
+        {
+            return static_cast<D3D11GraphicsDevice*>(device)->GetDevice();
+        }
+    }
+
+    bool D3D11Shader::LoadVertexShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) {
+        if (FAILED(GetD3DDevice(device)->CreateVertexShader(bytecode, size, nullptr, &m_vertexShader)))
+        {
+            return false;
+        }
+
+        // 保存字节码
+        m_vertexShaderBytecode.assign(
+            static_cast<const char*>(bytecode),
+            static_cast<const char*>(bytecode) + size
+        );
+
+        return true;
+    }
+
+    bool D3D11Shader::LoadPixelShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) 
+    {
+        HRESULT hr = GetD3DDevice(device)->CreatePixelShader(bytecode, size, nullptr, &m_pixelShader);
+        return SUCCEEDED(hr);
+    }
+
+    bool D3D11Shader::LoadComputeShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) 
+    {
+        HRESULT hr = GetD3DDevice(device)->CreateComputeShader(bytecode, size, nullptr, &m_computeShader);
+        return SUCCEEDED(hr);
+    }
+
+    bool D3D11Shader::SetInputLayout(GraphicsDevice* device, const D3D11_INPUT_ELEMENT_DESC* layout, uint32_t layoutCount) 
+    {
+        if (m_vertexShaderBytecode.empty()) 
+        {
+            return false;
+        }
+
+        HRESULT hr = GetD3DDevice(device)->CreateInputLayout(
+            layout, layoutCount,
+            m_vertexShaderBytecode.data(),
+            m_vertexShaderBytecode.size(),
+            &m_inputLayout
+        );
+
+        return SUCCEEDED(hr);
+    }
+}
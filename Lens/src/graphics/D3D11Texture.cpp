@@ -1,9 +1,23 @@
 ﻿#include "LensPch.h"
-#include "graphics/Texture.h"
+#include "graphics/D3D11Texture.h"
 
 namespace lens::graphics
 {
-    bool Texture::Create(GraphicsDevice* device, const Desc& desc) 
+    namespace
+    {
+        // 纹理由 D3D11GraphicsDevice 创建，传入的一定是同一个设备
+        ID3D11Device* GetD3DDevice(GraphicsDevice* device)
+        {
+            return static_cast<D3D11GraphicsDevice*>(device)->GetDevice();
+        }
+
+        ID3D11DeviceContext* GetContext(GraphicsDevice* device)
+        {
+            return static_cast<D3D11GraphicsDevice*>(device)->GetContext();
+        }
+    }
+
+    bool D3D11Texture::Create(GraphicsDevice* device, const Desc& desc) 
     {
         m_desc = desc;
 
@@ -33,7 +47,7 @@ namespace lens::graphics
             texDesc.MiscFlags = 0;
         }
 
-        HRESULT hr = device->GetDevice()->CreateTexture2D(&texDesc, nullptr, &m_texture);
+        HRESULT hr = GetD3DDevice(device)->CreateTexture2D(&texDesc, nullptr, &m_texture);
         if (FAILED(hr)) 
         {
             LOG_ERROR("Failed to create D3D11 texture");
@@ -51,7 +65,7 @@ namespace lens::graphics
                 srvDesc.Texture2D.MostDetailedMip = 0;
             }
 
-            hr = device->GetDevice()->CreateShaderResourceView(m_texture.Get(), &srvDesc, &m_srv);
+            hr = GetD3DDevice(device)->CreateShaderResourceView(m_texture.Get(), &srvDesc, &m_srv);
             if (FAILED(hr)) 
             {
                 return false;
@@ -68,7 +82,7 @@ namespace lens::graphics
                 rtvDesc.Texture2D.MipSlice = 0;
             }
 
-            hr = device->GetDevice()->CreateRenderTargetView(m_texture.Get(), &rtvDesc, &m_rtv);
+            hr = GetD3DDevice(device)->CreateRenderTargetView(m_texture.Get(), &rtvDesc, &m_rtv);
             if (FAILED(hr)) 
             {
                 return false;
@@ -78,7 +92,7 @@ namespace lens::graphics
         return true;
     }
 
-    bool Texture::CreateFromMemory(GraphicsDevice* device, const Desc& desc, const void* data) 
+    bool D3D11Texture::CreateFromMemory(GraphicsDevice* device, const Desc& desc, const void* data) 
     {
         if (!Create(device, desc)) 
         {
@@ -95,20 +109,19 @@ namespace lens::graphics
             box.front = 0;
             box.back = 1;
 
-            device->GetContext()->UpdateSubresource(m_texture.Get(), 0, &box, data, desc.width * 4, 0);
+            GetContext(device)->UpdateSubresource(m_texture.Get(), 0, &box, data, desc.width * 4, 0);
         }
 
         return true;
     }
 
-    bool Texture::CreateFromD3DTexture(GraphicsDevice* device, ID3D11Texture2D* texture)
+    bool D3D11Texture::CreateFromD3DTexture(GraphicsDevice* device, ID3D11Texture2D* texture)
     {
         if (!texture)
         {
             LOG_ERROR("Null texture provided to CreateFromD3DTexture");
             return false;
         }
-
         m_texture = texture;
 
         D3D11_TEXTURE2D_DESC texDesc;
@@ -132,21 +145,21 @@ namespace lens::graphics
             newDesc.MiscFlags = 0;
 
             Microsoft::WRL::ComPtr<ID3D11Texture2D> newTexture;
-            HRESULT hr = device->GetDevice()->CreateTexture2D(&newDesc, nullptr, &newTexture);
+            HRESULT hr = GetD3DDevice(device)->CreateTexture2D(&newDesc, nullptr, &newTexture);
             if (FAILED(hr))
             {
                 LOG_ERROR("Failed to create texture with SHADER_RESOURCE flag: 0x{:X}", hr);
                 return false;
             }
 
-            device->GetContext()->CopyResource(newTexture.Get(), texture);
-            device->GetContext()->Flush();
+            GetContext(device)->CopyResource(newTexture.Get(), texture);
+            GetContext(device)->Flush();
 
             m_texture = newTexture;
         }
 
         // 创建着色器资源视图
-        HRESULT hr = device->GetDevice()->CreateShaderResourceView(m_texture.Get(), nullptr, &m_srv);
+        HRESULT hr = GetD3DDevice(device)->CreateShaderResourceView(m_texture.Get(), nullptr, &m_srv);
         if (FAILED(hr))
         {
             LOG_ERROR("Failed to create shader resource view: 0x{:X}", hr);
@@ -156,17 +169,58 @@ namespace lens::graphics
         // 根据绑定标志创建其他视图
         if (texDesc.BindFlags & D3D11_BIND_RENDER_TARGET)
         {
-            device->GetDevice()->CreateRenderTargetView(m_texture.Get(), nullptr, &m_rtv);
+            GetD3DDevice(device)->CreateRenderTargetView(m_texture.Get(), nullptr, &m_rtv);
         }
         if (texDesc.BindFlags & D3D11_BIND_UNORDERED_ACCESS)
         {
-            device->GetDevice()->CreateUnorderedAccessView(m_texture.Get(), nullptr, &m_uav);
+            GetD3DDevice(device)->CreateUnorderedAccessView(m_texture.Get(), nullptr, &m_uav);
+        }
+
+        return true;
+    }
+
+    bool D3D11Texture::CopyFrom(GraphicsDevice* device, ID3D11Texture2D* source)
+    {
+        if (!m_texture || !source)
+        {
+            LOG_ERROR("CopyFrom called with null texture");
+            return false;
+        }
+
+        D3D11_TEXTURE2D_DESC srcDesc;
+        source->GetDesc(&srcDesc);
+        if (srcDesc.Width < m_desc.width || srcDesc.Height < m_desc.height ||
+            srcDesc.Format != static_cast<DXGI_FORMAT>(m_desc.format))
+        {
+            LOG_ERROR("CopyFrom size/format mismatch: {}x{} -> {}x{}",
+                srcDesc.Width, srcDesc.Height, m_desc.width, m_desc.height);
+            return false;
         }
 
+        if (srcDesc.Width == m_desc.width && srcDesc.Height == m_desc.height)
+        {
+            GetContext(device)->CopyResource(m_texture.Get(), source);
+        }
+        else
+        {
+            D3D11_BOX box = {};
+            box.left = 0;
+            box.top = 0;
+            box.front = 0;
+            box.right = m_desc.width;
+            box.bottom = m_desc.height;
+            box.back = 1;
+            GetContext(device)->CopySubresourceRegion(m_texture.Get(), 0, 0, 0, 0, source, 0, &box);
+        }
         return true;
     }
 
-    void Texture::UpdateData(GraphicsDevice* device, const void* data, size_t size, uint32_t mipLevel) 
+    bool D3D11Texture::CopyFrom(GraphicsDevice* device, const Texture& source)
+    {
+        return CopyFrom(device, static_cast<const D3D11Texture&>(source).GetD3DTexture());
+    }
+
+    void D3D11Texture::UpdateData(GraphicsDevice* device, const void* data, size_t size, uint32_t mipLevel) 
     {
         D3D11_BOX box = {};
         {
@@ -177,37 +231,55 @@ namespace lens::graphics
             box.bottom = m_desc.height >> mipLevel;
             box.back = 1;
         }
-        device->GetContext()->UpdateSubresource(m_texture.Get(), mipLevel, &box, data,
+        GetContext(device)->UpdateSubresource(m_texture.Get(), mipLevel, &box, data,
             static_cast<UINT>(box.right * 4), 0);
     }
 
-    D3D11_MAPPED_SUBRESOURCE Texture::Map(GraphicsDevice* device, uint32_t mipLevel, D3D11_MAP mapType) 
+    void D3D11Texture::UpdateRegion(GraphicsDevice* device, const void* data, uint32_t rowPitch,
+        uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+    {
+        D3D11_BOX box = {};
+        {
+            box.left = x;
+            box.top = y;
+            box.front = 0;
+            box.right = (std::min)(x + width, m_desc.width);
+            box.bottom = (std::min)(y + height, m_desc.height);
+            box.back = 1;
+        }
+        if (box.right <= box.left || box.bottom <= box.top)
+            return;
+
+        GetContext(device)->UpdateSubresource(m_texture.Get(), 0, &box, data, rowPitch, 0);
+    }
+
+    MappedData D3D11Texture::Map(GraphicsDevice* device, uint32_t mipLevel, MapMode mode) 
     {
         D3D11_MAPPED_SUBRESOURCE mappedResource;
-        HRESULT hr = device->GetContext()->Map(m_texture.Get(), mipLevel, mapType, 0, &mappedResource);
+        HRESULT hr = GetContext(device)->Map(m_texture.Get(), mipLevel, static_cast<D3D11_MAP>(mode), 0, &mappedResource);
 
         if (FAILED(hr)) 
         {
             return {};
         }
 
-        return mappedResource;
+        return MappedData{ mappedResource.pData, mappedResource.RowPitch, mappedResource.DepthPitch };
     }
 
-    void Texture::Unmap(GraphicsDevice* device, uint32_t mipLevel) 
+    void D3D11Texture::Unmap(GraphicsDevice* device, uint32_t mipLevel) 
     {
-        device->GetContext()->Unmap(m_texture.Get(), mipLevel);
+        GetContext(device)->Unmap(m_texture.Get(), mipLevel);
     }
 
-    void Texture::GenerateMipmaps(GraphicsDevice* device)
+    void D3D11Texture::GenerateMipmaps(GraphicsDevice* device)
     {
         if (m_srv)
         {
-            device->GetContext()->GenerateMips(m_srv.Get());
+            GetContext(device)->GenerateMips(m_srv.Get());
         }
     }
 
-    bool Texture::SaveToFile(GraphicsDevice* device, const char* filename)
+    bool D3D11Texture::SaveToFile(GraphicsDevice* device, const char* filename, const ImageEncodeOptions& options)
     {
         if (!m_texture)
         {
@@ -224,7 +296,7 @@ namespace lens::graphics
         stagingDesc.MiscFlags = 0;
 
         Microsoft::WRL::ComPtr<ID3D11Texture2D> stagingTexture;
-        HRESULT hr = device->GetDevice()->CreateTexture2D(&stagingDesc, nullptr, &stagingTexture);
+        HRESULT hr = GetD3DDevice(device)->CreateTexture2D(&stagingDesc, nullptr, &stagingTexture);
         if (FAILED(hr))
         {
             LOG_ERROR("Failed to create staging texture: 0x{:X}", hr);
@@ -232,61 +304,28 @@ namespace lens::graphics
         }
 
         // 复制纹理到staging纹理
-        device->GetContext()->CopyResource(stagingTexture.Get(), m_texture.Get());
+        GetContext(device)->CopyResource(stagingTexture.Get(), m_texture.Get());
 
         // 映射staging纹理
         D3D11_MAPPED_SUBRESOURCE mappedResource;
-        hr = device->GetContext()->Map(stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
+        hr = GetContext(device)->Map(stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
         if (FAILED(hr))
         {
             LOG_ERROR("Failed to map staging texture: 0x{:X}", hr);
             return false;
         }
 
-        // 创建BMP文件
-        int width = m_desc.width;
-        int height = m_desc.height;
-        int rowSize = width * 4; // BGRA8格式
-
-        // 创建BMP文件头
-        unsigned char fileHeader[14] = { 0 };
-        unsigned char infoHeader[40] = { 0 };
-
-        int fileSize = 14 + 40 + rowSize * height;
-        fileHeader[0] = 'B';
-        fileHeader[1] = 'M';
-        *(int*)&fileHeader[2] = fileSize;
-        *(int*)&fileHeader[10] = 54;
-
-        infoHeader[0] = 40;
-        *(int*)&infoHeader[4] = width;
-        *(int*)&infoHeader[8] = height;
-        infoHeader[12] = 1;
-        infoHeader[14] = 32; // 32位BGRA
-
-        // 写入文件
-        FILE* f = nullptr;
-        errno_t err = fopen_s(&f, filename, "wb");
-        if (err != 0 || !f)
-        {
-            LOG_ERROR("Failed to create file: {}", filename);
-            device->GetContext()->Unmap(stagingTexture.Get(), 0);
-            return false;
-        }
+        // 直接从映射内存按 RowPitch 编码，编码器按扩展名或 options.codec 选择
+        const bool saved = SaveImage(filename, static_cast<const uint8_t*>(mappedResource.pData), mappedResource.RowPitch,
+            m_desc.width, m_desc.height, m_desc.format, options);
+        GetContext(device)->Unmap(stagingTexture.Get(), 0);
 
-        fwrite(fileHeader, 1, 14, f);
-        fwrite(infoHeader, 1, 40, f);
-
-        // 写入像素数据（BMP是从下到上的）
-        unsigned char* rowPtr = static_cast<unsigned char*>(mappedResource.pData);
-        for (int y = height - 1; y >= 0; y--)
+        if (!saved)
         {
-            fwrite(rowPtr + y * mappedResource.RowPitch, 1, rowSize, f);
+            LOG_ERROR("Failed to save texture to {}", filename);
+            return false;
         }
 
-        fclose(f);
-        device->GetContext()->Unmap(stagingTexture.Get(), 0);
-
         LOG_INFO("Texture saved to {}", filename);
         return true;
     }
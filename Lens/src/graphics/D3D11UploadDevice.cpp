@@ -0,0 +1,142 @@
+﻿#include "LensPch.h"
+#include "graphics/D3D11UploadDevice.h"
+
+namespace lens::graphics
+{
+    namespace
+    {
+        // 按偏移绑定常量缓冲区时，偏移和大小都以 16 字节常量为单位，且须为 16 个常量的倍数
+        void GetConstantRange(const UploadRing::Allocation& allocation, UINT& first, UINT& count)
+        {
+            first = static_cast<UINT>(allocation.offset / 16);
+            count = (static_cast<UINT>(allocation.size / 16) + 15) & ~15u;
+        }
+    }
+
+    D3D11UploadDevice::D3D11UploadDevice(D3D11GraphicsDevice* device)
+        : m_device(device)
+    {
+        m_device->GetContext()->QueryInterface(IID_PPV_ARGS(&m_context1));
+    }
+
+    bool D3D11UploadDevice::IsSupported(D3D11GraphicsDevice* device)
+    {
+        D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+        HRESULT hr = device->GetDevice()->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+        return SUCCEEDED(hr) && options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer;
+    }
+
+    bool D3D11UploadDevice::Create(uint64_t capacity)
+    {
+        if (!m_context1)
+        {
+            LOG_ERROR("ID3D11DeviceContext1 is not available");
+            return false;
+        }
+
+        // 单个常量缓冲区最大 4096 个常量，但按偏移绑定时整个缓冲区可以更大
+        D3D11_BUFFER_DESC bufferDesc = {};
+        {
+            bufferDesc.ByteWidth = static_cast<UINT>(capacity);
+            bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+            bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+            bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        }
+
+        m_buffer.Reset();
+        HRESULT hr = m_device->GetDevice()->CreateBuffer(&bufferDesc, nullptr, &m_buffer);
+        if (FAILED(hr))
+        {
+            LOG_ERROR("Failed to create upload buffer: 0x{:X}", hr);
+            return false;
+        }
+        return true;
+    }
+
+    uint8_t* D3D11UploadDevice::Map(bool discard)
+    {
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        HRESULT hr = m_device->GetContext()->Map(m_buffer.Get(), 0,
+            discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped);
+        if (FAILED(hr))
+        {
+            LOG_ERROR("Failed to map upload buffer: 0x{:X}", hr);
+            return nullptr;
+        }
+        return static_cast<uint8_t*>(mapped.pData);
+    }
+
+    void D3D11UploadDevice::Unmap()
+    {
+        m_device->GetContext()->Unmap(m_buffer.Get(), 0);
+    }
+
+    void D3D11UploadDevice::SignalFence(uint64_t value)
+    {
+        Microsoft::WRL::ComPtr<ID3D11Query> query;
+        if (!m_freeQueries.empty())
+        {
+            query = std::move(m_freeQueries.back());
+            m_freeQueries.pop_back();
+        }
+        else
+        {
+            D3D11_QUERY_DESC queryDesc = {};
+            queryDesc.Query = D3D11_QUERY_EVENT;
+            HRESULT hr = m_device->GetDevice()->CreateQuery(&queryDesc, &query);
+            if (FAILED(hr))
+            {
+                // 没有查询就无法知道 GPU 何时用完，只能在下一次检查时刷新并视为完成
+                LOG_ERROR("Failed to create upload fence query: 0x{:X}", hr);
+                m_pending.push_back(PendingFence{ value, nullptr });
+                return;
+            }
+        }
+
+        m_device->GetContext()->End(query.Get());
+        m_pending.push_back(PendingFence{ value, std::move(query) });
+    }
+
+    uint64_t D3D11UploadDevice::GetCompletedFence(bool wait)
+    {
+        auto context = m_device->GetContext();
+        while (!m_pending.empty())
+        {
+            PendingFence& fence = m_pending.front();
+            if (fence.query)
+            {
+                // 只在等待时允许刷新命令缓冲，平时不打断批处理
+                const UINT flags = wait ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH;
+                if (context->GetData(fence.query.Get(), nullptr, 0, flags) != S_OK)
+                    break;
+                m_freeQueries.push_back(std::move(fence.query));
+            }
+            else
+            {
+                context->Flush();
+            }
+
+            m_completedFence = fence.value;
+            m_pending.pop_front();
+        }
+        return m_completedFence;
+    }
+
+    void D3D11UploadDevice::BindVS(uint32_t slot, const UploadRing::Allocation& allocation) const
+    {
+        ID3D11Buffer* buffer = m_buffer.Get();
+        UINT first = 0;
+        UINT count = 0;
+        GetConstantRange(allocation, first, count);
+        m_context1->VSSetConstantBuffers1(slot, 1, &buffer, &first, &count);
+    }
+
+    void D3D11UploadDevice::BindPS(uint32_t slot, const UploadRing::Allocation& allocation) const
+    {
+        ID3D11Buffer* buffer = m_buffer.Get();
+        UINT first = 0;
+        UINT count = 0;
+        GetConstantRange(allocation, first, count);
+        m_context1->PSSetConstantBuffers1(slot, 1, &buffer, &first, &count);
+    }
+}
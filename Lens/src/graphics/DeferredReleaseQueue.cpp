@@ -0,0 +1,105 @@
+﻿#include "LensPch.h"
+#include "graphics/DeferredReleaseQueue.h"
+#include <vector>
+
+namespace lens::graphics
+{
+    DeferredReleaseQueue::DeferredReleaseQueue()
+        : DeferredReleaseQueue(Desc{})
+    {
+    }
+
+    DeferredReleaseQueue::DeferredReleaseQueue(const Desc& desc)
+        : m_desc(desc)
+    {
+    }
+
+    DeferredReleaseQueue::~DeferredReleaseQueue()
+    {
+        Flush();
+    }
+
+    void DeferredReleaseQueue::Retire(std::shared_ptr<void> object, uint64_t bytes)
+    {
+        if (!object)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.push_back(Entry{ m_frame, std::chrono::steady_clock::now(), bytes, std::move(object) });
+        m_stats.retired++;
+        m_stats.pendingBytes += bytes;
+        m_stats.peakPendingBytes = (std::max)(m_stats.peakPendingBytes, m_stats.pendingBytes);
+    }
+
+    size_t DeferredReleaseQueue::EndFrame()
+    {
+        return ReleaseBatch(ReleaseMode::EndFrame);
+    }
+
+    size_t DeferredReleaseQueue::Poll()
+    {
+        return ReleaseBatch(ReleaseMode::Poll);
+    }
+
+    size_t DeferredReleaseQueue::Flush()
+    {
+        return ReleaseBatch(ReleaseMode::All);
+    }
+
+    DeferredReleaseQueue::Stats DeferredReleaseQueue::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats = m_stats;
+        stats.pendingCount = m_entries.size();
+        stats.frame = m_frame;
+        return stats;
+    }
+
+    size_t DeferredReleaseQueue::ReleaseBatch(ReleaseMode mode)
+    {
+        const bool all = mode == ReleaseMode::All;
+        const auto now = std::chrono::steady_clock::now();
+
+        // 到期的条目在锁内取出，在锁外销毁，销毁期间其他线程仍可 Retire
+        std::vector<std::shared_ptr<void>> batch;
+        uint64_t batchBytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (mode == ReleaseMode::EndFrame)
+            {
+                m_frame++;
+            }
+
+            const size_t limit = all || m_desc.maxReleasesPerFrame == 0 ? m_entries.size() : m_desc.maxReleasesPerFrame;
+            while (!m_entries.empty() && batch.size() < limit)
+            {
+                const Entry& entry = m_entries.front();
+                const bool frameExpired = entry.frame + m_desc.frameLatency < m_frame;
+                const bool ageExpired = m_desc.maxAge.count() > 0 && now - entry.time >= m_desc.maxAge;
+                if (!all && !frameExpired && !ageExpired)
+                    break;
+
+                batchBytes += entry.bytes;
+                batch.push_back(std::move(m_entries.front().object));
+                m_entries.pop_front();
+            }
+            m_stats.pendingBytes -= batchBytes;
+        }
+
+        if (batch.empty())
+            return 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        const size_t count = batch.size();
+        batch.clear();
+        const double batchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.released += count;
+        m_stats.releasedBytes += batchBytes;
+        m_stats.batches++;
+        m_stats.releaseMs += batchMs;
+        m_stats.maxBatchMs = (std::max)(m_stats.maxBatchMs, batchMs);
+        return count;
+    }
+}
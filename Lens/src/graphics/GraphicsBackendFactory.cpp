@@ -0,0 +1,60 @@
+﻿#include "LensPch.h"
+#include "graphics/GraphicsDevice.h"
+#include "graphics/CpuReadbackDevice.h"
+#include "graphics/CpuUploadDevice.h"
+#include "graphics/NullGraphicsDevice.h"
+#ifdef _WIN32
+#include "graphics/D3D11GraphicsDevice.h"
+#include "graphics/D3D11ReadbackDevice.h"
+#include "graphics/D3D11UploadDevice.h"
+#endif
+
+// 按后端创建设备的工厂集中在这里，空后端和 CPU 实现的源文件不依赖 D3D11
+namespace lens::graphics
+{
+    std::unique_ptr<GraphicsDevice> CreateGraphicsDevice(GraphicsBackend backend)
+    {
+        if (backend == GraphicsBackend::Null)
+        {
+            return std::make_unique<NullGraphicsDevice>();
+        }
+#ifdef _WIN32
+        return std::make_unique<D3D11GraphicsDevice>();
+#else
+        LOG_ERROR("D3D11 backend is only available on Windows");
+        return nullptr;
+#endif
+    }
+
+    std::unique_ptr<IReadbackDevice> CreateReadbackDevice(GraphicsDevice* device)
+    {
+        if (device->GetBackend() == GraphicsBackend::Null)
+        {
+            return std::make_unique<CpuReadbackDevice>();
+        }
+#ifdef _WIN32
+        return std::make_unique<D3D11ReadbackDevice>(static_cast<D3D11GraphicsDevice*>(device));
+#else
+        return nullptr;
+#endif
+    }
+
+    std::unique_ptr<IUploadDevice> CreateUploadDevice(GraphicsDevice* device)
+    {
+        if (device->GetBackend() == GraphicsBackend::Null)
+        {
+            return std::make_unique<CpuUploadDevice>();
+        }
+#ifdef _WIN32
+        auto* d3dDevice = static_cast<D3D11GraphicsDevice*>(device);
+        if (!D3D11UploadDevice::IsSupported(d3dDevice))
+        {
+            LOG_WARN("Constant buffer offsetting is not supported, upload ring disabled");
+            return nullptr;
+        }
+        return std::make_unique<D3D11UploadDevice>(d3dDevice);
+#else
+        return nullptr;
+#endif
+    }
+}
@@ -0,0 +1,433 @@
+﻿#include "LensPch.h"
+#include "graphics/ImageEncoder.h"
+#include "graphics/PixelConvert.h"
+#include "ThreadPool.h"
+#include <cstring>
+#include <fstream>
+
+namespace lens::graphics
+{
+    namespace
+    {
+        constexpr uint8_t kQoiOpIndex = 0x00;
+        constexpr uint8_t kQoiOpDiff = 0x40;
+        constexpr uint8_t kQoiOpLuma = 0x80;
+        constexpr uint8_t kQoiOpRun = 0xC0;
+        constexpr uint8_t kQoiOpRgb = 0xFE;
+        constexpr uint8_t kQoiOpRgba = 0xFF;
+        constexpr uint8_t kQoiMask = 0xC0;
+        constexpr uint8_t kQoiEnd[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+        // 每个 QOI 行带约 1 MB 像素
+        constexpr size_t kQoiBandBytes = 1 << 20;
+
+        struct QoiPixel
+        {
+            uint8_t r, g, b, a;
+
+            bool operator==(const QoiPixel& other) const
+            {
+                return r == other.r && g == other.g && b == other.b && a == other.a;
+            }
+        };
+
+        inline uint32_t QoiHash(const QoiPixel& p)
+        {
+            return (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) % 64;
+        }
+
+        inline QoiPixel LoadPixel(const uint8_t* p, bool bgra, bool keepAlpha)
+        {
+            return bgra
+                ? QoiPixel{ p[2], p[1], p[0], keepAlpha ? p[3] : uint8_t(0xFF) }
+                : QoiPixel{ p[0], p[1], p[2], keepAlpha ? p[3] : uint8_t(0xFF) };
+        }
+
+        inline void PutU32BE(uint8_t* dst, uint32_t value)
+        {
+            dst[0] = static_cast<uint8_t>(value >> 24);
+            dst[1] = static_cast<uint8_t>(value >> 16);
+            dst[2] = static_cast<uint8_t>(value >> 8);
+            dst[3] = static_cast<uint8_t>(value);
+        }
+
+        inline uint32_t GetU32BE(const uint8_t* src)
+        {
+            return (static_cast<uint32_t>(src[0]) << 24) | (static_cast<uint32_t>(src[1]) << 16) |
+                (static_cast<uint32_t>(src[2]) << 8) | src[3];
+        }
+
+        // 编码 [y0, y1) 行。QOI 本身是串行格式，这里让每个行带只引用本带内写入过的索引项，
+        // 并以上一行最后一个像素作为起始的前一像素，这样各带独立编码后直接拼接仍是合法的单一码流
+        uint8_t* EncodeQoiBand(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t y0, uint32_t y1,
+            bool bgra, bool keepAlpha, uint8_t* out)
+        {
+            QoiPixel index[64] = {};
+            // 第一带与解码器一样从全零索引开始，可以直接使用
+            uint64_t valid = y0 == 0 ? ~0ull : 0;
+            QoiPixel prev = y0 == 0
+                ? QoiPixel{ 0, 0, 0, 255 }
+                : LoadPixel(pixels + static_cast<size_t>(y0 - 1) * stride + static_cast<size_t>(width - 1) * 4, bgra, keepAlpha);
+            uint32_t run = 0;
+
+            for (uint32_t y = y0; y < y1; ++y)
+            {
+                const uint8_t* row = pixels + static_cast<size_t>(y) * stride;
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    const QoiPixel px = LoadPixel(row + x * 4, bgra, keepAlpha);
+                    if (px == prev)
+                    {
+                        if (++run == 62)
+                        {
+                            *out++ = static_cast<uint8_t>(kQoiOpRun | (run - 1));
+                            run = 0;
+                        }
+                        continue;
+                    }
+
+                    if (run > 0)
+                    {
+                        *out++ = static_cast<uint8_t>(kQoiOpRun | (run - 1));
+                        run = 0;
+                    }
+
+                    const uint32_t hash = QoiHash(px);
+                    if (((valid >> hash) & 1) && index[hash] == px)
+                    {
+                        *out++ = static_cast<uint8_t>(kQoiOpIndex | hash);
+                    }
+                    else
+                    {
+                        index[hash] = px;
+                        valid |= 1ull << hash;
+
+                        if (px.a == prev.a)
+                        {
+                            const int8_t dr = static_cast<int8_t>(px.r - prev.r);
+                            const int8_t dg = static_cast<int8_t>(px.g - prev.g);
+                            const int8_t db = static_cast<int8_t>(px.b - prev.b);
+                            const int8_t drdg = static_cast<int8_t>(dr - dg);
+                            const int8_t dbdg = static_cast<int8_t>(db - dg);
+
+                            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                            {
+                                *out++ = static_cast<uint8_t>(kQoiOpDiff | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+                            }
+                            else if (dg >= -32 && dg <= 31 && drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7)
+                            {
+                                *out++ = static_cast<uint8_t>(kQoiOpLuma | (dg + 32));
+                                *out++ = static_cast<uint8_t>(((drdg + 8) << 4) | (dbdg + 8));
+                            }
+                            else
+                            {
+                                *out++ = kQoiOpRgb;
+                                *out++ = px.r;
+                                *out++ = px.g;
+                                *out++ = px.b;
+                            }
+                        }
+                        else
+                        {
+                            *out++ = kQoiOpRgba;
+                            *out++ = px.r;
+                            *out++ = px.g;
+                            *out++ = px.b;
+                            *out++ = px.a;
+                        }
+                    }
+                    prev = px;
+                }
+            }
+
+            if (run > 0)
+            {
+                *out++ = static_cast<uint8_t>(kQoiOpRun | (run - 1));
+            }
+            return out;
+        }
+    }
+
+    const char* GetImageCodecName(ImageCodec codec)
+    {
+        switch (codec)
+        {
+        case ImageCodec::Auto: return "Auto";
+        case ImageCodec::BMP:  return "BMP";
+        case ImageCodec::QOI:  return "QOI";
+        case ImageCodec::PNG:  return "PNG";
+        case ImageCodec::JPEG: return "JPEG";
+        default:               return "Unknown";
+        }
+    }
+
+    ImageCodec GetImageCodecForPath(const std::filesystem::path& path)
+    {
+        auto ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (ext == ".bmp")
+            return ImageCodec::BMP;
+        if (ext == ".qoi")
+            return ImageCodec::QOI;
+        if (ext == ".png")
+            return ImageCodec::PNG;
+        if (ext == ".jpg" || ext == ".jpeg")
+            return ImageCodec::JPEG;
+        return ImageCodec::Auto;
+    }
+
+    bool EncodeImage(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, TextureFormat format,
+        std::vector<uint8_t>& output, const ImageEncodeOptions& options)
+    {
+        output.clear();
+        if (!pixels || width == 0 || height == 0 || stride < width * 4)
+        {
+            LOG_ERROR("Invalid image for encoding: {}x{}, stride {}", width, height, stride);
+            return false;
+        }
+        if (format != TextureFormat::BGRA8_UNorm && format != TextureFormat::RGBA8_UNorm)
+        {
+            LOG_ERROR("Image encoding only supports BGRA8/RGBA8, got format {}", static_cast<int>(format));
+            return false;
+        }
+
+        const bool bgra = format == TextureFormat::BGRA8_UNorm;
+        ThreadPool& pool = options.pool ? *options.pool : ThreadPool::GetShared();
+        switch (options.codec)
+        {
+        case ImageCodec::BMP:
+            return detail::EncodeBmp(pixels, stride, width, height, bgra, output);
+        case ImageCodec::QOI:
+            return detail::EncodeQoi(pixels, stride, width, height, bgra, options.keepAlpha, pool, output);
+        case ImageCodec::JPEG:
+            return detail::EncodeJpeg(pixels, stride, width, height, bgra, options.jpegQuality, pool, output);
+        case ImageCodec::Auto:
+        case ImageCodec::PNG:
+        default:
+            return detail::EncodePng(pixels, stride, width, height, bgra, options.keepAlpha, options.pngLevel, pool, output);
+        }
+    }
+
+    bool EncodeImage(const CpuImage& image, std::vector<uint8_t>& output, const ImageEncodeOptions& options)
+    {
+        return EncodeImage(image.pixels.data(), image.rowPitch, image.width, image.height, image.format, output, options);
+    }
+
+    bool SaveImage(const std::filesystem::path& path, const uint8_t* pixels, uint32_t stride,
+        uint32_t width, uint32_t height, TextureFormat format, const ImageEncodeOptions& options)
+    {
+        ImageEncodeOptions resolved = options;
+        if (resolved.codec == ImageCodec::Auto)
+        {
+            resolved.codec = GetImageCodecForPath(path);
+        }
+
+        std::vector<uint8_t> encoded;
+        if (!EncodeImage(pixels, stride, width, height, format, encoded, resolved))
+        {
+            return false;
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open() || !out.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size())))
+        {
+            LOG_ERROR("Failed to write image: {}", path.string());
+            return false;
+        }
+        return true;
+    }
+
+    bool SaveImage(const std::filesystem::path& path, const CpuImage& image, const ImageEncodeOptions& options)
+    {
+        return SaveImage(path, image.pixels.data(), image.rowPitch, image.width, image.height, image.format, options);
+    }
+
+    bool DecodeQoi(const uint8_t* data, size_t size, CpuImage& image)
+    {
+        if (size < 14 + sizeof(kQoiEnd) || std::memcmp(data, "qoif", 4) != 0)
+        {
+            LOG_ERROR("Not a QOI image");
+            return false;
+        }
+
+        const uint32_t width = GetU32BE(data + 4);
+        const uint32_t height = GetU32BE(data + 8);
+        if (width == 0 || height == 0 || static_cast<uint64_t>(width) * height > (1ull << 30))
+        {
+            LOG_ERROR("Unsupported QOI size: {}x{}", width, height);
+            return false;
+        }
+
+        image.Allocate(width, height, TextureFormat::BGRA8_UNorm);
+
+        QoiPixel index[64] = {};
+        QoiPixel px{ 0, 0, 0, 255 };
+        uint32_t run = 0;
+        size_t pos = 14;
+        const size_t end = size - sizeof(kQoiEnd);
+
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            uint8_t* row = image.Row(y);
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                if (run > 0)
+                {
+                    run--;
+                }
+                else if (pos < end)
+                {
+                    const uint8_t b1 = data[pos++];
+                    if (b1 == kQoiOpRgb)
+                    {
+                        if (pos + 3 > end)
+                            return false;
+                        px.r = data[pos];
+                        px.g = data[pos + 1];
+                        px.b = data[pos + 2];
+                        pos += 3;
+                    }
+                    else if (b1 == kQoiOpRgba)
+                    {
+                        if (pos + 4 > end)
+                            return false;
+                        px = { data[pos], data[pos + 1], data[pos + 2], data[pos + 3] };
+                        pos += 4;
+                    }
+                    else if ((b1 & kQoiMask) == kQoiOpIndex)
+                    {
+                        px = index[b1];
+                    }
+                    else if ((b1 & kQoiMask) == kQoiOpDiff)
+                    {
+                        px.r = static_cast<uint8_t>(px.r + ((b1 >> 4) & 0x03) - 2);
+                        px.g = static_cast<uint8_t>(px.g + ((b1 >> 2) & 0x03) - 2);
+                        px.b = static_cast<uint8_t>(px.b + (b1 & 0x03) - 2);
+                    }
+                    else if ((b1 & kQoiMask) == kQoiOpLuma)
+                    {
+                        if (pos + 1 > end)
+                            return false;
+                        const uint8_t b2 = data[pos++];
+                        const int dg = (b1 & 0x3F) - 32;
+                        px.r = static_cast<uint8_t>(px.r + dg - 8 + ((b2 >> 4) & 0x0F));
+                        px.g = static_cast<uint8_t>(px.g + dg);
+                        px.b = static_cast<uint8_t>(px.b + dg - 8 + (b2 & 0x0F));
+                    }
+                    else
+                    {
+                        run = b1 & 0x3F;
+                    }
+                    index[QoiHash(px)] = px;
+                }
+                else
+                {
+                    LOG_ERROR("Truncated QOI image");
+                    return false;
+                }
+
+                row[x * 4 + 0] = px.b;
+                row[x * 4 + 1] = px.g;
+                row[x * 4 + 2] = px.r;
+                row[x * 4 + 3] = px.a;
+            }
+        }
+        return true;
+    }
+
+    namespace detail
+    {
+        bool EncodeBmp(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, bool bgra,
+            std::vector<uint8_t>& output)
+        {
+            // BITMAPFILEHEADER + BITMAPINFOHEADER，高度取负表示自上而下存储，行按 32 位无需填充
+            const uint32_t rowBytes = width * 4;
+            const uint64_t imageSize = static_cast<uint64_t>(rowBytes) * height;
+            if (imageSize + 54 > 0xFFFFFFFFull)
+            {
+                LOG_ERROR("Image too large for BMP: {}x{}", width, height);
+                return false;
+            }
+
+            output.assign(54 + static_cast<size_t>(imageSize), 0);
+            uint8_t* header = output.data();
+            auto putU16 = [&](size_t offset, uint16_t value) { std::memcpy(header + offset, &value, sizeof(value)); };
+            auto putU32 = [&](size_t offset, uint32_t value) { std::memcpy(header + offset, &value, sizeof(value)); };
+
+            header[0] = 'B';
+            header[1] = 'M';
+            putU32(2, static_cast<uint32_t>(54 + imageSize));  // bfSize
+            putU32(10, 54);                                     // bfOffBits
+            putU32(14, 40);                                     // biSize
+            putU32(18, width);                                  // biWidth
+            putU32(22, static_cast<uint32_t>(-static_cast<int32_t>(height))); // biHeight
+            putU16(26, 1);                                      // biPlanes
+            putU16(28, 32);                                     // biBitCount
+            putU32(30, 0);                                      // biCompression = BI_RGB
+            putU32(34, static_cast<uint32_t>(imageSize));       // biSizeImage
+            putU32(38, 2835);                                   // 72 DPI
+            putU32(42, 2835);
+
+            uint8_t* dst = output.data() + 54;
+            if (bgra)
+            {
+                for (uint32_t y = 0; y < height; ++y)
+                {
+                    std::memcpy(dst + static_cast<size_t>(y) * rowBytes, pixels + static_cast<size_t>(y) * stride, rowBytes);
+                }
+            }
+            else
+            {
+                ConvertRGBAToBGRA(pixels, stride, dst, rowBytes, width, height);
+            }
+            return true;
+        }
+
+        bool EncodeQoi(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, bool bgra,
+            bool keepAlpha, ThreadPool& pool, std::vector<uint8_t>& output)
+        {
+            const uint32_t rowsPerBand = static_cast<uint32_t>((std::max)(size_t(1), kQoiBandBytes / (static_cast<size_t>(width) * 4)));
+            const uint32_t bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+            std::vector<std::vector<uint8_t>> bands(bandCount);
+
+            pool.ParallelFor(bandCount, 1, [&](uint32_t begin, uint32_t end)
+            {
+                // 按最坏情况（每像素 5 字节）准备线程内缓冲，编码后只保留实际长度
+                thread_local std::vector<uint8_t> scratch;
+                for (uint32_t band = begin; band < end; ++band)
+                {
+                    const uint32_t y0 = band * rowsPerBand;
+                    const uint32_t y1 = (std::min)(height, y0 + rowsPerBand);
+                    const size_t worst = static_cast<size_t>(width) * (y1 - y0) * 5;
+                    if (scratch.size() < worst)
+                        scratch.resize(worst);
+
+                    uint8_t* last = EncodeQoiBand(pixels, stride, width, y0, y1, bgra, keepAlpha, scratch.data());
+                    bands[band].assign(scratch.data(), last);
+                }
+            });
+
+            size_t total = 14 + sizeof(kQoiEnd);
+            for (const auto& band : bands)
+            {
+                total += band.size();
+            }
+
+            output.resize(total);
+            uint8_t* out = output.data();
+            std::memcpy(out, "qoif", 4);
+            PutU32BE(out + 4, width);
+            PutU32BE(out + 8, height);
+            out[12] = keepAlpha ? 4 : 3;
+            out[13] = 0;    // sRGB
+            out += 14;
+            for (const auto& band : bands)
+            {
+                std::memcpy(out, band.data(), band.size());
+                out += band.size();
+            }
+            std::memcpy(out, kQoiEnd, sizeof(kQoiEnd));
+            return true;
+        }
+    }
+}
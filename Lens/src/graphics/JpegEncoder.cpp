@@ -0,0 +1,599 @@
+﻿#include "LensPch.h"
+#include "graphics/ImageEncoder.h"
+#include "ThreadPool.h"
+#include <bit>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace lens::graphics::detail
+{
+    namespace
+    {
+        // 基线 JPEG：YCbCr 4:2:0，MCU 为 16x16 像素（4 个 Y 块 + Cb + Cr），标准 Huffman 表。
+        // 每一行 MCU 是一个重启间隔，DC 预测在间隔处清零，各行在线程池上独立编码后以 RSTn 标记拼接
+
+        // 自然顺序 -> 之字形顺序
+        constexpr uint8_t kZigzag[64] =
+        {
+             0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+            12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+            35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+            58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+        };
+
+        // ITU T.81 Annex K 的参考量化表，自然顺序
+        constexpr uint8_t kLumaQuant[64] =
+        {
+            16, 11, 10, 16,  24,  40,  51,  61,
+            12, 12, 14, 19,  26,  58,  60,  55,
+            14, 13, 16, 24,  40,  57,  69,  56,
+            14, 17, 22, 29,  51,  87,  80,  62,
+            18, 22, 37, 56,  68, 109, 103,  77,
+            24, 35, 55, 64,  81, 104, 113,  92,
+            49, 64, 78, 87, 103, 121, 120, 101,
+            72, 92, 95, 98, 112, 100, 103,  99
+        };
+
+        constexpr uint8_t kChromaQuant[64] =
+        {
+            17, 18, 24, 47, 99, 99, 99, 99,
+            18, 21, 26, 66, 99, 99, 99, 99,
+            24, 26, 56, 99, 99, 99, 99, 99,
+            47, 66, 99, 99, 99, 99, 99, 99,
+            99, 99, 99, 99, 99, 99, 99, 99,
+            99, 99, 99, 99, 99, 99, 99, 99,
+            99, 99, 99, 99, 99, 99, 99, 99,
+            99, 99, 99, 99, 99, 99, 99, 99
+        };
+
+        // Annex K 的标准 Huffman 表：各码长的码字个数和符号
+        constexpr uint8_t kDcLumaBits[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+        constexpr uint8_t kDcChromaBits[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+        constexpr uint8_t kDcValues[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+        constexpr uint8_t kAcLumaBits[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D };
+        constexpr uint8_t kAcLumaValues[162] =
+        {
+            0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+            0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+            0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+            0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+            0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+            0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+            0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+            0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+            0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+            0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+            0xF9, 0xFA
+        };
+
+        constexpr uint8_t kAcChromaBits[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+        constexpr uint8_t kAcChromaValues[162] =
+        {
+            0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+            0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+            0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+            0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+            0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+            0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+            0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+            0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+            0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+            0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+            0xF9, 0xFA
+        };
+
+        // 每个块最坏 64 个系数各 27 位，字节填充后不超过 512 字节
+        constexpr size_t kMaxMcuBytes = 6 * 512;
+
+        // 基线 JPEG 的系数不超过 11 位（AC 为 10 位）
+        constexpr int16_t kMaxCoefficient = 1023;
+
+        // AAN 浮点 DCT 的输出缩放，和量化合并成一次乘法
+        constexpr float kAanScale[8] =
+        {
+            1.0f, 1.387039845f, 1.306562965f, 1.175875602f, 1.0f, 0.785694958f, 0.541196100f, 0.275899379f
+        };
+
+        struct HuffmanTable
+        {
+            uint16_t code[256] = {};
+            uint8_t size[256] = {};
+        };
+
+        HuffmanTable BuildHuffmanTable(const uint8_t* bits, const uint8_t* values)
+        {
+            HuffmanTable table;
+            uint32_t code = 0;
+            size_t k = 0;
+            for (uint32_t length = 1; length <= 16; ++length)
+            {
+                for (uint32_t i = 0; i < bits[length - 1]; ++i, ++k)
+                {
+                    table.code[values[k]] = static_cast<uint16_t>(code++);
+                    table.size[values[k]] = static_cast<uint8_t>(length);
+                }
+                code <<= 1;
+            }
+            return table;
+        }
+
+        struct HuffmanTables
+        {
+            HuffmanTable dcLuma = BuildHuffmanTable(kDcLumaBits, kDcValues);
+            HuffmanTable acLuma = BuildHuffmanTable(kAcLumaBits, kAcLumaValues);
+            HuffmanTable dcChroma = BuildHuffmanTable(kDcChromaBits, kDcValues);
+            HuffmanTable acChroma = BuildHuffmanTable(kAcChromaBits, kAcChromaValues);
+        };
+
+        const HuffmanTables& GetHuffmanTables()
+        {
+            static const HuffmanTables tables;
+            return tables;
+        }
+
+        // 按 libjpeg 的质量公式缩放参考表，之字形顺序，供 DQT 段写出
+        void ScaleQuantTable(const uint8_t* base, uint32_t quality, uint8_t* zigzag)
+        {
+            quality = std::clamp(quality, 1u, 100u);
+            const uint32_t scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+            for (int k = 0; k < 64; ++k)
+            {
+                const uint32_t value = (base[kZigzag[k]] * scale + 50) / 100;
+                zigzag[k] = static_cast<uint8_t>(std::clamp(value, 1u, 255u));
+            }
+        }
+
+        // 量化倒数，按 DCT 输出的布局：两遍一维变换后系数 (u, v) 位于 v * 8 + u
+        struct QuantTable
+        {
+            alignas(16) float reciprocal[64];
+            uint8_t zigzag[64];
+        };
+
+        void BuildQuantTable(const uint8_t* base, uint32_t quality, QuantTable& table)
+        {
+            ScaleQuantTable(base, quality, table.zigzag);
+            for (int k = 0; k < 64; ++k)
+            {
+                const int u = kZigzag[k] / 8;
+                const int v = kZigzag[k] % 8;
+                table.reciprocal[v * 8 + u] = 1.0f / (table.zigzag[k] * kAanScale[u] * kAanScale[v] * 8.0f);
+            }
+        }
+
+        // 之字形序号 -> DCT 输出布局中的位置
+        struct ZigzagLayout
+        {
+            uint8_t index[64];
+
+            ZigzagLayout()
+            {
+                for (int k = 0; k < 64; ++k)
+                {
+                    index[k] = static_cast<uint8_t>((kZigzag[k] % 8) * 8 + kZigzag[k] / 8);
+                }
+            }
+        };
+
+        // 一维 AAN DCT，8 个向量的同一通道构成一组输入
+        inline void Dct8(__m128* d)
+        {
+            const __m128 tmp0 = _mm_add_ps(d[0], d[7]);
+            const __m128 tmp7 = _mm_sub_ps(d[0], d[7]);
+            const __m128 tmp1 = _mm_add_ps(d[1], d[6]);
+            const __m128 tmp6 = _mm_sub_ps(d[1], d[6]);
+            const __m128 tmp2 = _mm_add_ps(d[2], d[5]);
+            const __m128 tmp5 = _mm_sub_ps(d[2], d[5]);
+            const __m128 tmp3 = _mm_add_ps(d[3], d[4]);
+            const __m128 tmp4 = _mm_sub_ps(d[3], d[4]);
+
+            // 偶数部分
+            const __m128 tmp10 = _mm_add_ps(tmp0, tmp3);
+            const __m128 tmp13 = _mm_sub_ps(tmp0, tmp3);
+            const __m128 tmp11 = _mm_add_ps(tmp1, tmp2);
+            const __m128 tmp12 = _mm_sub_ps(tmp1, tmp2);
+
+            d[0] = _mm_add_ps(tmp10, tmp11);
+            d[4] = _mm_sub_ps(tmp10, tmp11);
+            const __m128 z1 = _mm_mul_ps(_mm_add_ps(tmp12, tmp13), _mm_set1_ps(0.707106781f));
+            d[2] = _mm_add_ps(tmp13, z1);
+            d[6] = _mm_sub_ps(tmp13, z1);
+
+            // 奇数部分
+            const __m128 odd10 = _mm_add_ps(tmp4, tmp5);
+            const __m128 odd11 = _mm_add_ps(tmp5, tmp6);
+            const __m128 odd12 = _mm_add_ps(tmp6, tmp7);
+
+            const __m128 z5 = _mm_mul_ps(_mm_sub_ps(odd10, odd12), _mm_set1_ps(0.382683433f));
+            const __m128 z2 = _mm_add_ps(_mm_mul_ps(odd10, _mm_set1_ps(0.541196100f)), z5);
+            const __m128 z4 = _mm_add_ps(_mm_mul_ps(odd12, _mm_set1_ps(1.306562965f)), z5);
+            const __m128 z3 = _mm_mul_ps(odd11, _mm_set1_ps(0.707106781f));
+
+            const __m128 z11 = _mm_add_ps(tmp7, z3);
+            const __m128 z13 = _mm_sub_ps(tmp7, z3);
+
+            d[5] = _mm_add_ps(z13, z2);
+            d[3] = _mm_sub_ps(z13, z2);
+            d[1] = _mm_add_ps(z11, z4);
+            d[7] = _mm_sub_ps(z11, z4);
+        }
+
+        // 8x8 浮点块（行优先，已减去 128）做二维 DCT 并量化，结果按 DCT 输出布局写入 coefficients
+        void ForwardDctQuantize(const float* block, const float* reciprocal, int16_t* coefficients)
+        {
+            // left[r] / right[r] 为第 r 行的前 4 列和后 4 列
+            __m128 left[8], right[8];
+            for (int r = 0; r < 8; ++r)
+            {
+                left[r] = _mm_load_ps(block + r * 8);
+                right[r] = _mm_load_ps(block + r * 8 + 4);
+            }
+
+            // 列变换：每个通道是一列
+            Dct8(left);
+            Dct8(right);
+
+            // 转置后再做一遍，每个通道变成一行
+            _MM_TRANSPOSE4_PS(left[0], left[1], left[2], left[3]);
+            _MM_TRANSPOSE4_PS(left[4], left[5], left[6], left[7]);
+            _MM_TRANSPOSE4_PS(right[0], right[1], right[2], right[3]);
+            _MM_TRANSPOSE4_PS(right[4], right[5], right[6], right[7]);
+            __m128 top[8] = { left[0], left[1], left[2], left[3], right[0], right[1], right[2], right[3] };
+            __m128 bottom[8] = { left[4], left[5], left[6], left[7], right[4], right[5], right[6], right[7] };
+            Dct8(top);
+            Dct8(bottom);
+
+            // top[v] 是水平频率 v、垂直频率 0~3，bottom[v] 是垂直频率 4~7
+            const __m128i low = _mm_set1_epi16(-kMaxCoefficient);
+            const __m128i high = _mm_set1_epi16(kMaxCoefficient);
+            for (int v = 0; v < 8; ++v)
+            {
+                const __m128i a = _mm_cvtps_epi32(_mm_mul_ps(top[v], _mm_load_ps(reciprocal + v * 8)));
+                const __m128i b = _mm_cvtps_epi32(_mm_mul_ps(bottom[v], _mm_load_ps(reciprocal + v * 8 + 4)));
+                const __m128i packed = _mm_min_epi16(_mm_max_epi16(_mm_packs_epi32(a, b), low), high);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(coefficients + v * 8), packed);
+            }
+        }
+
+        // 4 个像素的三个通道，c0 为内存中的第一个字节
+        inline void LoadChannels(const uint8_t* src, bool bgra, __m128& r, __m128& g, __m128& b)
+        {
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            const __m128 c0 = _mm_cvtepi32_ps(_mm_and_si128(pixels, mask));
+            const __m128 c2 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), mask));
+            g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), mask));
+            r = bgra ? c2 : c0;
+            b = bgra ? c0 : c2;
+        }
+
+        inline __m128 ToLuma(__m128 r, __m128 g, __m128 b)
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(0.299f)), _mm_mul_ps(g, _mm_set1_ps(0.587f))),
+                _mm_sub_ps(_mm_mul_ps(b, _mm_set1_ps(0.114f)), _mm_set1_ps(128.0f)));
+        }
+
+        // 相邻两个通道相加：(a0+a1, a2+a3, b0+b1, b2+b3)
+        inline __m128 PairSum(__m128 a, __m128 b)
+        {
+            return _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+
+        struct McuBlocks
+        {
+            alignas(16) float y[4][64];     // 左上、右上、左下、右下
+            alignas(16) float cb[64];
+            alignas(16) float cr[64];
+        };
+
+        // 16 行像素转换成 JFIF 全范围 YCbCr，色度取 2x2 平均。rows 每行至少 16 个像素
+        void ConvertMcu(const uint8_t* const* rows, bool bgra, McuBlocks& mcu)
+        {
+            for (int y = 0; y < 16; y += 2)
+            {
+                const int chromaOffset = (y / 2) * 8;
+                for (int x = 0; x < 16; x += 8)
+                {
+                    // 两行各 8 个像素，分两组 4 个
+                    float* luma = mcu.y[(y / 8) * 2 + x / 8] + (y % 8) * 8;
+                    __m128 sumR[2], sumG[2], sumB[2];
+                    for (int half = 0; half < 2; ++half)
+                    {
+                        __m128 r0, g0, b0, r1, g1, b1;
+                        LoadChannels(rows[y] + (x + half * 4) * 4, bgra, r0, g0, b0);
+                        LoadChannels(rows[y + 1] + (x + half * 4) * 4, bgra, r1, g1, b1);
+
+                        _mm_store_ps(luma + half * 4, ToLuma(r0, g0, b0));
+                        _mm_store_ps(luma + half * 4 + 8, ToLuma(r1, g1, b1));
+
+                        sumR[half] = _mm_add_ps(r0, r1);
+                        sumG[half] = _mm_add_ps(g0, g1);
+                        sumB[half] = _mm_add_ps(b0, b1);
+                    }
+
+                    const __m128 quarter = _mm_set1_ps(0.25f);
+                    const __m128 r = _mm_mul_ps(PairSum(sumR[0], sumR[1]), quarter);
+                    const __m128 g = _mm_mul_ps(PairSum(sumG[0], sumG[1]), quarter);
+                    const __m128 b = _mm_mul_ps(PairSum(sumB[0], sumB[1]), quarter);
+
+                    const __m128 cb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(-0.168736f)), _mm_mul_ps(g, _mm_set1_ps(-0.331264f))),
+                        _mm_mul_ps(b, _mm_set1_ps(0.5f)));
+                    const __m128 cr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(0.5f)), _mm_mul_ps(g, _mm_set1_ps(-0.418688f))),
+                        _mm_mul_ps(b, _mm_set1_ps(-0.081312f)));
+                    _mm_store_ps(mcu.cb + chromaOffset + x / 2, cb);
+                    _mm_store_ps(mcu.cr + chromaOffset + x / 2, cr);
+                }
+            }
+        }
+
+        // 熵编码输出，自动在 0xFF 后插入 0x00
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& output)
+                : m_output(output)
+            {
+            }
+
+            // 保证还能写入 bytes 字节
+            void Reserve(size_t bytes)
+            {
+                if (m_output.size() - m_size < bytes)
+                {
+                    m_output.resize((std::max)(m_output.size() * 2, m_size + bytes));
+                }
+            }
+
+            void Put(uint32_t bits, uint32_t count)
+            {
+                m_buffer = (m_buffer << count) | bits;
+                m_count += count;
+                if (m_count >= 32)
+                {
+                    Drain();
+                }
+            }
+
+            // 剩余位用 1 填满一个字节
+            void Finish()
+            {
+                const uint32_t pad = (8 - m_count % 8) % 8;
+                Put((1u << pad) - 1, pad);
+                Drain();
+                m_output.resize(m_size);
+            }
+
+        private:
+            void Drain()
+            {
+                uint8_t* out = m_output.data();
+                while (m_count >= 8)
+                {
+                    m_count -= 8;
+                    const uint8_t byte = static_cast<uint8_t>(m_buffer >> m_count);
+                    out[m_size++] = byte;
+                    if (byte == 0xFF)
+                    {
+                        out[m_size++] = 0;
+                    }
+                }
+            }
+
+            std::vector<uint8_t>& m_output;
+            size_t m_size = 0;
+            uint64_t m_buffer = 0;
+            uint32_t m_count = 0;
+        };
+
+        inline void PutValue(BitWriter& writer, const HuffmanTable& table, uint32_t run, int value)
+        {
+            const uint32_t magnitude = static_cast<uint32_t>(value < 0 ? -value : value);
+            const uint32_t category = static_cast<uint32_t>(std::bit_width(magnitude));
+            const uint32_t symbol = (run << 4) | category;
+            // 负数写成 value - 1 的低 category 位
+            const uint32_t bits = static_cast<uint32_t>(value < 0 ? value - 1 : value) & ((1u << category) - 1);
+            writer.Put((static_cast<uint32_t>(table.code[symbol]) << category) | bits, table.size[symbol] + category);
+        }
+
+        void EncodeBlock(BitWriter& writer, const float* block, const float* reciprocal, const ZigzagLayout& layout,
+            const HuffmanTable& dc, const HuffmanTable& ac, int& previousDc)
+        {
+            alignas(16) int16_t coefficients[64];
+            ForwardDctQuantize(block, reciprocal, coefficients);
+
+            alignas(16) int16_t zigzag[64];
+            for (int k = 0; k < 64; ++k)
+            {
+                zigzag[k] = coefficients[layout.index[k]];
+            }
+
+            // 非零系数位图，按位跳过零系数
+            uint64_t nonzero = 0;
+            const __m128i zero = _mm_setzero_si128();
+            for (int i = 0; i < 8; ++i)
+            {
+                const __m128i values = _mm_load_si128(reinterpret_cast<const __m128i*>(zigzag + i * 8));
+                const __m128i equal = _mm_cmpeq_epi16(values, zero);
+                const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(equal, equal))) & 0xFF;
+                nonzero |= static_cast<uint64_t>(~mask & 0xFF) << (i * 8);
+            }
+
+            const int diff = zigzag[0] - previousDc;
+            previousDc = zigzag[0];
+            PutValue(writer, dc, 0, diff);
+
+            nonzero &= ~1ull;
+            int last = 0;
+            while (nonzero)
+            {
+                const int k = std::countr_zero(nonzero);
+                nonzero &= nonzero - 1;
+                uint32_t run = static_cast<uint32_t>(k - last - 1);
+                while (run >= 16)
+                {
+                    writer.Put(ac.code[0xF0], ac.size[0xF0]);
+                    run -= 16;
+                }
+                PutValue(writer, ac, run, zigzag[k]);
+                last = k;
+            }
+            if (last != 63)
+            {
+                writer.Put(ac.code[0x00], ac.size[0x00]);
+            }
+        }
+
+        void PutMarker(std::vector<uint8_t>& out, uint8_t marker, uint32_t length)
+        {
+            out.push_back(0xFF);
+            out.push_back(marker);
+            if (length > 0)
+            {
+                out.push_back(static_cast<uint8_t>(length >> 8));
+                out.push_back(static_cast<uint8_t>(length));
+            }
+        }
+
+        void PutU16BE(std::vector<uint8_t>& out, uint32_t value)
+        {
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        void PutHuffmanTable(std::vector<uint8_t>& out, uint8_t id, const uint8_t* bits, const uint8_t* values, size_t count)
+        {
+            out.push_back(id);
+            out.insert(out.end(), bits, bits + 16);
+            out.insert(out.end(), values, values + count);
+        }
+
+        void WriteHeaders(std::vector<uint8_t>& out, uint32_t width, uint32_t height, uint32_t restartInterval,
+            const QuantTable& luma, const QuantTable& chroma)
+        {
+            PutMarker(out, 0xD8, 0);                    // SOI
+
+            static constexpr uint8_t kJfif[14] = { 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 };
+            PutMarker(out, 0xE0, 2 + sizeof(kJfif));    // APP0
+            out.insert(out.end(), kJfif, kJfif + sizeof(kJfif));
+
+            PutMarker(out, 0xDB, 2 + 2 * 65);           // DQT
+            out.push_back(0);
+            out.insert(out.end(), luma.zigzag, luma.zigzag + 64);
+            out.push_back(1);
+            out.insert(out.end(), chroma.zigzag, chroma.zigzag + 64);
+
+            PutMarker(out, 0xC0, 2 + 6 + 3 * 3);        // SOF0
+            out.push_back(8);
+            PutU16BE(out, height);
+            PutU16BE(out, width);
+            out.push_back(3);
+            const uint8_t components[9] = { 1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1 };
+            out.insert(out.end(), components, components + 9);
+
+            PutMarker(out, 0xC4, 2 + 4 * 17 + 2 * 12 + 2 * 162);   // DHT
+            PutHuffmanTable(out, 0x00, kDcLumaBits, kDcValues, 12);
+            PutHuffmanTable(out, 0x10, kAcLumaBits, kAcLumaValues, 162);
+            PutHuffmanTable(out, 0x01, kDcChromaBits, kDcValues, 12);
+            PutHuffmanTable(out, 0x11, kAcChromaBits, kAcChromaValues, 162);
+
+            PutMarker(out, 0xDD, 4);                    // DRI
+            PutU16BE(out, restartInterval);
+
+            PutMarker(out, 0xDA, 2 + 1 + 3 * 2 + 3);    // SOS
+            const uint8_t scan[10] = { 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0 };
+            out.insert(out.end(), scan, scan + 10);
+        }
+    }
+
+    bool EncodeJpeg(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height, bool bgra,
+        uint32_t quality, ThreadPool& pool, std::vector<uint8_t>& output)
+    {
+        if (width > 65535 || height > 65535)
+        {
+            LOG_ERROR("Image too large for JPEG: {}x{}", width, height);
+            return false;
+        }
+
+        QuantTable luma, chroma;
+        BuildQuantTable(kLumaQuant, quality, luma);
+        BuildQuantTable(kChromaQuant, quality, chroma);
+        const HuffmanTables& huffman = GetHuffmanTables();
+        static const ZigzagLayout layout;
+
+        const uint32_t mcusX = (width + 15) / 16;
+        const uint32_t mcusY = (height + 15) / 16;
+        std::vector<std::vector<uint8_t>> slices(mcusY);
+
+        pool.ParallelFor(mcusY, 1, [&](uint32_t begin, uint32_t end)
+        {
+            McuBlocks mcu;
+            uint8_t edge[16 * 16 * 4];
+            const uint8_t* rows[16];
+
+            for (uint32_t my = begin; my < end; ++my)
+            {
+                auto& slice = slices[my];
+                slice.clear();
+                BitWriter writer(slice);
+                int dcY = 0, dcCb = 0, dcCr = 0;
+
+                for (uint32_t mx = 0; mx < mcusX; ++mx)
+                {
+                    // 超出图像的部分复制边缘像素
+                    const uint32_t x0 = mx * 16;
+                    const uint32_t columns = (std::min)(16u, width - x0);
+                    for (uint32_t i = 0; i < 16; ++i)
+                    {
+                        const uint32_t y = (std::min)(my * 16 + i, height - 1);
+                        const uint8_t* src = pixels + static_cast<size_t>(y) * stride + static_cast<size_t>(x0) * 4;
+                        if (columns == 16)
+                        {
+                            rows[i] = src;
+                            continue;
+                        }
+
+                        uint8_t* dst = edge + i * 64;
+                        std::memcpy(dst, src, columns * 4);
+                        for (uint32_t x = columns; x < 16; ++x)
+                        {
+                            std::memcpy(dst + x * 4, src + (columns - 1) * 4, 4);
+                        }
+                        rows[i] = dst;
+                    }
+
+                    ConvertMcu(rows, bgra, mcu);
+
+                    writer.Reserve(kMaxMcuBytes);
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        EncodeBlock(writer, mcu.y[i], luma.reciprocal, layout, huffman.dcLuma, huffman.acLuma, dcY);
+                    }
+                    EncodeBlock(writer, mcu.cb, chroma.reciprocal, layout, huffman.dcChroma, huffman.acChroma, dcCb);
+                    EncodeBlock(writer, mcu.cr, chroma.reciprocal, layout, huffman.dcChroma, huffman.acChroma, dcCr);
+                }
+                writer.Finish();
+            }
+        });
+
+        size_t total = 1024;
+        for (const auto& slice : slices)
+        {
+            total += slice.size() + 2;
+        }
+
+        output.clear();
+        output.reserve(total);
+        WriteHeaders(output, width, height, mcusX, luma, chroma);
+        for (uint32_t i = 0; i < mcusY; ++i)
+        {
+            output.insert(output.end(), slices[i].begin(), slices[i].end());
+            if (i + 1 < mcusY)
+            {
+                PutMarker(output, static_cast<uint8_t>(0xD0 + (i & 7)), 0);    // RSTn
+            }
+        }
+        PutMarker(output, 0xD9, 0);                     // EOI
+        return true;
+    }
+}
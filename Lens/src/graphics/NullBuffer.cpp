@@ -0,0 +1,35 @@
+﻿#include "LensPch.h"
+#include "graphics/NullBuffer.h"
+
+namespace lens::graphics 
+{
+
+    bool NullBuffer::Create(GraphicsDevice* device, const Desc& desc, const void* initialData) 
+    {
+        m_desc = desc;
+        m_data.assign(desc.size, 0);
+        if (initialData)
+        {
+            memcpy(m_data.data(), initialData, desc.size);
+        }
+        return true;
+    }
+
+    void NullBuffer::UpdateData(GraphicsDevice* device, const void* data, size_t size, size_t offset) 
+    {
+        if (offset < m_data.size())
+        {
+            memcpy(m_data.data() + offset, data, (std::min)(size, m_data.size() - offset));
+        }
+    }
+
+    MappedData NullBuffer::Map(GraphicsDevice* device, MapMode mode) 
+    {
+        MappedData mapped;
+        mapped.data = m_data.data();
+        mapped.rowPitch = static_cast<uint32_t>(m_data.size());
+        mapped.depthPitch = mapped.rowPitch;
+        return mapped;
+    }
+
+}
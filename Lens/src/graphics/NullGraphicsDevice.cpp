@@ -0,0 +1,46 @@
+﻿#include "LensPch.h"
+#include "graphics/NullGraphicsDevice.h"
+#include "graphics/NullBuffer.h"
+#include "graphics/NullShader.h"
+#include "graphics/NullTexture.h"
+
+namespace lens::graphics
+{
+    NullGraphicsDevice::~NullGraphicsDevice()
+    {
+        m_releaseQueue.Flush();
+    }
+
+    bool NullGraphicsDevice::Initialize(const Desc& desc)
+    {
+        SetViewport(0.0f, 0.0f, static_cast<float>(desc.width), static_cast<float>(desc.height));
+        LOG_INFO("Null graphics device initialized: {}x{}", desc.width, desc.height);
+        return true;
+    }
+
+    void NullGraphicsDevice::Resize(uint32_t width, uint32_t height)
+    {
+        SetViewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+    }
+
+    std::unique_ptr<Texture> NullGraphicsDevice::CreateTexture()
+    {
+        return std::make_unique<NullTexture>();
+    }
+
+    std::unique_ptr<Buffer> NullGraphicsDevice::CreateBuffer()
+    {
+        return std::make_unique<NullBuffer>();
+    }
+
+    std::unique_ptr<Shader> NullGraphicsDevice::CreateShader()
+    {
+        return std::make_unique<NullShader>();
+    }
+
+    void NullGraphicsDevice::SetViewport(float x, float y, float width, float height, float minDepth, float maxDepth)
+    {
+        m_width = static_cast<uint32_t>(width);
+        m_height = static_cast<uint32_t>(height);
+    }
+}
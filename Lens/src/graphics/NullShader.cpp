@@ -0,0 +1,25 @@
+﻿#include "LensPch.h"
+#include "graphics/NullShader.h"
+
+namespace lens::graphics 
+{
+
+    bool NullShader::LoadVertexShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size)
+    {
+        m_stages |= kVertexStage;
+        return true;
+    }
+
+    bool NullShader::LoadPixelShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size)
+    {
+        m_stages |= kPixelStage;
+        return true;
+    }
+
+    bool NullShader::LoadComputeShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size)
+    {
+        m_stages |= kComputeStage;
+        return true;
+    }
+
+}
@@ -0,0 +1,109 @@
+﻿#include "LensPch.h"
+#include "graphics/NullTexture.h"
+
+namespace lens::graphics
+{
+    bool NullTexture::Create(GraphicsDevice* device, const Desc& desc)
+    {
+        m_desc = desc;
+
+        if (GetFormatBytesPerPixel(desc.format) == 0 || desc.width == 0 || desc.height == 0)
+        {
+            LOG_ERROR("Unsupported texture for null backend: {}x{}", desc.width, desc.height);
+            return false;
+        }
+        m_image.Allocate(desc.width, desc.height, desc.format);
+        return true;
+    }
+
+    bool NullTexture::CreateFromMemory(GraphicsDevice* device, const Desc& desc, const void* data)
+    {
+        if (!Create(device, desc))
+        {
+            return false;
+        }
+
+        if (data)
+        {
+            UpdateData(device, data, m_image.GetSizeInBytes());
+        }
+        return true;
+    }
+
+    bool NullTexture::CopyFrom(GraphicsDevice* device, const Texture& source)
+    {
+        const CpuImage& src = static_cast<const NullTexture&>(source).GetImage();
+        if (m_image.IsEmpty() || src.IsEmpty())
+        {
+            LOG_ERROR("CopyFrom called with null texture");
+            return false;
+        }
+        if (src.width < m_desc.width || src.height < m_desc.height || src.format != m_desc.format)
+        {
+            LOG_ERROR("CopyFrom size/format mismatch: {}x{} -> {}x{}",
+                src.width, src.height, m_desc.width, m_desc.height);
+            return false;
+        }
+
+        for (uint32_t y = 0; y < m_image.height; ++y)
+        {
+            memcpy(m_image.Row(y), src.Row(y), m_image.rowPitch);
+        }
+        return true;
+    }
+
+    void NullTexture::UpdateData(GraphicsDevice* device, const void* data, size_t size, uint32_t mipLevel)
+    {
+        // 只保存第 0 级，源数据按紧密排列的行处理
+        if (mipLevel == 0)
+        {
+            memcpy(m_image.pixels.data(), data, (std::min)(size, m_image.GetSizeInBytes()));
+        }
+    }
+
+    void NullTexture::UpdateRegion(GraphicsDevice* device, const void* data, uint32_t rowPitch,
+        uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+    {
+        const uint32_t right = (std::min)(x + width, m_desc.width);
+        const uint32_t bottom = (std::min)(y + height, m_desc.height);
+        if (right <= x || bottom <= y)
+            return;
+
+        const size_t offset = static_cast<size_t>(x) * GetFormatBytesPerPixel(m_desc.format);
+        const size_t rowBytes = static_cast<size_t>(right - x) * GetFormatBytesPerPixel(m_desc.format);
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        for (uint32_t row = y; row < bottom; ++row)
+        {
+            memcpy(m_image.Row(row) + offset, src, rowBytes);
+            src += rowPitch;
+        }
+    }
+
+    MappedData NullTexture::Map(GraphicsDevice* device, uint32_t mipLevel, MapMode mode)
+    {
+        MappedData mapped;
+        if (mipLevel == 0 && !m_image.IsEmpty())
+        {
+            mapped.data = m_image.pixels.data();
+            mapped.rowPitch = m_image.rowPitch;
+            mapped.depthPitch = static_cast<uint32_t>(m_image.GetSizeInBytes());
+        }
+        return mapped;
+    }
+
+    bool NullTexture::SaveToFile(GraphicsDevice* device, const char* filename, const ImageEncodeOptions& options)
+    {
+        if (m_image.IsEmpty())
+        {
+            LOG_ERROR("No texture to save");
+            return false;
+        }
+        if (!SaveImage(filename, m_image, options))
+        {
+            LOG_ERROR("Failed to save texture to {}", filename);
+            return false;
+        }
+        LOG_INFO("Texture saved to {}", filename);
+        return true;
+    }
+}
@@ -0,0 +1,334 @@
+﻿#include "LensPch.h"
+#include "graphics/PixelConvert.h"
+#include "graphics/PixelConvertKernels.h"
+#include <atomic>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace lens::graphics
+{
+    namespace detail
+    {
+        void SwapRBScalar(const uint8_t* src, uint8_t* dst, uint32_t width)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint8_t b = src[x * 4 + 0];
+                uint8_t g = src[x * 4 + 1];
+                uint8_t r = src[x * 4 + 2];
+                uint8_t a = src[x * 4 + 3];
+                dst[x * 4 + 0] = r;
+                dst[x * 4 + 1] = g;
+                dst[x * 4 + 2] = b;
+                dst[x * 4 + 3] = a;
+            }
+        }
+
+        void BGRAToGrayScalar(const uint8_t* src, uint8_t* dst, uint32_t width)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const uint8_t* p = src + x * 4;
+                dst[x] = static_cast<uint8_t>((kGrayB * p[0] + kGrayG * p[1] + kGrayR * p[2] + 128) >> 8);
+            }
+        }
+
+        void BGRAToLumaScalar(const uint8_t* src, uint8_t* dst, uint32_t width)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const uint8_t* p = src + x * 4;
+                dst[x] = static_cast<uint8_t>(((kLumaB * p[0] + kLumaG * p[1] + kLumaR * p[2] + 128) >> 8) + 16);
+            }
+        }
+
+        void BGRAToChromaScalar(const uint8_t* row0, const uint8_t* row1, uint8_t* u, uint8_t* v, uint32_t width)
+        {
+            const uint32_t chromaWidth = (width + 1) / 2;
+            for (uint32_t c = 0; c < chromaWidth; ++c)
+            {
+                const uint32_t x0 = c * 2;
+                const uint32_t x1 = (std::min)(x0 + 1, width - 1);
+
+                // 2x2 的和，系数除以 4 合并进最后的移位
+                int sum[3];
+                for (int ch = 0; ch < 3; ++ch)
+                {
+                    sum[ch] = row0[x0 * 4 + ch] + row0[x1 * 4 + ch] + row1[x0 * 4 + ch] + row1[x1 * 4 + ch];
+                }
+                u[c] = static_cast<uint8_t>(((kUB * sum[0] + kUG * sum[1] + kUR * sum[2] + 512) >> 10) + 128);
+                v[c] = static_cast<uint8_t>(((kVB * sum[0] + kVG * sum[1] + kVR * sum[2] + 512) >> 10) + 128);
+            }
+        }
+
+        void InterleaveUVScalar(const uint8_t* u, const uint8_t* v, uint8_t* uv, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uv[i * 2 + 0] = u[i];
+                uv[i * 2 + 1] = v[i];
+            }
+        }
+
+        void RGBA32FToRGBA8Scalar(const float* src, uint8_t* dst, uint32_t width)
+        {
+            for (uint32_t i = 0; i < width * 4; ++i)
+            {
+                // 比较顺序与 minps/maxps 一致，NaN 得到 1
+                float f = src[i] < 1.0f ? src[i] : 1.0f;
+                f = f > 0.0f ? f : 0.0f;
+                dst[i] = static_cast<uint8_t>(static_cast<int32_t>(f * 255.0f + 0.5f));
+            }
+        }
+
+        const PixelConvertKernels kScalarKernels =
+        {
+            &SwapRBScalar,
+            &BGRAToGrayScalar,
+            &BGRAToLumaScalar,
+            &BGRAToChromaScalar,
+            &InterleaveUVScalar,
+            &RGBA32FToRGBA8Scalar,
+        };
+    }
+
+    namespace
+    {
+        void Cpuid(int regs[4], int leaf, int subleaf)
+        {
+#if defined(_MSC_VER)
+            __cpuidex(regs, leaf, subleaf);
+#else
+            unsigned int a, b, c, d;
+            __cpuid_count(leaf, subleaf, a, b, c, d);
+            regs[0] = static_cast<int>(a);
+            regs[1] = static_cast<int>(b);
+            regs[2] = static_cast<int>(c);
+            regs[3] = static_cast<int>(d);
+#endif
+        }
+
+        uint64_t ReadXcr0()
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t lo, hi;
+            __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+        }
+
+        const detail::PixelConvertKernels* GetKernelsForIsa(CpuIsa isa)
+        {
+            switch (isa)
+            {
+            case CpuIsa::AVX512: return &detail::kAVX512Kernels;
+            case CpuIsa::AVX2:   return &detail::kAVX2Kernels;
+            case CpuIsa::SSE2:   return &detail::kSSE2Kernels;
+            default:             return &detail::kScalarKernels;
+            }
+        }
+
+        std::atomic<int> g_isa{ -1 };
+
+        const detail::PixelConvertKernels& GetKernels()
+        {
+            return *GetKernelsForIsa(GetPixelConvertIsa());
+        }
+    }
+
+    CpuIsa DetectCpuIsa()
+    {
+        static const CpuIsa detected = []
+        {
+            int regs[4];
+            Cpuid(regs, 0, 0);
+            const int maxLeaf = regs[0];
+
+            Cpuid(regs, 1, 0);
+            const bool sse2 = (regs[3] & (1 << 26)) != 0;
+            const bool osxsave = (regs[2] & (1 << 27)) != 0;
+            const bool avx = (regs[2] & (1 << 28)) != 0;
+            if (!sse2)
+                return CpuIsa::Scalar;
+
+            // AVX 系列还需要操作系统保存对应的寄存器状态
+            const uint64_t xcr0 = osxsave ? ReadXcr0() : 0;
+            const bool osAvx = (xcr0 & 0x6) == 0x6;
+            const bool osAvx512 = (xcr0 & 0xE6) == 0xE6;
+
+            if (maxLeaf < 7 || !avx || !osAvx)
+                return CpuIsa::SSE2;
+
+            Cpuid(regs, 7, 0);
+            const bool avx2 = (regs[1] & (1 << 5)) != 0;
+            const bool avx512f = (regs[1] & (1 << 16)) != 0;
+            const bool avx512bw = (regs[1] & (1 << 30)) != 0;
+
+            if (avx512f && avx512bw && osAvx512)
+                return CpuIsa::AVX512;
+            if (avx2)
+                return CpuIsa::AVX2;
+            return CpuIsa::SSE2;
+        }();
+        return detected;
+    }
+
+    const char* GetCpuIsaName(CpuIsa isa)
+    {
+        switch (isa)
+        {
+        case CpuIsa::Scalar: return "scalar";
+        case CpuIsa::SSE2:   return "SSE2";
+        case CpuIsa::AVX2:   return "AVX2";
+        case CpuIsa::AVX512: return "AVX-512";
+        default:             return "unknown";
+        }
+    }
+
+    CpuIsa GetPixelConvertIsa()
+    {
+        int isa = g_isa.load(std::memory_order_relaxed);
+        if (isa < 0)
+        {
+            isa = static_cast<int>(DetectCpuIsa());
+            g_isa.store(isa, std::memory_order_relaxed);
+        }
+        return static_cast<CpuIsa>(isa);
+    }
+
+    void SetPixelConvertIsa(CpuIsa isa)
+    {
+        CpuIsa detected = DetectCpuIsa();
+        if (static_cast<int>(isa) > static_cast<int>(detected))
+        {
+            isa = detected;
+        }
+        g_isa.store(static_cast<int>(isa), std::memory_order_relaxed);
+    }
+
+    void ConvertBGRAToRGBA(const uint8_t* src, uint32_t srcStride, uint8_t* dst, uint32_t dstStride,
+        uint32_t width, uint32_t height)
+    {
+        const auto& kernels = GetKernels();
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            kernels.swapRB(src + static_cast<size_t>(y) * srcStride, dst + static_cast<size_t>(y) * dstStride, width);
+        }
+    }
+
+    void ConvertBGRAToGray(const uint8_t* src, uint32_t srcStride, uint8_t* dst, uint32_t dstStride,
+        uint32_t width, uint32_t height)
+    {
+        const auto& kernels = GetKernels();
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            kernels.bgraToGray(src + static_cast<size_t>(y) * srcStride, dst + static_cast<size_t>(y) * dstStride, width);
+        }
+    }
+
+    void ConvertBGRAToI420(const uint8_t* src, uint32_t srcStride,
+        uint8_t* y, uint32_t yStride, uint8_t* u, uint32_t uStride, uint8_t* v, uint32_t vStride,
+        uint32_t width, uint32_t height)
+    {
+        const auto& kernels = GetKernels();
+        for (uint32_t row = 0; row < height; row += 2)
+        {
+            const uint8_t* row0 = src + static_cast<size_t>(row) * srcStride;
+            const uint8_t* row1 = row + 1 < height ? row0 + srcStride : row0;
+
+            kernels.bgraToLuma(row0, y + static_cast<size_t>(row) * yStride, width);
+            if (row + 1 < height)
+            {
+                kernels.bgraToLuma(row1, y + static_cast<size_t>(row + 1) * yStride, width);
+            }
+            kernels.bgraToChroma(row0, row1,
+                u + static_cast<size_t>(row / 2) * uStride, v + static_cast<size_t>(row / 2) * vStride, width);
+        }
+    }
+
+    void ConvertBGRAToNV12(const uint8_t* src, uint32_t srcStride,
+        uint8_t* y, uint32_t yStride, uint8_t* uv, uint32_t uvStride,
+        uint32_t width, uint32_t height)
+    {
+        const auto& kernels = GetKernels();
+        const uint32_t chromaWidth = (width + 1) / 2;
+        std::vector<uint8_t> planar(static_cast<size_t>(chromaWidth) * 2);
+
+        for (uint32_t row = 0; row < height; row += 2)
+        {
+            const uint8_t* row0 = src + static_cast<size_t>(row) * srcStride;
+            const uint8_t* row1 = row + 1 < height ? row0 + srcStride : row0;
+
+            kernels.bgraToLuma(row0, y + static_cast<size_t>(row) * yStride, width);
+            if (row + 1 < height)
+            {
+                kernels.bgraToLuma(row1, y + static_cast<size_t>(row + 1) * yStride, width);
+            }
+
+            // 先生成平面的 U、V，再交织成 UV
+            kernels.bgraToChroma(row0, row1, planar.data(), planar.data() + chromaWidth, width);
+            kernels.interleaveUV(planar.data(), planar.data() + chromaWidth,
+                uv + static_cast<size_t>(row / 2) * uvStride, chromaWidth);
+        }
+    }
+
+    void ConvertRGBA32FToRGBA8(const uint8_t* src, uint32_t srcStride, uint8_t* dst, uint32_t dstStride,
+        uint32_t width, uint32_t height)
+    {
+        const auto& kernels = GetKernels();
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            kernels.rgba32fToRgba8(reinterpret_cast<const float*>(src + static_cast<size_t>(y) * srcStride),
+                dst + static_cast<size_t>(y) * dstStride, width);
+        }
+    }
+
+    bool ConvertImage(const CpuImage& src, TextureFormat dstFormat, CpuImage& dst)
+    {
+        const bool srcIs8Bit = src.format == TextureFormat::BGRA8_UNorm || src.format == TextureFormat::RGBA8_UNorm;
+        const bool dstIs8Bit = dstFormat == TextureFormat::BGRA8_UNorm || dstFormat == TextureFormat::RGBA8_UNorm;
+        const bool inPlace = &dst == &src;
+
+        if (src.format == dstFormat)
+        {
+            if (!inPlace)
+            {
+                dst = src;
+            }
+            return true;
+        }
+
+        if (srcIs8Bit && dstIs8Bit)
+        {
+            if (!inPlace)
+            {
+                dst.Allocate(src.width, src.height, dstFormat);
+            }
+            ConvertBGRAToRGBA(src.pixels.data(), src.rowPitch, dst.pixels.data(), dst.rowPitch, src.width, src.height);
+            dst.format = dstFormat;
+            return true;
+        }
+
+        // 32 位浮点转 8 位，尺寸不同不能原地进行
+        if (src.format == TextureFormat::RGBA32_Float && dstIs8Bit && !inPlace)
+        {
+            dst.Allocate(src.width, src.height, dstFormat);
+            ConvertRGBA32FToRGBA8(src.pixels.data(), src.rowPitch, dst.pixels.data(), dst.rowPitch, src.width, src.height);
+            if (dstFormat == TextureFormat::BGRA8_UNorm)
+            {
+                ConvertRGBAToBGRA(dst.pixels.data(), dst.rowPitch, dst.pixels.data(), dst.rowPitch, dst.width, dst.height);
+            }
+            return true;
+        }
+
+        LOG_ERROR("Unsupported pixel conversion: {} -> {}{}",
+            static_cast<int>(src.format), static_cast<int>(dstFormat), inPlace ? " (in place)" : "");
+        return false;
+    }
+}
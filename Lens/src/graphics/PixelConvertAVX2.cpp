@@ -0,0 +1,194 @@
+﻿#include "graphics/PixelConvertKernels.h"
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+// 本文件以 /arch:AVX2 编译，只在运行时检测到 AVX2 后才会被调用
+// 不包含预编译头和其他项目头文件：那里的内联函数在这里会按 AVX 指令生成，链接器可能选中这一份
+namespace lens::graphics::detail
+{
+    namespace
+    {
+        // 8 个 BGRA 像素的加权和，按像素顺序输出 8 个 int32
+        inline __m256i WeightedSum8(__m256i pixels, __m256i weights)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(pixels, zero), weights);
+            __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(pixels, zero), weights);
+            __m256 even = _mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 odd = _mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(3, 1, 3, 1));
+            return _mm256_add_epi32(_mm256_castps_si256(even), _mm256_castps_si256(odd));
+        }
+
+        // 4 组各 8 个 int32 打包成 32 个字节；打包指令按 128 位通道工作，最后重排回顺序
+        inline __m256i PackBytes(__m256i a, __m256i b, __m256i c, __m256i d)
+        {
+            __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+            return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        }
+
+        template<int Bias, int Shift, int Offset>
+        void WeightedRow(const uint8_t* src, uint8_t* dst, uint32_t width, __m256i weights)
+        {
+            const __m256i bias = _mm256_set1_epi32(Bias);
+            const __m256i offset = _mm256_set1_epi32(Offset);
+
+            uint32_t x = 0;
+            for (; x + 32 <= width; x += 32)
+            {
+                __m256i sums[4];
+                for (int i = 0; i < 4; ++i)
+                {
+                    __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (x + i * 8) * 4));
+                    sums[i] = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(WeightedSum8(pixels, weights), bias), Shift), offset);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), PackBytes(sums[0], sums[1], sums[2], sums[3]));
+            }
+            if (x < width)
+            {
+                if (Offset == 0)
+                    BGRAToGrayScalar(src + x * 4, dst + x, width - x);
+                else
+                    BGRAToLumaScalar(src + x * 4, dst + x, width - x);
+            }
+        }
+
+        // 两行各 8 个像素 -> 4 个色度样本的四项和，按样本顺序
+        inline __m256i ChromaSums(const uint8_t* row0, const uint8_t* row1)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1));
+            __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+            __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+            return _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+        }
+
+        // 8 个色度样本的四项和 -> 8 个 int32 色度值，按样本顺序
+        inline __m256i ChromaValue(__m256i sums0, __m256i sums1, __m256i weights)
+        {
+            __m256i m0 = _mm256_madd_epi16(sums0, weights);
+            __m256i m1 = _mm256_madd_epi16(sums1, weights);
+            __m256 even = _mm256_shuffle_ps(_mm256_castsi256_ps(m0), _mm256_castsi256_ps(m1), _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 odd = _mm256_shuffle_ps(_mm256_castsi256_ps(m0), _mm256_castsi256_ps(m1), _MM_SHUFFLE(3, 1, 3, 1));
+            __m256i sum = _mm256_add_epi32(_mm256_castps_si256(even), _mm256_castps_si256(odd));
+            sum = _mm256_permutevar8x32_epi32(sum, _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7));
+            return _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(512)), 10), _mm256_set1_epi32(128));
+        }
+    }
+
+    static void SwapRBAVX2(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        const __m256i mask = _mm256_setr_epi8(
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+        uint32_t x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), _mm256_shuffle_epi8(p, mask));
+        }
+        if (x < width)
+        {
+            SwapRBScalar(src + x * 4, dst + x * 4, width - x);
+        }
+    }
+
+    static void BGRAToGrayAVX2(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        WeightedRow<128, 8, 0>(src, dst, width, _mm256_setr_epi16(
+            kGrayB, kGrayG, kGrayR, 0, kGrayB, kGrayG, kGrayR, 0,
+            kGrayB, kGrayG, kGrayR, 0, kGrayB, kGrayG, kGrayR, 0));
+    }
+
+    static void BGRAToLumaAVX2(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        WeightedRow<128, 8, 16>(src, dst, width, _mm256_setr_epi16(
+            kLumaB, kLumaG, kLumaR, 0, kLumaB, kLumaG, kLumaR, 0,
+            kLumaB, kLumaG, kLumaR, 0, kLumaB, kLumaG, kLumaR, 0));
+    }
+
+    static void BGRAToChromaAVX2(const uint8_t* row0, const uint8_t* row1, uint8_t* u, uint8_t* v, uint32_t width)
+    {
+        const __m256i uWeights = _mm256_setr_epi16(
+            kUB, kUG, kUR, 0, kUB, kUG, kUR, 0, kUB, kUG, kUR, 0, kUB, kUG, kUR, 0);
+        const __m256i vWeights = _mm256_setr_epi16(
+            kVB, kVG, kVR, 0, kVB, kVG, kVR, 0, kVB, kVG, kVR, 0, kVB, kVG, kVR, 0);
+
+        // 每次 32 个像素，输出 16 个色度样本
+        uint32_t x = 0;
+        for (; x + 32 <= width; x += 32)
+        {
+            __m256i sums[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                sums[i] = ChromaSums(row0 + (x + i * 8) * 4, row1 + (x + i * 8) * 4);
+            }
+
+            __m256i packed = PackBytes(
+                ChromaValue(sums[0], sums[1], uWeights), ChromaValue(sums[2], sums[3], uWeights),
+                ChromaValue(sums[0], sums[1], vWeights), ChromaValue(sums[2], sums[3], vWeights));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(u + x / 2), _mm256_castsi256_si128(packed));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(v + x / 2), _mm256_extracti128_si256(packed, 1));
+        }
+        if (x < width)
+        {
+            BGRAToChromaScalar(row0 + x * 4, row1 + x * 4, u + x / 2, v + x / 2, width - x);
+        }
+    }
+
+    static void InterleaveUVAVX2(const uint8_t* u, const uint8_t* v, uint8_t* uv, uint32_t count)
+    {
+        uint32_t i = 0;
+        for (; i + 32 <= count; i += 32)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(u + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+            __m256i lo = _mm256_unpacklo_epi8(a, b);
+            __m256i hi = _mm256_unpackhi_epi8(a, b);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(uv + i * 2), _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(uv + i * 2 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+        if (i < count)
+        {
+            InterleaveUVScalar(u + i, v + i, uv + i * 2, count - i);
+        }
+    }
+
+    static void RGBA32FToRGBA8AVX2(const float* src, uint8_t* dst, uint32_t width)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 scale = _mm256_set1_ps(255.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        // 每次 8 个像素
+        uint32_t x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            __m256i values[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                __m256 f = _mm256_loadu_ps(src + (x + i * 2) * 4);
+                f = _mm256_max_ps(_mm256_min_ps(f, one), zero);
+                values[i] = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(f, scale), half));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), PackBytes(values[0], values[1], values[2], values[3]));
+        }
+        if (x < width)
+        {
+            RGBA32FToRGBA8Scalar(src + x * 4, dst + x * 4, width - x);
+        }
+    }
+
+    const PixelConvertKernels kAVX2Kernels =
+    {
+        &SwapRBAVX2,
+        &BGRAToGrayAVX2,
+        &BGRAToLumaAVX2,
+        &BGRAToChromaAVX2,
+        &InterleaveUVAVX2,
+        &RGBA32FToRGBA8AVX2,
+    };
+}
@@ -0,0 +1,198 @@
+﻿#include "graphics/PixelConvertKernels.h"
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+// 本文件以 /arch:AVX512 编译，需要 AVX-512F 和 AVX-512BW，运行时检测通过后才会被调用
+// 不包含预编译头和其他项目头文件：那里的内联函数在这里会按 AVX 指令生成，链接器可能选中这一份
+namespace lens::graphics::detail
+{
+    namespace
+    {
+        // 16 个 BGRA 像素的加权和，按像素顺序输出 16 个 int32
+        inline __m512i WeightedSum16(__m512i pixels, __m512i weights)
+        {
+            const __m512i zero = _mm512_setzero_si512();
+            __m512i lo = _mm512_madd_epi16(_mm512_unpacklo_epi8(pixels, zero), weights);
+            __m512i hi = _mm512_madd_epi16(_mm512_unpackhi_epi8(pixels, zero), weights);
+            __m512 even = _mm512_shuffle_ps(_mm512_castsi512_ps(lo), _mm512_castsi512_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+            __m512 odd = _mm512_shuffle_ps(_mm512_castsi512_ps(lo), _mm512_castsi512_ps(hi), _MM_SHUFFLE(3, 1, 3, 1));
+            return _mm512_add_epi32(_mm512_castps_si512(even), _mm512_castps_si512(odd));
+        }
+
+        // 4 组各 16 个 int32 打包成 64 个字节，打包后按 128 位通道交错，重排回顺序
+        inline __m512i PackBytes(__m512i a, __m512i b, __m512i c, __m512i d)
+        {
+            __m512i packed = _mm512_packus_epi16(_mm512_packs_epi32(a, b), _mm512_packs_epi32(c, d));
+            return _mm512_permutexvar_epi32(
+                _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15), packed);
+        }
+
+        inline __m512i BroadcastWeights(int b, int g, int r)
+        {
+            return _mm512_broadcast_i32x4(_mm_setr_epi16(
+                static_cast<short>(b), static_cast<short>(g), static_cast<short>(r), 0,
+                static_cast<short>(b), static_cast<short>(g), static_cast<short>(r), 0));
+        }
+
+        template<int Bias, int Shift, int Offset>
+        void WeightedRow(const uint8_t* src, uint8_t* dst, uint32_t width, __m512i weights)
+        {
+            const __m512i bias = _mm512_set1_epi32(Bias);
+            const __m512i offset = _mm512_set1_epi32(Offset);
+
+            uint32_t x = 0;
+            for (; x + 64 <= width; x += 64)
+            {
+                __m512i sums[4];
+                for (int i = 0; i < 4; ++i)
+                {
+                    __m512i pixels = _mm512_loadu_si512(src + (x + i * 16) * 4);
+                    sums[i] = _mm512_add_epi32(_mm512_srai_epi32(_mm512_add_epi32(WeightedSum16(pixels, weights), bias), Shift), offset);
+                }
+                _mm512_storeu_si512(dst + x, PackBytes(sums[0], sums[1], sums[2], sums[3]));
+            }
+            if (x < width)
+            {
+                if (Offset == 0)
+                    BGRAToGrayScalar(src + x * 4, dst + x, width - x);
+                else
+                    BGRAToLumaScalar(src + x * 4, dst + x, width - x);
+            }
+        }
+
+        // 两行各 16 个像素 -> 8 个色度样本的四项和，按样本顺序
+        inline __m512i ChromaSums(const uint8_t* row0, const uint8_t* row1)
+        {
+            const __m512i zero = _mm512_setzero_si512();
+            __m512i a = _mm512_loadu_si512(row0);
+            __m512i b = _mm512_loadu_si512(row1);
+            __m512i lo = _mm512_add_epi16(_mm512_unpacklo_epi8(a, zero), _mm512_unpacklo_epi8(b, zero));
+            __m512i hi = _mm512_add_epi16(_mm512_unpackhi_epi8(a, zero), _mm512_unpackhi_epi8(b, zero));
+            return _mm512_add_epi16(_mm512_unpacklo_epi64(lo, hi), _mm512_unpackhi_epi64(lo, hi));
+        }
+
+        // 16 个色度样本的四项和 -> 16 个 int32 色度值，按样本顺序
+        inline __m512i ChromaValue(__m512i sums0, __m512i sums1, __m512i weights)
+        {
+            __m512i m0 = _mm512_madd_epi16(sums0, weights);
+            __m512i m1 = _mm512_madd_epi16(sums1, weights);
+            __m512 even = _mm512_shuffle_ps(_mm512_castsi512_ps(m0), _mm512_castsi512_ps(m1), _MM_SHUFFLE(2, 0, 2, 0));
+            __m512 odd = _mm512_shuffle_ps(_mm512_castsi512_ps(m0), _mm512_castsi512_ps(m1), _MM_SHUFFLE(3, 1, 3, 1));
+            __m512i sum = _mm512_add_epi32(_mm512_castps_si512(even), _mm512_castps_si512(odd));
+            sum = _mm512_permutexvar_epi32(
+                _mm512_setr_epi32(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15), sum);
+            return _mm512_add_epi32(_mm512_srai_epi32(_mm512_add_epi32(sum, _mm512_set1_epi32(512)), 10), _mm512_set1_epi32(128));
+        }
+    }
+
+    static void SwapRBAVX512(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        const __m512i mask = _mm512_broadcast_i32x4(_mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+
+        uint32_t x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            __m512i p = _mm512_loadu_si512(src + x * 4);
+            _mm512_storeu_si512(dst + x * 4, _mm512_shuffle_epi8(p, mask));
+        }
+        if (x < width)
+        {
+            SwapRBScalar(src + x * 4, dst + x * 4, width - x);
+        }
+    }
+
+    static void BGRAToGrayAVX512(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        WeightedRow<128, 8, 0>(src, dst, width, BroadcastWeights(kGrayB, kGrayG, kGrayR));
+    }
+
+    static void BGRAToLumaAVX512(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        WeightedRow<128, 8, 16>(src, dst, width, BroadcastWeights(kLumaB, kLumaG, kLumaR));
+    }
+
+    static void BGRAToChromaAVX512(const uint8_t* row0, const uint8_t* row1, uint8_t* u, uint8_t* v, uint32_t width)
+    {
+        const __m512i uWeights = BroadcastWeights(kUB, kUG, kUR);
+        const __m512i vWeights = BroadcastWeights(kVB, kVG, kVR);
+
+        // 每次 64 个像素，输出 32 个色度样本
+        uint32_t x = 0;
+        for (; x + 64 <= width; x += 64)
+        {
+            __m512i sums[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                sums[i] = ChromaSums(row0 + (x + i * 16) * 4, row1 + (x + i * 16) * 4);
+            }
+
+            __m512i packed = PackBytes(
+                ChromaValue(sums[0], sums[1], uWeights), ChromaValue(sums[2], sums[3], uWeights),
+                ChromaValue(sums[0], sums[1], vWeights), ChromaValue(sums[2], sums[3], vWeights));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(u + x / 2), _mm512_castsi512_si256(packed));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(v + x / 2), _mm512_extracti64x4_epi64(packed, 1));
+        }
+        if (x < width)
+        {
+            BGRAToChromaScalar(row0 + x * 4, row1 + x * 4, u + x / 2, v + x / 2, width - x);
+        }
+    }
+
+    static void InterleaveUVAVX512(const uint8_t* u, const uint8_t* v, uint8_t* uv, uint32_t count)
+    {
+        const __m512i first = _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11);
+        const __m512i second = _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15);
+
+        uint32_t i = 0;
+        for (; i + 64 <= count; i += 64)
+        {
+            __m512i a = _mm512_loadu_si512(u + i);
+            __m512i b = _mm512_loadu_si512(v + i);
+            __m512i lo = _mm512_unpacklo_epi8(a, b);
+            __m512i hi = _mm512_unpackhi_epi8(a, b);
+            _mm512_storeu_si512(uv + i * 2, _mm512_permutex2var_epi64(lo, first, hi));
+            _mm512_storeu_si512(uv + i * 2 + 64, _mm512_permutex2var_epi64(lo, second, hi));
+        }
+        if (i < count)
+        {
+            InterleaveUVScalar(u + i, v + i, uv + i * 2, count - i);
+        }
+    }
+
+    static void RGBA32FToRGBA8AVX512(const float* src, uint8_t* dst, uint32_t width)
+    {
+        const __m512 one = _mm512_set1_ps(1.0f);
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 scale = _mm512_set1_ps(255.0f);
+        const __m512 half = _mm512_set1_ps(0.5f);
+
+        // 每次 16 个像素
+        uint32_t x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            __m512i values[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                __m512 f = _mm512_loadu_ps(src + (x + i * 4) * 4);
+                f = _mm512_max_ps(_mm512_min_ps(f, one), zero);
+                values[i] = _mm512_cvttps_epi32(_mm512_add_ps(_mm512_mul_ps(f, scale), half));
+            }
+            _mm512_storeu_si512(dst + x * 4, PackBytes(values[0], values[1], values[2], values[3]));
+        }
+        if (x < width)
+        {
+            RGBA32FToRGBA8Scalar(src + x * 4, dst + x * 4, width - x);
+        }
+    }
+
+    const PixelConvertKernels kAVX512Kernels =
+    {
+        &SwapRBAVX512,
+        &BGRAToGrayAVX512,
+        &BGRAToLumaAVX512,
+        &BGRAToChromaAVX512,
+        &InterleaveUVAVX512,
+        &RGBA32FToRGBA8AVX512,
+    };
+}
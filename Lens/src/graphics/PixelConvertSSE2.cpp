@@ -0,0 +1,188 @@
+﻿#include "LensPch.h"
+#include "graphics/PixelConvertKernels.h"
+#include <emmintrin.h>
+
+namespace lens::graphics::detail
+{
+    namespace
+    {
+        // 4 个 BGRA 像素的加权和：B、G、R 分别乘 weights 的前三项，结果为 4 个 int32
+        inline __m128i WeightedSum4(__m128i pixels, __m128i weights)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights);
+            __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights);
+            // madd 得到每像素 (B*wb + G*wg, R*wr + A*0)，奇偶两项相加
+            __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1));
+            return _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+        }
+
+        // 16 个 int32 饱和打包成 16 个字节
+        inline __m128i PackBytes(__m128i a, __m128i b, __m128i c, __m128i d)
+        {
+            return _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        }
+
+        template<int Bias, int Shift, int Offset>
+        void WeightedRow(const uint8_t* src, uint8_t* dst, uint32_t width, __m128i weights)
+        {
+            const __m128i bias = _mm_set1_epi32(Bias);
+            const __m128i offset = _mm_set1_epi32(Offset);
+
+            uint32_t x = 0;
+            for (; x + 16 <= width; x += 16)
+            {
+                __m128i sums[4];
+                for (int i = 0; i < 4; ++i)
+                {
+                    __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (x + i * 4) * 4));
+                    sums[i] = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(WeightedSum4(pixels, weights), bias), Shift), offset);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), PackBytes(sums[0], sums[1], sums[2], sums[3]));
+            }
+            if (x < width)
+            {
+                if (Offset == 0)
+                    BGRAToGrayScalar(src + x * 4, dst + x, width - x);
+                else
+                    BGRAToLumaScalar(src + x * 4, dst + x, width - x);
+            }
+        }
+
+        // 两行各 4 个像素 -> 2 个色度样本的 (B, G, R, A) 四项和，16 位
+        inline __m128i ChromaSums(const uint8_t* row0, const uint8_t* row1)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));  // 像素 0、1
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));  // 像素 2、3
+            return _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+        }
+
+        // 4 个色度样本的四项和 -> 4 个 int32 色度值
+        inline __m128i ChromaValue(__m128i sums01, __m128i sums23, __m128i weights)
+        {
+            __m128i m0 = _mm_madd_epi16(sums01, weights);
+            __m128i m1 = _mm_madd_epi16(sums23, weights);
+            __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(m0), _mm_castsi128_ps(m1), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(m0), _mm_castsi128_ps(m1), _MM_SHUFFLE(3, 1, 3, 1));
+            __m128i sum = _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+            return _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(512)), 10), _mm_set1_epi32(128));
+        }
+    }
+
+    static void SwapRBSSE2(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        // 没有 pshufb，用移位和掩码交换第 0、2 字节
+        const __m128i keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+        const __m128i low = _mm_set1_epi32(0x000000FF);
+        const __m128i high = _mm_set1_epi32(0x00FF0000);
+
+        uint32_t x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+            __m128i r = _mm_or_si128(_mm_and_si128(p, keep),
+                _mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 16), high), _mm_and_si128(_mm_srli_epi32(p, 16), low)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), r);
+        }
+        if (x < width)
+        {
+            SwapRBScalar(src + x * 4, dst + x * 4, width - x);
+        }
+    }
+
+    static void BGRAToGraySSE2(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        WeightedRow<128, 8, 0>(src, dst, width, _mm_setr_epi16(kGrayB, kGrayG, kGrayR, 0, kGrayB, kGrayG, kGrayR, 0));
+    }
+
+    static void BGRAToLumaSSE2(const uint8_t* src, uint8_t* dst, uint32_t width)
+    {
+        WeightedRow<128, 8, 16>(src, dst, width, _mm_setr_epi16(kLumaB, kLumaG, kLumaR, 0, kLumaB, kLumaG, kLumaR, 0));
+    }
+
+    static void BGRAToChromaSSE2(const uint8_t* row0, const uint8_t* row1, uint8_t* u, uint8_t* v, uint32_t width)
+    {
+        const __m128i uWeights = _mm_setr_epi16(kUB, kUG, kUR, 0, kUB, kUG, kUR, 0);
+        const __m128i vWeights = _mm_setr_epi16(kVB, kVG, kVR, 0, kVB, kVG, kVR, 0);
+
+        // 每次 16 个像素，输出 8 个色度样本
+        uint32_t x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            __m128i sums[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                sums[i] = ChromaSums(row0 + (x + i * 4) * 4, row1 + (x + i * 4) * 4);
+            }
+
+            __m128i u0 = ChromaValue(sums[0], sums[1], uWeights);
+            __m128i u1 = ChromaValue(sums[2], sums[3], uWeights);
+            __m128i v0 = ChromaValue(sums[0], sums[1], vWeights);
+            __m128i v1 = ChromaValue(sums[2], sums[3], vWeights);
+
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(u0, u1), _mm_packs_epi32(v0, v1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2), packed);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2), _mm_srli_si128(packed, 8));
+        }
+        if (x < width)
+        {
+            BGRAToChromaScalar(row0 + x * 4, row1 + x * 4, u + x / 2, v + x / 2, width - x);
+        }
+    }
+
+    static void InterleaveUVSSE2(const uint8_t* u, const uint8_t* v, uint8_t* uv, uint32_t count)
+    {
+        uint32_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + i * 2), _mm_unpacklo_epi8(a, b));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + i * 2 + 16), _mm_unpackhi_epi8(a, b));
+        }
+        if (i < count)
+        {
+            InterleaveUVScalar(u + i, v + i, uv + i * 2, count - i);
+        }
+    }
+
+    static void RGBA32FToRGBA8SSE2(const float* src, uint8_t* dst, uint32_t width)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 scale = _mm_set1_ps(255.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+
+        // 每次 4 个像素（16 个分量）
+        uint32_t x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128i values[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                __m128 f = _mm_loadu_ps(src + (x + i) * 4);
+                f = _mm_max_ps(_mm_min_ps(f, one), zero);
+                values[i] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, scale), half));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), PackBytes(values[0], values[1], values[2], values[3]));
+        }
+        if (x < width)
+        {
+            RGBA32FToRGBA8Scalar(src + x * 4, dst + x * 4, width - x);
+        }
+    }
+
+    const PixelConvertKernels kSSE2Kernels =
+    {
+        &SwapRBSSE2,
+        &BGRAToGraySSE2,
+        &BGRAToLumaSSE2,
+        &BGRAToChromaSSE2,
+        &InterleaveUVSSE2,
+        &RGBA32FToRGBA8SSE2,
+    };
+}
@@ -0,0 +1,151 @@
+﻿#include "LensPch.h"
+#include "graphics/ReadbackRing.h"
+#include <thread>
+
+namespace lens::graphics
+{
+    ReadbackRing::ReadbackRing(std::unique_ptr<IReadbackDevice> device, uint32_t slotCount)
+        : m_device(std::move(device)),
+          m_slots((std::max)(slotCount, 1u)),
+          m_images([](const TextureKey& key)
+          {
+              auto image = std::make_unique<CpuImage>();
+              image->Allocate(key.width, key.height, key.format);
+              return image;
+          })
+    {
+    }
+
+    ReadbackRing::~ReadbackRing()
+    {
+        // 未交付的帧直接丢弃，不再等待 GPU
+        for (auto& slot : m_slots)
+        {
+            slot.callback = nullptr;
+        }
+        if (m_device)
+        {
+            m_device->ReleaseSlots();
+        }
+    }
+
+    bool ReadbackRing::Submit(Texture* source, Callback callback)
+    {
+        if (!source || !m_device)
+            return false;
+
+        if (m_count == m_slots.size())
+        {
+            m_stats.dropped++;
+            return false;
+        }
+
+        uint32_t index = (m_head + m_count) % static_cast<uint32_t>(m_slots.size());
+        Slot& slot = m_slots[index];
+        slot.width = source->GetWidth();
+        slot.height = source->GetHeight();
+        slot.format = source->GetFormat();
+
+        if (!m_device->PrepareSlot(index, slot.width, slot.height, slot.format) ||
+            !m_device->SubmitCopy(index, source))
+        {
+            m_stats.failed++;
+            return false;
+        }
+
+        slot.callback = std::move(callback);
+        slot.submitTime = Clock::now();
+        if (m_stats.submitted == 0)
+        {
+            m_firstSubmit = slot.submitTime;
+        }
+        m_stats.submitted++;
+        m_count++;
+        return true;
+    }
+
+    uint32_t ReadbackRing::Poll()
+    {
+        uint32_t delivered = 0;
+
+        // 按提交顺序检查，最早的没完成就停下，保证回调顺序与提交一致
+        while (m_count > 0)
+        {
+            Slot& slot = m_slots[m_head];
+
+            // 复制没完成时不从池里取图像，避免每次 Poll 都借出再归还
+            if (!m_device->IsSlotReady(m_head))
+            {
+                m_stats.notReadyPolls++;
+                break;
+            }
+            auto image = m_images.Acquire(TextureKey{ slot.width, slot.height, slot.format });
+
+            auto readStart = Clock::now();
+            auto result = image ? m_device->ReadSlot(m_head, *image) : IReadbackDevice::ReadResult::Failed;
+            if (result == IReadbackDevice::ReadResult::NotReady)
+            {
+                m_stats.notReadyPolls++;
+                break;
+            }
+
+            auto readEnd = Clock::now();
+            Callback callback = std::move(slot.callback);
+            slot.callback = nullptr;
+            m_head = (m_head + 1) % static_cast<uint32_t>(m_slots.size());
+            m_count--;
+
+            if (result == IReadbackDevice::ReadResult::Failed)
+            {
+                LOG_ERROR("Readback of {}x{} frame failed", slot.width, slot.height);
+                m_stats.failed++;
+                continue;
+            }
+
+            double latencyMs = std::chrono::duration<double, std::milli>(readStart - slot.submitTime).count();
+            m_totalLatencyMs += latencyMs;
+            m_stats.maxLatencyMs = (std::max)(m_stats.maxLatencyMs, latencyMs);
+            m_stats.readMs += std::chrono::duration<double, std::milli>(readEnd - readStart).count();
+            m_stats.bytesRead += image->GetSizeInBytes();
+            m_stats.completed++;
+            m_lastComplete = readEnd;
+            delivered++;
+
+            if (callback)
+            {
+                callback(std::move(image));
+            }
+        }
+
+        return delivered;
+    }
+
+    void ReadbackRing::Flush()
+    {
+        auto start = Clock::now();
+        while (m_count > 0)
+        {
+            if (Poll() == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        m_stats.stallMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    ReadbackRing::Stats ReadbackRing::GetStats() const
+    {
+        Stats stats = m_stats;
+        if (stats.completed > 0)
+        {
+            stats.avgLatencyMs = m_totalLatencyMs / static_cast<double>(stats.completed);
+
+            double seconds = std::chrono::duration<double>(m_lastComplete - m_firstSubmit).count();
+            if (seconds > 0.0)
+            {
+                stats.throughputMBps = static_cast<double>(stats.bytesRead) / (1024.0 * 1024.0) / seconds;
+            }
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,312 @@
+﻿#include "LensPch.h"
+#include "graphics/Resampler.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+namespace lens::graphics
+{
+    namespace
+    {
+        // 权重定点位数；水平结果以 int16 保存，比 8 位多保留 kIntermediateBits 位精度
+        constexpr int kWeightBits = 14;
+        constexpr int kIntermediateBits = 7;
+        constexpr int kHorizontalShift = kWeightBits - kIntermediateBits;
+        constexpr int kVerticalShift = kWeightBits + kIntermediateBits;
+
+        constexpr double kPi = 3.14159265358979323846;
+
+        double GetFilterRadius(ResampleFilter filter)
+        {
+            switch (filter)
+            {
+            case ResampleFilter::Box:      return 0.5;
+            case ResampleFilter::Bilinear: return 1.0;
+            case ResampleFilter::Lanczos3: return 3.0;
+            default:                       return 0.5;
+            }
+        }
+
+        double EvaluateFilter(ResampleFilter filter, double x)
+        {
+            switch (filter)
+            {
+            case ResampleFilter::Box:
+                return (x >= -0.5 && x < 0.5) ? 1.0 : 0.0;
+            case ResampleFilter::Bilinear:
+                x = std::abs(x);
+                return x < 1.0 ? 1.0 - x : 0.0;
+            case ResampleFilter::Lanczos3:
+                x = std::abs(x);
+                if (x < 1e-8)
+                    return 1.0;
+                if (x >= 3.0)
+                    return 0.0;
+                return 3.0 * std::sin(kPi * x) * std::sin(kPi * x / 3.0) / (kPi * kPi * x * x);
+            default:
+                return 0.0;
+            }
+        }
+
+        inline int16_t ClampInt16(int32_t value)
+        {
+            return static_cast<int16_t>(value < -32768 ? -32768 : (value > 32767 ? 32767 : value));
+        }
+
+        inline uint8_t ClampByte(int32_t value)
+        {
+            return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+        }
+
+        bool IsResampleFormat(TextureFormat format)
+        {
+            return format == TextureFormat::BGRA8_UNorm || format == TextureFormat::RGBA8_UNorm;
+        }
+
+        // 每个工作线程复用的临时缓冲区
+        thread_local std::vector<int16_t> t_intermediate;
+        thread_local std::vector<int32_t> t_accumulator;
+    }
+
+    const char* GetResampleFilterName(ResampleFilter filter)
+    {
+        switch (filter)
+        {
+        case ResampleFilter::Box:      return "box";
+        case ResampleFilter::Bilinear: return "bilinear";
+        case ResampleFilter::Lanczos3: return "lanczos3";
+        default:                       return "unknown";
+        }
+    }
+
+    void Resampler::BuildContributors(Contributors& table, uint32_t srcSize, uint32_t dstSize, ResampleFilter filter)
+    {
+        table.srcSize = srcSize;
+        table.dstSize = dstSize;
+        table.filter = filter;
+        table.first.assign(dstSize, 0);
+        table.count.assign(dstSize, 0);
+
+        const double scale = static_cast<double>(dstSize) / srcSize;
+        // 缩小时按比例加宽滤波器，覆盖全部源像素
+        const double filterScale = scale < 1.0 ? 1.0 / scale : 1.0;
+        const double support = GetFilterRadius(filter) * filterScale;
+
+        std::vector<std::vector<double>> raw(dstSize);
+        uint32_t taps = 1;
+
+        for (uint32_t i = 0; i < dstSize; ++i)
+        {
+            const double center = (i + 0.5) / scale;
+            int32_t left = (std::max)(0, static_cast<int32_t>(std::floor(center - support)));
+            int32_t right = (std::min)(static_cast<int32_t>(srcSize) - 1, static_cast<int32_t>(std::ceil(center + support)));
+
+            std::vector<double>& w = raw[i];
+            for (int32_t j = left; j <= right; ++j)
+            {
+                w.push_back(EvaluateFilter(filter, (j + 0.5 - center) / filterScale));
+            }
+
+            // 去掉两端的零权重
+            size_t head = 0;
+            while (head < w.size() && w[head] == 0.0)
+                ++head;
+            while (!w.empty() && w.size() > head && w.back() == 0.0)
+                w.pop_back();
+            w.erase(w.begin(), w.begin() + head);
+            left += static_cast<int32_t>(head);
+
+            if (w.empty())
+            {
+                // 放大时盒式滤波可能落在两个像素之间，取最近像素
+                left = (std::min)(static_cast<int32_t>(srcSize) - 1, static_cast<int32_t>(center));
+                w.assign(1, 1.0);
+            }
+
+            table.first[i] = static_cast<uint32_t>(left);
+            table.count[i] = static_cast<uint32_t>(w.size());
+            taps = (std::max)(taps, table.count[i]);
+        }
+
+        table.taps = taps;
+        table.weights.assign(static_cast<size_t>(dstSize) * taps, 0);
+
+        for (uint32_t i = 0; i < dstSize; ++i)
+        {
+            const std::vector<double>& w = raw[i];
+            double total = 0.0;
+            for (double value : w)
+                total += value;
+
+            // 归一化后量化，舍入误差补到最大的权重上，保证和恰好为 1 << kWeightBits
+            int16_t* out = table.weights.data() + static_cast<size_t>(i) * taps;
+            int32_t sum = 0;
+            size_t largest = 0;
+            for (size_t t = 0; t < w.size(); ++t)
+            {
+                out[t] = static_cast<int16_t>(std::lround(w[t] / total * (1 << kWeightBits)));
+                sum += out[t];
+                if (out[t] > out[largest])
+                    largest = t;
+            }
+            out[largest] = static_cast<int16_t>(out[largest] + ((1 << kWeightBits) - sum));
+        }
+    }
+
+    bool Resampler::Resample(const uint8_t* src, uint32_t srcStride, uint32_t srcWidth, uint32_t srcHeight,
+        uint8_t* dst, uint32_t dstStride, uint32_t dstWidth, uint32_t dstHeight,
+        ResampleFilter filter, ThreadPool* pool)
+    {
+        if (!src || !dst || srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0)
+        {
+            LOG_ERROR("Invalid resample size: {}x{} -> {}x{}", srcWidth, srcHeight, dstWidth, dstHeight);
+            return false;
+        }
+
+        if (!m_horizontal.Matches(srcWidth, dstWidth, filter))
+            BuildContributors(m_horizontal, srcWidth, dstWidth, filter);
+        if (!m_vertical.Matches(srcHeight, dstHeight, filter))
+            BuildContributors(m_vertical, srcHeight, dstHeight, filter);
+
+        const Contributors& horizontal = m_horizontal;
+        const Contributors& vertical = m_vertical;
+        const uint32_t bandHeight = m_bandHeight;
+        const size_t dstRowElements = static_cast<size_t>(dstWidth) * 4;
+
+        auto processBand = [&](uint32_t bandBegin, uint32_t bandEnd)
+        {
+            for (uint32_t band = bandBegin; band < bandEnd; ++band)
+            {
+                const uint32_t rowBegin = band * bandHeight;
+                const uint32_t rowEnd = (std::min)(rowBegin + bandHeight, dstHeight);
+
+                // 本行带需要的源行范围，相邻行带在滤波半径内有少量重叠
+                uint32_t srcBegin = vertical.first[rowBegin];
+                uint32_t srcEnd = 0;
+                for (uint32_t y = rowBegin; y < rowEnd; ++y)
+                {
+                    srcBegin = (std::min)(srcBegin, vertical.first[y]);
+                    srcEnd = (std::max)(srcEnd, vertical.first[y] + vertical.count[y]);
+                }
+
+                // 水平滤波：源行 -> int16 中间行
+                auto& intermediate = t_intermediate;
+                intermediate.resize(static_cast<size_t>(srcEnd - srcBegin) * dstRowElements);
+                for (uint32_t sy = srcBegin; sy < srcEnd; ++sy)
+                {
+                    const uint8_t* srcRow = src + static_cast<size_t>(sy) * srcStride;
+                    int16_t* out = intermediate.data() + static_cast<size_t>(sy - srcBegin) * dstRowElements;
+
+                    for (uint32_t x = 0; x < dstWidth; ++x)
+                    {
+                        const uint8_t* s = srcRow + static_cast<size_t>(horizontal.first[x]) * 4;
+                        const int16_t* w = horizontal.weights.data() + static_cast<size_t>(x) * horizontal.taps;
+                        const uint32_t count = horizontal.count[x];
+
+                        int32_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+                        for (uint32_t t = 0; t < count; ++t)
+                        {
+                            c0 += w[t] * s[t * 4 + 0];
+                            c1 += w[t] * s[t * 4 + 1];
+                            c2 += w[t] * s[t * 4 + 2];
+                            c3 += w[t] * s[t * 4 + 3];
+                        }
+
+                        constexpr int32_t round = 1 << (kHorizontalShift - 1);
+                        out[x * 4 + 0] = ClampInt16((c0 + round) >> kHorizontalShift);
+                        out[x * 4 + 1] = ClampInt16((c1 + round) >> kHorizontalShift);
+                        out[x * 4 + 2] = ClampInt16((c2 + round) >> kHorizontalShift);
+                        out[x * 4 + 3] = ClampInt16((c3 + round) >> kHorizontalShift);
+                    }
+                }
+
+                // 垂直滤波：整行累加，内层循环连续访问便于向量化
+                auto& accumulator = t_accumulator;
+                accumulator.resize(dstRowElements);
+                for (uint32_t y = rowBegin; y < rowEnd; ++y)
+                {
+                    std::fill(accumulator.begin(), accumulator.end(), 1 << (kVerticalShift - 1));
+
+                    const int16_t* w = vertical.weights.data() + static_cast<size_t>(y) * vertical.taps;
+                    for (uint32_t t = 0; t < vertical.count[y]; ++t)
+                    {
+                        const int16_t* in = intermediate.data() +
+                            static_cast<size_t>(vertical.first[y] + t - srcBegin) * dstRowElements;
+                        const int32_t weight = w[t];
+                        int32_t* acc = accumulator.data();
+                        for (size_t i = 0; i < dstRowElements; ++i)
+                        {
+                            acc[i] += weight * in[i];
+                        }
+                    }
+
+                    uint8_t* out = dst + static_cast<size_t>(y) * dstStride;
+                    for (size_t i = 0; i < dstRowElements; ++i)
+                    {
+                        out[i] = ClampByte(accumulator[i] >> kVerticalShift);
+                    }
+                }
+            }
+        };
+
+        const uint32_t bandCount = (dstHeight + bandHeight - 1) / bandHeight;
+        ThreadPool& threads = pool ? *pool : ThreadPool::GetShared();
+        threads.ParallelFor(bandCount, 1, processBand);
+        return true;
+    }
+
+    bool Resampler::Resample(const CpuImage& src, uint32_t dstWidth, uint32_t dstHeight, ResampleFilter filter,
+        CpuImage& dst, ThreadPool* pool)
+    {
+        if (!IsResampleFormat(src.format) || src.IsEmpty())
+        {
+            LOG_ERROR("Resample requires a non-empty BGRA8/RGBA8 image (format {})", static_cast<int>(src.format));
+            return false;
+        }
+        if (&src == &dst)
+        {
+            LOG_ERROR("Resample cannot run in place");
+            return false;
+        }
+
+        dst.Allocate(dstWidth, dstHeight, src.format);
+        return Resample(src.pixels.data(), src.rowPitch, src.width, src.height,
+            dst.pixels.data(), dst.rowPitch, dstWidth, dstHeight, filter, pool);
+    }
+
+    bool Resampler::ResampleToFit(const CpuImage& src, uint32_t maxWidth, uint32_t maxHeight, ResampleFilter filter,
+        CpuImage& dst, ThreadPool* pool)
+    {
+        if (src.width == 0 || src.height == 0 || maxWidth == 0 || maxHeight == 0)
+        {
+            LOG_ERROR("Invalid resample size: {}x{} -> fit {}x{}", src.width, src.height, maxWidth, maxHeight);
+            return false;
+        }
+
+        const double scale = (std::min)({ 1.0,
+            static_cast<double>(maxWidth) / src.width, static_cast<double>(maxHeight) / src.height });
+        const uint32_t width = (std::max)(1u, static_cast<uint32_t>(std::lround(src.width * scale)));
+        const uint32_t height = (std::max)(1u, static_cast<uint32_t>(std::lround(src.height * scale)));
+        return Resample(src, width, height, filter, dst, pool);
+    }
+
+    bool Resampler::BuildPreviewLevels(const CpuImage& src, uint32_t minSize, std::vector<CpuImage>& levels,
+        ThreadPool* pool)
+    {
+        levels.clear();
+        minSize = (std::max)(minSize, 1u);
+
+        const CpuImage* current = &src;
+        while (current->width > minSize || current->height > minSize)
+        {
+            CpuImage level;
+            const uint32_t width = (std::max)(1u, current->width / 2);
+            const uint32_t height = (std::max)(1u, current->height / 2);
+            if (!Resample(*current, width, height, ResampleFilter::Box, level, pool))
+                return false;
+
+            levels.push_back(std::move(level));
+            current = &levels.back();
+        }
+        return true;
+    }
+}
@@ -1,6 +1,8 @@
 ﻿#include "LensPch.h"
 #include "graphics/Shader.h"
+#include <d3dcompiler.h>
 #include <fstream>
+#include <wrl/client.h>
 #include "Log.h"
 
 namespace lens::graphics 
@@ -8,136 +10,104 @@ namespace lens::graphics
 
     bool Shader::LoadVertexShader(GraphicsDevice* device, const std::string& filename, const char* entryPoint) 
     {
-        ComPtr<ID3DBlob> blob;
-        if (!CompileShader(filename, entryPoint, "vs_5_0", blob)) 
+        std::vector<uint8_t> bytecode;
+        if (!CompileShader(filename, entryPoint, "vs_5_0", bytecode)) 
         {
             return false;
         }
 
-        HRESULT hr = device->GetDevice()->CreateVertexShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &m_vertexShader);
-        if (FAILED(hr)) 
-        {
-            return false;
-        }
-
-        // 保存字节码用于输入布局创建
-        m_vertexShaderBytecode.assign(
-            static_cast<char*>(blob->GetBufferPointer()),
-            static_cast<char*>(blob->GetBufferPointer()) + blob->GetBufferSize()
-        );
-
-        return true;
+        return LoadVertexShaderFromBytecode(device, bytecode.data(), bytecode.size());
     }
 
     bool Shader::LoadPixelShader(GraphicsDevice* device, const std::string& filename, const char* entryPoint) 
     {
-        ComPtr<ID3DBlob> blob;
-        if (!CompileShader(filename, entryPoint, "ps_5_0", blob)) 
+        std::vector<uint8_t> bytecode;
+        if (!CompileShader(filename, entryPoint, "ps_5_0", bytecode)) 
         {
             return false;
         }
 
-        HRESULT hr = device->GetDevice()->CreatePixelShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &m_pixelShader);
-        if (FAILED(hr)) 
-        {
-            return false;
-        }
-
-        return true;
+        return LoadPixelShaderFromBytecode(device, bytecode.data(), bytecode.size());
     }
 
     bool Shader::LoadComputeShader(GraphicsDevice* device, const std::string& filename, const char* entryPoint) 
     {
-        ComPtr<ID3DBlob> blob;
-        if (!CompileShader(filename, entryPoint, "cs_5_0", blob)) 
-        {
-            return false;
-        }
-
-        HRESULT hr = device->GetDevice()->CreateComputeShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &m_computeShader);
-        if (FAILED(hr)) 
+        std::vector<uint8_t> bytecode;
+        if (!CompileShader(filename, entryPoint, "cs_5_0", bytecode)) 
         {
             return false;
         }
 
-        return true;
+        return LoadComputeShaderFromBytecode(device, bytecode.data(), bytecode.size());
     }
 
-    bool Shader::LoadVertexShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) {
-        HRESULT hr = device->GetDevice()->CreateVertexShader(bytecode, size, nullptr, &m_vertexShader);
-        if (FAILED(hr)) 
-        {
+    bool Shader::CompileShader(const std::string& filename, const char* entryPoint, const char* target, std::vector<uint8_t>& bytecode) 
+    {
+        // 读取文件
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
             return false;
         }
 
-        // 保存字节码
-        m_vertexShaderBytecode.assign(
-            static_cast<const char*>(bytecode),
-            static_cast<const char*>(bytecode) + size
-        );
-
-        return true;
-    }
+        std::string source(static_cast<size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(source.data(), source.size());
 
-    bool Shader::LoadPixelShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) 
-    {
-        HRESULT hr = device->GetDevice()->CreatePixelShader(bytecode, size, nullptr, &m_pixelShader);
-        return SUCCEEDED(hr);
+        uint32_t flags = D3DCOMPILE_ENABLE_STRICTNESS;
+#ifdef _DEBUG
+        flags |= D3DCOMPILE_DEBUG;
+#endif
+        return CompileSource(source, filename.c_str(), entryPoint, target, flags, bytecode);
     }
 
-    bool Shader::LoadComputeShaderFromBytecode(GraphicsDevice* device, const void* bytecode, size_t size) 
+    bool Shader::CompileSource(std::string_view source, const char* sourceName, const char* entryPoint, const char* target,
+        uint32_t flags, std::vector<uint8_t>& bytecode, std::span<const ShaderCache::Define> defines, ShaderCache* cache)
     {
-        HRESULT hr = device->GetDevice()->CreateComputeShader(bytecode, size, nullptr, &m_computeShader);
-        return SUCCEEDED(hr);
-    }
+        // 键里带上编译器版本，换了 d3dcompiler 之后旧的字节码自动失效
+        const auto key = ShaderCache::MakeKey(source, sourceName ? sourceName : "", entryPoint, target,
+            defines, flags, D3D_COMPILER_VERSION);
 
-    bool Shader::SetInputLayout(GraphicsDevice* device, const D3D11_INPUT_ELEMENT_DESC* layout, uint32_t layoutCount) 
-    {
-        if (m_vertexShaderBytecode.empty()) 
+        if (!cache)
         {
-            return false;
-        }
-
-        HRESULT hr = device->GetDevice()->CreateInputLayout(
-            layout, layoutCount,
-            m_vertexShaderBytecode.data(),
-            m_vertexShaderBytecode.size(),
-            &m_inputLayout
-        );
-
-        return SUCCEEDED(hr);
-    }
-
-    bool Shader::CompileShader(const std::string& filename, const char* entryPoint, const char* target, ComPtr<ID3DBlob>& blob) 
-    {
-        // 读取文件
-        std::ifstream file(filename, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
-            return false;
+            cache = &ShaderCache::GetShared();
         }
 
-        std::vector<char> source(file.tellg());
-        file.seekg(0);
-        file.read(source.data(), source.size());
-
-        ComPtr<ID3DBlob> errorBlob;
-        HRESULT hr = D3DCompile(
-            source.data(), source.size(),
-            filename.c_str(), nullptr, nullptr,
-            entryPoint, target,
-            D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_DEBUG,
-            0, &blob, &errorBlob
-        );
-
-        if (FAILED(hr)) {
-            if (errorBlob) {
-                // 输出编译错误
-                OutputDebugStringA(static_cast<const char*>(errorBlob->GetBufferPointer()));
+        return cache->GetOrCompile(key, bytecode, [&](std::vector<uint8_t>& output)
+        {
+            std::vector<D3D_SHADER_MACRO> macros;
+            for (const auto& define : defines)
+            {
+                macros.push_back({ define.name.c_str(), define.value.c_str() });
+            }
+            macros.push_back({ nullptr, nullptr });
+
+            Microsoft::WRL::ComPtr<ID3DBlob> blob;
+            Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+            HRESULT hr = D3DCompile(
+                source.data(), source.size(),
+                sourceName, macros.data(), nullptr,
+                entryPoint, target,
+                flags, 0, &blob, &errorBlob
+            );
+
+            if (FAILED(hr))
+            {
+                if (errorBlob)
+                {
+                    // 输出编译错误
+                    OutputDebugStringA(static_cast<const char*>(errorBlob->GetBufferPointer()));
+                    LOG_ERROR("Shader compilation error: {}", static_cast<const char*>(errorBlob->GetBufferPointer()));
+                }
+                else
+                {
+                    LOG_ERROR("Shader compilation failed: 0x{:X}", hr);
+                }
+                return false;
             }
-            return false;
-        }
 
-        return true;
+            const uint8_t* data = static_cast<const uint8_t*>(blob->GetBufferPointer());
+            output.assign(data, data + blob->GetBufferSize());
+            return true;
+        });
     }
-
 }
\ No newline at end of file
@@ -0,0 +1,232 @@
+﻿#include "LensPch.h"
+#include "graphics/ShaderCache.h"
+#include "Deflate.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace lens::graphics
+{
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x4353484C;     // "LHSC"
+        constexpr uint32_t kVersion = 1;
+
+        // 文件头，小端
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t keyHash;
+            uint32_t keyCheck;
+            uint32_t size;
+            uint32_t crc;
+            uint32_t reserved;
+        };
+        static_assert(sizeof(FileHeader) == 32);
+
+        // 每个字段先写长度再写内容，"ab"+"c" 和 "a"+"bc" 得到不同的键
+        class KeyHasher
+        {
+        public:
+            void Add(const void* data, size_t size)
+            {
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    m_fnv = (m_fnv ^ bytes[i]) * 0x100000001B3ull;
+                }
+                m_crc = Crc32(bytes, size, m_crc);
+            }
+
+            void AddField(std::string_view text)
+            {
+                const uint64_t length = text.size();
+                Add(&length, sizeof(length));
+                Add(text.data(), text.size());
+            }
+
+            void AddU32(uint32_t value) { Add(&value, sizeof(value)); }
+
+            ShaderCache::Key Finish() const { return { m_fnv, m_crc }; }
+
+        private:
+            uint64_t m_fnv = 0xCBF29CE484222325ull;
+            uint32_t m_crc = 0;
+        };
+
+        double ElapsedMs(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    ShaderCache::ShaderCache()
+        : ShaderCache(Desc{})
+    {
+    }
+
+    ShaderCache::ShaderCache(const Desc& desc)
+        : m_desc(desc)
+    {
+    }
+
+    ShaderCache& ShaderCache::GetShared()
+    {
+        static ShaderCache cache;
+        return cache;
+    }
+
+    ShaderCache::Key ShaderCache::MakeKey(std::string_view source, std::string_view sourceName, std::string_view entryPoint,
+        std::string_view target, std::span<const Define> defines, uint32_t flags, uint32_t compilerVersion)
+    {
+        KeyHasher hasher;
+        hasher.AddU32(kVersion);
+        hasher.AddField(source);
+        hasher.AddField(sourceName);
+        hasher.AddField(entryPoint);
+        hasher.AddField(target);
+        hasher.AddU32(static_cast<uint32_t>(defines.size()));
+        for (const auto& define : defines)
+        {
+            hasher.AddField(define.name);
+            hasher.AddField(define.value);
+        }
+        hasher.AddU32(flags);
+        hasher.AddU32(compilerVersion);
+        return hasher.Finish();
+    }
+
+    std::filesystem::path ShaderCache::GetPath(const Key& key) const
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.shader", static_cast<unsigned long long>(key.hash));
+        return m_desc.directory / name;
+    }
+
+    bool ShaderCache::Load(const Key& key, std::vector<uint8_t>& bytecode)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto path = GetPath(key);
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.misses++;
+            return false;
+        }
+
+        const auto fileSize = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        FileHeader header{};
+        bool valid = fileSize >= sizeof(header) &&
+            file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            header.magic == kMagic && header.version == kVersion &&
+            header.keyHash == key.hash && header.keyCheck == key.check &&
+            header.size == fileSize - sizeof(header);
+        if (valid)
+        {
+            bytecode.resize(header.size);
+            valid = file.read(reinterpret_cast<char*>(bytecode.data()), header.size) &&
+                Crc32(bytecode.data(), bytecode.size()) == header.crc;
+        }
+        file.close();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!valid)
+        {
+            // 截断、损坏或键碰撞，删掉后按未命中处理，重新编译时会覆盖
+            LOG_WARN("Shader cache entry rejected: {}", path.string());
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            bytecode.clear();
+            m_stats.rejected++;
+            m_stats.misses++;
+            return false;
+        }
+
+        m_stats.hits++;
+        m_stats.bytesRead += bytecode.size();
+        m_stats.loadMs += ElapsedMs(start);
+        return true;
+    }
+
+    bool ShaderCache::Store(const Key& key, const uint8_t* data, size_t size)
+    {
+        if (m_desc.readOnly || size > UINT32_MAX)
+            return false;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::error_code ec;
+        std::filesystem::create_directories(m_desc.directory, ec);
+
+        // 临时文件名带进程内序号和线程号，同一进程内并发写入也不冲突
+        static std::atomic<uint32_t> s_counter{ 0 };
+        const auto path = GetPath(key);
+        auto temp = path;
+        temp += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) & 0xFFFFFF) +
+            "." + std::to_string(s_counter.fetch_add(1)) + ".tmp";
+
+        FileHeader header{};
+        header.magic = kMagic;
+        header.version = kVersion;
+        header.keyHash = key.hash;
+        header.keyCheck = key.check;
+        header.size = static_cast<uint32_t>(size);
+        header.crc = Crc32(data, size);
+
+        bool ok = false;
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            ok = file.is_open() &&
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header)) &&
+                file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+            file.close();
+            ok = ok && !file.fail();
+        }
+        if (ok)
+        {
+            std::filesystem::rename(temp, path, ec);
+            ok = !ec;
+        }
+        if (!ok)
+        {
+            LOG_WARN("Failed to write shader cache entry: {}", path.string());
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.stores++;
+        m_stats.bytesWritten += sizeof(header) + size;
+        m_stats.storeMs += ElapsedMs(start);
+        return true;
+    }
+
+    bool ShaderCache::GetOrCompile(const Key& key, std::vector<uint8_t>& bytecode, const CompileFunction& compile)
+    {
+        if (Load(key, bytecode))
+            return true;
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool compiled = compile(bytecode);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.compileMs += ElapsedMs(start);
+        }
+        if (!compiled)
+            return false;
+
+        Store(key, bytecode.data(), bytecode.size());
+        return true;
+    }
+
+    ShaderCache::Stats ShaderCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+}
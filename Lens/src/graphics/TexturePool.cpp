@@ -0,0 +1,45 @@
+﻿#include "LensPch.h"
+#include "graphics/TexturePool.h"
+#include "graphics/CpuImage.h"
+
+namespace lens::graphics
+{
+    TexturePool::TexturePool(GraphicsDevice* device, const Pool::Desc& desc)
+        : m_device(device),
+          m_pool([device](const TextureKey& key) -> std::unique_ptr<Texture>
+          {
+              Texture::Desc texDesc{};
+              {
+                  texDesc.width = key.width;
+                  texDesc.height = key.height;
+                  texDesc.format = key.format;
+                  texDesc.bindShaderResource = true;
+              }
+
+              auto texture = device->CreateTexture();
+              if (!texture->Create(device, texDesc))
+              {
+                  LOG_ERROR("TexturePool failed to create {}x{} texture", key.width, key.height);
+                  return nullptr;
+              }
+              return texture;
+          }, desc)
+    {
+        // 裁剪常发生在捕获线程归还纹理时，交给设备的延迟销毁队列，在渲染线程上 GPU 用完之后再释放
+        m_pool.SetDisposer([device](const TextureKey& key, std::unique_ptr<Texture> texture)
+        {
+            const uint64_t bytes = static_cast<uint64_t>(key.width) * key.height * GetFormatBytesPerPixel(key.format);
+            device->GetReleaseQueue().Retire(std::move(texture), bytes);
+        });
+    }
+
+    std::shared_ptr<Texture> TexturePool::Acquire(uint32_t width, uint32_t height, TextureFormat format)
+    {
+        return m_pool.Acquire(TextureKey{ width, height, format });
+    }
+
+    void TexturePool::TrimOtherSizes(uint32_t width, uint32_t height, TextureFormat format)
+    {
+        m_pool.TrimOtherKeys(TextureKey{ width, height, format });
+    }
+}
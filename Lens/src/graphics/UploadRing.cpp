@@ -0,0 +1,188 @@
+﻿#include "LensPch.h"
+#include "graphics/UploadRing.h"
+#include <thread>
+
+namespace lens::graphics
+{
+    UploadRing::UploadRing(std::unique_ptr<IUploadDevice> device)
+        : UploadRing(std::move(device), Desc{})
+    {
+    }
+
+    UploadRing::UploadRing(std::unique_ptr<IUploadDevice> device, const Desc& desc)
+        : m_device(std::move(device)), m_desc(desc)
+    {
+        // 对齐须为 2 的幂，容量按对齐取整
+        if (m_desc.alignment == 0 || (m_desc.alignment & (m_desc.alignment - 1)) != 0)
+        {
+            m_desc.alignment = 256;
+        }
+        m_desc.capacity = (m_desc.capacity + m_desc.alignment - 1) & ~static_cast<uint64_t>(m_desc.alignment - 1);
+
+        m_valid = m_device && m_desc.capacity > 0 && m_device->Create(m_desc.capacity);
+        if (!m_valid)
+        {
+            LOG_ERROR("Failed to create {} KB upload ring", m_desc.capacity / 1024);
+        }
+    }
+
+    UploadRing::~UploadRing()
+    {
+        Unmap();
+    }
+
+    void UploadRing::BeginFrame()
+    {
+        if (m_valid && !m_frames.empty())
+        {
+            Retire(m_device->GetCompletedFence(false));
+        }
+    }
+
+    UploadRing::Allocation UploadRing::Allocate(uint32_t size)
+    {
+        if (!m_valid || size == 0)
+            return {};
+
+        const uint64_t aligned = (static_cast<uint64_t>(size) + m_desc.alignment - 1) & ~static_cast<uint64_t>(m_desc.alignment - 1);
+        uint64_t offset = 0;
+        if (!Reserve(aligned, offset))
+        {
+            // 放不下时按提交顺序等待旧帧完成，当前帧自己占用的部分不能回收
+            m_stats.stalls++;
+            while (!m_frames.empty() && !Reserve(aligned, offset))
+            {
+                const uint64_t completed = m_device->GetCompletedFence(true);
+                if (completed >= m_frames.front().fence)
+                {
+                    Retire(completed);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+            if (m_frames.empty() && !Reserve(aligned, offset))
+            {
+                m_stats.failed++;
+                return {};
+            }
+        }
+
+        if (!m_mapped)
+        {
+            m_mapped = m_device->Map(m_needDiscard);
+            if (!m_mapped)
+            {
+                LOG_ERROR("Failed to map upload ring");
+                return {};
+            }
+            m_stats.maps++;
+            m_stats.discards += m_needDiscard ? 1 : 0;
+            m_needDiscard = false;
+        }
+
+        m_stats.allocations++;
+        m_stats.bytesAllocated += aligned;
+        m_stats.peakUsedBytes = (std::max)(m_stats.peakUsedBytes, m_used);
+
+        Allocation allocation;
+        allocation.data = m_mapped + offset;
+        allocation.offset = offset;
+        allocation.size = static_cast<uint32_t>(aligned);
+        return allocation;
+    }
+
+    void UploadRing::Unmap()
+    {
+        if (m_mapped)
+        {
+            m_device->Unmap();
+            m_mapped = nullptr;
+        }
+    }
+
+    void UploadRing::EndFrame()
+    {
+        if (!m_valid)
+            return;
+
+        Unmap();
+        m_stats.frames++;
+
+        // 没有分配的帧不需要围栏
+        if (m_frameBytes == 0)
+            return;
+
+        const uint64_t fence = m_nextFence++;
+        m_device->SignalFence(fence);
+        m_frames.push_back(FrameRecord{ fence, m_head, m_frameBytes });
+        m_frameBytes = 0;
+    }
+
+    UploadRing::Stats UploadRing::GetStats() const
+    {
+        Stats stats = m_stats;
+        stats.usedBytes = m_used;
+        stats.framesInFlight = static_cast<uint32_t>(m_frames.size());
+        return stats;
+    }
+
+    bool UploadRing::Reserve(uint64_t size, uint64_t& offset)
+    {
+        if (size > m_desc.capacity)
+            return false;
+
+        if (m_used == 0)
+        {
+            m_head = 0;
+            m_tail = 0;
+        }
+
+        // head 在 tail 之后（含空环）时，空闲区是 [head, 末尾) 和 [0, tail)；否则是 [head, tail)
+        const bool wrapped = m_head < m_tail || (m_head == m_tail && m_used > 0);
+        if (!wrapped)
+        {
+            if (m_desc.capacity - m_head >= size)
+            {
+                offset = m_head;
+            }
+            else if (m_tail >= size)
+            {
+                // 末尾放不下，跳过剩余部分从开头继续，跳过的字节随本帧一起回收
+                const uint64_t waste = m_desc.capacity - m_head;
+                m_used += waste;
+                m_frameBytes += waste;
+                m_stats.wrapWaste += waste;
+                offset = 0;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if (m_tail - m_head >= size)
+        {
+            offset = m_head;
+        }
+        else
+        {
+            return false;
+        }
+
+        m_head = offset + size;
+        m_used += size;
+        m_frameBytes += size;
+        return true;
+    }
+
+    void UploadRing::Retire(uint64_t completedFence)
+    {
+        while (!m_frames.empty() && m_frames.front().fence <= completedFence)
+        {
+            m_tail = m_frames.front().end;
+            m_used -= m_frames.front().bytes;
+            m_frames.pop_front();
+        }
+    }
+}
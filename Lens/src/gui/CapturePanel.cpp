@@ -1,6 +1,5 @@
 ﻿#include "LensPch.h"
 #include "gui/CapturePanel.h"
-#include "Application.h"
 #include "Log.h"
 
 namespace lens
@@ -17,6 +16,20 @@ namespace lens
 
     void CapturePanel::Shutdown()
     {
+        // 回调引用本面板，先把未完成的回读处理掉
+        if (m_readback)
+        {
+            m_readback->Flush();
+        }
+        if (m_snapshots)
+        {
+            m_snapshots->Flush();
+        }
+        m_recorder.Close();
+        m_videoRecorder.Close();
+        m_replay.reset();
+        m_previewTexture.reset();
+        m_lastReadback.reset();
         LOG_INFO("CapturePanel shutdown");
     }
 
@@ -32,25 +45,224 @@ namespace lens
         if (m_capturer && m_capturer->HasNewFrame())
         {
             auto frame = m_capturer->GetLatestFrame();
-            if (frame)
+            if (frame.texture)
             {
-                m_lastFrame = frame;
+                m_lastFrame = std::move(frame);
+                m_lastFramePresented = false;
+
+                // 内容没变的帧不需要再分析
+                const bool wantPreview = m_filteredPreview && m_device;
+                if (m_readback && (m_readbackEnabled || wantPreview || m_recording || m_recordingVideo || m_replay) && !m_lastFrame.descriptor.IsUnchanged())
+                {
+                    m_readback->Submit(m_lastFrame.texture.get(),
+                        [this, descriptor = m_lastFrame.descriptor](std::shared_ptr<const graphics::CpuImage> image)
+                    {
+                        OnReadback(std::move(image), descriptor);
+                    });
+                }
+
+                if (m_snapshots && m_burstRemaining > 0)
+                {
+                    m_snapshots->Submit(m_lastFrame, capturer::SnapshotWriter::MakeSnapshotPath("snapshots"));
+                    m_burstRemaining--;
+                }
             }
         }
 
         if (ImGui::Begin("Capture", &m_visible))
         {
+            // Frame pipeline counters
+            if (m_capturer)
+            {
+                auto stats = m_capturer->GetFrameStats();
+                ImGui::Text("Delivered: %llu  Forwarded: %llu  Dropped: %llu  Unchanged: %llu",
+                    static_cast<unsigned long long>(stats.delivered),
+                    static_cast<unsigned long long>(stats.forwarded),
+                    static_cast<unsigned long long>(stats.dropped),
+                    static_cast<unsigned long long>(stats.unchanged));
+                if (stats.deduplicated > 0)
+                {
+                    ImGui::Text("Dedup: %llu (%.1f MB saved)",
+                        static_cast<unsigned long long>(stats.deduplicated),
+                        stats.dedupBytes / (1024.0 * 1024.0));
+                }
+
+                // Capture-to-display latency
+                const auto& present = m_capturer->GetLatency().Get(capturer::FrameLatency::Stage::Present);
+                if (present.GetCount() > 0)
+                {
+                    ImGui::Text("Latency p50: %.2f ms  p99: %.2f ms  p99.9: %.2f ms",
+                        capturer::FrameLatency::TicksToMs(present.GetPercentile(0.50)),
+                        capturer::FrameLatency::TicksToMs(present.GetPercentile(0.99)),
+                        capturer::FrameLatency::TicksToMs(present.GetPercentile(0.999)));
+                }
+            }
+
+            // Resources waiting for the GPU before destruction
+            if (m_device)
+            {
+                auto stats = m_device->GetReleaseQueue().GetStats();
+                if (stats.pendingCount > 0)
+                {
+                    ImGui::Text("Pending release: %llu (%.1f MB)",
+                        static_cast<unsigned long long>(stats.pendingCount),
+                        stats.pendingBytes / (1024.0 * 1024.0));
+                }
+            }
+
+            // Readback throughput
+            if (m_readback)
+            {
+                ImGui::Checkbox("Read back frames", &m_readbackEnabled);
+                if (m_readbackEnabled)
+                {
+                    auto stats = m_readback->GetStats();
+                    ImGui::SameLine();
+                    ImGui::Text("%.1f MB/s  latency %.2f ms  dropped %llu",
+                        stats.throughputMBps, stats.avgLatencyMs,
+                        static_cast<unsigned long long>(stats.dropped));
+
+                    if (!m_diffResult.bitmap.empty())
+                    {
+                        ImGui::Text("Changed tiles: %u / %u  rects: %zu  (%.2f ms)",
+                            m_diffResult.dirtyTiles, m_diffResult.tilesX * m_diffResult.tilesY,
+                            m_diffResult.rects.size(), m_diffMs);
+                    }
+                }
+
+                // Raw recording
+                if (ImGui::Checkbox("Record", &m_recording))
+                {
+                    if (m_recording)
+                    {
+                        capturer::RawRecordingWriter::Desc recordDesc;
+                        recordDesc.path = capturer::SnapshotWriter::MakeSnapshotPath("recordings", ".lensraw");
+                        recordDesc.deltaCompression = true;
+                        m_recording = m_recorder.Open(recordDesc);
+                    }
+                    else
+                    {
+                        m_recorder.Close();
+                    }
+                }
+                if (m_recording)
+                {
+                    auto stats = m_recorder.GetStats();
+                    ImGui::SameLine();
+                    ImGui::Text("%llu frames  %.1f MB (raw %.1f MB)  stalls %u",
+                        static_cast<unsigned long long>(stats.frames),
+                        stats.bytesWritten / (1024.0 * 1024.0), stats.inputBytes / (1024.0 * 1024.0), stats.stalls);
+                }
+
+                // MJPEG/AVI recording
+                if (ImGui::Checkbox("Record MJPEG", &m_recordingVideo))
+                {
+                    if (m_recordingVideo)
+                    {
+                        capturer::MjpegRecorder::Desc videoDesc;
+                        videoDesc.path = capturer::SnapshotWriter::MakeSnapshotPath("recordings", ".avi");
+                        m_recordingVideo = m_videoRecorder.Open(videoDesc);
+                    }
+                    else
+                    {
+                        m_videoRecorder.Close();
+                    }
+                }
+                if (m_recordingVideo)
+                {
+                    auto stats = m_videoRecorder.GetStats();
+                    ImGui::SameLine();
+                    ImGui::Text("%llu frames  %.1f MB  encode %.1f ms  dropped %llu",
+                        static_cast<unsigned long long>(stats.encoded + stats.repeated),
+                        stats.bytesWritten / (1024.0 * 1024.0),
+                        stats.encoded > 0 ? stats.encodeMs / stats.encoded : 0.0,
+                        static_cast<unsigned long long>(stats.dropped));
+                }
+
+                // Instant replay
+                bool replayEnabled = m_replay != nullptr;
+                if (ImGui::Checkbox("Instant replay", &replayEnabled))
+                {
+                    if (replayEnabled)
+                    {
+                        m_replay = std::make_unique<capturer::ReplayBuffer>();
+                    }
+                    else
+                    {
+                        m_replay.reset();
+                    }
+                }
+                if (m_replay)
+                {
+                    auto stats = m_replay->GetStats();
+                    ImGui::SameLine();
+                    if (ImGui::Button("Save replay") && !stats.saving)
+                    {
+                        m_replay->SaveAsync(capturer::SnapshotWriter::MakeSnapshotPath("recordings", ".lensraw"));
+                    }
+                    ImGui::SameLine();
+                    ImGui::Text("%.1f s  %u frames  %.1f / %.0f MB%s",
+                        stats.seconds, stats.frames, stats.usedBytes / (1024.0 * 1024.0),
+                        stats.arenaBytes / (1024.0 * 1024.0), stats.saving ? "  saving..." : "");
+                }
+
+                // CPU filtered preview
+                ImGui::Checkbox("Filtered preview", &m_filteredPreview);
+                if (m_filteredPreview)
+                {
+                    const char* filterNames[] = { "Box", "Bilinear", "Lanczos3" };
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100.0f);
+                    ImGui::Combo("##PreviewFilter", &m_previewFilter, filterNames, IM_ARRAYSIZE(filterNames));
+                    if (m_previewTexture)
+                    {
+                        ImGui::SameLine();
+                        ImGui::Text("%ux%u  %.2f ms", m_previewTexture->GetWidth(), m_previewTexture->GetHeight(), m_previewMs);
+                    }
+                }
+            }
+
+            // Snapshots
+            if (m_snapshots)
+            {
+                if (ImGui::Button("Snapshot") && m_lastFrame)
+                {
+                    m_snapshots->Submit(m_lastFrame, capturer::SnapshotWriter::MakeSnapshotPath("snapshots"));
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Burst x30"))
+                {
+                    m_burstRemaining = 30;
+                }
+
+                auto stats = m_snapshots->GetStats();
+                if (stats.submitted > 0)
+                {
+                    ImGui::SameLine();
+                    ImGui::Text("Saved: %llu  Dropped: %llu  Failed: %llu  Pending: %u  encode %.1f ms  write %.1f ms",
+                        static_cast<unsigned long long>(stats.saved),
+                        static_cast<unsigned long long>(stats.dropped),
+                        static_cast<unsigned long long>(stats.failed),
+                        stats.inFlight, stats.avgEncodeMs, stats.avgWriteMs);
+                }
+            }
+
             // Render cached frame
-            if (m_lastFrame && m_lastFrame->GetSRV())
+            const auto& texture = m_lastFrame.texture;
+            if (texture && texture->GetNativeView())
             {
                 // Get texture dimensions
-                uint32_t texWidth = m_lastFrame->GetWidth();
-                uint32_t texHeight = m_lastFrame->GetHeight();
+                uint32_t texWidth = texture->GetWidth();
+                uint32_t texHeight = texture->GetHeight();
 
-                // Convert SRV to ImTextureID (ID3D11ShaderResourceView*)
-                ImTextureID textureId = reinterpret_cast<ImTextureID>(m_lastFrame->GetSRV());
+                // Convert native view to ImTextureID (ID3D11ShaderResourceView* on D3D11)
+                // 已有 CPU 缩小的预览时优先显示预览
+                const bool usePreview = m_filteredPreview && m_previewTexture && m_previewTexture->GetNativeView();
+                ImTextureID textureId = reinterpret_cast<ImTextureID>(
+                    usePreview ? m_previewTexture->GetNativeView() : texture->GetNativeView());
 
                 // Get available content region
+                ImVec2 origin = ImGui::GetCursorPos();
                 ImVec2 availSize = ImGui::GetContentRegionAvail();
 
                 // Calculate display size maintaining aspect ratio
@@ -76,13 +288,25 @@ namespace lens
                 // Center the image
                 ImGui::SetCursorPos(
                     ImVec2(
-                        (availSize.x - displayWidth) * 0.5f,
-                        (availSize.y - displayHeight) * 0.5f
+                        origin.x + (availSize.x - displayWidth) * 0.5f,
+                        origin.y + (availSize.y - displayHeight) * 0.5f
                     )
                 );
 
                 // Render the image
                 ImGui::Image(textureId, ImVec2(displayWidth, displayHeight));
+
+                // 预览目标为当前显示尺寸，下一次回读按此缩放
+                m_previewWidth = static_cast<uint32_t>((std::max)(displayWidth, 1.0f));
+                m_previewHeight = static_cast<uint32_t>((std::max)(displayHeight, 1.0f));
+
+                // Each frame counts once, when it is first drawn
+                if (!m_lastFramePresented && m_capturer)
+                {
+                    m_capturer->GetLatency().Record(capturer::FrameLatency::Stage::Present,
+                        m_lastFrame.descriptor.captureTime);
+                    m_lastFramePresented = true;
+                }
             }
             else
             {
@@ -97,4 +321,75 @@ namespace lens
         }
         ImGui::End();
     }
+
+    void CapturePanel::OnReadback(std::shared_ptr<const graphics::CpuImage> image, const capturer::FrameDescriptor& descriptor)
+    {
+        if (m_recording && !m_recorder.Append(image, descriptor))
+        {
+            m_recording = false;
+            m_recorder.Close();
+        }
+
+        if (m_replay)
+        {
+            m_replay->Append(image, descriptor);
+        }
+
+        // 队列满时丢帧，时间轴上的空缺由录制器补齐
+        if (m_recordingVideo)
+        {
+            m_videoRecorder.Submit(image, descriptor.captureTime);
+        }
+
+        if (m_readbackEnabled)
+        {
+            auto start = std::chrono::steady_clock::now();
+            m_frameDiff.Compare(m_lastReadback.get(), *image, m_diffResult);
+            m_diffMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            m_lastReadback = image;
+        }
+
+        if (m_filteredPreview)
+        {
+            UpdatePreview(*image);
+        }
+    }
+
+    void CapturePanel::UpdatePreview(const graphics::CpuImage& image)
+    {
+        if (!m_device || m_previewWidth == 0 || m_previewHeight == 0)
+            return;
+
+        auto start = std::chrono::steady_clock::now();
+        if (!m_resampler.ResampleToFit(image, m_previewWidth, m_previewHeight,
+            static_cast<graphics::ResampleFilter>(m_previewFilter), m_previewImage))
+        {
+            return;
+        }
+        m_previewMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // 尺寸或格式变化时重建纹理，否则原地更新
+        if (!m_previewTexture ||
+            m_previewTexture->GetWidth() != m_previewImage.width ||
+            m_previewTexture->GetHeight() != m_previewImage.height ||
+            m_previewTexture->GetFormat() != m_previewImage.format)
+        {
+            graphics::Texture::Desc desc{};
+            desc.width = m_previewImage.width;
+            desc.height = m_previewImage.height;
+            desc.format = m_previewImage.format;
+
+            auto texture = m_device->CreateTexture();
+            if (!texture->Create(m_device, desc))
+            {
+                LOG_ERROR("Failed to create preview texture {}x{}", desc.width, desc.height);
+                m_previewTexture.reset();
+                return;
+            }
+            m_previewTexture = std::move(texture);
+        }
+
+        m_previewTexture->UpdateRegion(m_device, m_previewImage.pixels.data(), m_previewImage.rowPitch,
+            0, 0, m_previewImage.width, m_previewImage.height);
+    }
 }
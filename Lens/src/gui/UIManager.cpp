@@ -3,12 +3,12 @@
 #include "gui/DemoPanel.h"
 #include "gui/DebugPanel.h"
 #include "gui/CapturePanel.h"
-#include "capturer/WGCCapturer.h"
+#include "capturer/ICaptureSource.h"
 #include "Log.h"
 #define IMGUI_HAS_DOCKING
 namespace lens
 {
-    void UIManager::InitializeAllPanels(capturer::WGCCapturer* capturer)
+    void UIManager::InitializeAllPanels(capturer::ICaptureSource* capturer)
     {
         LOG_INFO("UIManager: Initializing all panels...");
 
@@ -50,7 +50,7 @@ namespace lens
         //}
     }
 
-    void UIManager::RegisterCapturePanels(capturer::WGCCapturer* capturer)
+    void UIManager::RegisterCapturePanels(capturer::ICaptureSource* capturer)
     {
         LOG_INFO("UIManager: Registering capture panels...");
 
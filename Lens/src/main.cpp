@@ -3,14 +3,73 @@
 #pragma comment(lib, "windowsapp")
 
 #include "Application.h"
+#include "bench/Benchmark.h"
+#include "tests/SelfTest.h"
 
 int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                      _In_opt_ HINSTANCE hPrevInstance,
                      _In_ LPWSTR    lpCmdLine,
                      _In_ int       nCmdShow)
 {
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+
+    // 基准测试模式：--bench <名称> [参数...]，不创建窗口
+    if (argv && argc >= 3 && std::wstring(argv[1]) == L"--bench")
+    {
+        std::vector<std::string> args;
+        for (int i = 3; i < argc; ++i)
+        {
+            args.push_back(winrt::to_string(argv[i]));
+        }
+        std::string name = winrt::to_string(argv[2]);
+        LocalFree(argv);
+        return lens::bench::RunBenchmark(name, args);
+    }
+
+    // 自检模式：--test [名称]，不创建窗口，返回失败的测试数
+    if (argv && argc >= 2 && std::wstring(argv[1]) == L"--test")
+    {
+        std::string name = argc >= 3 ? winrt::to_string(argv[2]) : std::string();
+        LocalFree(argv);
+        return lens::tests::RunTests(name);
+    }
+
     lens::Application app(hInstance, nCmdShow);
 
+    // 命令行选择帧来源：--synthetic 或 --replay <目录或 .lensraw 文件>，默认 WGC；--dedup 丢弃几乎相同的帧；
+    // --headless [帧数] 不创建窗口，用空图形后端跑完指定帧数后退出；--min-refresh <Hz> 空闲时的最低重绘频率
+    for (int i = 1; argv && i < argc; ++i)
+    {
+        std::wstring arg = argv[i];
+        if (arg == L"--synthetic")
+        {
+            app.SetCaptureBackend(lens::Application::CaptureBackend::Synthetic);
+        }
+        else if (arg == L"--replay" && i + 1 < argc)
+        {
+            app.SetCaptureBackend(lens::Application::CaptureBackend::FileReplay, argv[++i]);
+        }
+        else if (arg == L"--dedup")
+        {
+            app.SetFrameDedup(true);
+        }
+        else if (arg == L"--headless")
+        {
+            uint32_t frames = 600;
+            if (i + 1 < argc && iswdigit(argv[i + 1][0]))
+            {
+                frames = static_cast<uint32_t>(wcstoul(argv[++i], nullptr, 10));
+            }
+            app.SetHeadless(frames);
+        }
+        else if (arg == L"--min-refresh" && i + 1 < argc)
+        {
+            app.SetMinRefreshRate(wcstod(argv[++i], nullptr));
+        }
+    }
+    LocalFree(argv);
+
     app.Initialize();
 
     auto res = app.Run();
@@ -0,0 +1,91 @@
+﻿#include "LensPch.h"
+#include "tests/SelfTest.h"
+#include "capturer/FrameMailbox.h"
+#include <thread>
+
+namespace lens::tests
+{
+    namespace
+    {
+        void TestSingleThreaded()
+        {
+            capturer::FrameMailbox<uint64_t> mailbox;
+            uint64_t value = 0;
+            LENS_CHECK(!mailbox.HasNew());
+            LENS_CHECK(!mailbox.TryTake(value));
+
+            // 最新的帧胜出，被覆盖的计为丢帧
+            mailbox.Publish(1);
+            mailbox.Publish(2);
+            mailbox.Publish(3);
+            LENS_CHECK(mailbox.HasNew());
+            LENS_CHECK(mailbox.TryTake(value) && value == 3);
+            LENS_CHECK(!mailbox.TryTake(value));
+            LENS_CHECK(mailbox.GetPublishedCount() == 3);
+            LENS_CHECK(mailbox.GetDroppedCount() == 2);
+
+            // 没有新帧时等待超时
+            const auto start = std::chrono::steady_clock::now();
+            LENS_CHECK(!mailbox.WaitTake(value, std::chrono::milliseconds(20)));
+            LENS_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(15));
+
+            mailbox.Publish(4);
+            mailbox.Reset();
+            LENS_CHECK(!mailbox.HasNew());
+            LENS_CHECK(mailbox.GetPublishedCount() == 0);
+            LENS_CHECK(mailbox.GetDroppedCount() == 0);
+        }
+
+        // 生产者连续发布递增序号，消费者看到的序号必须严格递增，
+        // 取空之后 取走 + 丢弃 = 发布，最后一帧一定能取到
+        void TestStress(bool blocking)
+        {
+            constexpr uint64_t kCount = 1000000;
+            capturer::FrameMailbox<uint64_t> mailbox;
+            std::atomic<bool> done{ false };
+
+            std::thread producer([&]
+            {
+                for (uint64_t i = 1; i <= kCount; ++i)
+                {
+                    mailbox.Publish(i);
+                }
+                done = true;
+            });
+
+            uint64_t taken = 0;
+            uint64_t last = 0;
+            uint64_t value = 0;
+            bool ordered = true;
+            auto take = [&]
+            {
+                const bool ok = blocking ? mailbox.WaitTake(value, std::chrono::milliseconds(10)) : mailbox.TryTake(value);
+                if (ok)
+                {
+                    ordered = ordered && value > last;
+                    last = value;
+                    taken++;
+                }
+            };
+            while (!done)
+            {
+                take();
+            }
+            producer.join();
+            take();
+
+            LENS_CHECK(ordered);
+            LENS_CHECK(last == kCount);
+            LENS_CHECK(!mailbox.HasNew());
+            LENS_CHECK(mailbox.GetPublishedCount() == kCount);
+            LENS_CHECK(taken + mailbox.GetDroppedCount() == kCount);
+        }
+    }
+
+    void TestFrameMailbox()
+    {
+        TestSingleThreaded();
+        TestStress(false);
+        TestStress(true);
+    }
+}
@@ -0,0 +1,64 @@
+﻿#include "LensPch.h"
+#include "tests/SelfTest.h"
+#include "capturer/FramePacer.h"
+
+namespace lens::tests
+{
+    namespace
+    {
+        // 按 sourceHz 均匀送入 seconds 秒的帧，返回转发的帧数；检查相邻转发间隔不小于 minGap
+        uint64_t RunPacer(capturer::FramePacer::Policy policy, uint32_t frameRate, uint32_t sourceHz,
+            uint32_t seconds, int64_t minGap)
+        {
+            capturer::FramePacer::Desc desc;
+            desc.policy = policy;
+            desc.frameRate = frameRate;
+            capturer::FramePacer pacer(desc);
+
+            const uint64_t frames = static_cast<uint64_t>(sourceHz) * seconds;
+            int64_t last = -capturer::FramePacer::kTicksPerSecond;
+            for (uint64_t i = 0; i < frames; ++i)
+            {
+                const int64_t timestamp = static_cast<int64_t>(i * capturer::FramePacer::kTicksPerSecond / sourceHz);
+                if (pacer.ShouldForward(timestamp))
+                {
+                    LENS_CHECK(timestamp - last >= minGap);
+                    last = timestamp;
+                }
+            }
+            LENS_CHECK(pacer.GetDeliveredCount() == frames);
+            return pacer.GetForwardedCount();
+        }
+    }
+
+    void TestFramePacer()
+    {
+        using Policy = capturer::FramePacer::Policy;
+        const int64_t interval60 = capturer::FramePacer::kTicksPerSecond / 60;
+
+        // MaxRate 是硬上限：相邻转发间隔不小于 1/fps
+        const uint64_t maxRate = RunPacer(Policy::MaxRate, 60, 144, 10, interval60);
+        LENS_CHECK(maxRate <= 600);
+        LENS_CHECK(maxRate >= 480);
+
+        // FixedRate 按节拍转发，容差允许个别帧提前，总数与目标帧率一致
+        const uint64_t fixedRate = RunPacer(Policy::FixedRate, 60, 144, 10, 0);
+        LENS_CHECK(fixedRate >= 599 && fixedRate <= 601);
+
+        // 60 → 30 不会因为抖动掉成 20
+        const uint64_t halfRate = RunPacer(Policy::FixedRate, 30, 60, 10, 0);
+        LENS_CHECK(halfRate >= 299 && halfRate <= 301);
+
+        LENS_CHECK(RunPacer(Policy::Unlimited, 60, 144, 1, 0) == 144);
+
+        // OnChangeOnly 丢弃没有变化的帧
+        capturer::FramePacer::Desc desc;
+        desc.policy = Policy::OnChangeOnly;
+        desc.frameRate = 60;
+        capturer::FramePacer pacer(desc);
+        LENS_CHECK(pacer.ShouldForward(0, true));
+        LENS_CHECK(!pacer.ShouldForward(interval60 * 2, false));
+        LENS_CHECK(pacer.ShouldForward(interval60 * 2 + 1, true));
+        LENS_CHECK(!pacer.ShouldForward(interval60 * 2 + 2, true));
+    }
+}
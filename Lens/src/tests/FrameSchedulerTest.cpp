@@ -0,0 +1,156 @@
+﻿#include "LensPch.h"
+#include "tests/SelfTest.h"
+#include "FrameScheduler.h"
+
+namespace lens::tests
+{
+    namespace
+    {
+        using Clock = FrameScheduler::Clock;
+        using Reason = FrameScheduler::Reason;
+        using namespace std::chrono_literals;
+
+        // 调度器不读时钟，用远离纪元的固定时间点，避免和 m_lastRedraw 的初值混在一起
+        const Clock::time_point kStart = Clock::time_point{} + 1000s;
+
+        // 模拟一次平台层醒来：需要重绘时绘制并返回 true
+        bool Wake(FrameScheduler& scheduler, Clock::time_point now)
+        {
+            if (!scheduler.ShouldRedraw(now))
+                return false;
+            scheduler.OnRedrawn(now);
+            return true;
+        }
+
+        // 检查计数的基本关系：每次醒来要么重绘要么空闲
+        void CheckAccounting(const FrameScheduler& scheduler)
+        {
+            const auto& stats = scheduler.GetStats();
+            LENS_CHECK(stats.wakeups == stats.redraws + stats.idleWakeups);
+        }
+
+        void TestSettle()
+        {
+            FrameScheduler::Desc desc;
+            desc.minRefreshHz = 0.0;
+            desc.settleFrames = 2;
+            FrameScheduler scheduler(desc);
+
+            // 第一帧按输入处理，之后补两帧，然后进入无期限等待
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart) == Clock::duration::zero());
+            LENS_CHECK(Wake(scheduler, kStart));
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart) == Clock::duration::zero());
+            LENS_CHECK(Wake(scheduler, kStart + 1ms));
+            LENS_CHECK(Wake(scheduler, kStart + 2ms));
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 2ms) == Clock::duration::max());
+            LENS_CHECK(!Wake(scheduler, kStart + 3ms));
+
+            auto stats = scheduler.GetStats();
+            LENS_CHECK(stats.redraws == 3);
+            LENS_CHECK(stats.byInput == 1);
+            LENS_CHECK(stats.bySettle == 2);
+            LENS_CHECK(stats.idleWakeups == 1);
+
+            // 补帧期间的新输入重新开始倒数
+            scheduler.Invalidate(Reason::Input);
+            LENS_CHECK(Wake(scheduler, kStart + 10ms));
+            LENS_CHECK(Wake(scheduler, kStart + 11ms));
+            scheduler.Invalidate(Reason::Input);
+            LENS_CHECK(Wake(scheduler, kStart + 12ms));
+            LENS_CHECK(Wake(scheduler, kStart + 13ms));
+            LENS_CHECK(Wake(scheduler, kStart + 14ms));
+            LENS_CHECK(!Wake(scheduler, kStart + 15ms));
+
+            stats = scheduler.GetStats();
+            LENS_CHECK(stats.byInput == 3);
+            LENS_CHECK(stats.bySettle == 6);
+
+            // 新帧只重绘一次，不触发补帧
+            scheduler.Invalidate(Reason::NewFrame);
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 20ms) == Clock::duration::zero());
+            LENS_CHECK(Wake(scheduler, kStart + 20ms));
+            LENS_CHECK(!Wake(scheduler, kStart + 21ms));
+            LENS_CHECK(scheduler.GetStats().byNewFrame == 1);
+            CheckAccounting(scheduler);
+        }
+
+        void TestTimer()
+        {
+            FrameScheduler::Desc desc;
+            desc.minRefreshHz = 0.0;
+            desc.settleFrames = 0;
+            FrameScheduler scheduler(desc);
+            LENS_CHECK(Wake(scheduler, kStart));
+
+            // 只保留最早的期限，等待时间按它计算
+            scheduler.ScheduleAt(kStart + 80ms);
+            scheduler.ScheduleAt(kStart + 50ms);
+            scheduler.ScheduleAt(kStart + 90ms);
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 10ms) == 40ms);
+
+            // 期限前醒来算空闲，到期后重绘一次，定时器随即清除
+            LENS_CHECK(!Wake(scheduler, kStart + 30ms));
+            LENS_CHECK(Wake(scheduler, kStart + 50ms));
+            LENS_CHECK(scheduler.GetStats().byTimer == 1);
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 50ms) == Clock::duration::max());
+            LENS_CHECK(!Wake(scheduler, kStart + 200ms));
+
+            // 已经过期的期限不再等待
+            scheduler.ScheduleAt(kStart + 250ms);
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 300ms) == Clock::duration::zero());
+            LENS_CHECK(Wake(scheduler, kStart + 300ms));
+            LENS_CHECK(scheduler.GetStats().byTimer == 2);
+            LENS_CHECK(scheduler.GetStats().idleWakeups == 2);
+            CheckAccounting(scheduler);
+        }
+
+        void TestMinRefresh()
+        {
+            FrameScheduler::Desc desc;
+            desc.minRefreshHz = 4.0;
+            desc.settleFrames = 0;
+            FrameScheduler scheduler(desc);
+            // 还没有绘制过，第一帧同时计入最低刷新
+            LENS_CHECK(Wake(scheduler, kStart));
+            LENS_CHECK(scheduler.GetStats().byMinRefresh == 1);
+
+            // 没有事件时按最低刷新间隔醒来
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 100ms) == 150ms);
+            LENS_CHECK(!Wake(scheduler, kStart + 249ms));
+            LENS_CHECK(Wake(scheduler, kStart + 250ms));
+            LENS_CHECK(scheduler.GetStats().byMinRefresh == 2);
+
+            // 间隔从上一次重绘算起，事件重绘也会推迟它
+            scheduler.Invalidate(Reason::NewFrame);
+            LENS_CHECK(Wake(scheduler, kStart + 300ms));
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 300ms) == 250ms);
+            LENS_CHECK(!Wake(scheduler, kStart + 500ms));
+
+            // 更早的定时器优先
+            scheduler.ScheduleAt(kStart + 400ms);
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 300ms) == 100ms);
+            LENS_CHECK(Wake(scheduler, kStart + 550ms));
+            LENS_CHECK(scheduler.GetStats().byMinRefresh == 3);
+            LENS_CHECK(scheduler.GetStats().byTimer == 1);
+
+            // 长时间没有醒来，只补一帧
+            LENS_CHECK(Wake(scheduler, kStart + 10s));
+            LENS_CHECK(scheduler.GetStats().redraws == 5);
+            LENS_CHECK(scheduler.GetStats().idleWakeups == 2);
+            CheckAccounting(scheduler);
+
+            // 关掉最低刷新率后不再有期限
+            desc.minRefreshHz = 0.0;
+            scheduler.Configure(desc);
+            LENS_CHECK(scheduler.GetWaitTimeout(kStart + 20s) == Clock::duration::max());
+            LENS_CHECK(!Wake(scheduler, kStart + 20s));
+        }
+    }
+
+    void TestFrameScheduler()
+    {
+        TestSettle();
+        TestTimer();
+        TestMinRefresh();
+    }
+}
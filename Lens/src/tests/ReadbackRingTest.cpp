@@ -0,0 +1,175 @@
+﻿#include "LensPch.h"
+#include "tests/SelfTest.h"
+#include "graphics/ReadbackRing.h"
+
+namespace lens::tests
+{
+    namespace
+    {
+        // 假回读设备：复制在 IsSlotReady 被问过 latency 次之后才算完成，
+        // ReadSlot 把提交序号写进图像第一个字节，便于检查交付顺序
+        class FakeReadbackDevice : public graphics::IReadbackDevice
+        {
+        public:
+            struct Counters
+            {
+                uint32_t prepares = 0;
+                uint32_t copies = 0;
+                uint32_t readyChecks = 0;
+                uint32_t reads = 0;
+                uint32_t releases = 0;
+            };
+
+            FakeReadbackDevice(Counters& counters, uint32_t latency)
+                : m_counters(counters), m_latency(latency)
+            {
+            }
+
+            bool PrepareSlot(uint32_t slot, uint32_t width, uint32_t height, graphics::TextureFormat format) override
+            {
+                m_counters.prepares++;
+                if (slot >= m_slots.size())
+                {
+                    m_slots.resize(slot + 1);
+                }
+                return width > 0 && height > 0;
+            }
+
+            bool SubmitCopy(uint32_t slot, graphics::Texture* source) override
+            {
+                m_counters.copies++;
+                m_slots[slot].remaining = m_latency;
+                m_slots[slot].sequence = m_nextSequence++;
+                m_slots[slot].fail = failNext;
+                failNext = false;
+                return true;
+            }
+
+            bool IsSlotReady(uint32_t slot) override
+            {
+                m_counters.readyChecks++;
+                if (m_slots[slot].remaining == 0)
+                    return true;
+                m_slots[slot].remaining--;
+                return false;
+            }
+
+            ReadResult ReadSlot(uint32_t slot, graphics::CpuImage& image) override
+            {
+                m_counters.reads++;
+                if (m_slots[slot].remaining > 0)
+                    return ReadResult::NotReady;
+                if (m_slots[slot].fail)
+                    return ReadResult::Failed;
+                image.pixels[0] = static_cast<uint8_t>(m_slots[slot].sequence);
+                return ReadResult::Ok;
+            }
+
+            void ReleaseSlots() override
+            {
+                m_counters.releases++;
+                m_slots.clear();
+            }
+
+            bool failNext = false;
+
+        private:
+            struct Slot
+            {
+                uint32_t remaining = 0;
+                uint32_t sequence = 0;
+                bool fail = false;
+            };
+
+            Counters& m_counters;
+            uint32_t m_latency;
+            uint32_t m_nextSequence = 0;
+            std::vector<Slot> m_slots;
+        };
+
+        struct Delivery
+        {
+            std::vector<uint8_t> sequences;
+            std::vector<const graphics::CpuImage*> images;
+
+            graphics::ReadbackRing::Callback MakeCallback()
+            {
+                return [this](std::shared_ptr<const graphics::CpuImage> image)
+                {
+                    sequences.push_back(image->pixels[0]);
+                    images.push_back(image.get());
+                };
+            }
+        };
+    }
+
+    void TestReadbackRing()
+    {
+        auto device = graphics::CreateGraphicsDevice(graphics::GraphicsBackend::Null);
+        LENS_CHECK(device && device->Initialize({}));
+
+        auto texture = device->CreateTexture();
+        graphics::Texture::Desc textureDesc;
+        textureDesc.width = 64;
+        textureDesc.height = 32;
+        textureDesc.format = graphics::TextureFormat::BGRA8_UNorm;
+        LENS_CHECK(texture->Create(device.get(), textureDesc));
+
+        FakeReadbackDevice::Counters counters;
+        {
+            auto fake = std::make_unique<FakeReadbackDevice>(counters, 2);
+            FakeReadbackDevice* fakeDevice = fake.get();
+            graphics::ReadbackRing ring(std::move(fake), 3);
+            Delivery delivery;
+
+            // 槽位用尽时拒绝并计为丢弃
+            for (int i = 0; i < 4; ++i)
+            {
+                ring.Submit(texture.get(), delivery.MakeCallback());
+            }
+            LENS_CHECK(ring.GetInFlightCount() == 3);
+            LENS_CHECK(ring.GetStats().dropped == 1);
+
+            // 没完成时只检查就绪，不读取、不从池里借图像
+            LENS_CHECK(ring.Poll() == 0);
+            LENS_CHECK(ring.Poll() == 0);
+            LENS_CHECK(counters.reads == 0);
+            LENS_CHECK(ring.GetStats().notReadyPolls == 2);
+
+            // 按提交顺序交付，后面的槽位要等前面的完成
+            LENS_CHECK(ring.Poll() == 1);
+            LENS_CHECK(ring.Poll() == 0);
+            LENS_CHECK(counters.reads == 1);
+            ring.Flush();
+            LENS_CHECK(ring.GetInFlightCount() == 0);
+            LENS_CHECK(delivery.sequences == std::vector<uint8_t>({ 0, 1, 2 }));
+            LENS_CHECK(counters.reads == 3);
+
+            // 回调释放图像后，下一帧复用同一块内存
+            delivery = {};
+            ring.Submit(texture.get(), delivery.MakeCallback());
+            ring.Flush();
+            ring.Submit(texture.get(), delivery.MakeCallback());
+            ring.Flush();
+            LENS_CHECK(delivery.images.size() == 2 && delivery.images[0] == delivery.images[1]);
+
+            // 失败的帧不回调，后面的帧照常交付
+            delivery = {};
+            fakeDevice->failNext = true;
+            ring.Submit(texture.get(), delivery.MakeCallback());
+            ring.Submit(texture.get(), delivery.MakeCallback());
+            ring.Flush();
+            LENS_CHECK(ring.GetStats().failed == 1);
+            LENS_CHECK(delivery.sequences.size() == 1);
+
+            auto stats = ring.GetStats();
+            LENS_CHECK(stats.submitted == 7);
+            LENS_CHECK(stats.completed == 6);
+            LENS_CHECK(stats.bytesRead == 6ull * 64 * 32 * 4);
+
+            // 析构时丢弃在途的帧并释放槽位
+            ring.Submit(texture.get(), delivery.MakeCallback());
+        }
+        LENS_CHECK(counters.releases == 1);
+    }
+}
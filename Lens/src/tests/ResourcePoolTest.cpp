@@ -0,0 +1,161 @@
+﻿#include "LensPch.h"
+#include "tests/SelfTest.h"
+#include "graphics/ResourcePool.h"
+
+namespace lens::tests
+{
+    namespace
+    {
+        struct FakeResource
+        {
+            int key;
+        };
+
+        using Pool = graphics::ResourcePool<FakeResource, int>;
+
+        // 记录工厂和 Disposer 的调用，计数即可检验复用是否生效
+        struct FakeFactory
+        {
+            uint32_t created = 0;
+            uint32_t disposed = 0;
+
+            Pool::Factory MakeFactory()
+            {
+                return [this](const int& key) -> std::unique_ptr<FakeResource>
+                {
+                    created++;
+                    return key < 0 ? nullptr : std::make_unique<FakeResource>(FakeResource{ key });
+                };
+            }
+
+            Pool::Disposer MakeDisposer()
+            {
+                return [this](const int&, std::unique_ptr<FakeResource>) { disposed++; };
+            }
+        };
+
+        void TestReuse()
+        {
+            FakeFactory factory;
+            Pool pool(factory.MakeFactory());
+
+            // 同 key 归还后复用，不同 key 另行创建
+            {
+                auto a = pool.Acquire(1);
+                LENS_CHECK(a && a->key == 1);
+                LENS_CHECK(pool.GetStats().liveCount == 1);
+            }
+            {
+                auto a = pool.Acquire(1);
+                auto b = pool.Acquire(2);
+                LENS_CHECK(a && a->key == 1 && b && b->key == 2);
+            }
+            auto stats = pool.GetStats();
+            LENS_CHECK(factory.created == 2);
+            LENS_CHECK(stats.allocations == 2);
+            LENS_CHECK(stats.reuses == 1);
+            LENS_CHECK(stats.liveCount == 0);
+            LENS_CHECK(stats.idleCount == 2);
+
+            // 工厂失败时返回空，不计入分配
+            LENS_CHECK(!pool.Acquire(-1));
+            LENS_CHECK(pool.GetStats().allocations == 2);
+        }
+
+        void TestWatermarks()
+        {
+            FakeFactory factory;
+            Pool::Desc desc;
+            desc.lowWatermark = 1;
+            desc.highWatermark = 3;
+            desc.maxIdleFrames = 0;
+            Pool pool(factory.MakeFactory(), desc);
+            pool.SetDisposer(factory.MakeDisposer());
+
+            // 第四个归还时超过高水位，裁剪到低水位，只留最近归还的
+            std::vector<std::shared_ptr<FakeResource>> live;
+            for (int key = 0; key < 4; ++key)
+            {
+                live.push_back(pool.Acquire(key));
+            }
+            for (auto& resource : live)
+            {
+                resource.reset();
+            }
+            auto stats = pool.GetStats();
+            LENS_CHECK(stats.idleCount == 1);
+            LENS_CHECK(stats.trimmed == 3);
+            LENS_CHECK(factory.disposed == 3);
+
+            pool.TrimOtherKeys(3);
+            LENS_CHECK(pool.GetStats().idleCount == 1);
+            pool.TrimOtherKeys(5);
+            LENS_CHECK(pool.GetStats().idleCount == 0);
+            LENS_CHECK(factory.disposed == 4);
+
+            // maxIdleFrames 为 0 时 EndFrame 不裁剪
+            pool.Acquire(7);
+            for (int i = 0; i < 1000; ++i)
+            {
+                pool.EndFrame();
+            }
+            LENS_CHECK(pool.GetStats().idleCount == 1);
+        }
+
+        void TestIdleFrames()
+        {
+            FakeFactory factory;
+            Pool::Desc desc;
+            desc.maxIdleFrames = 3;
+            Pool pool(factory.MakeFactory(), desc);
+            pool.SetDisposer(factory.MakeDisposer());
+
+            auto kept = pool.Acquire(1);
+            pool.Acquire(2);
+            LENS_CHECK(pool.GetStats().idleCount == 1);
+
+            // 空闲不超过 maxIdleFrames 帧时保留，超过后裁剪；借出中的不受影响
+            for (int i = 0; i < 3; ++i)
+            {
+                pool.EndFrame();
+            }
+            LENS_CHECK(pool.GetStats().idleCount == 1);
+            pool.EndFrame();
+            LENS_CHECK(pool.GetStats().idleCount == 0);
+            LENS_CHECK(factory.disposed == 1);
+
+            // 复用会让对象重新开始计时
+            kept.reset();
+            pool.EndFrame();
+            auto again = pool.Acquire(1);
+            LENS_CHECK(pool.GetStats().reuses == 1);
+            again.reset();
+            pool.EndFrame();
+            pool.EndFrame();
+            LENS_CHECK(pool.GetStats().idleCount == 1);
+            LENS_CHECK(factory.created == 2);
+        }
+
+        void TestPoolOutlivedByObject()
+        {
+            FakeFactory factory;
+            std::shared_ptr<FakeResource> orphan;
+            {
+                Pool pool(factory.MakeFactory());
+                pool.SetDisposer(factory.MakeDisposer());
+                orphan = pool.Acquire(1);
+            }
+            // 池已经销毁，对象直接删除，不经过 Disposer
+            orphan.reset();
+            LENS_CHECK(factory.disposed == 0);
+        }
+    }
+
+    void TestResourcePool()
+    {
+        TestReuse();
+        TestWatermarks();
+        TestIdleFrames();
+        TestPoolOutlivedByObject();
+    }
+}
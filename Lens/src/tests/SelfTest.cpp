@@ -0,0 +1,72 @@
+﻿#include "LensPch.h"
+#include "tests/SelfTest.h"
+#include <atomic>
+
+namespace lens::tests
+{
+    namespace
+    {
+        struct TestEntry
+        {
+            const char* name;
+            void (*run)();
+        };
+
+        const TestEntry kTests[] =
+        {
+            { "mailbox", &TestFrameMailbox },
+            { "resource-pool", &TestResourcePool },
+            { "frame-pacer", &TestFramePacer },
+            { "readback-ring", &TestReadbackRing },
+            { "frame-scheduler", &TestFrameScheduler },
+            { "shader-cache", &TestShaderCache },
+            { "upload-ring", &TestUploadRing },
+        };
+
+        // 自检在主线程上逐个运行，测试内部的线程只通过 ReportFailure 计数
+        std::atomic<uint32_t> g_failures{ 0 };
+    }
+
+    void ReportFailure(const char* expression, const char* file, int line)
+    {
+        g_failures.fetch_add(1);
+        LOG_ERROR("  check failed: {} ({}:{})", expression, file, line);
+    }
+
+    int RunTests(const std::string& name)
+    {
+        int failedTests = 0;
+        bool found = false;
+        for (const auto& entry : kTests)
+        {
+            if (!name.empty() && name != entry.name)
+                continue;
+
+            found = true;
+            g_failures = 0;
+            const auto start = std::chrono::steady_clock::now();
+            entry.run();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (g_failures > 0)
+            {
+                LOG_ERROR("[FAIL] {} ({} checks failed, {:.1f} ms)", entry.name, g_failures.load(), ms);
+                failedTests++;
+            }
+            else
+            {
+                LOG_INFO("[ OK ] {} ({:.1f} ms)", entry.name, ms);
+            }
+        }
+
+        if (!found)
+        {
+            LOG_ERROR("Unknown test: {}", name);
+            for (const auto& entry : kTests)
+            {
+                LOG_INFO("  --test {}", entry.name);
+            }
+            return 1;
+        }
+        return failedTests;
+    }
+}
@@ -0,0 +1,223 @@
+﻿#include "LensPch.h"
+#include "tests/SelfTest.h"
+#include "graphics/ShaderCache.h"
+#include <fstream>
+
+namespace lens::tests
+{
+    namespace
+    {
+        using graphics::ShaderCache;
+
+        constexpr size_t kHeaderSize = 32;
+
+        // 每项测试一个空的临时目录，结束时删除
+        class TempDirectory
+        {
+        public:
+            explicit TempDirectory(const char* name)
+                : m_path(std::filesystem::temp_directory_path() / name)
+            {
+                std::error_code ec;
+                std::filesystem::remove_all(m_path, ec);
+            }
+            ~TempDirectory()
+            {
+                std::error_code ec;
+                std::filesystem::remove_all(m_path, ec);
+            }
+
+            const std::filesystem::path& GetPath() const { return m_path; }
+
+        private:
+            std::filesystem::path m_path;
+        };
+
+        ShaderCache::Key MakeTestKey(std::string_view entryPoint)
+        {
+            const ShaderCache::Define defines[] = { { "SAMPLES", "4" } };
+            return ShaderCache::MakeKey("float4 main() : SV_Target { return 0; }", "test.hlsl", entryPoint,
+                "ps_5_0", defines, 0, 47);
+        }
+
+        std::vector<uint8_t> MakeBytecode(size_t size)
+        {
+            std::vector<uint8_t> bytecode(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                bytecode[i] = static_cast<uint8_t>(i * 7 + 3);
+            }
+            return bytecode;
+        }
+
+        void FlipByte(const std::filesystem::path& path, size_t offset)
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekg(static_cast<std::streamoff>(offset));
+            char value = 0;
+            file.read(&value, 1);
+            value = static_cast<char>(value ^ 0x5A);
+            file.seekp(static_cast<std::streamoff>(offset));
+            file.write(&value, 1);
+        }
+
+        void TestKeys()
+        {
+            // 字段边界和每一项输入都参与哈希
+            const auto key = MakeTestKey("main");
+            LENS_CHECK(key == MakeTestKey("main"));
+            LENS_CHECK(!(key == MakeTestKey("main2")));
+
+            const auto ab = ShaderCache::MakeKey("ab", "c", "main", "ps_5_0", {}, 0, 47);
+            const auto bc = ShaderCache::MakeKey("a", "bc", "main", "ps_5_0", {}, 0, 47);
+            LENS_CHECK(ab.hash != bc.hash);
+            LENS_CHECK(ab.hash != ShaderCache::MakeKey("ab", "c", "main", "ps_5_0", {}, 1, 47).hash);
+            LENS_CHECK(ab.hash != ShaderCache::MakeKey("ab", "c", "main", "ps_5_0", {}, 0, 43).hash);
+        }
+
+        void TestRoundTrip()
+        {
+            TempDirectory directory("lens-test-shadercache-roundtrip");
+            ShaderCache::Desc desc;
+            desc.directory = directory.GetPath();
+            ShaderCache cache(desc);
+
+            const auto key = MakeTestKey("main");
+            const auto bytecode = MakeBytecode(1000);
+            std::vector<uint8_t> loaded;
+            LENS_CHECK(!cache.Load(key, loaded));
+            LENS_CHECK(cache.Store(key, bytecode.data(), bytecode.size()));
+            LENS_CHECK(std::filesystem::file_size(cache.GetPath(key)) == kHeaderSize + bytecode.size());
+            LENS_CHECK(cache.Load(key, loaded));
+            LENS_CHECK(loaded == bytecode);
+
+            // 另一个实例读同一个目录也能命中
+            ShaderCache other(desc);
+            loaded.clear();
+            LENS_CHECK(other.Load(key, loaded));
+            LENS_CHECK(loaded == bytecode);
+
+            // 命中时不调用编译；未命中时编译并写回
+            uint32_t compiles = 0;
+            auto compile = [&](std::vector<uint8_t>& out) { compiles++; out = MakeBytecode(64); return true; };
+            LENS_CHECK(cache.GetOrCompile(key, loaded, compile));
+            LENS_CHECK(compiles == 0 && loaded == bytecode);
+
+            const auto otherKey = MakeTestKey("other");
+            LENS_CHECK(cache.GetOrCompile(otherKey, loaded, compile));
+            LENS_CHECK(compiles == 1 && loaded == MakeBytecode(64));
+            LENS_CHECK(cache.GetOrCompile(otherKey, loaded, compile));
+            LENS_CHECK(compiles == 1);
+
+            // 编译失败不写入
+            const auto failedKey = MakeTestKey("failed");
+            LENS_CHECK(!cache.GetOrCompile(failedKey, loaded, [](std::vector<uint8_t>&) { return false; }));
+            LENS_CHECK(!std::filesystem::exists(cache.GetPath(failedKey)));
+
+            const auto stats = cache.GetStats();
+            LENS_CHECK(stats.hits == 3);
+            LENS_CHECK(stats.misses == 3);
+            LENS_CHECK(stats.stores == 2);
+            LENS_CHECK(stats.rejected == 0);
+            LENS_CHECK(stats.bytesRead == 2000 + 64);
+
+            // 残留的临时文件说明改名失败
+            for (const auto& entry : std::filesystem::directory_iterator(directory.GetPath()))
+            {
+                LENS_CHECK(entry.path().extension() == ".shader");
+            }
+        }
+
+        void TestRejection()
+        {
+            TempDirectory directory("lens-test-shadercache-reject");
+            ShaderCache::Desc desc;
+            desc.directory = directory.GetPath();
+            ShaderCache cache(desc);
+
+            const auto key = MakeTestKey("main");
+            const auto bytecode = MakeBytecode(256);
+            const auto path = cache.GetPath(key);
+            std::vector<uint8_t> loaded;
+
+            // 截断：大小和文件头不符
+            LENS_CHECK(cache.Store(key, bytecode.data(), bytecode.size()));
+            std::filesystem::resize_file(path, kHeaderSize + bytecode.size() - 1);
+            LENS_CHECK(!cache.Load(key, loaded));
+            LENS_CHECK(loaded.empty());
+            LENS_CHECK(!std::filesystem::exists(path));
+
+            // 只剩半个文件头
+            LENS_CHECK(cache.Store(key, bytecode.data(), bytecode.size()));
+            std::filesystem::resize_file(path, kHeaderSize / 2);
+            LENS_CHECK(!cache.Load(key, loaded));
+            LENS_CHECK(!std::filesystem::exists(path));
+
+            // 字节码损坏：CRC 不符
+            LENS_CHECK(cache.Store(key, bytecode.data(), bytecode.size()));
+            FlipByte(path, kHeaderSize + 100);
+            LENS_CHECK(!cache.Load(key, loaded));
+            LENS_CHECK(loaded.empty());
+            LENS_CHECK(!std::filesystem::exists(path));
+
+            // 文件名相同但键校验不同，按哈希碰撞处理
+            LENS_CHECK(cache.Store(key, bytecode.data(), bytecode.size()));
+            ShaderCache::Key collision = key;
+            collision.check ^= 1;
+            LENS_CHECK(cache.GetPath(collision) == path);
+            LENS_CHECK(!cache.Load(collision, loaded));
+            LENS_CHECK(!std::filesystem::exists(path));
+
+            // 被删除后重新写入即可恢复
+            LENS_CHECK(cache.Store(key, bytecode.data(), bytecode.size()));
+            LENS_CHECK(cache.Load(key, loaded));
+            LENS_CHECK(loaded == bytecode);
+
+            const auto stats = cache.GetStats();
+            LENS_CHECK(stats.rejected == 4);
+            LENS_CHECK(stats.misses == 4);
+            LENS_CHECK(stats.hits == 1);
+        }
+
+        void TestReadOnly()
+        {
+            TempDirectory directory("lens-test-shadercache-readonly");
+            ShaderCache::Desc desc;
+            desc.directory = directory.GetPath();
+
+            const auto key = MakeTestKey("main");
+            const auto bytecode = MakeBytecode(128);
+            {
+                ShaderCache writer(desc);
+                LENS_CHECK(writer.Store(key, bytecode.data(), bytecode.size()));
+            }
+
+            // 只读时照常命中，但不写入任何文件
+            desc.readOnly = true;
+            ShaderCache cache(desc);
+            std::vector<uint8_t> loaded;
+            LENS_CHECK(cache.Load(key, loaded));
+            LENS_CHECK(loaded == bytecode);
+
+            const auto otherKey = MakeTestKey("other");
+            LENS_CHECK(!cache.Store(otherKey, bytecode.data(), bytecode.size()));
+            LENS_CHECK(!std::filesystem::exists(cache.GetPath(otherKey)));
+
+            uint32_t compiles = 0;
+            auto compile = [&](std::vector<uint8_t>& out) { compiles++; out = bytecode; return true; };
+            LENS_CHECK(cache.GetOrCompile(otherKey, loaded, compile));
+            LENS_CHECK(cache.GetOrCompile(otherKey, loaded, compile));
+            LENS_CHECK(compiles == 2);
+            LENS_CHECK(!std::filesystem::exists(cache.GetPath(otherKey)));
+            LENS_CHECK(cache.GetStats().stores == 0);
+        }
+    }
+
+    void TestShaderCache()
+    {
+        TestKeys();
+        TestRoundTrip();
+        TestRejection();
+        TestReadOnly();
+    }
+}
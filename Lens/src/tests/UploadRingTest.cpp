@@ -0,0 +1,169 @@
+﻿#include "LensPch.h"
+#include "tests/SelfTest.h"
+#include "graphics/CpuUploadDevice.h"
+#include "graphics/UploadRing.h"
+#include <deque>
+
+namespace lens::tests
+{
+    namespace
+    {
+        struct Region
+        {
+            uint64_t offset;
+            uint32_t size;
+            uint8_t tag;
+        };
+
+        bool IsFilled(const uint8_t* data, const Region& region)
+        {
+            for (uint32_t i = 0; i < region.size; ++i)
+            {
+                if (data[region.offset + i] != region.tag)
+                    return false;
+            }
+            return true;
+        }
+
+        void TestAllocation()
+        {
+            graphics::UploadRing::Desc desc;
+            desc.capacity = 4096;
+            desc.alignment = 256;
+            graphics::UploadRing ring(std::make_unique<graphics::CpuUploadDevice>(), desc);
+            LENS_CHECK(ring.IsValid());
+
+            // 按对齐取整，同一帧内顺序排列，只映射一次
+            ring.BeginFrame();
+            auto first = ring.Allocate(16);
+            auto second = ring.Push(uint64_t{ 42 });
+            LENS_CHECK(first && first.offset == 0 && first.size == 256);
+            LENS_CHECK(second && second.offset == 256);
+            LENS_CHECK(memcmp(second.data, "\x2A\0\0\0\0\0\0\0", 8) == 0);
+            LENS_CHECK(!ring.Allocate(0));
+            ring.EndFrame();
+
+            auto stats = ring.GetStats();
+            LENS_CHECK(stats.allocations == 2);
+            LENS_CHECK(stats.bytesAllocated == 512);
+            LENS_CHECK(stats.maps == 1 && stats.discards == 1);
+
+            // 之后的映射都不丢弃旧内容
+            for (int frame = 0; frame < 10; ++frame)
+            {
+                ring.BeginFrame();
+                LENS_CHECK(ring.Push(frame));
+                ring.EndFrame();
+            }
+            stats = ring.GetStats();
+            LENS_CHECK(stats.maps == 11 && stats.discards == 1);
+            LENS_CHECK(stats.stalls == 0);
+
+            // 超过容量的分配和超过容量的一帧都失败
+            ring.BeginFrame();
+            LENS_CHECK(!ring.Allocate(5000));
+            for (int i = 0; i < 16; ++i)
+            {
+                LENS_CHECK(ring.Allocate(256));
+            }
+            LENS_CHECK(!ring.Allocate(256));
+            ring.EndFrame();
+            LENS_CHECK(ring.GetStats().failed == 2);
+        }
+
+        void TestInFlightRegions()
+        {
+            // GPU 落后两帧：在途帧的区域在围栏完成之前不能被新分配覆盖
+            auto device = std::make_unique<graphics::CpuUploadDevice>(2);
+            graphics::CpuUploadDevice* cpuDevice = device.get();
+            graphics::UploadRing::Desc desc;
+            desc.capacity = 4096;
+            desc.alignment = 256;
+            graphics::UploadRing ring(std::move(device), desc);
+
+            // 只记录有分配的帧，与环里的在途帧一一对应
+            std::deque<std::vector<Region>> frames;
+            for (uint32_t frame = 0; frame < 300; ++frame)
+            {
+                ring.BeginFrame();
+                const auto before = ring.GetStats();
+                while (frames.size() > before.framesInFlight)
+                {
+                    frames.pop_front();
+                }
+                for (const auto& regions : frames)
+                {
+                    for (const auto& region : regions)
+                    {
+                        LENS_CHECK(IsFilled(cpuDevice->GetData(), region));
+                    }
+                }
+
+                std::vector<Region> regions;
+                const uint32_t count = frame % 7 == 6 ? 0 : 1 + frame % 5;
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    auto allocation = ring.Allocate(100 + (frame * 37 + i * 11) % 400);
+                    LENS_CHECK(allocation);
+                    if (!allocation)
+                        continue;
+                    LENS_CHECK(allocation.offset % desc.alignment == 0);
+                    LENS_CHECK(allocation.offset + allocation.size <= desc.capacity);
+                    const Region region{ allocation.offset, allocation.size, static_cast<uint8_t>(frame + 1) };
+                    memset(allocation.data, region.tag, region.size);
+                    regions.push_back(region);
+                }
+                ring.EndFrame();
+                if (!regions.empty())
+                {
+                    frames.push_back(std::move(regions));
+                }
+            }
+
+            // 容量小于三帧的最大用量，必然有等待和绕回
+            const auto stats = ring.GetStats();
+            LENS_CHECK(stats.stalls > 0);
+            LENS_CHECK(stats.wrapWaste > 0);
+            LENS_CHECK(stats.failed == 0);
+            LENS_CHECK(stats.peakUsedBytes <= desc.capacity);
+            LENS_CHECK(stats.discards == 1);
+            LENS_CHECK(cpuDevice->GetStats().waits > 0);
+            LENS_CHECK(cpuDevice->GetStats().discards == 1);
+        }
+
+        void TestCpuUploadDevice()
+        {
+            graphics::CpuUploadDevice device(1);
+            LENS_CHECK(device.Create(256));
+
+            // DISCARD 映射清掉旧内容，NO_OVERWRITE 保留
+            uint8_t* data = device.Map(false);
+            memset(data, 0xAB, 256);
+            LENS_CHECK(device.Map(false)[255] == 0xAB);
+            LENS_CHECK(device.Map(true)[255] == 0);
+
+            // 围栏经过一次查询后完成，等待的查询立即完成全部
+            device.SignalFence(1);
+            device.SignalFence(2);
+            LENS_CHECK(device.GetCompletedFence(false) == 2);
+            device.SignalFence(3);
+            device.SignalFence(4);
+            LENS_CHECK(device.GetCompletedFence(true) == 4);
+            LENS_CHECK(device.GetStats().waits == 1);
+            LENS_CHECK(device.GetCompletedFence(true) == 4);
+            LENS_CHECK(device.GetStats().waits == 1);
+
+            graphics::CpuUploadDevice immediate;
+            LENS_CHECK(immediate.Create(256));
+            immediate.SignalFence(7);
+            LENS_CHECK(immediate.GetCompletedFence(false) == 7);
+        }
+    }
+
+    void TestUploadRing()
+    {
+        TestAllocation();
+        TestInFlightRegions();
+        TestCpuUploadDevice();
+    }
+}